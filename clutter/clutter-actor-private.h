@@ -258,6 +258,7 @@ void                            _clutter_actor_apply_modelview_transform
 void                            _clutter_actor_apply_relative_transformation_matrix     (ClutterActor *self,
                                                                                          ClutterActor *ancestor,
                                                                                          CoglMatrix   *matrix);
+void                            _clutter_actor_invalidate_transform                     (ClutterActor *self);
 
 void                            _clutter_actor_rerealize                                (ClutterActor    *self,
                                                                                          ClutterCallback  callback,
@@ -299,6 +300,14 @@ void                            _clutter_actor_push_clone_paint
 void                            _clutter_actor_pop_clone_paint                          (void);
 
 guint32                         _clutter_actor_get_pick_id                              (ClutterActor *self);
+void                            _clutter_actor_class_set_geometric_pick                 (ClutterActorClass *klass);
+gboolean                        _clutter_actor_geometric_pick                           (ClutterActor      *self,
+                                                                                         const CoglMatrix  *projection,
+                                                                                         const float       *viewport,
+                                                                                         ClutterPickMode    mode,
+                                                                                         float              x,
+                                                                                         float              y,
+                                                                                         ClutterActor     **hit);
 
 void                            _clutter_actor_shader_pre_paint                         (ClutterActor *actor,
                                                                                          gboolean      repeat);
@@ -316,12 +325,38 @@ void                            _clutter_actor_detach_clone
 void                            _clutter_actor_queue_redraw_on_clones                   (ClutterActor *actor);
 void                            _clutter_actor_queue_relayout_on_clones                 (ClutterActor *actor);
 void                            _clutter_actor_queue_only_relayout                      (ClutterActor *actor);
+void                            _clutter_actor_relayout_root                            (ClutterActor *self);
+
+void                            _clutter_actor_get_size_request_stats                   (guint        *n_hits,
+                                                                                         guint        *n_misses,
+                                                                                         guint        *n_evictions);
+void                            _clutter_actor_reset_size_request_stats                 (void);
 
 CoglFramebuffer *               _clutter_actor_get_active_framebuffer                   (ClutterActor *actor);
 
 ClutterPaintNode *              clutter_actor_create_texture_paint_node                 (ClutterActor *self,
                                                                                          CoglTexture  *texture);
 
+gboolean                        _clutter_actor_can_set_animated_property                (ClutterActor       *self,
+                                                                                         GParamSpec         *pspec);
+void                            _clutter_actor_set_animated_float                       (ClutterActor       *self,
+                                                                                         GParamSpec         *pspec,
+                                                                                         gfloat              value);
+void                            _clutter_actor_set_animated_double                      (ClutterActor       *self,
+                                                                                         GParamSpec         *pspec,
+                                                                                         gdouble             value);
+void                            _clutter_actor_set_animated_uint                        (ClutterActor       *self,
+                                                                                         GParamSpec         *pspec,
+                                                                                         guint               value);
+void                            _clutter_actor_set_animated_color                       (ClutterActor       *self,
+                                                                                         GParamSpec         *pspec,
+                                                                                         const ClutterColor *value);
+void                            _clutter_actor_set_animated_point                       (ClutterActor       *self,
+                                                                                         GParamSpec         *pspec,
+                                                                                         const ClutterPoint *value);
+void                            _clutter_actor_begin_deferred_notifies                  (void);
+void                            _clutter_actor_end_deferred_notifies                    (void);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_ACTOR_PRIVATE_H__ */
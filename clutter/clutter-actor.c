@@ -607,6 +607,7 @@
 
 #include "config.h"
 
+#include <float.h>
 #include <math.h>
 
 #include <gobject/gvaluecollector.h>
@@ -632,6 +633,7 @@
 #include "clutter-enum-types.h"
 #include "clutter-fixed-layout.h"
 #include "clutter-flatten-effect.h"
+#include "clutter-image-private.h"
 #include "clutter-interval.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
@@ -642,6 +644,7 @@
 #include "clutter-property-transition.h"
 #include "clutter-scriptable.h"
 #include "clutter-script-private.h"
+#include "clutter-spatial-index.h"
 #include "clutter-stage-private.h"
 #include "clutter-timeline.h"
 #include "clutter-transition.h"
@@ -668,9 +671,47 @@ typedef enum {
                               */
 } MapStateChange;
 
-/* 3 entries should be a good compromise, few layout managers
- * will ask for 3 different preferred size in each allocation cycle */
-#define N_CACHED_SIZE_REQUESTS 3
+/* the cache of size requests of an actor for a given orientation.
+ *
+ * most actors are only ever asked for their preferred size for a
+ * single for_size, which is stored in the @first slot; the table
+ * is created the first time a different for_size is requested, as
+ * height-for-width layout managers do, and it holds up to the value
+ * returned by _clutter_get_size_request_cache_size() entries, keyed
+ * by the bits of the for_size
+ */
+typedef struct _SizeRequestCache
+{
+  SizeRequest first;
+
+  GHashTable *requests;
+
+  /* the age of the most recent entry; an entry with an
+   * age of 0 is not set
+   */
+  guint age;
+} SizeRequestCache;
+
+/* statistics of all the size request caches; see
+ * _clutter_actor_get_size_request_stats()
+ */
+static guint size_request_n_hits = 0;
+static guint size_request_n_misses = 0;
+static guint size_request_n_evictions = 0;
+
+static void
+size_request_cache_clear (SizeRequestCache *cache)
+{
+  cache->first.age = 0;
+
+  if (cache->requests != NULL)
+    g_hash_table_remove_all (cache->requests);
+}
+
+/* containers with fewer children than this are only ever walked
+ * through the list of siblings; see clutter_actor_ensure_child_index()
+ */
+#define CHILD_INDEX_MIN_CHILDREN 32
 
 struct _ClutterActorPrivate
 {
@@ -678,12 +719,8 @@ struct _ClutterActorPrivate
   ClutterRequestMode request_mode;
 
   /* our cached size requests for different width / height */
-  SizeRequest width_requests[N_CACHED_SIZE_REQUESTS];
-  SizeRequest height_requests[N_CACHED_SIZE_REQUESTS];
-
-  /* An age of 0 means the entry is not set */
-  guint cached_height_age;
-  guint cached_width_age;
+  SizeRequestCache width_requests;
+  SizeRequestCache height_requests;
 
   /* the bounding box of the actor, relative to the parent's
    * allocation
@@ -715,6 +752,19 @@ struct _ClutterActorPrivate
 
   gint n_children;
 
+  /* an array of the children, in paint order, built once a container
+   * grows past CHILD_INDEX_MIN_CHILDREN children; it is kept in sync
+   * with the list of siblings, and it is used to look up children by
+   * index and to find the insertion point of a child by depth
+   */
+  GPtrArray *child_index;
+  /* the positions stored by the first child_index_valid children in
+   * the array are up to date; the rest are recomputed on demand
+   */
+  guint child_index_valid;
+  /* the position of the actor inside the child index of its parent */
+  guint child_index_pos;
+
   /* tracks whenever the children of an actor are changed; the
    * age is incremented by 1 whenever an actor is added or
    * removed. the age is not incremented when the first or the
@@ -783,6 +833,27 @@ struct _ClutterActorPrivate
 
   ClutterStageQueueRedrawEntry *queue_redraw_entry;
 
+  /* the entry of the actor inside the spatial index of the stage,
+   * or -1 if the actor is not indexed
+   */
+  gint spatial_index_id;
+
+  /* incremented every time the transformation or the allocation of
+   * the actor change; the sum of the ages of the actor and of all its
+   * ancestors is stored when the spatial index is updated, so that we
+   * can detect when the indexed paint box is out of date
+   */
+  guint transform_age;
+  guint spatial_index_age;
+
+  /* the paint nodes retained across frames, and the state they
+   * were built for; see clutter_stage_set_retain_paint_nodes()
+   */
+  ClutterPaintNode *retained_paint_node;
+  gfloat retained_width;
+  gfloat retained_height;
+  guint8 retained_opacity;
+
   ClutterColor bg_color;
 
 #ifdef CLUTTER_ENABLE_DEBUG
@@ -840,6 +911,18 @@ struct _ClutterActorPrivate
   guint needs_compute_expand        : 1;
   guint needs_x_expand              : 1;
   guint needs_y_expand              : 1;
+  /* the box in the spatial index matches the last paint volume */
+  guint spatial_index_valid         : 1;
+  /* the box in the spatial index may not contain the boxes of all
+   * the descendants of the actor
+   */
+  guint spatial_index_partial       : 1;
+  /* the notifications are frozen until the end of the frame */
+  guint notify_deferred             : 1;
+  /* the children are known to be sorted by depth */
+  guint children_depth_sorted       : 1;
+  /* the relayout being queued was queued by one of the children */
+  guint relayout_from_child         : 1;
 };
 
 enum
@@ -1046,6 +1129,7 @@ static void clutter_actor_set_natural_height_set (ClutterActor *self,
 static void clutter_actor_update_map_state       (ClutterActor  *self,
                                                   MapStateChange change);
 static void clutter_actor_unrealize_not_hiding   (ClutterActor *self);
+static gboolean clutter_actor_has_valid_spatial_index (ClutterActor *self);
 
 /* Helper routines for managing anchor coords */
 static void clutter_anchor_coord_get_units (ClutterActor      *self,
@@ -1105,6 +1189,7 @@ static GQuark quark_shader_data = 0;
 static GQuark quark_actor_layout_info = 0;
 static GQuark quark_actor_transform_info = 0;
 static GQuark quark_actor_animation_info = 0;
+static GQuark quark_actor_geometric_pick = 0;
 
 G_DEFINE_TYPE_WITH_CODE (ClutterActor,
                          clutter_actor,
@@ -1618,6 +1703,17 @@ clutter_actor_real_unmap (ClutterActor *self)
 
       priv->pick_id = -1;
 
+      if (stage != NULL && priv->spatial_index_id >= 0)
+        {
+          _clutter_spatial_index_remove (_clutter_stage_get_spatial_index (stage),
+                                         priv->spatial_index_id);
+        }
+
+      priv->spatial_index_id = -1;
+      priv->spatial_index_valid = FALSE;
+
+      g_clear_pointer (&priv->retained_paint_node, clutter_paint_node_unref);
+
       if (stage != NULL &&
           clutter_stage_get_key_focus (stage) == self)
         {
@@ -2283,6 +2379,295 @@ clutter_actor_should_pick_paint (ClutterActor *self)
   return FALSE;
 }
 
+static gboolean
+clutter_actor_real_hit_test (ClutterActor *self,
+                             gfloat        x,
+                             gfloat        y)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  /* this matches the rectangle painted by clutter_actor_real_pick() */
+  return x >= 0.f && x < clutter_actor_box_get_width (&priv->allocation) &&
+         y >= 0.f && y < clutter_actor_box_get_height (&priv->allocation);
+}
+
+/* Maps the stage point (@x, @y) onto the z = 0 plane of an actor, given
+ * the @mvp matrix taking the actor coordinates into clip coordinates;
+ * this is the inverse of _clutter_util_fully_transform_vertices() for a
+ * single vertex lying on the actor's plane.
+ */
+static gboolean
+unproject_stage_point (const CoglMatrix *mvp,
+                       const float      *viewport,
+                       float             x,
+                       float             y,
+                       float            *x_out,
+                       float            *y_out)
+{
+  float nx, ny;
+  float a, b, c, d, e, f;
+  float det, scale, u, v;
+
+  if (viewport[2] <= 0.f || viewport[3] <= 0.f)
+    return FALSE;
+
+  /* window coordinates to normalized device coordinates */
+  nx = (x - viewport[0]) * 2.f / viewport[2] - 1.f;
+  ny = 1.f - (y - viewport[1]) * 2.f / viewport[3];
+
+  /* for a point (u, v, 0, 1) we have:
+   *
+   *   nx = (xx * u + xy * v + xw) / (wx * u + wy * v + ww)
+   *   ny = (yx * u + yy * v + yw) / (wx * u + wy * v + ww)
+   *
+   * which is a linear system in (u, v)
+   */
+  a = mvp->xx - nx * mvp->wx;
+  b = mvp->xy - nx * mvp->wy;
+  c = nx * mvp->ww - mvp->xw;
+  d = mvp->yx - ny * mvp->wx;
+  e = mvp->yy - ny * mvp->wy;
+  f = ny * mvp->ww - mvp->yw;
+
+  det = a * e - b * d;
+
+  /* the plane of the actor is parallel to the line of sight; the
+   * determinant is compared with the magnitude of its terms, so that
+   * the test does not depend on the scale of the transformation
+   */
+  scale = MAX (fabsf (a), fabsf (b)) * MAX (fabsf (d), fabsf (e));
+  if (scale == 0.f || fabsf (det) <= scale * FLT_EPSILON * 16.f)
+    return FALSE;
+
+  u = (c * e - b * f) / det;
+  v = (a * f - c * d) / det;
+
+  /* the intersection is behind the eye */
+  if (mvp->wx * u + mvp->wy * v + mvp->ww <= 0.f)
+    return FALSE;
+
+  *x_out = u;
+  *y_out = v;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_actor_class_set_geometric_pick:
+ * @klass: a #ClutterActorClass
+ *
+ * Declares that the #ClutterActorClass.pick implementation of @klass
+ * paints the same silhouette as the default implementation, and then
+ * the children of the actor in paint order, so that it can be replaced
+ * by #ClutterActorClass.hit_test when picking geometrically.
+ *
+ * Sub-classes of @klass overriding the pick virtual function are not
+ * affected by this declaration.
+ */
+void
+_clutter_actor_class_set_geometric_pick (ClutterActorClass *klass)
+{
+  g_type_set_qdata (G_TYPE_FROM_CLASS (klass),
+                    quark_actor_geometric_pick,
+                    (gpointer) klass->pick);
+}
+
+static gboolean
+clutter_actor_class_has_geometric_pick (ClutterActorClass *klass)
+{
+  GType gtype;
+
+  if (klass->pick == clutter_actor_real_pick ||
+      klass->hit_test != clutter_actor_real_hit_test)
+    return TRUE;
+
+  /* the pick implementation may have been declared by an ancestor */
+  for (gtype = G_TYPE_FROM_CLASS (klass);
+       gtype != CLUTTER_TYPE_ACTOR;
+       gtype = g_type_parent (gtype))
+    {
+      if (g_type_get_qdata (gtype, quark_actor_geometric_pick) == (gpointer) klass->pick)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+/* Whether we can replicate the result of painting @self in pick mode
+ * without actually painting it
+ */
+static gboolean
+clutter_actor_can_geometric_pick (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (g_signal_has_handler_pending (self, actor_signals[PICK], 0, TRUE))
+    return FALSE;
+
+  if (priv->effects != NULL)
+    {
+      const GList *l;
+
+      for (l = _clutter_meta_group_peek_metas (priv->effects);
+           l != NULL;
+           l = l->next)
+        {
+          if (clutter_actor_meta_get_enabled (l->data) &&
+              _clutter_effect_has_custom_pick (l->data))
+            return FALSE;
+        }
+    }
+
+  /* the stage does not paint any silhouette of its own */
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    return TRUE;
+
+  return clutter_actor_class_has_geometric_pick (CLUTTER_ACTOR_GET_CLASS (self));
+}
+
+static gboolean
+clutter_actor_geometric_pick_internal (ClutterActor      *self,
+                                       const CoglMatrix  *projection,
+                                       const CoglMatrix  *parent_modelview,
+                                       const float       *viewport,
+                                       ClutterPickMode    mode,
+                                       float              x,
+                                       float              y,
+                                       ClutterActor     **hit)
+{
+  ClutterActorPrivate *priv = self->priv;
+  CoglMatrix modelview, mvp;
+  ClutterActor *child;
+  gboolean has_point;
+  float u = 0.f, v = 0.f;
+
+  /* these are the same checks done by clutter_actor_paint() */
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self) || !CLUTTER_ACTOR_IS_MAPPED (self))
+    return TRUE;
+
+  /* the box of the actor in the spatial index covers its allocation
+   * and, unless some descendant was found outside of it, the boxes of
+   * its descendants, so we can reject the whole sub-tree without
+   * transforming it
+   */
+  if (clutter_actor_has_valid_spatial_index (self) &&
+      !priv->spatial_index_partial)
+    {
+      ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+      ClutterActorBox box;
+
+      _clutter_spatial_index_get_box (_clutter_stage_get_spatial_index (CLUTTER_STAGE (stage)),
+                                      priv->spatial_index_id,
+                                      &box);
+
+      if (!clutter_actor_box_contains (&box, x, y))
+        return TRUE;
+    }
+
+  if (!clutter_actor_can_geometric_pick (self))
+    {
+      CLUTTER_NOTE (PICK, "Actor '%s' cannot be picked geometrically",
+                    _clutter_actor_get_debug_name (self));
+      return FALSE;
+    }
+
+  modelview = *parent_modelview;
+  if (priv->enable_model_view_transform)
+    _clutter_actor_apply_modelview_transform (self, &modelview);
+
+  cogl_matrix_multiply (&mvp, projection, &modelview);
+  has_point = unproject_stage_point (&mvp, viewport, x, y, &u, &v);
+
+  /* the clip applies to the actor and to all its descendants */
+  if (priv->has_clip)
+    {
+      if (!has_point ||
+          u < priv->clip.origin.x ||
+          u >= priv->clip.origin.x + priv->clip.size.width ||
+          v < priv->clip.origin.y ||
+          v >= priv->clip.origin.y + priv->clip.size.height)
+        return TRUE;
+    }
+  else if (priv->clip_to_allocation)
+    {
+      if (!has_point ||
+          u < 0.f || u >= clutter_actor_box_get_width (&priv->allocation) ||
+          v < 0.f || v >= clutter_actor_box_get_height (&priv->allocation))
+        return TRUE;
+    }
+
+  /* children are painted on top of their parent, and later siblings on
+   * top of earlier ones, so we walk the scene graph in reverse paint
+   * order and stop at the first hit; everything below it is occluded
+   */
+  for (child = priv->last_child;
+       child != NULL;
+       child = child->priv->prev_sibling)
+    {
+      if (!clutter_actor_geometric_pick_internal (child,
+                                                  projection,
+                                                  &modelview,
+                                                  viewport,
+                                                  mode,
+                                                  x, y,
+                                                  hit))
+        return FALSE;
+
+      if (*hit != NULL)
+        return TRUE;
+    }
+
+  if (has_point &&
+      !CLUTTER_ACTOR_IS_TOPLEVEL (self) &&
+      (mode == CLUTTER_PICK_ALL || CLUTTER_ACTOR_IS_REACTIVE (self)) &&
+      CLUTTER_ACTOR_GET_CLASS (self)->hit_test (self, u, v))
+    *hit = self;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_actor_geometric_pick:
+ * @self: a #ClutterActor, usually the stage
+ * @projection: the projection matrix of the stage
+ * @viewport: the viewport of the stage
+ * @mode: the #ClutterPickMode
+ * @x: the X coordinate of the point, in stage coordinates
+ * @y: the Y coordinate of the point, in stage coordinates
+ * @hit: (out): return location for the picked actor, or %NULL
+ *
+ * Picks the actor at the given point by intersecting it with the
+ * transformed allocation boxes of @self and its descendants, instead
+ * of painting them in pick mode.
+ *
+ * Return value: %TRUE if the pick was resolved, and %FALSE if an actor
+ *   with a custom pick implementation was found; in that case the
+ *   caller should fall back to a pick paint
+ */
+gboolean
+_clutter_actor_geometric_pick (ClutterActor      *self,
+                               const CoglMatrix  *projection,
+                               const float       *viewport,
+                               ClutterPickMode    mode,
+                               float              x,
+                               float              y,
+                               ClutterActor     **hit)
+{
+  CoglMatrix modelview;
+
+  cogl_matrix_init_identity (&modelview);
+
+  *hit = NULL;
+
+  return clutter_actor_geometric_pick_internal (self,
+                                                projection,
+                                                &modelview,
+                                                viewport,
+                                                mode,
+                                                x, y,
+                                                hit);
+}
+
 static void
 clutter_actor_real_get_preferred_width (ClutterActor *self,
                                         gfloat        for_height,
@@ -2496,7 +2881,7 @@ clutter_actor_set_allocation_internal (ClutterActor           *self,
       CLUTTER_NOTE (LAYOUT, "Allocation for '%s' changed",
                     _clutter_actor_get_debug_name (self));
 
-      priv->transform_valid = FALSE;
+      _clutter_actor_invalidate_transform (self);
 
       g_object_notify_by_pspec (obj, obj_props[PROP_ALLOCATION]);
 
@@ -2674,6 +3059,9 @@ clutter_actor_real_queue_redraw (ClutterActor *self,
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
 
+  /* the paint volume of the actor may have changed */
+  self->priv->spatial_index_valid = FALSE;
+
   /* If the queue redraw is coming from a child then the actor has
      become dirty and any queued effect is no longer valid */
   if (self != origin)
@@ -2717,28 +3105,100 @@ clutter_actor_real_queue_redraw (ClutterActor *self,
     }
 }
 
+/*< private >
+ * clutter_actor_is_relayout_root:
+ * @self: a #ClutterActor
+ *
+ * Checks whether a relayout queued by one of the children of @self can
+ * stop at @self, instead of going all the way up to the stage.
+ *
+ * This is possible if the size request of @self does not depend on its
+ * children, because both its width and its height are fixed, and if
+ * @self already has an allocation that can be reused as it is; in that
+ * case the parent of @self would allocate it exactly as it did before.
+ *
+ * The expand flags of @self can also depend on its children, unless
+ * they have been set explicitly, and the parent of @self may allocate
+ * more space to @self when they change.
+ *
+ * The ancestors of a relayout root do not emit ::queue-relayout.
+ */
+static gboolean
+clutter_actor_is_relayout_root (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (priv->parent == NULL || CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    return FALSE;
+
+  if (!(priv->min_width_set && priv->natural_width_set &&
+        priv->min_height_set && priv->natural_height_set))
+    return FALSE;
+
+  /* the allocation is recomputed by the parent when it changes */
+  if (priv->needs_allocation || !CLUTTER_ACTOR_IS_VISIBLE (self))
+    return FALSE;
+
+  /* constraints can only be applied from clutter_actor_allocate() */
+  if (priv->constraints != NULL)
+    return FALSE;
+
+  /* a child changed its expand flags */
+  if (priv->needs_compute_expand &&
+      !(priv->x_expand_set && priv->y_expand_set))
+    return FALSE;
+
+  return TRUE;
+}
+
 static void
 clutter_actor_real_queue_relayout (ClutterActor *self)
 {
   ClutterActorPrivate *priv = self->priv;
+  gboolean is_relayout_root;
 
   /* no point in queueing a redraw on a destroyed actor */
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
 
+  /* only a relayout coming from the children cannot affect the way
+   * the parent allocates us; a relayout queued on the actor itself
+   * may be caused by a change in its position, margins or alignment
+   */
+  is_relayout_root = priv->relayout_from_child &&
+                     clutter_actor_is_relayout_root (self);
+
   priv->needs_width_request  = TRUE;
   priv->needs_height_request = TRUE;
   priv->needs_allocation     = TRUE;
 
   /* reset the cached size requests */
-  memset (priv->width_requests, 0,
-          N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
-  memset (priv->height_requests, 0,
-          N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
+  size_request_cache_clear (&priv->width_requests);
+  size_request_cache_clear (&priv->height_requests);
+
+  if (is_relayout_root)
+    {
+      ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+
+      if (stage != NULL)
+        {
+          CLUTTER_NOTE (LAYOUT, "Queueing relayout root '%s'",
+                        _clutter_actor_get_debug_name (self));
+
+          _clutter_stage_queue_relayout_root (CLUTTER_STAGE (stage), self);
+          return;
+        }
+    }
 
   /* We need to go all the way up the hierarchy */
   if (priv->parent != NULL)
-    _clutter_actor_queue_only_relayout (priv->parent);
+    {
+      ClutterActor *parent = priv->parent;
+
+      parent->priv->relayout_from_child = TRUE;
+      _clutter_actor_queue_only_relayout (parent);
+      parent->priv->relayout_from_child = FALSE;
+    }
 }
 
 /**
@@ -3427,6 +3887,188 @@ in_clone_paint (void)
   return clone_paint_level > 0;
 }
 
+static inline guint
+clutter_actor_get_transform_path_age (ClutterActor *self)
+{
+  guint age = 0;
+
+  for (; self != NULL; self = self->priv->parent)
+    age += self->priv->transform_age;
+
+  return age;
+}
+
+/* Whether the paint box of the actor inside the spatial index of the
+ * stage still reflects the position of the actor on the stage
+ */
+static gboolean
+clutter_actor_has_valid_spatial_index (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  return priv->spatial_index_id >= 0 &&
+         priv->spatial_index_valid &&
+         priv->spatial_index_age == clutter_actor_get_transform_path_age (self);
+}
+
+static inline gboolean
+box_contains_box (const ClutterActorBox *outer,
+                  const ClutterActorBox *inner)
+{
+  return outer->x1 <= inner->x1 && outer->y1 <= inner->y1 &&
+         outer->x2 >= inner->x2 && outer->y2 >= inner->y2;
+}
+
+/* Lets the ancestors of the actor know that they cannot reject their
+ * sub-tree using their own box when picking, because the actor is not
+ * covered by the spatial index
+ */
+static void
+clutter_actor_set_spatial_index_partial (ClutterActor *self)
+{
+  ClutterActor *parent;
+
+  for (parent = self->priv->parent;
+       parent != NULL && !CLUTTER_ACTOR_IS_TOPLEVEL (parent);
+       parent = parent->priv->parent)
+    parent->priv->spatial_index_partial = TRUE;
+}
+
+/* Updates the paint box of the actor inside the spatial index of the
+ * stage, using the last paint volume and the allocation of the actor
+ */
+static void
+clutter_actor_update_spatial_index (ClutterActor *self,
+                                    ClutterStage *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterSpatialIndex *index_;
+  ClutterActorBox box, allocation_box;
+  ClutterPaintVolume pv;
+  ClutterActor *parent;
+  guint age;
+
+  if (stage == NULL || CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    return;
+
+  index_ = _clutter_stage_get_spatial_index (stage);
+
+  if (!priv->last_paint_volume_valid)
+    {
+      if (priv->spatial_index_id >= 0)
+        _clutter_spatial_index_remove (index_, priv->spatial_index_id);
+
+      priv->spatial_index_id = -1;
+      priv->spatial_index_valid = FALSE;
+
+      /* the actor can still be picked inside its allocation */
+      clutter_actor_set_spatial_index_partial (self);
+      return;
+    }
+
+  _clutter_paint_volume_get_stage_paint_box (&priv->last_paint_volume,
+                                             stage,
+                                             &box);
+
+  /* the paint volume can be smaller than the allocation, like the ink
+   * rectangle of a ClutterText, but the whole allocation is picked
+   */
+  _clutter_paint_volume_init_static (&pv, self);
+  clutter_paint_volume_set_width (&pv, clutter_actor_box_get_width (&priv->allocation));
+  clutter_paint_volume_set_height (&pv, clutter_actor_box_get_height (&priv->allocation));
+  _clutter_paint_volume_get_stage_paint_box (&pv, stage, &allocation_box);
+  clutter_paint_volume_free (&pv);
+
+  clutter_actor_box_union (&box, &allocation_box, &box);
+
+  age = clutter_actor_get_transform_path_age (self);
+
+  /* if the actor moved, so did its descendants, and they will
+   * check again whether they are inside our box when painted
+   */
+  if (priv->spatial_index_id < 0 || priv->spatial_index_age != age)
+    priv->spatial_index_partial = FALSE;
+
+  if (priv->spatial_index_id < 0)
+    priv->spatial_index_id = _clutter_spatial_index_insert (index_, &box, self);
+  else
+    _clutter_spatial_index_update (index_, priv->spatial_index_id, &box);
+
+  priv->spatial_index_age = age;
+  priv->spatial_index_valid = TRUE;
+
+  /* let the ancestors whose box does not contain ours know that they
+   * cannot reject their sub-tree using their own box
+   */
+  for (parent = priv->parent;
+       parent != NULL && !CLUTTER_ACTOR_IS_TOPLEVEL (parent);
+       parent = parent->priv->parent)
+    {
+      ClutterActorBox parent_box;
+
+      if (parent->priv->spatial_index_id < 0)
+        continue;
+
+      _clutter_spatial_index_get_box (index_,
+                                      parent->priv->spatial_index_id,
+                                      &parent_box);
+
+      if (box_contains_box (&parent_box, &box))
+        break;
+
+      parent->priv->spatial_index_partial = TRUE;
+    }
+}
+
+/* Returns TRUE if the actor, and all its children, can be skipped
+ * because its paint box in the spatial index is outside of the area
+ * of the stage being painted; unlike cull_actor() this does not need
+ * to transform the paint volume of the actor
+ */
+static gboolean
+cull_actor_by_spatial_index (ClutterActor *self,
+                             ClutterStage *stage)
+{
+  ClutterActorPrivate *priv = self->priv;
+  guint mark;
+
+  if (G_UNLIKELY (clutter_paint_debug_flags &
+                  (CLUTTER_DEBUG_DISABLE_CULLING | CLUTTER_DEBUG_REDRAWS)))
+    return FALSE;
+
+  if (stage == NULL || !clutter_actor_has_valid_spatial_index (self))
+    return FALSE;
+
+  mark = _clutter_stage_get_spatial_index_mark (stage);
+  if (mark == 0)
+    return FALSE;
+
+  if (cogl_get_draw_framebuffer () != _clutter_stage_get_active_framebuffer (stage))
+    return FALSE;
+
+  return !_clutter_spatial_index_is_marked (_clutter_stage_get_spatial_index (stage),
+                                            priv->spatial_index_id,
+                                            mark);
+}
+
+/*< private >
+ * _clutter_actor_invalidate_transform:
+ * @self: a #ClutterActor
+ *
+ * Invalidates the cached transformation of @self, and every
+ * transformation derived from it.
+ */
+void
+_clutter_actor_invalidate_transform (ClutterActor *self)
+{
+  /* the age is used by the spatial index to know when the paint
+   * box of the actor needs to be computed again, so every site
+   * invalidating the transformation must go through here
+   */
+  self->priv->transform_valid = FALSE;
+  self->priv->transform_age += 1;
+}
+
 /* Returns TRUE if the actor can be ignored */
 /* FIXME: we should return a ClutterCullResult, and
  * clutter_actor_paint should understand that a CLUTTER_CULL_RESULT_IN
@@ -3638,17 +4280,32 @@ clutter_actor_real_paint (ClutterActor *actor)
     }
 }
 
-static gboolean
-clutter_actor_paint_node (ClutterActor     *actor,
-                          ClutterPaintNode *root)
+/* Whether the paint() implementation or the ::paint handlers of the
+ * actor may draw using Cogl directly, instead of only painting the
+ * children of the actor; anything drawn that way must not be reordered
+ * with the rectangles batched by the paint nodes
+ */
+static gboolean
+clutter_actor_paints_directly (ClutterActor *self)
+{
+  if (g_signal_has_handler_pending (self, actor_signals[PAINT], 0, TRUE))
+    return TRUE;
+
+  /* the stage only paints its children */
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    return FALSE;
+
+  return CLUTTER_ACTOR_GET_CLASS (self)->paint != clutter_actor_real_paint;
+}
+
+static void
+clutter_actor_add_paint_nodes (ClutterActor     *actor,
+                               ClutterPaintNode *root)
 {
   ClutterActorPrivate *priv = actor->priv;
   ClutterActorBox box;
   ClutterColor bg_color;
 
-  if (root == NULL)
-    return FALSE;
-
   box.x1 = 0.f;
   box.y1 = 0.f;
   box.x2 = clutter_actor_box_get_width (&priv->allocation);
@@ -3710,6 +4367,16 @@ clutter_actor_paint_node (ClutterActor     *actor,
 
   if (CLUTTER_ACTOR_GET_CLASS (actor)->paint_node != NULL)
     CLUTTER_ACTOR_GET_CLASS (actor)->paint_node (actor, root);
+}
+
+static gboolean
+clutter_actor_paint_node (ClutterActor     *actor,
+                          ClutterPaintNode *root)
+{
+  if (root == NULL)
+    return FALSE;
+
+  clutter_actor_add_paint_nodes (actor, root);
 
   if (clutter_paint_node_get_n_children (root) == 0)
     return FALSE;
@@ -3774,7 +4441,15 @@ clutter_actor_paint (ClutterActor *self)
       /* Use the override opacity if its been set */
       ((priv->opacity_override >= 0) ?
        priv->opacity_override : priv->opacity) == 0)
-    return;
+    {
+      /* the actor and its children are still picked, but their
+       * boxes in the spatial index are not updated
+       */
+      if (!in_clone_paint ())
+        clutter_actor_set_spatial_index_partial (self);
+
+      return;
+    }
 
   /* if we aren't paintable (not in a toplevel with all
    * parents paintable) then do nothing.
@@ -3784,6 +4459,19 @@ clutter_actor_paint (ClutterActor *self)
 
   stage = (ClutterStage *) _clutter_actor_get_stage_internal (self);
 
+  /* if nothing changed since the last paint, we can use the spatial
+   * index to skip the actor without computing its paint volume
+   */
+  if (pick_mode == CLUTTER_PICK_NONE &&
+      !in_clone_paint () &&
+      cull_actor_by_spatial_index (self, stage))
+    {
+      CLUTTER_NOTE (CLIPPING, "Culled actor '%s' using the spatial index",
+                    _clutter_actor_get_debug_name (self));
+      priv->is_dirty = FALSE;
+      return;
+    }
+
   /* mark that we are in the paint process */
   CLUTTER_SET_PRIVATE_FLAGS (self, CLUTTER_IN_PAINT);
 
@@ -3843,6 +4531,8 @@ clutter_actor_paint (ClutterActor *self)
   if (priv->has_clip)
     {
       CoglFramebuffer *fb = _clutter_stage_get_active_framebuffer (stage);
+
+      _clutter_paint_batch_flush ();
       cogl_framebuffer_push_rectangle_clip (fb,
                                             priv->clip.origin.x,
                                             priv->clip.origin.y,
@@ -3858,6 +4548,7 @@ clutter_actor_paint (ClutterActor *self)
       width  = priv->allocation.x2 - priv->allocation.x1;
       height = priv->allocation.y2 - priv->allocation.y1;
 
+      _clutter_paint_batch_flush ();
       cogl_framebuffer_push_rectangle_clip (fb, 0, 0, width, height);
       clip_set = TRUE;
     }
@@ -3905,19 +4596,34 @@ clutter_actor_paint (ClutterActor *self)
        * the initialization is redundant :-( */
       ClutterCullResult result = CLUTTER_CULL_RESULT_IN;
 
+      /* the last paint volume is still valid if the paint box in the
+       * spatial index is; otherwise we update both
+       */
       if (G_LIKELY ((clutter_paint_debug_flags &
                      (CLUTTER_DEBUG_DISABLE_CULLING |
                       CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS)) !=
                     (CLUTTER_DEBUG_DISABLE_CULLING |
-                     CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS)))
-        _clutter_actor_update_last_paint_volume (self);
+                     CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS)) &&
+          !clutter_actor_has_valid_spatial_index (self))
+        {
+          _clutter_actor_update_last_paint_volume (self);
+          clutter_actor_update_spatial_index (self, stage);
+        }
 
       success = cull_actor (self, &result);
 
       if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_REDRAWS))
         _clutter_actor_paint_cull_result (self, success, result);
       else if (result == CLUTTER_CULL_RESULT_OUT && success)
-        goto done;
+        {
+          /* the children are not painted, so they cannot tell us
+           * whether they are still inside our box
+           */
+          if (priv->n_children != 0)
+            priv->spatial_index_partial = TRUE;
+
+          goto done;
+        }
     }
 
   if (priv->effects == NULL)
@@ -3925,6 +4631,7 @@ clutter_actor_paint (ClutterActor *self)
       if (pick_mode == CLUTTER_PICK_NONE &&
           actor_has_shader_data (self))
         {
+          _clutter_paint_batch_flush ();
           _clutter_actor_shader_pre_paint (self, FALSE);
           shader_applied = TRUE;
         }
@@ -3938,11 +4645,17 @@ clutter_actor_paint (ClutterActor *self)
   clutter_actor_continue_paint (self);
 
   if (shader_applied)
-    _clutter_actor_shader_post_paint (self);
+    {
+      _clutter_paint_batch_flush ();
+      _clutter_actor_shader_post_paint (self);
+    }
 
   if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_PAINT_VOLUMES &&
                   pick_mode == CLUTTER_PICK_NONE))
-    _clutter_actor_draw_paint_volume (self);
+    {
+      _clutter_paint_batch_flush ();
+      _clutter_actor_draw_paint_volume (self);
+    }
 
 done:
   /* If we make it here then the actor has run through a complete
@@ -3954,6 +4667,7 @@ done:
     {
       CoglFramebuffer *fb = _clutter_stage_get_active_framebuffer (stage);
 
+      _clutter_paint_batch_flush ();
       cogl_framebuffer_pop_clip (fb);
     }
 
@@ -3961,6 +4675,79 @@ done:
 
   /* paint sequence complete */
   CLUTTER_UNSET_PRIVATE_FLAGS (self, CLUTTER_IN_PAINT);
+
+  /* submit whatever is left once we leave the scene graph, or before
+   * returning to a parent that can draw on top of us
+   */
+  if (priv->parent == NULL ||
+      !CLUTTER_ACTOR_IN_PAINT (priv->parent) ||
+      clutter_actor_paints_directly (priv->parent))
+    _clutter_paint_batch_flush ();
+}
+
+static void
+clutter_actor_clear_retained_paint_node (ClutterActor *self)
+{
+  g_clear_pointer (&self->priv->retained_paint_node, clutter_paint_node_unref);
+}
+
+/* Paints the tree of paint nodes retained from a previous frame,
+ * building a new one only if the actor has been changed since then
+ */
+static void
+clutter_actor_paint_retained_node (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterPaintNode *root = priv->retained_paint_node;
+  gfloat width, height;
+  guint8 opacity;
+
+  width = clutter_actor_box_get_width (&priv->allocation);
+  height = clutter_actor_box_get_height (&priv->allocation);
+  opacity = clutter_actor_get_paint_opacity_internal (self);
+
+  if (root != NULL &&
+      (priv->retained_width != width ||
+       priv->retained_height != height ||
+       priv->retained_opacity != opacity ||
+       clutter_paint_node_get_framebuffer (root) != _clutter_actor_get_active_framebuffer (self)))
+    {
+      clutter_actor_clear_retained_paint_node (self);
+      root = NULL;
+    }
+
+  if (root == NULL)
+    {
+      root = _clutter_dummy_node_new (self);
+      clutter_paint_node_set_name (root, "Root");
+
+      clutter_actor_add_paint_nodes (self, root);
+
+      priv->retained_paint_node = root;
+      priv->retained_width = width;
+      priv->retained_height = height;
+      priv->retained_opacity = opacity;
+
+      CLUTTER_NOTE (PAINT, "Built the retained paint nodes of '%s'",
+                    _clutter_actor_get_debug_name (self));
+    }
+  else if (CLUTTER_IS_IMAGE (priv->content))
+    {
+      /* the content is not painted again, but its texture is still
+       * in use, and must not be evicted from the image cache
+       */
+      _clutter_image_mark_painted (CLUTTER_IMAGE (priv->content));
+    }
+
+  if (clutter_paint_node_get_n_children (root) == 0)
+    return;
+
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (CLUTTER_HAS_DEBUG (PAINT))
+    _clutter_paint_node_dump_tree (root);
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+  _clutter_paint_node_paint (root);
 }
 
 /**
@@ -3998,24 +4785,57 @@ clutter_actor_continue_paint (ClutterActor *self)
     {
       if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
         {
-          ClutterPaintNode *dummy;
+          ClutterActor *stage;
+          gboolean paints_directly;
+
+          stage = _clutter_actor_get_stage_internal (self);
 
-          /* XXX - this will go away in 2.0, when we can get rid of this
-           * stuff and switch to a pure retained render tree of PaintNodes
-           * for the entire frame, starting from the Stage; the paint()
-           * virtual function can then be called directly.
+          /* the stage owns the framebuffer of its root node, so it
+           * never retains its paint nodes; neither do actors painted
+           * by a clone, as their paint opacity depends on the clone
            */
-          dummy = _clutter_dummy_node_new (self);
-          clutter_paint_node_set_name (dummy, "Root");
+          if (stage != NULL && stage != self &&
+              !in_clone_paint () &&
+              clutter_stage_get_retain_paint_nodes (CLUTTER_STAGE (stage)))
+            {
+              clutter_actor_paint_retained_node (self);
+            }
+          else
+            {
+              ClutterPaintNode *dummy;
+
+              if (priv->retained_paint_node != NULL)
+                clutter_actor_clear_retained_paint_node (self);
+
+              /* XXX - this will go away in 2.0, when we can get rid of
+               * this stuff and switch to a pure retained render tree of
+               * PaintNodes for the entire frame, starting from the Stage;
+               * the paint() virtual function can then be called directly.
+               */
+              dummy = _clutter_dummy_node_new (self);
+              clutter_paint_node_set_name (dummy, "Root");
+
+              /* XXX - for 1.12, we use the return value of paint_node()
+               * to decide whether we should emit the ::paint signal.
+               */
+              clutter_actor_paint_node (self, dummy);
+              clutter_paint_node_unref (dummy);
+            }
 
-          /* XXX - for 1.12, we use the return value of paint_node() to
-           * decide whether we should emit the ::paint signal.
+          /* the default implementation of paint() only paints the
+           * children, which can keep adding to the current batch of
+           * rectangles; anything else may draw directly
            */
-          clutter_actor_paint_node (self, dummy);
-          clutter_paint_node_unref (dummy);
+          paints_directly = clutter_actor_paints_directly (self);
+          if (paints_directly)
+            _clutter_paint_batch_flush ();
 
           /* XXX:2.0 - Call the paint() virtual directly */
           g_signal_emit (self, actor_signals[PAINT], 0);
+
+          /* the effect will use what we painted once we return */
+          if (paints_directly || priv->current_effect != NULL)
+            _clutter_paint_batch_flush ();
         }
       else
         {
@@ -4058,6 +4878,7 @@ clutter_actor_continue_paint (ClutterActor *self)
                 run_flags |= CLUTTER_EFFECT_PAINT_ACTOR_DIRTY;
             }
 
+          _clutter_paint_batch_flush ();
           _clutter_effect_paint (priv->current_effect, run_flags);
         }
       else
@@ -4125,12 +4946,226 @@ invalidate_queue_redraw_entry (ClutterActor *self,
   return CLUTTER_ACTOR_TRAVERSE_VISIT_CONTINUE;
 }
 
+static inline float
+clutter_actor_get_z_position_fast (ClutterActor *self)
+{
+  return _clutter_actor_get_transform_info_or_defaults (self)->z_position;
+}
+
+/*< private >
+ * clutter_actor_ensure_child_index:
+ * @self: a #ClutterActor
+ *
+ * Builds the index of the children of @self, if the actor has enough
+ * children to make it worthwhile.
+ *
+ * Once built, the index is updated every time a child is added or
+ * removed, so this function is O(n) only the first time it is called.
+ *
+ * Return value: %TRUE if the child index of @self can be used
+ */
+static gboolean
+clutter_actor_ensure_child_index (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *iter;
+  guint i;
+
+  if (priv->child_index != NULL)
+    return TRUE;
+
+  if (priv->n_children < CHILD_INDEX_MIN_CHILDREN)
+    return FALSE;
+
+  priv->child_index = g_ptr_array_sized_new (priv->n_children);
+
+  for (iter = priv->first_child, i = 0;
+       iter != NULL;
+       iter = iter->priv->next_sibling, i += 1)
+    {
+      iter->priv->child_index_pos = i;
+      g_ptr_array_add (priv->child_index, iter);
+    }
+
+  priv->child_index_valid = i;
+
+  CLUTTER_NOTE (ACTOR, "Built the child index of actor '%s' (%u children)",
+                _clutter_actor_get_debug_name (self),
+                priv->child_index->len);
+
+  return TRUE;
+}
+
+static void
+clutter_actor_clear_child_index (ClutterActor *self)
+{
+  g_clear_pointer (&self->priv->child_index, g_ptr_array_unref);
+  self->priv->child_index_valid = 0;
+}
+
+/*< private >
+ * child_index_get_position:
+ * @self: a #ClutterActor with a child index
+ * @child: a child of @self
+ *
+ * Retrieves the position of @child inside the child index of @self.
+ *
+ * Insertions and removals in the middle of the index only invalidate
+ * the positions after the changed slot, which are renumbered lazily
+ * the next time one of them is needed.
+ */
+static guint
+child_index_get_position (ClutterActor *self,
+                          ClutterActor *child)
+{
+  ClutterActorPrivate *priv = self->priv;
+  GPtrArray *index_ = priv->child_index;
+
+  if (child->priv->child_index_pos >= priv->child_index_valid)
+    {
+      guint i;
+
+      for (i = priv->child_index_valid; i < index_->len; i++)
+        {
+          ClutterActor *iter = g_ptr_array_index (index_, i);
+
+          iter->priv->child_index_pos = i;
+        }
+
+      priv->child_index_valid = index_->len;
+    }
+
+  g_assert (g_ptr_array_index (index_, child->priv->child_index_pos) == child);
+
+  return child->priv->child_index_pos;
+}
+
+/*< private >
+ * child_index_insert:
+ * @self: a #ClutterActor
+ * @child: a child of @self, already linked to its siblings
+ *
+ * Updates the child index and the depth ordering state of @self
+ * after @child has been inserted in the list of children.
+ */
+static void
+child_index_insert (ClutterActor *self,
+                    ClutterActor *child)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *prev_sibling = child->priv->prev_sibling;
+  ClutterActor *next_sibling = child->priv->next_sibling;
+
+  if (priv->children_depth_sorted)
+    {
+      float child_depth = clutter_actor_get_z_position_fast (child);
+
+      if ((prev_sibling != NULL &&
+           clutter_actor_get_z_position_fast (prev_sibling) > child_depth) ||
+          (next_sibling != NULL &&
+           clutter_actor_get_z_position_fast (next_sibling) < child_depth))
+        priv->children_depth_sorted = FALSE;
+    }
+
+  if (priv->child_index == NULL)
+    return;
+
+  if (next_sibling == NULL)
+    {
+      /* appending is the common case, and it does not invalidate
+       * any of the stored positions
+       */
+      child->priv->child_index_pos = priv->child_index->len;
+      if (priv->child_index_valid == priv->child_index->len)
+        priv->child_index_valid += 1;
+
+      g_ptr_array_add (priv->child_index, child);
+    }
+  else
+    {
+      guint pos;
+
+      if (prev_sibling == NULL)
+        pos = 0;
+      else
+        pos = child_index_get_position (self, prev_sibling) + 1;
+
+      g_ptr_array_insert (priv->child_index, pos, child);
+
+      child->priv->child_index_pos = pos;
+      priv->child_index_valid = MIN (priv->child_index_valid, pos);
+    }
+}
+
+/*< private >
+ * child_index_remove:
+ * @self: a #ClutterActor
+ * @child: a child of @self, still linked to its siblings
+ *
+ * Removes @child from the child index of @self.
+ */
+static void
+child_index_remove (ClutterActor *self,
+                    ClutterActor *child)
+{
+  ClutterActorPrivate *priv = self->priv;
+  guint pos;
+
+  /* removing a child cannot break the depth ordering, but removing
+   * the last one resets it
+   */
+  if (priv->first_child == priv->last_child)
+    priv->children_depth_sorted = TRUE;
+
+  if (priv->child_index == NULL)
+    return;
+
+  if (child == priv->last_child)
+    pos = priv->child_index->len - 1;
+  else
+    pos = child_index_get_position (self, child);
+
+  g_ptr_array_remove_index (priv->child_index, pos);
+
+  priv->child_index_valid = MIN (priv->child_index_valid, pos);
+}
+
+/*< private >
+ * child_index_depth_changed:
+ * @self: a #ClutterActor
+ *
+ * Checks whether the depth ordering of the parent of @self still
+ * holds after the depth of @self changed.
+ */
+static void
+child_index_depth_changed (ClutterActor *self)
+{
+  ClutterActor *parent = self->priv->parent;
+  ClutterActor *prev_sibling, *next_sibling;
+  float depth;
+
+  if (parent == NULL || !parent->priv->children_depth_sorted)
+    return;
+
+  depth = clutter_actor_get_z_position_fast (self);
+  prev_sibling = self->priv->prev_sibling;
+  next_sibling = self->priv->next_sibling;
+
+  if ((prev_sibling != NULL &&
+       clutter_actor_get_z_position_fast (prev_sibling) > depth) ||
+      (next_sibling != NULL &&
+       clutter_actor_get_z_position_fast (next_sibling) < depth))
+    parent->priv->children_depth_sorted = FALSE;
+}
+
 static inline void
 remove_child (ClutterActor *self,
               ClutterActor *child)
 {
   ClutterActor *prev_sibling, *next_sibling;
 
+  child_index_remove (self, child);
+
   prev_sibling = child->priv->prev_sibling;
   next_sibling = child->priv->next_sibling;
 
@@ -4404,7 +5439,7 @@ clutter_actor_set_pivot_point_internal (ClutterActor       *self,
   info = _clutter_actor_get_transform_info (self);
   info->pivot = *pivot;
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_PIVOT_POINT]);
 
@@ -4420,7 +5455,7 @@ clutter_actor_set_pivot_point_z_internal (ClutterActor *self,
   info = _clutter_actor_get_transform_info (self);
   info->pivot_z = pivot_z;
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_PIVOT_POINT_Z]);
 
@@ -4454,7 +5489,7 @@ clutter_actor_set_translation_internal (ClutterActor *self,
   else
     g_assert_not_reached ();
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
   clutter_actor_queue_redraw (self);
   g_object_notify_by_pspec (obj, pspec);
 }
@@ -4586,7 +5621,7 @@ clutter_actor_set_rotation_angle_internal (ClutterActor *self,
   else
     g_assert_not_reached ();
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
@@ -4742,7 +5777,7 @@ clutter_actor_set_rotation_center_internal (ClutterActor        *self,
       break;
     }
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   g_object_thaw_notify (obj);
 
@@ -4768,7 +5803,7 @@ clutter_actor_set_scale_factor_internal (ClutterActor *self,
   else
     g_assert_not_reached ();
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
   clutter_actor_queue_redraw (self);
   g_object_notify_by_pspec (obj, pspec);
 }
@@ -4849,7 +5884,7 @@ clutter_actor_set_scale_center (ClutterActor      *self,
       g_assert_not_reached ();
     }
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
@@ -4871,7 +5906,7 @@ clutter_actor_set_scale_gravity (ClutterActor   *self,
   else
     clutter_anchor_coord_set_gravity (&info->scale_center, gravity);
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_CENTER_X]);
   g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_CENTER_Y]);
@@ -4924,7 +5959,7 @@ clutter_actor_set_anchor_coord (ClutterActor      *self,
       g_assert_not_reached ();
     }
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
@@ -5929,6 +6964,8 @@ clutter_actor_dispose (GObject *object)
   g_clear_object (&priv->effects);
   g_clear_object (&priv->flatten_effect);
 
+  g_clear_pointer (&priv->retained_paint_node, clutter_paint_node_unref);
+
   if (priv->child_model != NULL)
     {
       if (priv->create_child_notify != NULL)
@@ -5973,6 +7010,15 @@ clutter_actor_finalize (GObject *object)
 
   g_free (priv->name);
 
+  if (priv->child_index != NULL)
+    g_ptr_array_unref (priv->child_index);
+
+  if (priv->width_requests.requests != NULL)
+    g_hash_table_unref (priv->width_requests.requests);
+
+  if (priv->height_requests.requests != NULL)
+    g_hash_table_unref (priv->height_requests.requests);
+
 #ifdef CLUTTER_ENABLE_DEBUG
   g_free (priv->debug_name);
 #endif
@@ -6223,6 +7269,8 @@ clutter_actor_real_destroy (ClutterActor *actor)
 
   g_object_freeze_notify (G_OBJECT (actor));
 
+  clutter_actor_clear_child_index (actor);
+
   clutter_actor_iter_init (&iter, actor);
   while (clutter_actor_iter_next (&iter, NULL))
     clutter_actor_iter_destroy (&iter);
@@ -6265,6 +7313,7 @@ clutter_actor_class_init (ClutterActorClass *klass)
   quark_actor_layout_info = g_quark_from_static_string ("-clutter-actor-layout-info");
   quark_actor_transform_info = g_quark_from_static_string ("-clutter-actor-transform-info");
   quark_actor_animation_info = g_quark_from_static_string ("-clutter-actor-animation-info");
+  quark_actor_geometric_pick = g_quark_from_static_string ("-clutter-actor-geometric-pick");
 
   object_class->constructor = clutter_actor_constructor;
   object_class->set_property = clutter_actor_set_property;
@@ -6280,6 +7329,7 @@ clutter_actor_class_init (ClutterActorClass *klass)
   klass->unmap = clutter_actor_real_unmap;
   klass->unrealize = clutter_actor_real_unrealize;
   klass->pick = clutter_actor_real_pick;
+  klass->hit_test = clutter_actor_real_hit_test;
   klass->get_preferred_width = clutter_actor_real_get_preferred_width;
   klass->get_preferred_height = clutter_actor_real_get_preferred_height;
   klass->allocate = clutter_actor_real_allocate;
@@ -8007,6 +9057,12 @@ clutter_actor_class_init (ClutterActorClass *klass)
    * properly in the procense of #ClutterClone actors. Applications will
    * not normally need to connect to this signal.
    *
+   * Since Clutter 1.26, the propagation stops at an actor with a fixed
+   * size and a valid allocation, if the relayout was queued by one of
+   * its children, and the size and expand flags of that actor cannot
+   * change; in that case the signal is not emitted on its ancestors,
+   * which are not going to be laid out again.
+   *
    * Since: 1.2
    */
   actor_signals[QUEUE_RELAYOUT] =
@@ -8488,6 +9544,7 @@ clutter_actor_init (ClutterActor *self)
   self->priv = priv = clutter_actor_get_instance_private (self);
 
   priv->pick_id = -1;
+  priv->spatial_index_id = -1;
 
   priv->opacity = 0xff;
   priv->show_on_set_parent = TRUE;
@@ -8496,12 +9553,11 @@ clutter_actor_init (ClutterActor *self)
   priv->needs_height_request = TRUE;
   priv->needs_allocation = TRUE;
 
-  priv->cached_width_age = 1;
-  priv->cached_height_age = 1;
-
   priv->opacity_override = -1;
   priv->enable_model_view_transform = TRUE;
 
+  priv->children_depth_sorted = TRUE;
+
   /* Initialize an empty paint volume to start with */
   _clutter_paint_volume_init_static (&priv->last_paint_volume, NULL);
   priv->last_paint_volume_valid = TRUE;
@@ -8772,6 +9828,17 @@ _clutter_actor_queue_redraw_full (ClutterActor       *self,
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
 
+  /* the ::queue-redraw signal is deferred until the next stage update,
+   * but we cannot trust the paint box in the spatial index from now on
+   */
+  priv->spatial_index_valid = FALSE;
+
+  /* redraws queued by an effect do not change the contents of the
+   * actor, so the retained paint nodes can still be used
+   */
+  if (effect == NULL && priv->retained_paint_node != NULL)
+    clutter_actor_clear_retained_paint_node (self);
+
   /* we can ignore unmapped actors, unless they have at least one
    * mapped clone or they are inside a cloned branch of the scene
    * graph, as unmapped actors will simply be left unpainted.
@@ -9351,49 +10418,175 @@ clutter_actor_adjust_height (ClutterActor *self,
                      adjusted_y1,
                      adjusted_y2);
 
-  /* we don't use effective_align() here, because text direction
-   * only affects the horizontal axis
-   */
-  adjust_for_alignment (info->y_align,
-                        *natural_height,
-                        adjusted_y1,
-                        adjusted_y2);
+  /* we don't use effective_align() here, because text direction
+   * only affects the horizontal axis
+   */
+  adjust_for_alignment (info->y_align,
+                        *natural_height,
+                        adjusted_y1,
+                        adjusted_y2);
+
+}
+
+static inline gpointer
+size_request_key (gfloat for_size)
+{
+  union { gfloat f; guint32 i; } key;
+
+  /* every negative size means that no size is defined, and 0 and
+   * -0 compare equal even though their bits are different
+   */
+  if (for_size < 0)
+    key.f = -1.f;
+  else if (for_size == 0)
+    key.f = 0.f;
+  else
+    key.f = for_size;
+
+  return GUINT_TO_POINTER (key.i);
+}
+
+/* looks for a cached size request for this for_size */
+static gboolean
+_clutter_actor_get_cached_size_request (gfloat             for_size,
+                                        SizeRequestCache  *cache,
+                                        SizeRequest      **result)
+{
+  gpointer key = size_request_key (for_size);
+  SizeRequest *sr = NULL;
+
+  if (cache->requests == NULL)
+    {
+      if (cache->first.age > 0 &&
+          size_request_key (cache->first.for_size) == key)
+        sr = &cache->first;
+    }
+  else
+    {
+      sr = g_hash_table_lookup (cache->requests, key);
+
+      /* the entries of the table are evicted by least recent use */
+      if (sr != NULL)
+        {
+          cache->age += 1;
+          sr->age = cache->age;
+        }
+    }
+
+  if (sr == NULL)
+    {
+      CLUTTER_NOTE (LAYOUT, "Size cache miss for size: %.2f", for_size);
+      size_request_n_misses += 1;
+      return FALSE;
+    }
+
+  CLUTTER_NOTE (LAYOUT, "Size cache hit for size: %.2f", for_size);
+  size_request_n_hits += 1;
+  *result = sr;
 
+  return TRUE;
 }
 
-/* looks for a cached size request for this for_size. If not
- * found, returns the oldest entry so it can be overwritten */
-static gboolean
-_clutter_actor_get_cached_size_request (gfloat         for_size,
-                                        SizeRequest   *cached_size_requests,
-                                        SizeRequest  **result)
+/* stores a size request for this for_size, evicting the oldest
+ * entry if the cache is full, and returns the cached entry */
+static SizeRequest *
+_clutter_actor_store_cached_size_request (gfloat            for_size,
+                                          gfloat            min_size,
+                                          gfloat            natural_size,
+                                          SizeRequestCache *cache)
 {
-  guint i;
+  SizeRequest *sr;
+
+  if (cache->requests == NULL)
+    {
+      if (cache->first.age == 0)
+        {
+          sr = &cache->first;
+          goto out;
+        }
+
+      /* a second for_size: move the first entry to the table */
+      cache->requests = g_hash_table_new_full (NULL, NULL, NULL, g_free);
 
-  *result = &cached_size_requests[0];
+      sr = g_memdup (&cache->first, sizeof (SizeRequest));
+      g_hash_table_insert (cache->requests,
+                           size_request_key (sr->for_size),
+                           sr);
 
-  for (i = 0; i < N_CACHED_SIZE_REQUESTS; i++)
+      cache->first.age = 0;
+    }
+
+  if (g_hash_table_size (cache->requests) >= _clutter_get_size_request_cache_size ())
     {
-      SizeRequest *sr;
+      GHashTableIter iter;
+      gpointer oldest_key = NULL, key, value;
 
-      sr = &cached_size_requests[i];
+      sr = NULL;
 
-      if (sr->age > 0 &&
-          sr->for_size == for_size)
-        {
-          CLUTTER_NOTE (LAYOUT, "Size cache hit for size: %.2f", for_size);
-          *result = sr;
-          return TRUE;
-        }
-      else if (sr->age < (*result)->age)
+      g_hash_table_iter_init (&iter, cache->requests);
+      while (g_hash_table_iter_next (&iter, &key, &value))
         {
-          *result = sr;
+          SizeRequest *request = value;
+
+          if (sr == NULL || request->age < sr->age)
+            {
+              oldest_key = key;
+              sr = request;
+            }
         }
+
+      g_hash_table_steal (cache->requests, oldest_key);
+      size_request_n_evictions += 1;
     }
+  else
+    sr = g_new (SizeRequest, 1);
 
-  CLUTTER_NOTE (LAYOUT, "Size cache miss for size: %.2f", for_size);
+  g_hash_table_insert (cache->requests, size_request_key (for_size), sr);
 
-  return FALSE;
+out:
+  cache->age += 1;
+
+  sr->age = cache->age;
+  sr->for_size = for_size;
+  sr->min_size = min_size;
+  sr->natural_size = natural_size;
+
+  return sr;
+}
+
+/*< private >
+ * _clutter_actor_get_size_request_stats:
+ * @n_hits: (out) (optional): return location for the number of size
+ *   requests satisfied by the cache
+ * @n_misses: (out) (optional): return location for the number of size
+ *   requests that had to be computed
+ * @n_evictions: (out) (optional): return location for the number of
+ *   cached size requests that were dropped because the cache was full
+ *
+ * Retrieves the statistics of the size request caches of all the
+ * actors since the last call to _clutter_actor_reset_size_request_stats().
+ */
+void
+_clutter_actor_get_size_request_stats (guint *n_hits,
+                                       guint *n_misses,
+                                       guint *n_evictions)
+{
+  if (n_hits != NULL)
+    *n_hits = size_request_n_hits;
+
+  if (n_misses != NULL)
+    *n_misses = size_request_n_misses;
+
+  if (n_evictions != NULL)
+    *n_evictions = size_request_n_evictions;
+}
+
+void
+_clutter_actor_reset_size_request_stats (void)
+{
+  size_request_n_hits = 0;
+  size_request_n_misses = 0;
+  size_request_n_evictions = 0;
 }
 
 static void
@@ -9466,6 +10659,7 @@ clutter_actor_get_preferred_width (ClutterActor *self,
 {
   float request_min_width, request_natural_width;
   SizeRequest *cached_size_request;
+  gfloat request_for_size;
   const ClutterLayoutInfo *info;
   ClutterActorPrivate *priv;
   gboolean found_in_cache;
@@ -9498,19 +10692,16 @@ clutter_actor_get_preferred_width (ClutterActor *self,
    * the *_set flags.
    */
 
-  if (!priv->needs_width_request)
-    {
-      found_in_cache =
-        _clutter_actor_get_cached_size_request (for_height,
-                                                priv->width_requests,
-                                                &cached_size_request);
-    }
-  else
-    {
-      /* if the actor needs a width request we use the first slot */
-      found_in_cache = FALSE;
-      cached_size_request = &priv->width_requests[0];
-    }
+  /* if the actor needs a width request we drop the stale entries */
+  if (priv->needs_width_request)
+    size_request_cache_clear (&priv->width_requests);
+
+  request_for_size = for_height;
+
+  found_in_cache =
+    _clutter_actor_get_cached_size_request (request_for_size,
+                                            &priv->width_requests,
+                                            &cached_size_request);
 
   if (!found_in_cache)
     {
@@ -9551,12 +10742,11 @@ clutter_actor_get_preferred_width (ClutterActor *self,
       if (natural_width < minimum_width)
 	natural_width = minimum_width;
 
-      cached_size_request->min_size = minimum_width;
-      cached_size_request->natural_size = natural_width;
-      cached_size_request->for_size = for_height;
-      cached_size_request->age = priv->cached_width_age;
-
-      priv->cached_width_age += 1;
+      cached_size_request =
+        _clutter_actor_store_cached_size_request (request_for_size,
+                                                  minimum_width,
+                                                  natural_width,
+                                                  &priv->width_requests);
       priv->needs_width_request = FALSE;
     }
 
@@ -9610,6 +10800,7 @@ clutter_actor_get_preferred_height (ClutterActor *self,
 {
   float request_min_height, request_natural_height;
   SizeRequest *cached_size_request;
+  gfloat request_for_size;
   const ClutterLayoutInfo *info;
   ClutterActorPrivate *priv;
   gboolean found_in_cache;
@@ -9642,18 +10833,16 @@ clutter_actor_get_preferred_height (ClutterActor *self,
    * the *_set flags.
    */
 
-  if (!priv->needs_height_request)
-    {
-      found_in_cache =
-        _clutter_actor_get_cached_size_request (for_width,
-                                                priv->height_requests,
-                                                &cached_size_request);
-    }
-  else
-    {
-      found_in_cache = FALSE;
-      cached_size_request = &priv->height_requests[0];
-    }
+  /* if the actor needs a height request we drop the stale entries */
+  if (priv->needs_height_request)
+    size_request_cache_clear (&priv->height_requests);
+
+  request_for_size = for_width;
+
+  found_in_cache =
+    _clutter_actor_get_cached_size_request (request_for_size,
+                                            &priv->height_requests,
+                                            &cached_size_request);
 
   if (!found_in_cache)
     {
@@ -9694,12 +10883,11 @@ clutter_actor_get_preferred_height (ClutterActor *self,
       if (natural_height < minimum_height)
 	natural_height = minimum_height;
 
-      cached_size_request->min_size = minimum_height;
-      cached_size_request->natural_size = natural_height;
-      cached_size_request->for_size = for_width;
-      cached_size_request->age = priv->cached_height_age;
-
-      priv->cached_height_age += 1;
+      cached_size_request =
+        _clutter_actor_store_cached_size_request (request_for_size,
+                                                  minimum_height,
+                                                  natural_height,
+                                                  &priv->height_requests);
       priv->needs_height_request = FALSE;
     }
 
@@ -9955,6 +11143,30 @@ clutter_actor_allocate_internal (ClutterActor           *self,
    */
 }
 
+/*< private >
+ * _clutter_actor_relayout_root:
+ * @self: a #ClutterActor queued as a relayout root
+ *
+ * Allocates the children of @self using the current allocation of
+ * @self, without going through its parent.
+ */
+void
+_clutter_actor_relayout_root (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActorBox allocation;
+
+  /* the actor was allocated in the meantime */
+  if (!priv->needs_allocation)
+    return;
+
+  allocation = priv->allocation;
+
+  clutter_actor_allocate_internal (self, &allocation,
+                                   priv->allocation_flags &
+                                   ~CLUTTER_ABSOLUTE_ORIGIN_CHANGED);
+}
+
 /**
  * clutter_actor_allocate:
  * @self: A #ClutterActor
@@ -11925,7 +13137,9 @@ clutter_actor_set_depth_internal (ClutterActor *self,
       /* Sets Z value - XXX 2.0: should we invert? */
       info->z_position = depth;
 
-      self->priv->transform_valid = FALSE;
+      child_index_depth_changed (self);
+
+      _clutter_actor_invalidate_transform (self);
 
       /* FIXME - remove this crap; sadly, there are still containers
        * in Clutter that depend on this utter brain damage
@@ -11950,7 +13164,9 @@ clutter_actor_set_z_position_internal (ClutterActor *self,
     {
       info->z_position = z_position;
 
-      self->priv->transform_valid = FALSE;
+      child_index_depth_changed (self);
+
+      _clutter_actor_invalidate_transform (self);
 
       clutter_actor_queue_redraw (self);
 
@@ -12542,17 +13758,48 @@ insert_child_at_depth (ClutterActor *self,
   /* Find the right place to insert the child so that it will still be
      sorted and the child will be after all of the actors at the same
      dept */
-  for (iter = self->priv->first_child;
-       iter != NULL;
-       iter = iter->priv->next_sibling)
+  if (self->priv->children_depth_sorted &&
+      clutter_actor_get_z_position_fast (self->priv->last_child) <= child_depth)
+    {
+      /* no child is deeper; this is what happens when adding children
+       * that all have the same depth
+       */
+      iter = NULL;
+    }
+  else if (self->priv->children_depth_sorted &&
+           clutter_actor_ensure_child_index (self))
     {
-      float iter_depth;
+      GPtrArray *index_ = self->priv->child_index;
+      guint lo = 0, hi = index_->len;
 
-      iter_depth =
-        _clutter_actor_get_transform_info_or_defaults (iter)->z_position;
+      /* the first child that is deeper than the new one */
+      while (lo < hi)
+        {
+          guint mid = lo + (hi - lo) / 2;
 
-      if (iter_depth > child_depth)
-        break;
+          iter = g_ptr_array_index (index_, mid);
+          if (clutter_actor_get_z_position_fast (iter) > child_depth)
+            hi = mid;
+          else
+            lo = mid + 1;
+        }
+
+      iter = lo < index_->len ? g_ptr_array_index (index_, lo) : NULL;
+    }
+  else
+    {
+      for (iter = self->priv->first_child;
+           iter != NULL;
+           iter = iter->priv->next_sibling)
+        {
+          float iter_depth;
+
+          iter_depth =
+            _clutter_actor_get_transform_info_or_defaults (iter)->z_position;
+
+          if (iter_depth > child_depth)
+            break;
+        }
     }
 
   if (iter != NULL)
@@ -12615,6 +13862,19 @@ insert_child_at_index (ClutterActor *self,
       child->priv->prev_sibling = tmp;
       child->priv->next_sibling = NULL;
     }
+  else if (clutter_actor_ensure_child_index (self))
+    {
+      ClutterActor *iter = g_ptr_array_index (self->priv->child_index, index_);
+      ClutterActor *tmp = iter->priv->prev_sibling;
+
+      child->priv->prev_sibling = tmp;
+      child->priv->next_sibling = iter;
+
+      iter->priv->prev_sibling = child;
+
+      if (tmp != NULL)
+        tmp->priv->next_sibling = child;
+    }
   else
     {
       ClutterActor *iter;
@@ -12868,6 +14128,8 @@ clutter_actor_add_child_internal (ClutterActor              *self,
 
   g_assert (child->priv->parent == self);
 
+  child_index_insert (self, child);
+
   self->priv->n_children += 1;
 
   self->priv->age += 1;
@@ -13249,6 +14511,11 @@ clutter_actor_remove_all_children (ClutterActor *self)
 
   g_object_freeze_notify (G_OBJECT (self));
 
+  /* removing the children from the front would shift the whole
+   * child index every time
+   */
+  clutter_actor_clear_child_index (self);
+
   clutter_actor_iter_init (&iter, self);
   while (clutter_actor_iter_next (&iter, NULL))
     clutter_actor_iter_remove (&iter);
@@ -13300,6 +14567,8 @@ clutter_actor_destroy_all_children (ClutterActor *self)
 
   g_object_freeze_notify (G_OBJECT (self));
 
+  clutter_actor_clear_child_index (self);
+
   clutter_actor_iter_init (&iter, self);
   while (clutter_actor_iter_next (&iter, NULL))
     clutter_actor_iter_destroy (&iter);
@@ -13926,6 +15195,15 @@ clutter_actor_set_reactive (ClutterActor *actor,
   else
     CLUTTER_ACTOR_UNSET_FLAGS (actor, CLUTTER_ACTOR_REACTIVE);
 
+  /* reactive picks depend on this flag */
+  if (CLUTTER_ACTOR_IS_MAPPED (actor))
+    {
+      ClutterActor *stage = _clutter_actor_get_stage_internal (actor);
+
+      if (stage != NULL)
+        _clutter_stage_invalidate_pick (CLUTTER_STAGE (stage));
+    }
+
   g_object_notify_by_pspec (G_OBJECT (actor), obj_props[PROP_REACTIVE]);
 }
 
@@ -14033,7 +15311,7 @@ clutter_actor_set_anchor_point (ClutterActor *self,
 
   if (changed)
     {
-      priv->transform_valid = FALSE;
+      _clutter_actor_invalidate_transform (self);
       clutter_actor_queue_redraw (self);
     }
 
@@ -14203,7 +15481,7 @@ clutter_actor_set_anchor_point_from_gravity (ClutterActor   *self,
       g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_X]);
       g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_Y]);
 
-      self->priv->transform_valid = FALSE;
+      _clutter_actor_invalidate_transform (self);
 
       clutter_actor_queue_redraw (self);
 
@@ -15071,6 +16349,235 @@ clutter_actor_set_final_state (ClutterAnimatable *animatable,
   g_free (p_name);
 }
 
+/* the actors whose notifications are being deferred until the end of
+ * the current advancement of the timelines
+ */
+static gboolean defer_animated_notifies = FALSE;
+static GPtrArray *deferred_notify_actors = NULL;
+
+/*< private >
+ * _clutter_actor_begin_deferred_notifies:
+ *
+ * Starts deferring the property notifications caused by the
+ * _clutter_actor_set_animated_* functions; each actor will emit
+ * the notifications, compressed by #GObject, when
+ * _clutter_actor_end_deferred_notifies() is called.
+ *
+ * The master clock calls this function around the advancement of
+ * the timelines, so that the notifications are emitted at most once
+ * per frame.
+ */
+void
+_clutter_actor_begin_deferred_notifies (void)
+{
+  defer_animated_notifies = TRUE;
+}
+
+/*< private >
+ * _clutter_actor_end_deferred_notifies:
+ *
+ * Emits the property notifications deferred since the call to
+ * _clutter_actor_begin_deferred_notifies().
+ */
+void
+_clutter_actor_end_deferred_notifies (void)
+{
+  GPtrArray *actors;
+  guint i;
+
+  defer_animated_notifies = FALSE;
+
+  if (deferred_notify_actors == NULL || deferred_notify_actors->len == 0)
+    return;
+
+  /* notification handlers might start new transitions */
+  actors = deferred_notify_actors;
+  deferred_notify_actors = NULL;
+
+  for (i = 0; i < actors->len; i++)
+    {
+      ClutterActor *actor = g_ptr_array_index (actors, i);
+
+      actor->priv->notify_deferred = FALSE;
+      g_object_thaw_notify (G_OBJECT (actor));
+      g_object_unref (actor);
+    }
+
+  g_ptr_array_unref (actors);
+}
+
+static inline void
+clutter_actor_begin_animated_update (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (!defer_animated_notifies)
+    {
+      g_object_freeze_notify (G_OBJECT (self));
+      return;
+    }
+
+  if (priv->notify_deferred)
+    return;
+
+  if (deferred_notify_actors == NULL)
+    deferred_notify_actors = g_ptr_array_new ();
+
+  g_ptr_array_add (deferred_notify_actors, g_object_ref (self));
+  g_object_freeze_notify (G_OBJECT (self));
+  priv->notify_deferred = TRUE;
+}
+
+static inline void
+clutter_actor_end_animated_update (ClutterActor *self)
+{
+  if (!defer_animated_notifies)
+    g_object_thaw_notify (G_OBJECT (self));
+}
+
+/*< private >
+ * _clutter_actor_can_set_animated_property:
+ * @self: a #ClutterActor
+ * @pspec: the #GParamSpec of an animatable property
+ *
+ * Checks whether the value of the property described by @pspec can be
+ * set using the _clutter_actor_set_animated_* functions, bypassing the
+ * #ClutterAnimatable interface.
+ *
+ * Return value: %TRUE if the property can be set directly
+ */
+gboolean
+_clutter_actor_can_set_animated_property (ClutterActor *self,
+                                          GParamSpec   *pspec)
+{
+  ClutterAnimatableIface *iface;
+
+  /* sub-classes might override the property, or the interface */
+  if (pspec->owner_type != CLUTTER_TYPE_ACTOR)
+    return FALSE;
+
+  iface = CLUTTER_ANIMATABLE_GET_IFACE (self);
+  if (iface->set_final_state != clutter_actor_set_final_state ||
+      iface->interpolate_value != NULL)
+    return FALSE;
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+    case PROP_Y:
+    case PROP_POSITION:
+    case PROP_OPACITY:
+    case PROP_BACKGROUND_COLOR:
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+void
+_clutter_actor_set_animated_float (ClutterActor *self,
+                                   GParamSpec   *pspec,
+                                   gfloat        value)
+{
+  clutter_actor_begin_animated_update (self);
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+      clutter_actor_set_x_internal (self, value);
+      break;
+
+    case PROP_Y:
+      clutter_actor_set_y_internal (self, value);
+      break;
+
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+      clutter_actor_set_translation_internal (self, value, pspec);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  clutter_actor_end_animated_update (self);
+}
+
+void
+_clutter_actor_set_animated_double (ClutterActor *self,
+                                    GParamSpec   *pspec,
+                                    gdouble       value)
+{
+  clutter_actor_begin_animated_update (self);
+
+  switch (pspec->param_id)
+    {
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+      clutter_actor_set_scale_factor_internal (self, value, pspec);
+      break;
+
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      clutter_actor_set_rotation_angle_internal (self, value, pspec);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  clutter_actor_end_animated_update (self);
+}
+
+void
+_clutter_actor_set_animated_uint (ClutterActor *self,
+                                  GParamSpec   *pspec,
+                                  guint         value)
+{
+  g_assert (pspec->param_id == PROP_OPACITY);
+
+  clutter_actor_begin_animated_update (self);
+  clutter_actor_set_opacity_internal (self, value);
+  clutter_actor_end_animated_update (self);
+}
+
+void
+_clutter_actor_set_animated_color (ClutterActor       *self,
+                                   GParamSpec         *pspec,
+                                   const ClutterColor *value)
+{
+  g_assert (pspec->param_id == PROP_BACKGROUND_COLOR);
+
+  clutter_actor_begin_animated_update (self);
+  clutter_actor_set_background_color_internal (self, value);
+  clutter_actor_end_animated_update (self);
+}
+
+void
+_clutter_actor_set_animated_point (ClutterActor       *self,
+                                   GParamSpec         *pspec,
+                                   const ClutterPoint *value)
+{
+  g_assert (pspec->param_id == PROP_POSITION);
+
+  clutter_actor_begin_animated_update (self);
+  clutter_actor_set_position_internal (self, value);
+  clutter_actor_end_animated_update (self);
+}
+
 static void
 clutter_animatable_iface_init (ClutterAnimatableIface *iface)
 {
@@ -16283,7 +17790,7 @@ clutter_actor_set_transform_internal (ClutterActor        *self,
   info->transform = *transform;
   info->transform_set = !cogl_matrix_is_identity (&info->transform);
 
-  self->priv->transform_valid = FALSE;
+  _clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
@@ -17749,6 +19256,10 @@ clutter_actor_get_child_at_index (ClutterActor *self,
   g_return_val_if_fail (CLUTTER_IS_ACTOR (self), NULL);
   g_return_val_if_fail (index_ <= self->priv->n_children, NULL);
 
+  if (index_ > 0 && index_ < self->priv->n_children &&
+      clutter_actor_ensure_child_index (self))
+    return g_ptr_array_index (self->priv->child_index, index_);
+
   for (iter = self->priv->first_child, i = 0;
        iter != NULL && i < index_;
        iter = iter->priv->next_sibling, i += 1)
@@ -20562,7 +22073,9 @@ clutter_actor_set_child_transform_internal (ClutterActor        *self,
   /* we need to reset the transform_valid flag on each child */
   clutter_actor_iter_init (&iter, self);
   while (clutter_actor_iter_next (&iter, &child))
-    child->priv->transform_valid = FALSE;
+    {
+      _clutter_actor_invalidate_transform (child);
+    }
 
   clutter_actor_queue_redraw (self);
 
@@ -211,6 +211,11 @@ struct _ClutterActor
  * @paint_node: virtual function for creating paint nodes and attaching
  *   them to the render tree
  * @touch_event: signal class closure for #ClutterActor::touch-event
+ * @hit_test: virtual function used when picking without painting; it
+ *   should return %TRUE if the given point, in actor-relative coordinates,
+ *   is covered by the silhouette painted by the @pick virtual function.
+ *   Sub-classes overriding @pick should also override this function if
+ *   they want to be picked geometrically. Since: 1.26
  *
  * Base class for actors.
  */
@@ -296,9 +301,13 @@ struct _ClutterActorClass
   gboolean (* touch_event)          (ClutterActor         *self,
                                      ClutterTouchEvent    *event);
 
+  gboolean (* hit_test)             (ClutterActor         *self,
+                                     gfloat                x,
+                                     gfloat                y);
+
   /*< private >*/
   /* padding for future expansion */
-  gpointer _padding_dummy[26];
+  gpointer _padding_dummy[25];
 };
 
 /**
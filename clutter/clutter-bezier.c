@@ -422,3 +422,16 @@ _clutter_bezier_get_length (const ClutterBezier *b)
 {
   return b->length;
 }
+
+/*
+ * Evaluates the bezier at t, from interval <0,1>, using floating point
+ * instead of the 14.18 fixed point used by _clutter_bezier_advance
+ */
+void
+_clutter_bezier_get_point (const ClutterBezier *b,
+                           gdouble              t,
+                           ClutterPoint        *point)
+{
+  point->x = ((b->ax * t + b->bx) * t + b->cx) * t + b->dx;
+  point->y = ((b->ay * t + b->by) * t + b->cy) * t + b->dy;
+}
@@ -60,6 +60,10 @@ void           _clutter_bezier_adjust (ClutterBezier *b,
 
 guint          _clutter_bezier_get_length (const ClutterBezier *b);
 
+void           _clutter_bezier_get_point (const ClutterBezier *b,
+                                          gdouble              t,
+                                          ClutterPoint        *point);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_BEZIER_H__ */
@@ -30,6 +30,12 @@
  * #ClutterBlurEffect is a sub-class of #ClutterEffect that allows blurring a
  * actor and its contents.
  *
+ * The blur is a Gaussian blur, applied in two separate passes: an
+ * horizontal one, followed by a vertical one, so that the cost of each
+ * painted pixel grows linearly with the #ClutterBlurEffect:radius. For
+ * large radii, the blur can be computed at a lower resolution using the
+ * #ClutterBlurEffect:downsample property.
+ *
  * #ClutterBlurEffect is available since Clutter 1.4
  */
 
@@ -45,34 +51,47 @@
 
 #include "clutter-blur-effect.h"
 
+#include <math.h>
+
 #include "cogl/cogl.h"
 
 #include "clutter-debug.h"
-#include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
-#define BLUR_PADDING    2
+#define DEFAULT_RADIUS          2
+#define MAX_RADIUS              120
+
+/* the maximum radius of the kernel used by each pass, in texels of the
+ * (possibly downsampled) pass; the effect will downsample further if
+ * the radius is larger than this
+ */
+#define MAX_PASS_RADIUS         30
 
-/* FIXME - lame shader; we should really have a decoupled
- * horizontal/vertical two pass shader for the gaussian blur
+/* pairs of adjacent texels are read with a single, linearly filtered
+ * lookup, so we need half the taps, plus the central one
  */
-static const gchar *box_blur_glsl_declarations =
-"uniform vec2 pixel_step;\n";
-#define SAMPLE(offx, offy) \
-  "cogl_texel += texture2D (cogl_sampler, cogl_tex_coord.st + pixel_step * " \
-  "vec2 (" G_STRINGIFY (offx) ", " G_STRINGIFY (offy) "));\n"
-static const gchar *box_blur_glsl_shader =
-"  cogl_texel = texture2D (cogl_sampler, cogl_tex_coord.st);\n"
-  SAMPLE (-1.0, -1.0)
-  SAMPLE ( 0.0, -1.0)
-  SAMPLE (+1.0, -1.0)
-  SAMPLE (-1.0,  0.0)
-  SAMPLE (+1.0,  0.0)
-  SAMPLE (-1.0, +1.0)
-  SAMPLE ( 0.0, +1.0)
-  SAMPLE (+1.0, +1.0)
-"  cogl_texel /= 9.0;\n";
-#undef SAMPLE
+#define MAX_TAPS                (1 + (MAX_PASS_RADIUS + 1) / 2)
+
+/* the horizontal pass reads the offscreen texture at its full
+ * resolution, so its kernel covers the whole radius
+ */
+#define MAX_H_TAPS              (1 + (MAX_RADIUS + 1) / 2)
+
+static const gchar *gaussian_blur_glsl_declarations =
+"uniform vec2 pixel_step;\n"
+"uniform vec2 taps[N_TAPS];\n";
+
+static const gchar *gaussian_blur_glsl_shader =
+"  cogl_texel = texture2D (cogl_sampler, cogl_tex_coord.st) * taps[0].y;\n"
+"  for (int i = 1; i < N_TAPS; i++)\n"
+"    {\n"
+"      vec2 offset = pixel_step * taps[i].x;\n"
+"      cogl_texel += texture2D (cogl_sampler, cogl_tex_coord.st + offset)\n"
+"                  * taps[i].y;\n"
+"      cogl_texel += texture2D (cogl_sampler, cogl_tex_coord.st - offset)\n"
+"                  * taps[i].y;\n"
+"    }\n";
 
 struct _ClutterBlurEffect
 {
@@ -81,25 +100,279 @@ struct _ClutterBlurEffect
   /* a back pointer to our actor, so that we can query it */
   ClutterActor *actor;
 
-  gint pixel_step_uniform;
+  guint radius;
+  gdouble sigma;
+  guint downsample;
 
   gint tex_width;
   gint tex_height;
 
-  CoglPipeline *pipeline;
+  /* the kernels of the two passes, as (offset, weight) pairs in
+   * texels of the texture read by each pass
+   */
+  gint h_n_taps;
+  gfloat h_taps[MAX_H_TAPS * 2];
+  gint v_n_taps;
+  gfloat v_taps[MAX_TAPS * 2];
+  gint pass_downsample;
+
+  /* the horizontal pass, from the offscreen texture to the
+   * pass texture, and the vertical pass, from the pass texture
+   * to the stage
+   */
+  CoglPipeline *h_pipeline;
+  CoglPipeline *v_pipeline;
+  gint h_pixel_step_uniform;
+  gint v_pixel_step_uniform;
+
+  /* leased from the pool of the offscreen effects; only the top
+   * left pass_width by pass_height texels are used
+   */
+  ClutterOffscreenTarget *pass_target;
+  gint pass_width;
+  gint pass_height;
+
+  guint kernel_dirty : 1;
+  guint pass_dirty   : 1;
 };
 
 struct _ClutterBlurEffectClass
 {
   ClutterOffscreenEffectClass parent_class;
 
-  CoglPipeline *base_pipeline;
+  /* one pipeline for each number of taps */
+  CoglPipeline *base_pipelines[MAX_H_TAPS + 1];
+};
+
+enum
+{
+  PROP_0,
+
+  PROP_RADIUS,
+  PROP_SIGMA,
+  PROP_DOWNSAMPLE,
+
+  PROP_LAST
 };
 
+static GParamSpec *obj_props[PROP_LAST];
+
 G_DEFINE_TYPE (ClutterBlurEffect,
                clutter_blur_effect,
                CLUTTER_TYPE_OFFSCREEN_EFFECT);
 
+static CoglPipeline *
+clutter_blur_effect_create_pipeline (ClutterBlurEffect *self,
+                                     gint               n_taps)
+{
+  ClutterBlurEffectClass *klass = CLUTTER_BLUR_EFFECT_GET_CLASS (self);
+
+  if (G_UNLIKELY (klass->base_pipelines[n_taps] == NULL))
+    {
+      CoglContext *ctx =
+        clutter_backend_get_cogl_context (clutter_get_default_backend ());
+      CoglPipeline *pipeline;
+      CoglSnippet *snippet;
+      gchar *declarations;
+
+      pipeline = cogl_pipeline_new (ctx);
+
+      declarations = g_strdup_printf ("#define N_TAPS %d\n%s",
+                                      n_taps,
+                                      gaussian_blur_glsl_declarations);
+
+      snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_TEXTURE_LOOKUP,
+                                  declarations,
+                                  NULL);
+      cogl_snippet_set_replace (snippet, gaussian_blur_glsl_shader);
+      cogl_pipeline_add_layer_snippet (pipeline, 0, snippet);
+      cogl_object_unref (snippet);
+
+      g_free (declarations);
+
+      cogl_pipeline_set_layer_null_texture (pipeline,
+                                            0, /* layer number */
+                                            COGL_TEXTURE_TYPE_2D);
+
+      /* the taps between two texels rely on linear filtering */
+      cogl_pipeline_set_layer_filters (pipeline, 0,
+                                       COGL_PIPELINE_FILTER_LINEAR,
+                                       COGL_PIPELINE_FILTER_LINEAR);
+      cogl_pipeline_set_layer_wrap_mode (pipeline, 0,
+                                         COGL_PIPELINE_WRAP_MODE_CLAMP_TO_EDGE);
+
+      klass->base_pipelines[n_taps] = pipeline;
+    }
+
+  return cogl_pipeline_copy (klass->base_pipelines[n_taps]);
+}
+
+/* computes the taps of a Gaussian kernel truncated at @radius texels,
+ * and returns their number
+ */
+static gint
+clutter_blur_effect_compute_taps (gint     radius,
+                                  gdouble  sigma,
+                                  gfloat  *taps)
+{
+  gfloat weights[MAX_RADIUS + 2];
+  gdouble sum;
+  gint i, n_taps;
+
+  sum = 0.0;
+  for (i = 0; i <= radius; i++)
+    {
+      weights[i] = exp (-(i * i) / (2.0 * sigma * sigma));
+      sum += i == 0 ? weights[i] : 2.0 * weights[i];
+    }
+
+  for (i = 0; i <= radius; i++)
+    weights[i] /= sum;
+
+  weights[radius + 1] = 0.f;
+
+  /* merge each pair of adjacent taps into a single lookup, placed
+   * between the two texels so that the linear filtering gives each
+   * of them its own weight
+   */
+  taps[0] = 0.f;
+  taps[1] = weights[0];
+  n_taps = 1;
+
+  for (i = 1; i <= radius; i += 2)
+    {
+      gfloat weight = weights[i] + weights[i + 1];
+
+      taps[n_taps * 2 + 0] = (i * weights[i] + (i + 1) * weights[i + 1]) / weight;
+      taps[n_taps * 2 + 1] = weight;
+
+      n_taps += 1;
+    }
+
+  return n_taps;
+}
+
+static void
+clutter_blur_effect_update_pipeline (ClutterBlurEffect  *self,
+                                     CoglPipeline      **pipeline,
+                                     gint               *pixel_step_uniform,
+                                     gint               *n_taps,
+                                     gint                new_n_taps,
+                                     const gfloat       *taps)
+{
+  if (*n_taps != new_n_taps)
+    {
+      if (*pipeline != NULL)
+        cogl_object_unref (*pipeline);
+
+      *pipeline = clutter_blur_effect_create_pipeline (self, new_n_taps);
+      *pixel_step_uniform =
+        cogl_pipeline_get_uniform_location (*pipeline, "pixel_step");
+      *n_taps = new_n_taps;
+    }
+
+  cogl_pipeline_set_uniform_float (*pipeline,
+                                   cogl_pipeline_get_uniform_location (*pipeline, "taps"),
+                                   2, /* n_components */
+                                   new_n_taps, /* count */
+                                   taps);
+}
+
+static void
+clutter_blur_effect_update_kernel (ClutterBlurEffect *self)
+{
+  gdouble sigma;
+  gint downsample, radius;
+  gint h_n_taps, v_n_taps;
+
+  /* downsample further if the kernel would not fit in a single pass */
+  downsample = self->downsample;
+  while ((self->radius + downsample - 1) / downsample > MAX_PASS_RADIUS)
+    downsample *= 2;
+
+  radius = (self->radius + downsample - 1) / downsample;
+
+  sigma = self->sigma > 0.0 ? self->sigma : self->radius / 2.0;
+
+  /* the horizontal pass reads the offscreen texture, in which the
+   * texels merged by each tap are adjacent only at full resolution;
+   * the vertical pass reads the downsampled pass texture
+   */
+  h_n_taps = clutter_blur_effect_compute_taps (radius * downsample,
+                                               MAX (sigma, 0.1),
+                                               self->h_taps);
+  v_n_taps = clutter_blur_effect_compute_taps (radius,
+                                               MAX (sigma / downsample, 0.1),
+                                               self->v_taps);
+
+  self->pass_downsample = downsample;
+
+  clutter_blur_effect_update_pipeline (self,
+                                       &self->h_pipeline,
+                                       &self->h_pixel_step_uniform,
+                                       &self->h_n_taps,
+                                       h_n_taps,
+                                       self->h_taps);
+  clutter_blur_effect_update_pipeline (self,
+                                       &self->v_pipeline,
+                                       &self->v_pixel_step_uniform,
+                                       &self->v_n_taps,
+                                       v_n_taps,
+                                       self->v_taps);
+
+  CLUTTER_NOTE (SHADER, "Blur kernel for radius %u: %d + %d taps, 1/%d resolution",
+                self->radius,
+                h_n_taps,
+                v_n_taps,
+                downsample);
+
+  self->kernel_dirty = FALSE;
+}
+
+static void
+clutter_blur_effect_clear_pass (ClutterBlurEffect *self)
+{
+  if (self->pass_target != NULL)
+    {
+      /* the texture can be given to another effect */
+      if (self->v_pipeline != NULL)
+        cogl_pipeline_set_layer_texture (self->v_pipeline, 0, NULL);
+
+      _clutter_offscreen_target_release (self->pass_target);
+      self->pass_target = NULL;
+    }
+
+  self->pass_width = 0;
+  self->pass_height = 0;
+}
+
+static gboolean
+clutter_blur_effect_ensure_pass (ClutterBlurEffect *self)
+{
+  gint downsample = self->pass_downsample;
+  gint width, height;
+
+  width = MAX ((self->tex_width + downsample - 1) / downsample, 1);
+  height = MAX ((self->tex_height + downsample - 1) / downsample, 1);
+
+  if (self->pass_target != NULL &&
+      self->pass_width == width &&
+      self->pass_height == height)
+    return TRUE;
+
+  clutter_blur_effect_clear_pass (self);
+
+  self->pass_target = _clutter_offscreen_target_lease (width, height);
+  if (self->pass_target == NULL)
+    return FALSE;
+
+  self->pass_width = width;
+  self->pass_height = height;
+  self->pass_dirty = TRUE;
+
+  return TRUE;
+}
+
 static gboolean
 clutter_blur_effect_pre_paint (ClutterEffect *effect)
 {
@@ -132,25 +405,12 @@ clutter_blur_effect_pre_paint (ClutterEffect *effect)
         CLUTTER_OFFSCREEN_EFFECT (effect);
       CoglHandle texture;
 
-      texture = clutter_offscreen_effect_get_texture (offscreen_effect);
+      texture = _clutter_offscreen_effect_get_texture (offscreen_effect);
       self->tex_width = cogl_texture_get_width (texture);
       self->tex_height = cogl_texture_get_height (texture);
 
-      if (self->pixel_step_uniform > -1)
-        {
-          gfloat pixel_step[2];
-
-          pixel_step[0] = 1.0f / self->tex_width;
-          pixel_step[1] = 1.0f / self->tex_height;
-
-          cogl_pipeline_set_uniform_float (self->pipeline,
-                                           self->pixel_step_uniform,
-                                           2, /* n_components */
-                                           1, /* count */
-                                           pixel_step);
-        }
-
-      cogl_pipeline_set_layer_texture (self->pipeline, 0, texture);
+      /* the contents of the offscreen texture are going to change */
+      self->pass_dirty = TRUE;
 
       return TRUE;
     }
@@ -158,22 +418,128 @@ clutter_blur_effect_pre_paint (ClutterEffect *effect)
     return FALSE;
 }
 
+static void
+clutter_blur_effect_paint_pass (ClutterBlurEffect *self,
+                                CoglHandle         texture)
+{
+  CoglFramebuffer *framebuffer;
+  CoglHandle pass_texture;
+  gfloat pixel_step[2];
+
+  framebuffer =
+    COGL_FRAMEBUFFER (_clutter_offscreen_target_get_offscreen (self->pass_target));
+  pass_texture = _clutter_offscreen_target_get_texture (self->pass_target);
+
+  /* the taps are in texels of the offscreen texture, even if each
+   * texel of the pass covers pass_downsample of them
+   */
+  pixel_step[0] = 1.0f / self->tex_width;
+  pixel_step[1] = 0.f;
+
+  if (self->h_pixel_step_uniform > -1)
+    cogl_pipeline_set_uniform_float (self->h_pipeline,
+                                     self->h_pixel_step_uniform,
+                                     2, /* n_components */
+                                     1, /* count */
+                                     pixel_step);
+
+  cogl_pipeline_set_layer_texture (self->h_pipeline, 0, texture);
+
+  /* the pooled framebuffer can have been used with a different
+   * projection by another effect
+   */
+  cogl_framebuffer_set_viewport (framebuffer,
+                                 0, 0,
+                                 cogl_texture_get_width (pass_texture),
+                                 cogl_texture_get_height (pass_texture));
+  cogl_framebuffer_orthographic (framebuffer,
+                                 0, 0,
+                                 cogl_texture_get_width (pass_texture),
+                                 cogl_texture_get_height (pass_texture),
+                                 -1, 1);
+  cogl_framebuffer_push_matrix (framebuffer);
+  cogl_framebuffer_identity_matrix (framebuffer);
+
+  /* the texels outside of the pass must be transparent, since the
+   * vertical pass can read them
+   */
+  cogl_framebuffer_clear4f (framebuffer, COGL_BUFFER_BIT_COLOR, 0, 0, 0, 0);
+  cogl_framebuffer_draw_rectangle (framebuffer, self->h_pipeline,
+                                   0, 0,
+                                   self->pass_width,
+                                   self->pass_height);
+
+  cogl_framebuffer_pop_matrix (framebuffer);
+
+  self->pass_dirty = FALSE;
+}
+
 static void
 clutter_blur_effect_paint_target (ClutterOffscreenEffect *effect)
 {
   ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
+  ClutterOffscreenEffectClass *parent_class;
+  CoglHandle texture, pass_texture;
+  gfloat pass_texture_width, pass_texture_height;
+  gfloat pixel_step[2];
   guint8 paint_opacity;
 
+  parent_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (clutter_blur_effect_parent_class);
+
+  texture = _clutter_offscreen_effect_get_texture (effect);
+  if (self->radius == 0 || texture == NULL)
+    {
+      parent_class->paint_target (effect);
+      return;
+    }
+
+  if (self->kernel_dirty)
+    {
+      clutter_blur_effect_update_kernel (self);
+      self->pass_dirty = TRUE;
+    }
+
+  if (!clutter_blur_effect_ensure_pass (self))
+    {
+      parent_class->paint_target (effect);
+      return;
+    }
+
+  /* the horizontal pass only needs to be repeated when the contents
+   * of the offscreen texture change
+   */
+  if (self->pass_dirty)
+    clutter_blur_effect_paint_pass (self, texture);
+
+  pass_texture = _clutter_offscreen_target_get_texture (self->pass_target);
+  pass_texture_width = cogl_texture_get_width (pass_texture);
+  pass_texture_height = cogl_texture_get_height (pass_texture);
+
+  pixel_step[0] = 0.f;
+  pixel_step[1] = 1.0f / pass_texture_height;
+
+  if (self->v_pixel_step_uniform > -1)
+    cogl_pipeline_set_uniform_float (self->v_pipeline,
+                                     self->v_pixel_step_uniform,
+                                     2, /* n_components */
+                                     1, /* count */
+                                     pixel_step);
+
+  cogl_pipeline_set_layer_texture (self->v_pipeline, 0, pass_texture);
+
   paint_opacity = clutter_actor_get_paint_opacity (self->actor);
 
-  cogl_pipeline_set_color4ub (self->pipeline,
+  cogl_pipeline_set_color4ub (self->v_pipeline,
                               paint_opacity,
                               paint_opacity,
                               paint_opacity,
                               paint_opacity);
-  cogl_push_source (self->pipeline);
+  cogl_push_source (self->v_pipeline);
 
-  cogl_rectangle (0, 0, self->tex_width, self->tex_height);
+  cogl_rectangle_with_texture_coords (0, 0, self->tex_width, self->tex_height,
+                                      0.0, 0.0,
+                                      self->pass_width / pass_texture_width,
+                                      self->pass_height / pass_texture_height);
 
   cogl_pop_source ();
 }
@@ -182,17 +548,28 @@ static gboolean
 clutter_blur_effect_get_paint_volume (ClutterEffect      *effect,
                                       ClutterPaintVolume *volume)
 {
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
   gfloat cur_width, cur_height;
   ClutterVertex origin;
+  gfloat padding;
+
+  if (self->kernel_dirty)
+    clutter_blur_effect_update_kernel (self);
+
+  /* the kernel is truncated at the radius, rounded up to the
+   * resolution of the passes
+   */
+  padding = ((self->radius + self->pass_downsample - 1) / self->pass_downsample)
+          * self->pass_downsample;
 
   clutter_paint_volume_get_origin (volume, &origin);
   cur_width = clutter_paint_volume_get_width (volume);
   cur_height = clutter_paint_volume_get_height (volume);
 
-  origin.x -= BLUR_PADDING;
-  origin.y -= BLUR_PADDING;
-  cur_width += 2 * BLUR_PADDING;
-  cur_height += 2 * BLUR_PADDING;
+  origin.x -= padding;
+  origin.y -= padding;
+  cur_width += 2 * padding;
+  cur_height += 2 * padding;
   clutter_paint_volume_set_origin (volume, &origin);
   clutter_paint_volume_set_width (volume, cur_width);
   clutter_paint_volume_set_height (volume, cur_height);
@@ -200,17 +577,85 @@ clutter_blur_effect_get_paint_volume (ClutterEffect      *effect,
   return TRUE;
 }
 
+static void
+clutter_blur_effect_set_property (GObject      *gobject,
+                                  guint         prop_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_RADIUS:
+      clutter_blur_effect_set_radius (self, g_value_get_uint (value));
+      break;
+
+    case PROP_SIGMA:
+      clutter_blur_effect_set_sigma (self, g_value_get_double (value));
+      break;
+
+    case PROP_DOWNSAMPLE:
+      clutter_blur_effect_set_downsample (self, g_value_get_uint (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_blur_effect_get_property (GObject    *gobject,
+                                  guint       prop_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_RADIUS:
+      g_value_set_uint (value, self->radius);
+      break;
+
+    case PROP_SIGMA:
+      g_value_set_double (value, self->sigma);
+      break;
+
+    case PROP_DOWNSAMPLE:
+      g_value_set_uint (value, self->downsample);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
 static void
 clutter_blur_effect_dispose (GObject *gobject)
 {
   ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (gobject);
 
-  if (self->pipeline != NULL)
+  if (self->h_pipeline != NULL)
+    {
+      cogl_object_unref (self->h_pipeline);
+      self->h_pipeline = NULL;
+    }
+
+  if (self->v_pipeline != NULL)
     {
-      cogl_object_unref (self->pipeline);
-      self->pipeline = NULL;
+      cogl_object_unref (self->v_pipeline);
+      self->v_pipeline = NULL;
     }
 
+  clutter_blur_effect_clear_pass (self);
+
+  self->h_n_taps = 0;
+  self->v_n_taps = 0;
+  self->kernel_dirty = TRUE;
+
   G_OBJECT_CLASS (clutter_blur_effect_parent_class)->dispose (gobject);
 }
 
@@ -221,6 +666,8 @@ clutter_blur_effect_class_init (ClutterBlurEffectClass *klass)
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
   ClutterOffscreenEffectClass *offscreen_class;
 
+  gobject_class->set_property = clutter_blur_effect_set_property;
+  gobject_class->get_property = clutter_blur_effect_get_property;
   gobject_class->dispose = clutter_blur_effect_dispose;
 
   effect_class->pre_paint = clutter_blur_effect_pre_paint;
@@ -228,37 +675,66 @@ clutter_blur_effect_class_init (ClutterBlurEffectClass *klass)
 
   offscreen_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (klass);
   offscreen_class->paint_target = clutter_blur_effect_paint_target;
+
+  /**
+   * ClutterBlurEffect:radius:
+   *
+   * The radius of the blur, in pixels. A radius of 0 disables
+   * the blur.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_RADIUS] =
+    g_param_spec_uint ("radius",
+                       P_("Radius"),
+                       P_("The radius of the blur, in pixels"),
+                       0, MAX_RADIUS,
+                       DEFAULT_RADIUS,
+                       CLUTTER_PARAM_READWRITE);
+
+  /**
+   * ClutterBlurEffect:sigma:
+   *
+   * The standard deviation of the Gaussian function used by the blur,
+   * in pixels. A value of 0 uses half of the #ClutterBlurEffect:radius.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_SIGMA] =
+    g_param_spec_double ("sigma",
+                         P_("Sigma"),
+                         P_("The standard deviation of the blur"),
+                         0.0, G_MAXDOUBLE,
+                         0.0,
+                         CLUTTER_PARAM_READWRITE);
+
+  /**
+   * ClutterBlurEffect:downsample:
+   *
+   * The factor by which the resolution of the actor is reduced before
+   * blurring it: 1, 2 or 4.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_DOWNSAMPLE] =
+    g_param_spec_uint ("downsample",
+                       P_("Downsample"),
+                       P_("The factor by which the resolution is reduced before blurring"),
+                       1, 4,
+                       1,
+                       CLUTTER_PARAM_READWRITE);
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 }
 
 static void
 clutter_blur_effect_init (ClutterBlurEffect *self)
 {
-  ClutterBlurEffectClass *klass = CLUTTER_BLUR_EFFECT_GET_CLASS (self);
-
-  if (G_UNLIKELY (klass->base_pipeline == NULL))
-    {
-      CoglSnippet *snippet;
-      CoglContext *ctx =
-        clutter_backend_get_cogl_context (clutter_get_default_backend ());
-
-      klass->base_pipeline = cogl_pipeline_new (ctx);
-
-      snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_TEXTURE_LOOKUP,
-                                  box_blur_glsl_declarations,
-                                  NULL);
-      cogl_snippet_set_replace (snippet, box_blur_glsl_shader);
-      cogl_pipeline_add_layer_snippet (klass->base_pipeline, 0, snippet);
-      cogl_object_unref (snippet);
-
-      cogl_pipeline_set_layer_null_texture (klass->base_pipeline,
-                                            0, /* layer number */
-                                            COGL_TEXTURE_TYPE_2D);
-    }
-
-  self->pipeline = cogl_pipeline_copy (klass->base_pipeline);
-
-  self->pixel_step_uniform =
-    cogl_pipeline_get_uniform_location (self->pipeline, "pixel_step");
+  self->radius = DEFAULT_RADIUS;
+  self->sigma = 0.0;
+  self->downsample = 1;
+  self->pass_downsample = 1;
+  self->kernel_dirty = TRUE;
 }
 
 /**
@@ -276,3 +752,168 @@ clutter_blur_effect_new (void)
 {
   return g_object_new (CLUTTER_TYPE_BLUR_EFFECT, NULL);
 }
+
+/**
+ * clutter_blur_effect_set_radius:
+ * @effect: a #ClutterBlurEffect
+ * @radius: the radius of the blur, in pixels
+ *
+ * Sets the radius of the blur applied by @effect.
+ *
+ * The cost of the blur grows linearly with the radius.
+ *
+ * Since: 1.26
+ */
+void
+clutter_blur_effect_set_radius (ClutterBlurEffect *effect,
+                                guint              radius)
+{
+  ClutterActor *actor;
+
+  g_return_if_fail (CLUTTER_IS_BLUR_EFFECT (effect));
+
+  radius = MIN (radius, MAX_RADIUS);
+
+  if (effect->radius == radius)
+    return;
+
+  effect->radius = radius;
+  effect->kernel_dirty = TRUE;
+
+  /* the paint volume depends on the radius, so the actor needs to
+   * be painted again into a bigger or smaller offscreen buffer
+   */
+  actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+  if (actor != NULL)
+    clutter_actor_queue_redraw (actor);
+
+  g_object_notify_by_pspec (G_OBJECT (effect), obj_props[PROP_RADIUS]);
+}
+
+/**
+ * clutter_blur_effect_get_radius:
+ * @effect: a #ClutterBlurEffect
+ *
+ * Retrieves the radius set with clutter_blur_effect_set_radius().
+ *
+ * Return value: the radius of the blur, in pixels
+ *
+ * Since: 1.26
+ */
+guint
+clutter_blur_effect_get_radius (ClutterBlurEffect *effect)
+{
+  g_return_val_if_fail (CLUTTER_IS_BLUR_EFFECT (effect), 0);
+
+  return effect->radius;
+}
+
+/**
+ * clutter_blur_effect_set_sigma:
+ * @effect: a #ClutterBlurEffect
+ * @sigma: the standard deviation of the blur, in pixels, or 0
+ *
+ * Sets the standard deviation of the Gaussian function used by @effect.
+ * If @sigma is 0, half of the #ClutterBlurEffect:radius is used.
+ *
+ * Since: 1.26
+ */
+void
+clutter_blur_effect_set_sigma (ClutterBlurEffect *effect,
+                               gdouble            sigma)
+{
+  g_return_if_fail (CLUTTER_IS_BLUR_EFFECT (effect));
+  g_return_if_fail (sigma >= 0.0);
+
+  if (fabs (effect->sigma - sigma) < 0.00001)
+    return;
+
+  effect->sigma = sigma;
+  effect->kernel_dirty = TRUE;
+
+  clutter_effect_queue_repaint (CLUTTER_EFFECT (effect));
+
+  g_object_notify_by_pspec (G_OBJECT (effect), obj_props[PROP_SIGMA]);
+}
+
+/**
+ * clutter_blur_effect_get_sigma:
+ * @effect: a #ClutterBlurEffect
+ *
+ * Retrieves the value set with clutter_blur_effect_set_sigma().
+ *
+ * Return value: the standard deviation of the blur, in pixels
+ *
+ * Since: 1.26
+ */
+gdouble
+clutter_blur_effect_get_sigma (ClutterBlurEffect *effect)
+{
+  g_return_val_if_fail (CLUTTER_IS_BLUR_EFFECT (effect), 0.0);
+
+  return effect->sigma;
+}
+
+/**
+ * clutter_blur_effect_set_downsample:
+ * @effect: a #ClutterBlurEffect
+ * @downsample: the downsampling factor: 1, 2 or 4; other values
+ *   are rounded down to the nearest of them
+ *
+ * Sets the factor by which the resolution of the actor is reduced
+ * before blurring it. Downsampling reduces the cost of large blurs,
+ * at the expense of their quality.
+ *
+ * The resolution is reduced further when the radius of the blur
+ * requires it.
+ *
+ * Since: 1.26
+ */
+void
+clutter_blur_effect_set_downsample (ClutterBlurEffect *effect,
+                                    guint              downsample)
+{
+  ClutterActor *actor;
+
+  g_return_if_fail (CLUTTER_IS_BLUR_EFFECT (effect));
+
+  if (downsample >= 4)
+    downsample = 4;
+  else if (downsample >= 2)
+    downsample = 2;
+  else
+    downsample = 1;
+
+  if (effect->downsample == downsample)
+    return;
+
+  effect->downsample = downsample;
+  effect->kernel_dirty = TRUE;
+
+  /* the padding of the paint volume is rounded to the resolution
+   * of the blur
+   */
+  actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+  if (actor != NULL)
+    clutter_actor_queue_redraw (actor);
+
+  g_object_notify_by_pspec (G_OBJECT (effect), obj_props[PROP_DOWNSAMPLE]);
+}
+
+/**
+ * clutter_blur_effect_get_downsample:
+ * @effect: a #ClutterBlurEffect
+ *
+ * Retrieves the value set with clutter_blur_effect_set_downsample().
+ *
+ * Return value: the downsampling factor
+ *
+ * Since: 1.26
+ */
+guint
+clutter_blur_effect_get_downsample (ClutterBlurEffect *effect)
+{
+  g_return_val_if_fail (CLUTTER_IS_BLUR_EFFECT (effect), 1);
+
+  return effect->downsample;
+}
@@ -54,6 +54,22 @@ GType clutter_blur_effect_get_type (void) G_GNUC_CONST;
 CLUTTER_AVAILABLE_IN_1_4
 ClutterEffect *clutter_blur_effect_new (void);
 
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_blur_effect_set_radius          (ClutterBlurEffect *effect,
+                                                         guint              radius);
+CLUTTER_AVAILABLE_IN_1_26
+guint           clutter_blur_effect_get_radius          (ClutterBlurEffect *effect);
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_blur_effect_set_sigma           (ClutterBlurEffect *effect,
+                                                         gdouble            sigma);
+CLUTTER_AVAILABLE_IN_1_26
+gdouble         clutter_blur_effect_get_sigma           (ClutterBlurEffect *effect);
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_blur_effect_set_downsample      (ClutterBlurEffect *effect,
+                                                         guint              downsample);
+CLUTTER_AVAILABLE_IN_1_26
+guint           clutter_blur_effect_get_downsample      (ClutterBlurEffect *effect);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_BLUR_EFFECT_H__ */
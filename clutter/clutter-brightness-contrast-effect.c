@@ -51,7 +51,7 @@
 
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
-#include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
 struct _ClutterBrightnessContrastEffect
@@ -164,7 +164,7 @@ clutter_brightness_contrast_effect_pre_paint (ClutterEffect *effect)
         CLUTTER_OFFSCREEN_EFFECT (effect);
       CoglHandle texture;
 
-      texture = clutter_offscreen_effect_get_texture (offscreen_effect);
+      texture = _clutter_offscreen_effect_get_texture (offscreen_effect);
       self->tex_width = cogl_texture_get_width (texture);
       self->tex_height = cogl_texture_get_height (texture);
 
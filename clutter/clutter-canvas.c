@@ -46,6 +46,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include <cogl/cogl.h>
 #include <cairo-gobject.h>
 
@@ -60,11 +62,14 @@
 #include "clutter-content-private.h"
 #include "clutter-debug.h"
 #include "clutter-marshal.h"
+#include "clutter-master-clock.h"
 #include "clutter-paint-node.h"
 #include "clutter-paint-nodes.h"
 #include "clutter-private.h"
 #include "clutter-settings.h"
 
+typedef struct _ClutterCanvasDrawJob    ClutterCanvasDrawJob;
+
 struct _ClutterCanvasPrivate
 {
   cairo_t *cr;
@@ -77,8 +82,35 @@ struct _ClutterCanvasPrivate
 
   CoglBitmap *buffer;
 
+  /* the scale factor used to create the buffer */
+  int buffer_scale;
+
+  /* the area of the buffer that changed since the last upload,
+   * in pixels; unused if the whole texture is dirty
+   */
+  cairo_region_t *dirty_region;
+
+  /* the draw in progress in the worker thread, if any */
+  ClutterCanvasDrawJob *draw_job;
+
   int scale_factor;
   guint scale_factor_set : 1;
+  guint threaded_draw : 1;
+};
+
+struct _ClutterCanvasDrawJob
+{
+  /* owns a reference on the canvas */
+  ClutterCanvas *canvas;
+
+  int width;
+  int height;
+  int window_scale;
+
+  /* set by the worker thread */
+  cairo_surface_t *surface;
+
+  volatile gint cancelled;
 };
 
 enum
@@ -89,6 +121,7 @@ enum
   PROP_HEIGHT,
   PROP_SCALE_FACTOR,
   PROP_SCALE_FACTOR_SET,
+  PROP_THREADED_DRAW,
 
   LAST_PROP
 };
@@ -104,6 +137,11 @@ enum
 
 static guint canvas_signals[LAST_SIGNAL] = { 0, };
 
+static GThreadPool *draw_thread_pool = NULL;
+static guint        draw_repaint_func = 0;
+static GList       *draw_done_list = NULL;
+static GMutex       draw_done_mutex;
+
 static void clutter_content_iface_init (ClutterContentIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (ClutterCanvas, clutter_canvas, G_TYPE_OBJECT,
@@ -145,6 +183,7 @@ clutter_canvas_finalize (GObject *gobject)
     }
 
   g_clear_pointer (&priv->texture, cogl_object_unref);
+  g_clear_pointer (&priv->dirty_region, cairo_region_destroy);
 
   G_OBJECT_CLASS (clutter_canvas_parent_class)->finalize (gobject);
 }
@@ -190,6 +229,11 @@ clutter_canvas_set_property (GObject      *gobject,
                                        g_value_get_int (value));
       break;
 
+    case PROP_THREADED_DRAW:
+      clutter_canvas_set_threaded_draw (CLUTTER_CANVAS (gobject),
+                                        g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -225,6 +269,10 @@ clutter_canvas_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->scale_factor_set);
       break;
 
+    case PROP_THREADED_DRAW:
+      g_value_set_boolean (value, priv->threaded_draw);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
       break;
@@ -309,6 +357,23 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
                       -1,
                       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ClutterCanvas:threaded-draw:
+   *
+   * Whether the #ClutterCanvas::draw signal should be emitted in a
+   * worker thread.
+   *
+   * See clutter_canvas_set_threaded_draw().
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_THREADED_DRAW] =
+    g_param_spec_boolean ("threaded-draw",
+                          P_("Threaded Draw"),
+                          P_("Whether the canvas is drawn in a worker thread"),
+                          FALSE,
+                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   /**
    * ClutterCanvas::draw:
    * @canvas: the #ClutterCanvas that emitted the signal
@@ -319,6 +384,13 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
    * The #ClutterCanvas::draw signal is emitted each time a canvas is
    * invalidated.
    *
+   * If the canvas was invalidated using clutter_canvas_invalidate_area()
+   * then @cr is clipped to the invalidated area, which has been cleared;
+   * the rest of the canvas keeps its contents.
+   *
+   * If the #ClutterCanvas:threaded-draw property is set, the signal
+   * is emitted in a worker thread; see clutter_canvas_set_threaded_draw().
+   *
    * It is safe to connect multiple handlers to this signal: each
    * handler invocation will be automatically protected by cairo_save()
    * and cairo_restore() pairs.
@@ -357,6 +429,54 @@ clutter_canvas_init (ClutterCanvas *self)
   self->priv->scale_factor = -1;
 }
 
+/* uploads the dirty region of the buffer to the texture; returns
+ * %FALSE if the texture has to be created again from the buffer
+ */
+static gboolean
+clutter_canvas_upload_dirty_region (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  CoglBuffer *buffer;
+  unsigned char *data;
+  int stride, i, n_rects;
+  gboolean res = TRUE;
+
+  buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->buffer));
+  if (buffer == NULL)
+    return FALSE;
+
+  data = cogl_buffer_map (buffer, COGL_BUFFER_ACCESS_READ, 0);
+  if (data == NULL)
+    return FALSE;
+
+  stride = cogl_bitmap_get_rowstride (priv->buffer);
+
+  n_rects = cairo_region_num_rectangles (priv->dirty_region);
+  for (i = 0; i < n_rects && res; i++)
+    {
+      cairo_rectangle_int_t rect;
+
+      cairo_region_get_rectangle (priv->dirty_region, i, &rect);
+
+      CLUTTER_NOTE (MISC, "Uploading area %d, %d, %d x %d of the canvas",
+                    rect.x, rect.y,
+                    rect.width, rect.height);
+
+      res = cogl_texture_set_region (priv->texture,
+                                     0, 0,
+                                     rect.x, rect.y,
+                                     rect.width, rect.height,
+                                     rect.width, rect.height,
+                                     CLUTTER_CAIRO_FORMAT_ARGB32,
+                                     stride,
+                                     data + rect.y * stride + rect.x * 4);
+    }
+
+  cogl_buffer_unmap (buffer);
+
+  return res;
+}
+
 static void
 clutter_canvas_paint_content (ClutterContent   *content,
                               ClutterActor     *actor,
@@ -369,6 +489,16 @@ clutter_canvas_paint_content (ClutterContent   *content,
   if (priv->buffer == NULL)
     return;
 
+  if (!priv->dirty &&
+      priv->texture != NULL &&
+      priv->dirty_region != NULL)
+    {
+      if (!clutter_canvas_upload_dirty_region (self))
+        priv->dirty = TRUE;
+    }
+
+  g_clear_pointer (&priv->dirty_region, cairo_region_destroy);
+
   if (priv->dirty)
     g_clear_pointer (&priv->texture, cogl_object_unref);
 
@@ -388,8 +518,34 @@ clutter_canvas_paint_content (ClutterContent   *content,
   priv->dirty = FALSE;
 }
 
+static int
+clutter_canvas_get_window_scale (ClutterCanvas *self)
+{
+  int window_scale = 1;
+
+  if (self->priv->scale_factor_set)
+    window_scale = self->priv->scale_factor;
+  else
+    g_object_get (clutter_settings_get_default (),
+                  "window-scaling-factor", &window_scale,
+                  NULL);
+
+  return window_scale;
+}
+
+/*< private >
+ * clutter_canvas_emit_draw:
+ * @self: a #ClutterCanvas
+ * @area: (allow-none): the area to draw, in canvas coordinates, or
+ *   %NULL to draw the whole canvas
+ *
+ * Emits the #ClutterCanvas::draw signal. If @area is set, the current
+ * buffer must have been created with the current scale factor, and
+ * only @area is redrawn.
+ */
 static void
-clutter_canvas_emit_draw (ClutterCanvas *self)
+clutter_canvas_emit_draw (ClutterCanvas               *self,
+                          const cairo_rectangle_int_t *area)
 {
   ClutterCanvasPrivate *priv = self->priv;
   int real_width, real_height;
@@ -397,20 +553,19 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
   gboolean mapped_buffer;
   unsigned char *data;
   CoglBuffer *buffer;
-  int window_scale = 1;
+  int window_scale;
   gboolean res;
   cairo_t *cr;
 
   g_assert (priv->width > 0 && priv->width > 0);
 
-  priv->dirty = TRUE;
+  if (area == NULL)
+    {
+      priv->dirty = TRUE;
+      g_clear_pointer (&priv->dirty_region, cairo_region_destroy);
+    }
 
-  if (priv->scale_factor_set)
-    window_scale = priv->scale_factor;
-  else
-    g_object_get (clutter_settings_get_default (),
-                  "window-scaling-factor", &window_scale,
-                  NULL);
+  window_scale = clutter_canvas_get_window_scale (self);
 
   real_width = priv->width * window_scale;
   real_height = priv->height * window_scale;
@@ -429,6 +584,7 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
                                                 real_width,
                                                 real_height,
                                                 CLUTTER_CAIRO_FORMAT_ARGB32);
+      priv->buffer_scale = window_scale;
     }
 
   buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->buffer));
@@ -437,9 +593,10 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
 
   cogl_buffer_set_update_hint (buffer, COGL_BUFFER_UPDATE_HINT_DYNAMIC);
 
+  /* the contents outside of @area must be preserved */
   data = cogl_buffer_map (buffer,
                           COGL_BUFFER_ACCESS_READ_WRITE,
-                          COGL_BUFFER_MAP_HINT_DISCARD);
+                          area == NULL ? COGL_BUFFER_MAP_HINT_DISCARD : 0);
 
   if (data != NULL)
     {
@@ -459,12 +616,49 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
                                             real_height);
 
       mapped_buffer = FALSE;
+
+      /* we cannot read back the previous contents */
+      if (area != NULL)
+        {
+          priv->dirty = TRUE;
+          g_clear_pointer (&priv->dirty_region, cairo_region_destroy);
+          area = NULL;
+        }
     }
 
   cairo_surface_set_device_scale (surface, window_scale, window_scale);
 
   self->priv->cr = cr = cairo_create (surface);
 
+  if (area != NULL)
+    {
+      cairo_rectangle_int_t dirty_rect;
+
+      cairo_rectangle (cr, area->x, area->y, area->width, area->height);
+      cairo_clip (cr);
+
+      cairo_save (cr);
+      cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+      cairo_paint (cr);
+      cairo_restore (cr);
+
+      /* if the whole texture has to be uploaded there's no need
+       * to track the changed areas
+       */
+      if (!priv->dirty)
+        {
+          dirty_rect.x = area->x * window_scale;
+          dirty_rect.y = area->y * window_scale;
+          dirty_rect.width = area->width * window_scale;
+          dirty_rect.height = area->height * window_scale;
+
+          if (priv->dirty_region == NULL)
+            priv->dirty_region = cairo_region_create_rectangle (&dirty_rect);
+          else
+            cairo_region_union_rectangle (priv->dirty_region, &dirty_rect);
+        }
+    }
+
   g_signal_emit (self, canvas_signals[DRAW], 0,
                  cr, priv->width, priv->height,
                  &res);
@@ -495,12 +689,235 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
   cairo_surface_destroy (surface);
 }
 
+static void
+clutter_canvas_draw_job_free (ClutterCanvasDrawJob *job)
+{
+  /* this function must be called by the main thread, as it may
+   * release the last reference on the canvas
+   */
+  if (job->surface != NULL)
+    cairo_surface_destroy (job->surface);
+
+  g_object_unref (job->canvas);
+
+  g_slice_free (ClutterCanvasDrawJob, job);
+}
+
+static void
+clutter_canvas_cancel_draw (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+
+  if (priv->draw_job == NULL)
+    return;
+
+  CLUTTER_NOTE (MISC, "Cancelling the threaded draw of <ClutterCanvas>[%p]",
+                self);
+
+  /* the job is freed once the worker thread is done with it */
+  g_atomic_int_set (&priv->draw_job->cancelled, TRUE);
+  priv->draw_job = NULL;
+}
+
+/* copies the contents of @surface into the buffer of @self, creating
+ * a new buffer if needed
+ */
+static void
+clutter_canvas_set_buffer_from_surface (ClutterCanvas   *self,
+                                        cairo_surface_t *surface,
+                                        int              window_scale)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  int real_width, real_height;
+  int surface_stride, bitmap_stride;
+  unsigned char *surface_data;
+  unsigned char *data;
+  CoglBuffer *buffer;
+  int y;
+
+  real_width = cairo_image_surface_get_width (surface);
+  real_height = cairo_image_surface_get_height (surface);
+
+  if (priv->buffer != NULL &&
+      (cogl_bitmap_get_width (priv->buffer) != real_width ||
+       cogl_bitmap_get_height (priv->buffer) != real_height))
+    {
+      cogl_object_unref (priv->buffer);
+      priv->buffer = NULL;
+    }
+
+  if (priv->buffer == NULL)
+    {
+      CoglContext *ctx;
+
+      ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+      priv->buffer = cogl_bitmap_new_with_size (ctx,
+                                                real_width,
+                                                real_height,
+                                                CLUTTER_CAIRO_FORMAT_ARGB32);
+    }
+
+  priv->buffer_scale = window_scale;
+  priv->dirty = TRUE;
+  g_clear_pointer (&priv->dirty_region, cairo_region_destroy);
+
+  buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->buffer));
+  if (buffer == NULL)
+    return;
+
+  cogl_buffer_set_update_hint (buffer, COGL_BUFFER_UPDATE_HINT_DYNAMIC);
+
+  surface_data = cairo_image_surface_get_data (surface);
+  surface_stride = cairo_image_surface_get_stride (surface);
+  bitmap_stride = cogl_bitmap_get_rowstride (priv->buffer);
+
+  data = cogl_buffer_map (buffer,
+                          COGL_BUFFER_ACCESS_WRITE,
+                          COGL_BUFFER_MAP_HINT_DISCARD);
+
+  for (y = 0; y < real_height; y++)
+    {
+      const unsigned char *row = surface_data + y * surface_stride;
+
+      if (data != NULL)
+        memcpy (data + y * bitmap_stride, row, real_width * 4);
+      else
+        cogl_buffer_set_data (buffer, y * bitmap_stride, row, real_width * 4);
+    }
+
+  if (data != NULL)
+    cogl_buffer_unmap (buffer);
+}
+
+static gboolean
+clutter_canvas_repaint_draw_func (gpointer user_data)
+{
+  GList *done_list, *l;
+
+  g_mutex_lock (&draw_done_mutex);
+  done_list = draw_done_list;
+  draw_done_list = NULL;
+  g_mutex_unlock (&draw_done_mutex);
+
+  for (l = done_list; l != NULL; l = l->next)
+    {
+      ClutterCanvasDrawJob *job = l->data;
+      ClutterCanvas *self = job->canvas;
+
+      if (!g_atomic_int_get (&job->cancelled) && job->surface != NULL)
+        {
+          CLUTTER_NOTE (MISC, "Threaded draw of <ClutterCanvas>[%p] complete",
+                        self);
+
+          self->priv->draw_job = NULL;
+
+          clutter_canvas_set_buffer_from_surface (self,
+                                                  job->surface,
+                                                  job->window_scale);
+
+          _clutter_content_queue_redraw (CLUTTER_CONTENT (self));
+        }
+
+      clutter_canvas_draw_job_free (job);
+    }
+
+  g_list_free (done_list);
+
+  return TRUE;
+}
+
+static void
+clutter_canvas_thread_draw (gpointer user_data,
+                            gpointer pool_data)
+{
+  ClutterCanvasDrawJob *job = user_data;
+
+  if (!g_atomic_int_get (&job->cancelled))
+    {
+      cairo_surface_t *surface;
+      gboolean res;
+      cairo_t *cr;
+
+      surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                            job->width * job->window_scale,
+                                            job->height * job->window_scale);
+      cairo_surface_set_device_scale (surface,
+                                      job->window_scale,
+                                      job->window_scale);
+
+      cr = cairo_create (surface);
+
+      g_signal_emit (job->canvas, canvas_signals[DRAW], 0,
+                     cr, job->width, job->height,
+                     &res);
+
+      cairo_destroy (cr);
+      cairo_surface_flush (surface);
+
+      job->surface = surface;
+    }
+
+  /* the job is always handed back, so that the main thread releases
+   * the reference on the canvas
+   */
+  g_mutex_lock (&draw_done_mutex);
+
+  if (draw_repaint_func == 0)
+    {
+      draw_repaint_func =
+        clutter_threads_add_repaint_func (clutter_canvas_repaint_draw_func,
+                                          NULL, NULL);
+    }
+
+  draw_done_list = g_list_append (draw_done_list, job);
+
+  g_mutex_unlock (&draw_done_mutex);
+
+  _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+}
+
+static void
+clutter_canvas_queue_draw (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  ClutterCanvasDrawJob *job;
+
+  g_assert (priv->draw_job == NULL);
+
+  job = g_slice_new0 (ClutterCanvasDrawJob);
+  job->canvas = g_object_ref (self);
+  job->width = priv->width;
+  job->height = priv->height;
+  job->window_scale = clutter_canvas_get_window_scale (self);
+
+  priv->draw_job = job;
+
+  if (G_UNLIKELY (draw_thread_pool == NULL))
+    draw_thread_pool = g_thread_pool_new (clutter_canvas_thread_draw, NULL,
+                                          1,
+                                          FALSE,
+                                          NULL);
+
+  g_thread_pool_push (draw_thread_pool, job, NULL);
+}
+
 static void
 clutter_canvas_invalidate (ClutterContent *content)
 {
   ClutterCanvas *self = CLUTTER_CANVAS (content);
   ClutterCanvasPrivate *priv = self->priv;
 
+  clutter_canvas_cancel_draw (self);
+
+  /* the current contents are displayed until the worker thread
+   * is done drawing the new ones
+   */
+  if (priv->threaded_draw && priv->width > 0 && priv->height > 0)
+    {
+      clutter_canvas_queue_draw (self);
+      return;
+    }
+
   if (priv->buffer != NULL)
     {
       cogl_object_unref (priv->buffer);
@@ -510,7 +927,7 @@ clutter_canvas_invalidate (ClutterContent *content)
   if (priv->width <= 0 || priv->height <= 0)
     return;
 
-  clutter_canvas_emit_draw (self);
+  clutter_canvas_emit_draw (self, NULL);
 }
 
 static gboolean
@@ -714,3 +1131,119 @@ clutter_canvas_get_scale_factor (ClutterCanvas *canvas)
 
   return canvas->priv->scale_factor;
 }
+
+/**
+ * clutter_canvas_invalidate_area:
+ * @canvas: a #ClutterCanvas
+ * @area: the area to redraw, in canvas coordinates
+ *
+ * Invalidates the given @area of the @canvas.
+ *
+ * Unlike clutter_content_invalidate(), which redraws the whole
+ * @canvas, the #ClutterCanvas::draw signal is emitted with a Cairo
+ * context clipped to @area, and only the changed area is uploaded
+ * to the GPU. This is useful for large canvases that change a
+ * small area at a time, like graphs.
+ *
+ * If the @canvas has never been drawn, if its scale factor has
+ * changed, or if the #ClutterCanvas:threaded-draw property is set,
+ * the whole @canvas is invalidated.
+ *
+ * Since: 1.26
+ */
+void
+clutter_canvas_invalidate_area (ClutterCanvas               *canvas,
+                                const cairo_rectangle_int_t *area)
+{
+  ClutterCanvasPrivate *priv;
+  cairo_rectangle_int_t clip;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+  g_return_if_fail (area != NULL);
+
+  priv = canvas->priv;
+
+  /* the worker thread always draws the whole canvas */
+  if (priv->threaded_draw ||
+      priv->buffer == NULL ||
+      priv->buffer_scale != clutter_canvas_get_window_scale (canvas))
+    {
+      clutter_content_invalidate (CLUTTER_CONTENT (canvas));
+      return;
+    }
+
+  /* clamp the area to the canvas */
+  clip.x = MAX (area->x, 0);
+  clip.y = MAX (area->y, 0);
+  clip.width = MIN (area->x + area->width, priv->width) - clip.x;
+  clip.height = MIN (area->y + area->height, priv->height) - clip.y;
+
+  if (clip.width <= 0 || clip.height <= 0)
+    return;
+
+  clutter_canvas_emit_draw (canvas, &clip);
+
+  _clutter_content_queue_redraw (CLUTTER_CONTENT (canvas));
+}
+
+/**
+ * clutter_canvas_set_threaded_draw:
+ * @canvas: a #ClutterCanvas
+ * @threaded_draw: whether to draw in a worker thread
+ *
+ * Sets whether the #ClutterCanvas::draw signal should be emitted in
+ * a worker thread, instead of blocking the main loop while drawing.
+ *
+ * When a threaded @canvas is invalidated, the current contents of
+ * @canvas are displayed until the worker thread is done drawing the
+ * new ones. If @canvas is invalidated again while drawing, the
+ * result of the previous draw is discarded.
+ *
+ * The handlers of the #ClutterCanvas::draw signal must only use the
+ * Cairo context and data they own, or that they protect using locks;
+ * calling the Clutter API from them is not allowed.
+ *
+ * Since: 1.26
+ */
+void
+clutter_canvas_set_threaded_draw (ClutterCanvas *canvas,
+                                  gboolean       threaded_draw)
+{
+  ClutterCanvasPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+
+  priv = canvas->priv;
+
+  threaded_draw = !!threaded_draw;
+
+  if (priv->threaded_draw == threaded_draw)
+    return;
+
+  priv->threaded_draw = threaded_draw;
+
+  /* draw the contents that were being drawn by the worker thread */
+  if (!priv->threaded_draw && priv->draw_job != NULL)
+    clutter_content_invalidate (CLUTTER_CONTENT (canvas));
+
+  g_object_notify_by_pspec (G_OBJECT (canvas), obj_props[PROP_THREADED_DRAW]);
+}
+
+/**
+ * clutter_canvas_get_threaded_draw:
+ * @canvas: a #ClutterCanvas
+ *
+ * Retrieves whether @canvas is drawn in a worker thread.
+ *
+ * Return value: %TRUE if the #ClutterCanvas::draw signal is emitted
+ *   in a worker thread
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_canvas_get_threaded_draw (ClutterCanvas *canvas)
+{
+  g_return_val_if_fail (CLUTTER_IS_CANVAS (canvas), FALSE);
+
+  return canvas->priv->threaded_draw;
+}
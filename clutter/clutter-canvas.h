@@ -101,6 +101,16 @@ void                    clutter_canvas_set_scale_factor         (ClutterCanvas *
 CLUTTER_AVAILABLE_IN_1_18
 int                     clutter_canvas_get_scale_factor         (ClutterCanvas *canvas);
 
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_canvas_invalidate_area          (ClutterCanvas               *canvas,
+                                                                 const cairo_rectangle_int_t *area);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_canvas_set_threaded_draw        (ClutterCanvas *canvas,
+                                                                 gboolean       threaded_draw);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_canvas_get_threaded_draw        (ClutterCanvas *canvas);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_CANVAS_H__ */
@@ -167,14 +167,30 @@ clutter_content_default_init (ClutterContentInterface *iface)
 void
 clutter_content_invalidate (ClutterContent *content)
 {
-  GHashTable *actors;
-  GHashTableIter iter;
-  gpointer key_p, value_p;
-
   g_return_if_fail (CLUTTER_IS_CONTENT (content));
 
   CLUTTER_CONTENT_GET_IFACE (content)->invalidate (content);
 
+  _clutter_content_queue_redraw (content);
+}
+
+/*< private >
+ * _clutter_content_queue_redraw:
+ * @content: a #ClutterContent
+ *
+ * Queues a redraw on all the actors using @content, without
+ * invalidating it.
+ *
+ * This function should be used by #ClutterContent implementations
+ * that update their own state, instead of clutter_content_invalidate().
+ */
+void
+_clutter_content_queue_redraw (ClutterContent *content)
+{
+  GHashTable *actors;
+  GHashTableIter iter;
+  gpointer key_p, value_p;
+
   actors = g_object_get_qdata (G_OBJECT (content), quark_content_actors);
   if (actors == NULL)
     return;
@@ -190,6 +206,37 @@ clutter_content_invalidate (ClutterContent *content)
     }
 }
 
+/*< private >
+ * _clutter_content_has_mapped_actors:
+ * @content: a #ClutterContent
+ *
+ * Checks whether any of the actors using @content is mapped.
+ *
+ * Return value: %TRUE if @content is used by a mapped actor
+ */
+gboolean
+_clutter_content_has_mapped_actors (ClutterContent *content)
+{
+  GHashTable *actors;
+  GHashTableIter iter;
+  gpointer key_p, value_p;
+
+  actors = g_object_get_qdata (G_OBJECT (content), quark_content_actors);
+  if (actors == NULL)
+    return FALSE;
+
+  g_hash_table_iter_init (&iter, actors);
+  while (g_hash_table_iter_next (&iter, &key_p, &value_p))
+    {
+      ClutterActor *actor = key_p;
+
+      if (CLUTTER_ACTOR_IS_MAPPED (actor))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 /*< private >
  * _clutter_content_attached:
  * @content: a #ClutterContent
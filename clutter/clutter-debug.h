@@ -28,7 +28,8 @@ typedef enum {
 
 typedef enum {
   CLUTTER_DEBUG_NOP_PICKING         = 1 << 0,
-  CLUTTER_DEBUG_DUMP_PICK_BUFFERS   = 1 << 1
+  CLUTTER_DEBUG_DUMP_PICK_BUFFERS   = 1 << 1,
+  CLUTTER_DEBUG_GEOMETRIC_PICKING   = 1 << 2
 } ClutterPickDebugFlag;
 
 typedef enum {
@@ -39,7 +40,8 @@ typedef enum {
   CLUTTER_DEBUG_DISABLE_CULLING         = 1 << 4,
   CLUTTER_DEBUG_DISABLE_OFFSCREEN_REDIRECT = 1 << 5,
   CLUTTER_DEBUG_CONTINUOUS_REDRAW       = 1 << 6,
-  CLUTTER_DEBUG_PAINT_DEFORM_TILES      = 1 << 7
+  CLUTTER_DEBUG_PAINT_DEFORM_TILES      = 1 << 7,
+  CLUTTER_DEBUG_DISABLE_BATCHING        = 1 << 8
 } ClutterDrawDebugFlag;
 
 #ifdef CLUTTER_ENABLE_DEBUG
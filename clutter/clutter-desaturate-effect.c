@@ -53,7 +53,7 @@
 
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
-#include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
 struct _ClutterDesaturateEffect
@@ -141,7 +141,7 @@ clutter_desaturate_effect_pre_paint (ClutterEffect *effect)
         CLUTTER_OFFSCREEN_EFFECT (effect);
       CoglHandle texture;
 
-      texture = clutter_offscreen_effect_get_texture (offscreen_effect);
+      texture = _clutter_offscreen_effect_get_texture (offscreen_effect);
       self->tex_width = cogl_texture_get_width (texture);
       self->tex_height = cogl_texture_get_height (texture);
 
@@ -161,7 +161,7 @@ clutter_desaturate_effect_paint_target (ClutterOffscreenEffect *effect)
   CoglHandle texture;
   guint8 paint_opacity;
 
-  texture = clutter_offscreen_effect_get_texture (effect);
+  texture = _clutter_offscreen_effect_get_texture (effect);
   cogl_pipeline_set_layer_texture (self->pipeline, 0, texture);
 
   actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
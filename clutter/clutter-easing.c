@@ -4,6 +4,12 @@
 
 #include <math.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 double
 clutter_linear (double t,
                 double d)
@@ -553,3 +559,384 @@ clutter_easing_for_mode (ClutterAnimationMode mode,
 
   return _clutter_animation_modes[mode].func (t, d);
 }
+
+/* the number of intervals of the sampled tables; the error of the linear
+ * interpolation between two samples is below 1e-5 for the smooth modes,
+ * and below 1e-3 around the kinks of the bounce modes
+ */
+#define EASING_TABLE_SIZE       4096
+
+typedef enum {
+  EASING_TABLE_LINEAR,
+  EASING_TABLE_STEPS_START,
+  EASING_TABLE_STEPS_END,
+  EASING_TABLE_CUBIC_BEZIER,
+  EASING_TABLE_FUNC,
+  EASING_TABLE_SAMPLED
+} EasingTableType;
+
+struct _ClutterEasingTable
+{
+  EasingTableType type;
+
+  /* steps() parameters */
+  int n_steps;
+
+  /* cubic-bezier() parameters */
+  double x_1, y_1;
+  double x_2, y_2;
+
+  ClutterEasingFunc func;
+
+  /* for sampled tables, the samples at 0, 1/EASING_TABLE_SIZE, ..., 1,
+   * plus a copy of the last one, so that a progress of 1 needs no
+   * special casing
+   */
+  float *samples;
+};
+
+static void
+clutter_easing_table_sample (ClutterEasingTable *table)
+{
+  int i;
+
+  table->samples = g_new (float, EASING_TABLE_SIZE + 2);
+
+  for (i = 0; i <= EASING_TABLE_SIZE; i++)
+    table->samples[i] = clutter_easing_table_evaluate (table,
+                                                       (double) i / EASING_TABLE_SIZE,
+                                                       1.0);
+
+  table->samples[EASING_TABLE_SIZE + 1] = table->samples[EASING_TABLE_SIZE];
+  table->type = EASING_TABLE_SAMPLED;
+}
+
+/* the modes whose functions call pow(), sin() or cos(), or solve a
+ * cubic bezier curve, are slower than a look up in a table
+ */
+static gboolean
+clutter_easing_mode_is_expensive (ClutterAnimationMode mode)
+{
+  switch (mode)
+    {
+    case CLUTTER_EASE_IN_SINE:
+    case CLUTTER_EASE_OUT_SINE:
+    case CLUTTER_EASE_IN_OUT_SINE:
+    case CLUTTER_EASE_IN_EXPO:
+    case CLUTTER_EASE_OUT_EXPO:
+    case CLUTTER_EASE_IN_OUT_EXPO:
+    case CLUTTER_EASE_IN_ELASTIC:
+    case CLUTTER_EASE_OUT_ELASTIC:
+    case CLUTTER_EASE_IN_OUT_ELASTIC:
+    case CLUTTER_EASE_IN_BOUNCE:
+    case CLUTTER_EASE_OUT_BOUNCE:
+    case CLUTTER_EASE_IN_OUT_BOUNCE:
+    case CLUTTER_CUBIC_BEZIER:
+    case CLUTTER_EASE:
+    case CLUTTER_EASE_IN:
+    case CLUTTER_EASE_OUT:
+    case CLUTTER_EASE_IN_OUT:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+/*< private >
+ * clutter_easing_table_new_steps:
+ * @n_steps: the number of steps
+ * @step_mode: the step mode
+ *
+ * Creates a table for the steps() easing function. Steps are never
+ * sampled, since the interpolation would smooth the discontinuities.
+ *
+ * Return value: the newly allocated table
+ */
+ClutterEasingTable *
+clutter_easing_table_new_steps (int             n_steps,
+                                ClutterStepMode step_mode)
+{
+  ClutterEasingTable *table;
+
+  g_return_val_if_fail (n_steps > 0, NULL);
+
+  table = g_slice_new0 (ClutterEasingTable);
+  table->type = step_mode == CLUTTER_STEP_MODE_START
+              ? EASING_TABLE_STEPS_START
+              : EASING_TABLE_STEPS_END;
+  table->n_steps = n_steps;
+
+  return table;
+}
+
+/*< private >
+ * clutter_easing_table_new_cubic_bezier:
+ * @x_1: the X coordinate of the first control point
+ * @y_1: the Y coordinate of the first control point
+ * @x_2: the X coordinate of the second control point
+ * @y_2: the Y coordinate of the second control point
+ * @sampled: whether the curve should be sampled into the table
+ *
+ * Creates a table for the cubic-bezier() easing function. If @sampled
+ * is %TRUE, the curve is solved once for each sample, instead of for
+ * each evaluation.
+ *
+ * Return value: the newly allocated table
+ */
+ClutterEasingTable *
+clutter_easing_table_new_cubic_bezier (double   x_1,
+                                       double   y_1,
+                                       double   x_2,
+                                       double   y_2,
+                                       gboolean sampled)
+{
+  ClutterEasingTable *table = g_slice_new0 (ClutterEasingTable);
+
+  table->type = EASING_TABLE_CUBIC_BEZIER;
+  table->x_1 = x_1;
+  table->y_1 = y_1;
+  table->x_2 = x_2;
+  table->y_2 = y_2;
+
+  if (sampled)
+    clutter_easing_table_sample (table);
+
+  return table;
+}
+
+static ClutterEasingTable *
+clutter_easing_table_new_for_mode (ClutterAnimationMode mode,
+                                   gboolean             sampled)
+{
+  ClutterEasingTable *table;
+
+  sampled = sampled && clutter_easing_mode_is_expensive (mode);
+
+  /* these match the timeline progress function */
+  switch (mode)
+    {
+    case CLUTTER_STEP_START:
+      return clutter_easing_table_new_steps (1, CLUTTER_STEP_MODE_START);
+
+    case CLUTTER_STEP_END:
+      return clutter_easing_table_new_steps (1, CLUTTER_STEP_MODE_END);
+
+    case CLUTTER_EASE:
+      return clutter_easing_table_new_cubic_bezier (0.25, 0.1, 0.25, 1.0, sampled);
+
+    case CLUTTER_EASE_IN:
+      return clutter_easing_table_new_cubic_bezier (0.42, 0.0, 1.0, 1.0, sampled);
+
+    case CLUTTER_EASE_OUT:
+      return clutter_easing_table_new_cubic_bezier (0.0, 0.0, 0.58, 1.0, sampled);
+
+    case CLUTTER_EASE_IN_OUT:
+      return clutter_easing_table_new_cubic_bezier (0.42, 0.0, 0.58, 1.0, sampled);
+
+    default:
+      break;
+    }
+
+  table = g_slice_new0 (ClutterEasingTable);
+
+  if (mode == CLUTTER_LINEAR)
+    table->type = EASING_TABLE_LINEAR;
+  else
+    {
+      table->type = EASING_TABLE_FUNC;
+      table->func = clutter_get_easing_func_for_mode (mode);
+
+      if (sampled)
+        clutter_easing_table_sample (table);
+    }
+
+  return table;
+}
+
+/*< private >
+ * clutter_easing_table_get_for_mode:
+ * @mode: an animation mode, except %CLUTTER_CUSTOM_MODE and the
+ *   parametrized %CLUTTER_STEPS and %CLUTTER_CUBIC_BEZIER modes
+ * @sampled: whether the expensive easing functions should be sampled
+ *
+ * Retrieves the table for @mode, shared by all the callers. If @sampled
+ * is %TRUE, the functions that are slower than a look up in a table
+ * are sampled, and interpolated linearly; the other modes, and all the
+ * modes if @sampled is %FALSE, are evaluated exactly.
+ *
+ * Return value: (transfer none): the table for @mode
+ */
+const ClutterEasingTable *
+clutter_easing_table_get_for_mode (ClutterAnimationMode mode,
+                                   gboolean             sampled)
+{
+  static ClutterEasingTable *mode_tables[2][CLUTTER_ANIMATION_LAST] = { { NULL, }, };
+  ClutterEasingTable **table;
+
+  g_return_val_if_fail (mode > CLUTTER_CUSTOM_MODE && mode < CLUTTER_ANIMATION_LAST, NULL);
+  g_return_val_if_fail (mode != CLUTTER_STEPS && mode != CLUTTER_CUBIC_BEZIER, NULL);
+
+  table = &mode_tables[sampled ? 1 : 0][mode];
+
+  if (G_UNLIKELY (*table == NULL))
+    *table = clutter_easing_table_new_for_mode (mode, sampled);
+
+  return *table;
+}
+
+/*< private >
+ * clutter_easing_table_free:
+ * @table: a table returned by clutter_easing_table_new_steps() or
+ *   clutter_easing_table_new_cubic_bezier()
+ *
+ * Frees @table.
+ */
+void
+clutter_easing_table_free (ClutterEasingTable *table)
+{
+  if (table == NULL)
+    return;
+
+  g_free (table->samples);
+  g_slice_free (ClutterEasingTable, table);
+}
+
+static inline double
+easing_table_lookup (const float *samples,
+                     double       p)
+{
+  double x = CLAMP (p, 0.0, 1.0) * EASING_TABLE_SIZE;
+  int i = (int) x;
+  double a = samples[i];
+  double b = samples[i + 1];
+
+  return a + (b - a) * (x - i);
+}
+
+/*< private >
+ * clutter_easing_table_evaluate:
+ * @table: a #ClutterEasingTable
+ * @t: the elapsed time
+ * @d: the duration
+ *
+ * Evaluates the easing function of @table.
+ *
+ * Return value: the eased progress
+ */
+double
+clutter_easing_table_evaluate (const ClutterEasingTable *table,
+                               double                    t,
+                               double                    d)
+{
+  switch (table->type)
+    {
+    case EASING_TABLE_LINEAR:
+      return t / d;
+
+    case EASING_TABLE_STEPS_START:
+      return clutter_ease_steps_start (t, d, table->n_steps);
+
+    case EASING_TABLE_STEPS_END:
+      return clutter_ease_steps_end (t, d, table->n_steps);
+
+    case EASING_TABLE_CUBIC_BEZIER:
+      return clutter_ease_cubic_bezier (t, d,
+                                        table->x_1, table->y_1,
+                                        table->x_2, table->y_2);
+
+    case EASING_TABLE_FUNC:
+      return table->func (t, d);
+
+    case EASING_TABLE_SAMPLED:
+      return easing_table_lookup (table->samples, t / d);
+    }
+
+  g_assert_not_reached ();
+
+  return t / d;
+}
+
+/*< private >
+ * clutter_easing_table_evaluate_array:
+ * @table: a #ClutterEasingTable
+ * @t: (array length=n_values): the elapsed times
+ * @d: (array length=n_values): the durations
+ * @res: (array length=n_values): return location for the eased values
+ * @n_values: the number of values
+ *
+ * Evaluates the easing function of @table on each elapsed time and
+ * duration pair, with the same results as clutter_easing_table_evaluate().
+ *
+ * The linear mode is evaluated two values at a time where SSE2 or 64 bit
+ * NEON are available, and so are the sampled tables with SSE2, unless
+ * the compiler could fuse the multiplication and addition of the scalar
+ * interpolation, and give different results.
+ */
+void
+clutter_easing_table_evaluate_array (const ClutterEasingTable *table,
+                                     const double             *t,
+                                     const double             *d,
+                                     double                   *res,
+                                     unsigned int              n_values)
+{
+  unsigned int i = 0;
+
+  switch (table->type)
+    {
+    case EASING_TABLE_LINEAR:
+#if defined(__SSE2__)
+      for (; i + 2 <= n_values; i += 2)
+        _mm_storeu_pd (res + i, _mm_div_pd (_mm_loadu_pd (t + i),
+                                            _mm_loadu_pd (d + i)));
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+      for (; i + 2 <= n_values; i += 2)
+        vst1q_f64 (res + i, vdivq_f64 (vld1q_f64 (t + i),
+                                       vld1q_f64 (d + i)));
+#endif
+      for (; i < n_values; i++)
+        res[i] = t[i] / d[i];
+      return;
+
+    case EASING_TABLE_SAMPLED:
+#if defined(__SSE2__) && !defined(__FMA__)
+      {
+        const float *samples = table->samples;
+        const __m128d zero = _mm_setzero_pd ();
+        const __m128d one = _mm_set1_pd (1.0);
+        const __m128d size = _mm_set1_pd (EASING_TABLE_SIZE);
+
+        for (; i + 2 <= n_values; i += 2)
+          {
+            __m128d x, f, a, b;
+            __m128i idx;
+            int i0, i1;
+
+            x = _mm_div_pd (_mm_loadu_pd (t + i), _mm_loadu_pd (d + i));
+            x = _mm_mul_pd (_mm_min_pd (_mm_max_pd (x, zero), one), size);
+
+            idx = _mm_cvttpd_epi32 (x);
+            f = _mm_sub_pd (x, _mm_cvtepi32_pd (idx));
+
+            i0 = _mm_cvtsi128_si32 (idx);
+            i1 = _mm_cvtsi128_si32 (_mm_shuffle_epi32 (idx, _MM_SHUFFLE (1, 1, 1, 1)));
+
+            a = _mm_set_pd (samples[i1], samples[i0]);
+            b = _mm_set_pd (samples[i1 + 1], samples[i0 + 1]);
+
+            _mm_storeu_pd (res + i, _mm_add_pd (a, _mm_mul_pd (_mm_sub_pd (b, a), f)));
+          }
+      }
+#endif
+      for (; i < n_values; i++)
+        res[i] = easing_table_lookup (table->samples, t[i] / d[i]);
+      return;
+
+    default:
+      break;
+    }
+
+  /* the type is checked once for the whole array */
+  for (i = 0; i < n_values; i++)
+    res[i] = clutter_easing_table_evaluate (table, t[i], d[i]);
+}
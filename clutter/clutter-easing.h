@@ -27,6 +27,39 @@ double                  clutter_easing_for_mode                 (ClutterAnimatio
                                                                  double               t,
                                                                  double               d);
 
+/*< private >
+ * ClutterEasingTable:
+ *
+ * The easing function of an animation mode, including its parameters,
+ * optionally sampled into a table.
+ */
+typedef struct _ClutterEasingTable      ClutterEasingTable;
+
+G_GNUC_INTERNAL
+const ClutterEasingTable *      clutter_easing_table_get_for_mode       (ClutterAnimationMode      mode,
+                                                                         gboolean                  sampled);
+G_GNUC_INTERNAL
+ClutterEasingTable *            clutter_easing_table_new_steps          (int                       n_steps,
+                                                                         ClutterStepMode           step_mode);
+G_GNUC_INTERNAL
+ClutterEasingTable *            clutter_easing_table_new_cubic_bezier   (double                    x_1,
+                                                                         double                    y_1,
+                                                                         double                    x_2,
+                                                                         double                    y_2,
+                                                                         gboolean                  sampled);
+G_GNUC_INTERNAL
+void                            clutter_easing_table_free               (ClutterEasingTable       *table);
+G_GNUC_INTERNAL
+double                          clutter_easing_table_evaluate           (const ClutterEasingTable *table,
+                                                                         double                    t,
+                                                                         double                    d);
+G_GNUC_INTERNAL
+void                            clutter_easing_table_evaluate_array     (const ClutterEasingTable *table,
+                                                                         const double             *t,
+                                                                         const double             *d,
+                                                                         double                   *res,
+                                                                         unsigned int              n_values);
+
 G_GNUC_INTERNAL
 double  clutter_linear                  (double t,
                                          double d);
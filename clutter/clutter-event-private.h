@@ -10,6 +10,8 @@ void            _clutter_event_set_pointer_emulated     (ClutterEvent       *eve
 
 /* Reinjecting queued events for processing */
 void            _clutter_process_event                  (ClutterEvent       *event);
+void            _clutter_pick_queued_events             (ClutterStage       *stage,
+                                                         GList              *events);
 
 gboolean        _clutter_event_process_filters          (ClutterEvent       *event);
 
@@ -0,0 +1,12 @@
+#ifndef __CLUTTER_IMAGE_PRIVATE_H__
+#define __CLUTTER_IMAGE_PRIVATE_H__
+
+#include <clutter/clutter-image.h>
+
+G_BEGIN_DECLS
+
+void    _clutter_image_mark_painted     (ClutterImage *image);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_IMAGE_PRIVATE_H__ */
@@ -33,6 +33,9 @@
  * See [image.c](https://git.gnome.org/browse/clutter/tree/examples/image-content.c?h=clutter-1.18)
  * for an example of how to use #ClutterImage.
  *
+ * Image files can be decoded and uploaded without blocking the main
+ * loop using clutter_image_load_async().
+ *
  * #ClutterImage is available since Clutter 1.10.
  */
 
@@ -42,21 +45,91 @@
 
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 
-#include "clutter-image.h"
+#ifdef HAVE_GDK_PIXBUF
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#endif
+
+#include "clutter-image-private.h"
 
 #include "clutter-actor-private.h"
 #include "clutter-color.h"
 #include "clutter-content-private.h"
 #include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-master-clock.h"
 #include "clutter-paint-node.h"
 #include "clutter-paint-nodes.h"
 #include "clutter-private.h"
 
+/* the time spent uploading decoded images in each frame */
+#define UPLOAD_BUDGET_USEC      (5 * 1000)
+
+/* the amount of pixel data uploaded at a time */
+#define UPLOAD_CHUNK_SIZE       (256 * 1024)
+
+typedef struct _ClutterImageLoad        ClutterImageLoad;
+
 struct _ClutterImagePrivate
 {
   CoglTexture *texture;
+
+  /* the most recent clutter_image_load_async() operation */
+  GTask *load_task;
+
+  /* the file the texture was loaded from, used to load it again
+   * after it has been evicted; NULL if the data was set directly
+   */
+  GFile *source;
+  int source_width;
+  int source_height;
+
+  /* the size of the texture, kept while it is evicted */
+  int width;
+  int height;
+
+  /* the link inside the image cache, while the texture is resident */
+  GList cache_link;
+  gsize texture_size;
+  guint last_paint_frame;
+
+  guint evicted : 1;
 };
 
+struct _ClutterImageLoad
+{
+  GFile *file;
+  int width;
+  int height;
+
+  /* set by the worker thread */
+#ifdef HAVE_GDK_PIXBUF
+  GdkPixbuf *pixbuf;
+#else
+  CoglBitmap *bitmap;
+#endif
+  GError *error;
+
+  /* the texture being uploaded, and the number of rows uploaded */
+  CoglTexture *texture;
+  int n_rows;
+};
+
+static GThreadPool *load_thread_pool = NULL;
+static guint        repaint_upload_func = 0;
+static GList       *upload_list = NULL;
+static GMutex       upload_list_mutex;
+
+/* only accessed by the main thread */
+static GQueue       upload_queue = G_QUEUE_INIT;
+
+/* the images with a resident texture, most recently painted first */
+static GQueue       image_cache = G_QUEUE_INIT;
+static gsize        image_cache_size = 0;
+static guint        image_cache_frame = 0;
+static guint        image_cache_n_evictions = 0;
+static guint        image_cache_n_reloads = 0;
+static guint        repaint_cache_func = 0;
+
 static void clutter_content_iface_init (ClutterContentIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (ClutterImage, clutter_image, G_TYPE_OBJECT,
@@ -71,15 +144,159 @@ clutter_image_error_quark (void)
 }
 
 static void
-clutter_image_finalize (GObject *gobject)
+clutter_image_cache_remove (ClutterImage *image)
 {
-  ClutterImagePrivate *priv = CLUTTER_IMAGE (gobject)->priv;
+  ClutterImagePrivate *priv = image->priv;
 
-  if (priv->texture != NULL)
+  if (priv->cache_link.data == NULL)
+    return;
+
+  g_queue_unlink (&image_cache, &priv->cache_link);
+  priv->cache_link.data = NULL;
+
+  image_cache_size -= priv->texture_size;
+  priv->texture_size = 0;
+}
+
+static gboolean
+clutter_image_repaint_cache_func (gpointer user_data)
+{
+  gsize budget = _clutter_get_image_cache_size ();
+  GList *l;
+
+  image_cache_frame += 1;
+
+  if (budget == 0)
+    return TRUE;
+
+  /* evict the least recently painted textures first, but never the
+   * ones painted by the previous frame, as they are most likely still
+   * visible; the images without a source cannot be loaded again, and
+   * the ones used by mapped actors would be loaded again right away,
+   * so they count towards the budget but are never evicted
+   */
+  l = image_cache.tail;
+  while (l != NULL && image_cache_size > budget)
     {
+      ClutterImage *image = l->data;
+      ClutterImagePrivate *priv = image->priv;
+
+      if (priv->last_paint_frame + 1 >= image_cache_frame)
+        break;
+
+      l = l->prev;
+
+      if (priv->source == NULL)
+        continue;
+
+      /* an image that was not painted recently can still be on a
+       * mapped actor, for instance if it was culled
+       */
+      if (_clutter_content_has_mapped_actors (CLUTTER_CONTENT (image)))
+        continue;
+
+      clutter_image_cache_remove (image);
+
       cogl_object_unref (priv->texture);
       priv->texture = NULL;
+      priv->evicted = TRUE;
+
+      image_cache_n_evictions += 1;
+
+      /* the paint nodes retained by the actors hold a reference on
+       * the texture, so they must be built again
+       */
+      _clutter_content_queue_redraw (CLUTTER_CONTENT (image));
+
+      CLUTTER_NOTE (TEXTURE, "Evicted the texture of <ClutterImage>[%p] "
+                             "(resident: %" G_GSIZE_FORMAT " bytes, budget: "
+                             "%" G_GSIZE_FORMAT " bytes)",
+                    image,
+                    image_cache_size,
+                    budget);
+    }
+
+  return TRUE;
+}
+
+/*
+ * clutter_image_set_texture:
+ * @image: a #ClutterImage
+ * @texture: (transfer full) (allow-none): a #CoglTexture
+ *
+ * Replaces the texture of @image, and accounts for it inside the
+ * image cache.
+ */
+static void
+clutter_image_set_texture (ClutterImage *image,
+                           CoglTexture  *texture)
+{
+  ClutterImagePrivate *priv = image->priv;
+
+  clutter_image_cache_remove (image);
+
+  if (priv->texture != NULL)
+    cogl_object_unref (priv->texture);
+
+  priv->texture = texture;
+  priv->evicted = FALSE;
+
+  if (priv->texture == NULL)
+    return;
+
+  priv->width = cogl_texture_get_width (priv->texture);
+  priv->height = cogl_texture_get_height (priv->texture);
+
+  priv->texture_size = (gsize) priv->width * priv->height * 4;
+  priv->last_paint_frame = image_cache_frame;
+  priv->cache_link.data = image;
+  g_queue_push_head_link (&image_cache, &priv->cache_link);
+
+  image_cache_size += priv->texture_size;
+
+  if (G_UNLIKELY (repaint_cache_func == 0) &&
+      _clutter_get_image_cache_size () != 0)
+    {
+      repaint_cache_func =
+        clutter_threads_add_repaint_func (clutter_image_repaint_cache_func,
+                                          NULL, NULL);
     }
+}
+
+/*< private >
+ * _clutter_image_mark_painted:
+ * @image: a #ClutterImage
+ *
+ * Marks the texture of @image as used by the current frame, so that it
+ * is the last one to be evicted from the image cache.
+ *
+ * This function is called when painting @image, and when replaying the
+ * paint nodes retained for an actor using @image.
+ */
+void
+_clutter_image_mark_painted (ClutterImage *image)
+{
+  ClutterImagePrivate *priv = image->priv;
+
+  if (priv->cache_link.data == NULL)
+    return;
+
+  priv->last_paint_frame = image_cache_frame;
+  if (image_cache.head != &priv->cache_link)
+    {
+      g_queue_unlink (&image_cache, &priv->cache_link);
+      g_queue_push_head_link (&image_cache, &priv->cache_link);
+    }
+}
+
+static void
+clutter_image_finalize (GObject *gobject)
+{
+  ClutterImage *image = CLUTTER_IMAGE (gobject);
+  ClutterImagePrivate *priv = image->priv;
+
+  clutter_image_set_texture (image, NULL);
+  g_clear_object (&priv->source);
 
   G_OBJECT_CLASS (clutter_image_parent_class)->finalize (gobject);
 }
@@ -101,11 +318,30 @@ clutter_image_paint_content (ClutterContent   *content,
                              ClutterActor     *actor,
                              ClutterPaintNode *root)
 {
-  ClutterImagePrivate *priv = CLUTTER_IMAGE (content)->priv;
+  ClutterImage *image = CLUTTER_IMAGE (content);
+  ClutterImagePrivate *priv = image->priv;
   ClutterPaintNode *node;
 
   if (priv->texture == NULL)
-    return;
+    {
+      /* the image becomes visible again after its texture was evicted */
+      if (priv->evicted &&
+          priv->source != NULL &&
+          priv->load_task == NULL)
+        {
+          image_cache_n_reloads += 1;
+
+          clutter_image_load_async (image, priv->source,
+                                    priv->source_width,
+                                    priv->source_height,
+                                    NULL,
+                                    NULL, NULL);
+        }
+
+      return;
+    }
+
+  _clutter_image_mark_painted (image);
 
   node = clutter_actor_create_texture_paint_node (actor, priv->texture);
   clutter_paint_node_set_name (node, "Image Content");
@@ -120,14 +356,15 @@ clutter_image_get_preferred_size (ClutterContent *content,
 {
   ClutterImagePrivate *priv = CLUTTER_IMAGE (content)->priv;
 
-  if (priv->texture == NULL)
+  /* evicted images keep their size until they are loaded again */
+  if (priv->texture == NULL && !priv->evicted)
     return FALSE;
 
   if (width != NULL)
-    *width = cogl_texture_get_width (priv->texture);
+    *width = priv->width;
 
   if (height != NULL)
-    *height = cogl_texture_get_height (priv->texture);
+    *height = priv->height;
 
   return TRUE;
 }
@@ -218,19 +455,21 @@ clutter_image_set_data (ClutterImage     *image,
 
   priv = image->priv;
 
-  if (priv->texture != NULL)
-    cogl_object_unref (priv->texture);
-
   flags = COGL_TEXTURE_NONE;
   if (width >= 512 && height >= 512)
     flags |= COGL_TEXTURE_NO_ATLAS;
 
-  priv->texture = cogl_texture_new_from_data (width, height,
-                                              flags,
-                                              pixel_format,
-                                              COGL_PIXEL_FORMAT_ANY,
-                                              row_stride,
-                                              data);
+  /* a pending load would replace the data set here */
+  priv->load_task = NULL;
+
+  g_clear_object (&priv->source);
+  clutter_image_set_texture (image,
+                             cogl_texture_new_from_data (width, height,
+                                                         flags,
+                                                         pixel_format,
+                                                         COGL_PIXEL_FORMAT_ANY,
+                                                         row_stride,
+                                                         data));
   if (priv->texture == NULL)
     {
       g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
@@ -286,19 +525,21 @@ clutter_image_set_bytes (ClutterImage     *image,
 
   priv = image->priv;
 
-  if (priv->texture != NULL)
-    cogl_object_unref (priv->texture);
-
   flags = COGL_TEXTURE_NONE;
   if (width >= 512 && height >= 512)
     flags |= COGL_TEXTURE_NO_ATLAS;
 
-  priv->texture = cogl_texture_new_from_data (width, height,
-                                              flags,
-                                              pixel_format,
-                                              COGL_PIXEL_FORMAT_ANY,
-                                              row_stride,
-                                              g_bytes_get_data (data, NULL));
+  /* a pending load would replace the data set here */
+  priv->load_task = NULL;
+
+  g_clear_object (&priv->source);
+  clutter_image_set_texture (image,
+                             cogl_texture_new_from_data (width, height,
+                                                         flags,
+                                                         pixel_format,
+                                                         COGL_PIXEL_FORMAT_ANY,
+                                                         row_stride,
+                                                         g_bytes_get_data (data, NULL)));
   if (priv->texture == NULL)
     {
       g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
@@ -357,6 +598,12 @@ clutter_image_set_area (ClutterImage                 *image,
 
   priv = image->priv;
 
+  /* the partial update cannot be replayed after an eviction, and a
+   * pending load would replace it
+   */
+  g_clear_object (&priv->source);
+  priv->load_task = NULL;
+
   if (priv->texture == NULL)
     {
       CoglTextureFlags flags = COGL_TEXTURE_NONE;
@@ -364,13 +611,14 @@ clutter_image_set_area (ClutterImage                 *image,
       if (area->width >= 512 && area->height >= 512)
         flags |= COGL_TEXTURE_NO_ATLAS;
 
-      priv->texture = cogl_texture_new_from_data (area->width,
-                                                  area->height,
-                                                  flags,
-                                                  pixel_format,
-                                                  COGL_PIXEL_FORMAT_ANY,
-                                                  row_stride,
-                                                  data);
+      clutter_image_set_texture (image,
+                                 cogl_texture_new_from_data (area->width,
+                                                             area->height,
+                                                             flags,
+                                                             pixel_format,
+                                                             COGL_PIXEL_FORMAT_ANY,
+                                                             row_stride,
+                                                             data));
     }
   else
     {
@@ -386,10 +634,7 @@ clutter_image_set_area (ClutterImage                 *image,
                                      data);
 
       if (!res)
-        {
-          cogl_object_unref (priv->texture);
-          priv->texture = NULL;
-        }
+        clutter_image_set_texture (image, NULL);
     }
 
   if (priv->texture == NULL)
@@ -405,6 +650,425 @@ clutter_image_set_area (ClutterImage                 *image,
   return TRUE;
 }
 
+static void
+clutter_image_load_free (gpointer data)
+{
+  ClutterImageLoad *load = data;
+
+  g_object_unref (load->file);
+
+#ifdef HAVE_GDK_PIXBUF
+  g_clear_object (&load->pixbuf);
+#else
+  g_clear_pointer (&load->bitmap, cogl_object_unref);
+#endif
+
+  g_clear_pointer (&load->texture, cogl_object_unref);
+
+  if (load->error != NULL)
+    g_error_free (load->error);
+
+  g_slice_free (ClutterImageLoad, load);
+}
+
+/*
+ * clutter_image_load_step:
+ * @task: the #GTask of a clutter_image_load_async() operation
+ *
+ * Uploads the next chunk of the decoded image to the GPU, and
+ * completes @task once the whole image has been uploaded.
+ *
+ * Return value: %TRUE if @task has been completed
+ */
+static gboolean
+clutter_image_load_step (GTask *task)
+{
+  ClutterImage *image = g_task_get_source_object (task);
+  ClutterImageLoad *load = g_task_get_task_data (task);
+  ClutterImagePrivate *priv = image->priv;
+  CoglTextureFlags flags;
+  int width, height;
+
+  if (load->error != NULL)
+    {
+      g_task_return_error (task, load->error);
+      load->error = NULL;
+      goto out;
+    }
+
+  /* a newer load supersedes this one */
+  if (priv->load_task != task)
+    {
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                               _("The image loading was cancelled"));
+      goto out;
+    }
+
+  if (g_task_return_error_if_cancelled (task))
+    goto out;
+
+#ifdef HAVE_GDK_PIXBUF
+  width = gdk_pixbuf_get_width (load->pixbuf);
+  height = gdk_pixbuf_get_height (load->pixbuf);
+#else
+  width = cogl_bitmap_get_width (load->bitmap);
+  height = cogl_bitmap_get_height (load->bitmap);
+#endif
+
+  flags = COGL_TEXTURE_NONE;
+  if (width >= 512 && height >= 512)
+    flags |= COGL_TEXTURE_NO_ATLAS;
+
+#ifdef HAVE_GDK_PIXBUF
+  {
+    CoglPixelFormat pixel_format;
+    int row_stride, n_rows;
+    guint8 *pixels;
+
+    pixel_format = gdk_pixbuf_get_has_alpha (load->pixbuf)
+                 ? COGL_PIXEL_FORMAT_RGBA_8888
+                 : COGL_PIXEL_FORMAT_RGB_888;
+    row_stride = gdk_pixbuf_get_rowstride (load->pixbuf);
+    pixels = gdk_pixbuf_get_pixels (load->pixbuf);
+
+    /* small images are uploaded in one go, so that Cogl can pack
+     * them inside its shared atlas textures
+     */
+    if (load->n_rows == 0 &&
+        flags == COGL_TEXTURE_NONE &&
+        row_stride * height <= UPLOAD_CHUNK_SIZE)
+      {
+        load->texture = cogl_texture_new_from_data (width, height,
+                                                    flags,
+                                                    pixel_format,
+                                                    COGL_PIXEL_FORMAT_ANY,
+                                                    row_stride,
+                                                    pixels);
+        if (load->texture == NULL)
+          {
+            g_task_return_new_error (task, CLUTTER_IMAGE_ERROR,
+                                     CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                                     _("Unable to load image data"));
+            goto out;
+          }
+      }
+    else
+      {
+        if (load->texture == NULL)
+          load->texture = cogl_texture_new_with_size (width, height,
+                                                      flags,
+                                                      pixel_format == COGL_PIXEL_FORMAT_RGB_888
+                                                        ? COGL_PIXEL_FORMAT_RGB_888
+                                                        : COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+
+        n_rows = MIN (MAX (UPLOAD_CHUNK_SIZE / row_stride, 1),
+                      height - load->n_rows);
+
+        if (load->texture == NULL ||
+            !cogl_texture_set_region (load->texture,
+                                      0, 0,
+                                      0, load->n_rows,
+                                      width, n_rows,
+                                      width, n_rows,
+                                      pixel_format,
+                                      row_stride,
+                                      pixels + load->n_rows * row_stride))
+          {
+            g_task_return_new_error (task, CLUTTER_IMAGE_ERROR,
+                                     CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                                     _("Unable to load image data"));
+            goto out;
+          }
+
+        load->n_rows += n_rows;
+        if (load->n_rows < height)
+          return FALSE;
+      }
+  }
+#else
+  load->texture = cogl_texture_new_from_bitmap (load->bitmap,
+                                                flags,
+                                                COGL_PIXEL_FORMAT_ANY);
+  if (load->texture == NULL)
+    {
+      g_task_return_new_error (task, CLUTTER_IMAGE_ERROR,
+                               CLUTTER_IMAGE_ERROR_INVALID_DATA,
+                               _("Unable to load image data"));
+      goto out;
+    }
+#endif
+
+  CLUTTER_NOTE (MISC, "Image of size %d x %d loaded for <ClutterImage>[%p]",
+                width, height,
+                image);
+
+  g_set_object (&priv->source, load->file);
+  priv->source_width = load->width;
+  priv->source_height = load->height;
+
+  clutter_image_set_texture (image, load->texture);
+  load->texture = NULL;
+
+  priv->load_task = NULL;
+
+  clutter_content_invalidate (CLUTTER_CONTENT (image));
+
+  g_task_return_boolean (task, TRUE);
+
+  return TRUE;
+
+out:
+  if (priv->load_task == task)
+    {
+      /* do not try to load an evicted image again if it failed */
+      if (priv->evicted)
+        g_clear_object (&priv->source);
+
+      priv->load_task = NULL;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+clutter_image_repaint_upload_func (gpointer user_data)
+{
+  gint64 start_time;
+
+  g_mutex_lock (&upload_list_mutex);
+
+  while (upload_list != NULL)
+    {
+      g_queue_push_tail (&upload_queue, upload_list->data);
+      upload_list = g_list_delete_link (upload_list, upload_list);
+    }
+
+  g_mutex_unlock (&upload_list_mutex);
+
+  /* keep uploading images as long as we haven't spent more than
+   * our budget during this stage redraw cycle
+   */
+  start_time = g_get_monotonic_time ();
+
+  while (!g_queue_is_empty (&upload_queue) &&
+         g_get_monotonic_time () < start_time + UPLOAD_BUDGET_USEC)
+    {
+      GTask *task = g_queue_peek_head (&upload_queue);
+
+      if (clutter_image_load_step (task))
+        {
+          g_queue_pop_head (&upload_queue);
+          g_object_unref (task);
+        }
+    }
+
+  if (!g_queue_is_empty (&upload_queue))
+    {
+      ClutterMasterClock *master_clock;
+
+      master_clock = _clutter_master_clock_get_default ();
+      _clutter_master_clock_ensure_next_iteration (master_clock);
+    }
+
+  return TRUE;
+}
+
+static void
+clutter_image_thread_load (gpointer data,
+                           gpointer pool_data)
+{
+  GTask *task = data;
+  ClutterImageLoad *load = g_task_get_task_data (task);
+  GCancellable *cancellable = g_task_get_cancellable (task);
+
+  if (!g_cancellable_set_error_if_cancelled (cancellable, &load->error))
+    {
+#ifdef HAVE_GDK_PIXBUF
+      GFileInputStream *stream;
+
+      stream = g_file_read (load->file, cancellable, &load->error);
+      if (stream != NULL)
+        {
+          /* the loaders that support it, like the JPEG one, decode
+           * the image at the requested size directly
+           */
+          load->pixbuf =
+            gdk_pixbuf_new_from_stream_at_scale (G_INPUT_STREAM (stream),
+                                                 load->width,
+                                                 load->height,
+                                                 TRUE,
+                                                 cancellable,
+                                                 &load->error);
+          g_object_unref (stream);
+        }
+#else
+      char *path = g_file_get_path (load->file);
+
+      if (path != NULL)
+        load->bitmap = cogl_bitmap_new_from_file (path, &load->error);
+      else
+        g_set_error (&load->error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                     _("Only local image files can be loaded"));
+
+      g_free (path);
+#endif
+    }
+
+  /* the operation is always completed by the main thread */
+  g_mutex_lock (&upload_list_mutex);
+
+  if (repaint_upload_func == 0)
+    {
+      repaint_upload_func =
+        clutter_threads_add_repaint_func (clutter_image_repaint_upload_func,
+                                          NULL, NULL);
+    }
+
+  upload_list = g_list_append (upload_list, task);
+
+  g_mutex_unlock (&upload_list_mutex);
+
+  _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+}
+
+/**
+ * clutter_image_load_async:
+ * @image: a #ClutterImage
+ * @file: the #GFile to load
+ * @width: the width to scale the image to, or -1
+ * @height: the height to scale the image to, or -1
+ * @cancellable: (allow-none): a #GCancellable, or %NULL
+ * @callback: (scope async): the function to call when the image is loaded
+ * @user_data: data to pass to @callback
+ *
+ * Asynchronously loads the image data of @image from @file.
+ *
+ * The image is decoded in a worker thread; if @width or @height are
+ * not -1, the image is scaled down to fit inside them, preserving its
+ * aspect ratio, while decoding. The decoded image is then uploaded to
+ * the GPU in small chunks across multiple frames, so that loading a
+ * large number of images does not cause the frames to take longer.
+ *
+ * The current image data is displayed until the new one is loaded.
+ * Calling this function again, or cancelling @cancellable, cancels
+ * the loading.
+ *
+ * When the image has been loaded, @image is invalidated and @callback
+ * is called; you should call clutter_image_load_finish() from it to
+ * retrieve the result of the operation.
+ *
+ * If Clutter was built without GDK-Pixbuf, the image is decoded using
+ * Cogl, only local files are supported, and the image is not scaled.
+ *
+ * If the texture memory used by images is limited, using the
+ * `CLUTTER_IMAGE_CACHE_SIZE` environment variable, the image data
+ * loaded by this function is dropped when @image has not been painted
+ * recently, and loaded again from @file once @image is painted.
+ *
+ * Since: 1.26
+ */
+void
+clutter_image_load_async (ClutterImage        *image,
+                          GFile               *file,
+                          int                  width,
+                          int                  height,
+                          GCancellable        *cancellable,
+                          GAsyncReadyCallback  callback,
+                          gpointer             user_data)
+{
+  ClutterImageLoad *load;
+  GTask *task;
+
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+  g_return_if_fail (G_IS_FILE (file));
+  g_return_if_fail (width >= -1 && width != 0);
+  g_return_if_fail (height >= -1 && height != 0);
+
+  task = g_task_new (image, cancellable, callback, user_data);
+  g_task_set_source_tag (task, clutter_image_load_async);
+
+  load = g_slice_new0 (ClutterImageLoad);
+  load->file = g_object_ref (file);
+  load->width = width;
+  load->height = height;
+  g_task_set_task_data (task, load, clutter_image_load_free);
+
+  image->priv->load_task = task;
+
+  if (G_UNLIKELY (load_thread_pool == NULL))
+    {
+      /* This apparently can't fail if exclusive == FALSE */
+      load_thread_pool =
+        g_thread_pool_new (clutter_image_thread_load, NULL,
+                           CLAMP (g_get_num_processors () - 1, 1, 4),
+                           FALSE,
+                           NULL);
+    }
+
+  /* the reference on the task is released once it's completed */
+  g_thread_pool_push (load_thread_pool, task, NULL);
+}
+
+/**
+ * clutter_image_load_finish:
+ * @image: a #ClutterImage
+ * @result: the #GAsyncResult passed to the callback
+ * @error: return location for a #GError, or %NULL
+ *
+ * Finishes an operation started by clutter_image_load_async().
+ *
+ * Return value: %TRUE if the image data was successfully loaded,
+ *   and %FALSE otherwise
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_image_load_finish (ClutterImage  *image,
+                           GAsyncResult  *result,
+                           GError       **error)
+{
+  g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
+  g_return_val_if_fail (g_task_is_valid (result, image), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * clutter_image_get_cache_stats:
+ * @n_resident: (out) (optional): return location for the number of
+ *   images with a texture in texture memory
+ * @resident_bytes: (out) (optional): return location for the memory
+ *   used by the textures of the images
+ * @n_evictions: (out) (optional): return location for the number of
+ *   textures evicted to stay within the budget
+ * @n_reloads: (out) (optional): return location for the number of
+ *   evicted images that were loaded again
+ *
+ * Retrieves the statistics of the cache shared by all the #ClutterImage
+ * instances, whose budget is set using the `CLUTTER_IMAGE_CACHE_SIZE`
+ * environment variable.
+ *
+ * Since: 1.26
+ */
+void
+clutter_image_get_cache_stats (guint *n_resident,
+                               gsize *resident_bytes,
+                               guint *n_evictions,
+                               guint *n_reloads)
+{
+  if (n_resident != NULL)
+    *n_resident = g_queue_get_length (&image_cache);
+
+  if (resident_bytes != NULL)
+    *resident_bytes = image_cache_size;
+
+  if (n_evictions != NULL)
+    *n_evictions = image_cache_n_evictions;
+
+  if (n_reloads != NULL)
+    *n_reloads = image_cache_n_reloads;
+}
+
 /**
  * clutter_image_get_texture:
  * @image: a #ClutterImage
@@ -29,6 +29,7 @@
 #error "Only <clutter/clutter.h> can be included directly."
 #endif
 
+#include <gio/gio.h>
 #include <cogl/cogl.h>
 #include <clutter/clutter-types.h>
 
@@ -131,6 +132,25 @@ gboolean                clutter_image_set_bytes         (ClutterImage
                                                          guint                         row_stride,
                                                          GError                      **error);
 
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_image_load_async        (ClutterImage                 *image,
+                                                         GFile                        *file,
+                                                         int                           width,
+                                                         int                           height,
+                                                         GCancellable                 *cancellable,
+                                                         GAsyncReadyCallback           callback,
+                                                         gpointer                      user_data);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean                clutter_image_load_finish       (ClutterImage                 *image,
+                                                         GAsyncResult                 *result,
+                                                         GError                      **error);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_image_get_cache_stats   (guint                        *n_resident,
+                                                         gsize                        *resident_bytes,
+                                                         guint                        *n_evictions,
+                                                         guint                        *n_reloads);
+
 #if defined(COGL_ENABLE_EXPERIMENTAL_API) && defined(CLUTTER_ENABLE_EXPERIMENTAL_API)
 CLUTTER_AVAILABLE_IN_1_10
 CoglTexture *           clutter_image_get_texture       (ClutterImage                 *image);
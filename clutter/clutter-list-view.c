@@ -0,0 +1,1218 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2016  Intel Corporation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-list-view
+ * @Title: ClutterListView
+ * @Short_Description: An actor displaying the visible items of a list
+ *
+ * #ClutterListView is an actor that displays the items of a #GListModel
+ * as a scrollable list of actors.
+ *
+ * Unlike a #ClutterScrollActor, which scrolls a fully populated tree of
+ * children, #ClutterListView only creates actors for the items inside
+ * the visible portion of the list, plus a number of items on each side
+ * controlled by the #ClutterListView:overscan property. Actors that are
+ * scrolled out of view are recycled for the items that are scrolled in,
+ * so the number of actors, and the cost of laying them out and painting
+ * them, depends on the size of the view, not on the size of the model.
+ *
+ * The actors are created by a #ClutterListViewCreateFunc, and they are
+ * bound to an item by a #ClutterListViewBindFunc; both functions are set
+ * using clutter_list_view_set_model().
+ *
+ * Since the size of the items that have never been displayed is not
+ * known, the position of the items and the total extent of the list
+ * are estimated from the average size of the items displayed so far,
+ * or from the #ClutterListView:estimated-item-size property.
+ *
+ * #ClutterListView does not provide pointer or keyboard event handling,
+ * nor does it provide visible scroll handles; the visible portion of
+ * the list is controlled by the #ClutterListView:scroll-offset property.
+ *
+ * #ClutterListView is available since Clutter 1.26.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+
+#include "clutter-list-view.h"
+
+#include "clutter-actor-private.h"
+#include "clutter-debug.h"
+#include "clutter-enum-types.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+
+#define DEFAULT_ESTIMATED_ITEM_SIZE     32.f
+#define DEFAULT_OVERSCAN                4
+
+struct _ClutterListViewPrivate
+{
+  GListModel *model;
+  ClutterListViewCreateFunc create_func;
+  ClutterListViewBindFunc bind_func;
+  gpointer func_data;
+  GDestroyNotify func_notify;
+
+  ClutterOrientation orientation;
+  guint overscan;
+  gfloat estimated_item_size;
+  gfloat scroll_offset;
+  gfloat estimated_extent;
+
+  /* the sum of the sizes of the items bound so far, used to
+   * estimate the size of the items that were never bound
+   */
+  gdouble measured_size;
+  guint n_measured;
+
+  /* the actors bound to the items starting at first_item */
+  GPtrArray *items;
+  guint first_item;
+
+  /* the first item whose actor is bound to a position changed by
+   * the model, or G_MAXUINT
+   */
+  guint stale_item;
+
+  /* the first visible item, and its estimated offset */
+  guint anchor_item;
+  gfloat anchor_offset;
+
+  /* hidden actors waiting to be bound to a new item */
+  GPtrArray *pool;
+
+  /* the size of the allocation, along and across the
+   * orientation of the view
+   */
+  gfloat viewport_size;
+  gfloat cross_size;
+
+  guint update_id;
+};
+
+enum
+{
+  PROP_0,
+
+  PROP_MODEL,
+  PROP_ORIENTATION,
+  PROP_OVERSCAN,
+  PROP_ESTIMATED_ITEM_SIZE,
+  PROP_SCROLL_OFFSET,
+  PROP_ESTIMATED_EXTENT,
+
+  PROP_LAST
+};
+
+static GParamSpec *obj_props[PROP_LAST] = { NULL, };
+
+G_DEFINE_TYPE_WITH_PRIVATE (ClutterListView, clutter_list_view, CLUTTER_TYPE_ACTOR)
+
+static inline gfloat
+clutter_list_view_get_item_size (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  if (priv->n_measured > 0)
+    return priv->measured_size / priv->n_measured;
+
+  return priv->estimated_item_size;
+}
+
+static gfloat
+clutter_list_view_measure_item (ClutterListView *self,
+                                ClutterActor    *item)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  gfloat for_size = priv->cross_size > 0.f ? priv->cross_size : -1.f;
+  gfloat size;
+
+  if (priv->orientation == CLUTTER_ORIENTATION_VERTICAL)
+    clutter_actor_get_preferred_height (item, for_size, NULL, &size);
+  else
+    clutter_actor_get_preferred_width (item, for_size, NULL, &size);
+
+  return size;
+}
+
+static void
+clutter_list_view_update_extent (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  gfloat extent = 0.f;
+
+  if (priv->model != NULL)
+    extent = g_list_model_get_n_items (priv->model)
+           * clutter_list_view_get_item_size (self);
+
+  if (priv->estimated_extent == extent)
+    return;
+
+  priv->estimated_extent = extent;
+
+  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_ESTIMATED_EXTENT]);
+}
+
+static ClutterActor *
+clutter_list_view_acquire_item (ClutterListView *self,
+                                guint            position)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  ClutterActor *item;
+  gpointer model_item;
+
+  if (priv->pool->len > 0)
+    {
+      item = g_ptr_array_index (priv->pool, priv->pool->len - 1);
+      g_ptr_array_remove_index_fast (priv->pool, priv->pool->len - 1);
+
+      clutter_actor_show (item);
+    }
+  else
+    {
+      item = priv->create_func (self, priv->func_data);
+      g_assert (CLUTTER_IS_ACTOR (item));
+
+      clutter_actor_add_child (CLUTTER_ACTOR (self), item);
+    }
+
+  model_item = g_list_model_get_item (priv->model, position);
+
+  if (priv->bind_func != NULL)
+    priv->bind_func (self, item, model_item, position, priv->func_data);
+
+  if (model_item != NULL)
+    g_object_unref (model_item);
+
+  priv->measured_size += clutter_list_view_measure_item (self, item);
+  priv->n_measured += 1;
+
+  return item;
+}
+
+static void
+clutter_list_view_recycle_item (ClutterListView *self,
+                                ClutterActor    *item,
+                                guint            max_pool_size)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  if (priv->pool->len >= max_pool_size)
+    {
+      clutter_actor_destroy (item);
+      return;
+    }
+
+  clutter_actor_hide (item);
+  g_ptr_array_add (priv->pool, item);
+}
+
+/* recycles the items bound to the positions starting at @position */
+static void
+clutter_list_view_recycle_items_from (ClutterListView *self,
+                                      guint            position)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  guint max_pool_size = priv->pool->len + priv->items->len;
+  guint i;
+
+  if (position < priv->first_item)
+    position = priv->first_item;
+
+  if (position >= priv->first_item + priv->items->len)
+    return;
+
+  for (i = position - priv->first_item; i < priv->items->len; i++)
+    clutter_list_view_recycle_item (self,
+                                    g_ptr_array_index (priv->items, i),
+                                    max_pool_size);
+
+  g_ptr_array_set_size (priv->items, position - priv->first_item);
+}
+
+/*< private >
+ * clutter_list_view_update_items:
+ * @self: a #ClutterListView
+ *
+ * Binds actors to the items that are visible given the current scroll
+ * offset and the size of the view, plus the overscan on both sides,
+ * and recycles the actors bound to any other item.
+ */
+static void
+clutter_list_view_update_items (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  GPtrArray *old_items, *new_items;
+  guint old_first, new_first, max_pool_size;
+  guint n_items, anchor, n_after, pos, i;
+  gfloat item_size, covered, needed;
+
+  if (priv->model == NULL || priv->create_func == NULL)
+    return;
+
+  n_items = g_list_model_get_n_items (priv->model);
+  item_size = clutter_list_view_get_item_size (self);
+
+  /* the model changed since the last update */
+  if (priv->stale_item != G_MAXUINT)
+    {
+      clutter_list_view_recycle_items_from (self, priv->stale_item);
+      priv->stale_item = G_MAXUINT;
+    }
+
+  old_items = priv->items;
+  old_first = priv->first_item;
+  max_pool_size = priv->pool->len + old_items->len;
+
+  if (n_items == 0)
+    {
+      clutter_list_view_recycle_items_from (self, 0);
+      priv->first_item = priv->anchor_item = 0;
+      priv->anchor_offset = 0.f;
+      clutter_list_view_update_extent (self);
+      return;
+    }
+
+  anchor = MIN (floorf (priv->scroll_offset / item_size), (gfloat) (n_items - 1));
+  new_first = anchor - MIN (anchor, priv->overscan);
+
+  /* the items before the new range can be recycled right away, so
+   * that their actors can be bound to the newly visible items
+   */
+  for (i = 0; i < old_items->len && old_first + i < new_first; i++)
+    {
+      clutter_list_view_recycle_item (self,
+                                      g_ptr_array_index (old_items, i),
+                                      max_pool_size);
+      g_ptr_array_index (old_items, i) = NULL;
+    }
+
+  new_items = g_ptr_array_sized_new (old_items->len);
+
+  /* the part of the anchor item above the viewport, plus the viewport */
+  needed = priv->viewport_size + priv->scroll_offset - anchor * item_size;
+  covered = 0.f;
+  n_after = 0;
+
+  for (pos = new_first; pos < n_items; pos++)
+    {
+      ClutterActor *item;
+
+      if (pos > anchor && covered >= needed)
+        {
+          if (n_after == priv->overscan)
+            break;
+
+          n_after += 1;
+        }
+
+      if (pos >= old_first && pos < old_first + old_items->len)
+        {
+          item = g_ptr_array_index (old_items, pos - old_first);
+          g_ptr_array_index (old_items, pos - old_first) = NULL;
+        }
+      else
+        item = clutter_list_view_acquire_item (self, pos);
+
+      g_ptr_array_add (new_items, item);
+
+      if (pos >= anchor)
+        covered += clutter_list_view_measure_item (self, item);
+    }
+
+  for (i = 0; i < old_items->len; i++)
+    {
+      ClutterActor *item = g_ptr_array_index (old_items, i);
+
+      if (item != NULL)
+        clutter_list_view_recycle_item (self, item, max_pool_size);
+    }
+
+  g_ptr_array_unref (old_items);
+
+  priv->items = new_items;
+  priv->first_item = new_first;
+  priv->anchor_item = anchor;
+  priv->anchor_offset = anchor * item_size;
+
+  CLUTTER_NOTE (ACTOR, "List view '%s': items %u-%u of %u (%u pooled)",
+                _clutter_actor_get_debug_name (CLUTTER_ACTOR (self)),
+                new_first, new_first + new_items->len,
+                n_items,
+                priv->pool->len);
+
+  clutter_list_view_update_extent (self);
+
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+}
+
+static gboolean
+clutter_list_view_update_func (gpointer data)
+{
+  ClutterListView *self = data;
+
+  self->priv->update_id = 0;
+
+  clutter_list_view_update_items (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* actors cannot be added or removed while the view is being
+ * allocated, so we defer the update to the next frame
+ */
+static void
+clutter_list_view_queue_update (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  if (priv->update_id != 0)
+    return;
+
+  priv->update_id =
+    clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT |
+                                           CLUTTER_REPAINT_FLAGS_QUEUE_REDRAW_ON_ADD,
+                                           clutter_list_view_update_func,
+                                           self,
+                                           NULL);
+}
+
+static void
+clutter_list_view_items_changed (GListModel      *model,
+                                 guint            position,
+                                 guint            removed,
+                                 guint            added,
+                                 ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  /* the actors bound to the items after the change are stale; the
+   * model can change while the view, or one of its ancestors, is
+   * being allocated, so the actors are recycled, and possibly
+   * destroyed, by the next update, like the newly visible items
+   */
+  priv->stale_item = MIN (priv->stale_item, position);
+
+  clutter_list_view_queue_update (self);
+}
+
+static void
+clutter_list_view_reset (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  clutter_list_view_recycle_items_from (self, 0);
+
+  priv->first_item = priv->anchor_item = 0;
+  priv->stale_item = G_MAXUINT;
+  priv->anchor_offset = 0.f;
+  priv->measured_size = 0.0;
+  priv->n_measured = 0;
+}
+
+static void
+clutter_list_view_allocate (ClutterActor           *actor,
+                            const ClutterActorBox  *box,
+                            ClutterAllocationFlags  flags)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (actor);
+  ClutterListViewPrivate *priv = self->priv;
+  gboolean vertical = priv->orientation == CLUTTER_ORIENTATION_VERTICAL;
+  gfloat viewport_size, cross_size, pos, end;
+  guint anchor_idx, n_items, i;
+
+  clutter_actor_set_allocation (actor, box, flags);
+
+  viewport_size = vertical ? clutter_actor_box_get_height (box)
+                           : clutter_actor_box_get_width (box);
+  cross_size = vertical ? clutter_actor_box_get_width (box)
+                        : clutter_actor_box_get_height (box);
+
+  if (viewport_size != priv->viewport_size ||
+      cross_size != priv->cross_size)
+    {
+      priv->viewport_size = viewport_size;
+      priv->cross_size = cross_size;
+
+      clutter_list_view_queue_update (self);
+    }
+
+  if (priv->items->len == 0)
+    return;
+
+  anchor_idx = MIN (priv->anchor_item - priv->first_item, priv->items->len - 1);
+
+  /* lay out the items after the anchor, then the ones before it */
+  pos = priv->anchor_offset - priv->scroll_offset;
+  for (i = anchor_idx; i < priv->items->len; i++)
+    {
+      ClutterActor *item = g_ptr_array_index (priv->items, i);
+      gfloat size = clutter_list_view_measure_item (self, item);
+      ClutterActorBox child_box;
+
+      if (vertical)
+        clutter_actor_box_init (&child_box, 0.f, pos, cross_size, pos + size);
+      else
+        clutter_actor_box_init (&child_box, pos, 0.f, pos + size, cross_size);
+
+      clutter_actor_allocate (item, &child_box, flags);
+
+      pos += size;
+    }
+
+  end = pos;
+
+  pos = priv->anchor_offset - priv->scroll_offset;
+  for (i = anchor_idx; i > 0; i--)
+    {
+      ClutterActor *item = g_ptr_array_index (priv->items, i - 1);
+      gfloat size = clutter_list_view_measure_item (self, item);
+      ClutterActorBox child_box;
+
+      pos -= size;
+
+      if (vertical)
+        clutter_actor_box_init (&child_box, 0.f, pos, cross_size, pos + size);
+      else
+        clutter_actor_box_init (&child_box, pos, 0.f, pos + size, cross_size);
+
+      clutter_actor_allocate (item, &child_box, flags);
+    }
+
+  /* the items turned out to be smaller than estimated */
+  n_items = priv->model != NULL ? g_list_model_get_n_items (priv->model) : 0;
+  if (end < viewport_size && priv->first_item + priv->items->len < n_items)
+    clutter_list_view_queue_update (self);
+}
+
+static void
+clutter_list_view_get_cross_size (ClutterListView *self,
+                                  gfloat          *min_size_p,
+                                  gfloat          *nat_size_p)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  gfloat min_size = 0.f, nat_size = 0.f;
+  guint i;
+
+  for (i = 0; i < priv->items->len; i++)
+    {
+      ClutterActor *item = g_ptr_array_index (priv->items, i);
+      gfloat child_min, child_nat;
+
+      if (priv->orientation == CLUTTER_ORIENTATION_VERTICAL)
+        clutter_actor_get_preferred_width (item, -1, &child_min, &child_nat);
+      else
+        clutter_actor_get_preferred_height (item, -1, &child_min, &child_nat);
+
+      min_size = MAX (min_size, child_min);
+      nat_size = MAX (nat_size, child_nat);
+    }
+
+  if (min_size_p != NULL)
+    *min_size_p = min_size;
+
+  if (nat_size_p != NULL)
+    *nat_size_p = nat_size;
+}
+
+static void
+clutter_list_view_get_preferred_width (ClutterActor *actor,
+                                       gfloat        for_height,
+                                       gfloat       *min_width_p,
+                                       gfloat       *nat_width_p)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (actor);
+
+  if (self->priv->orientation == CLUTTER_ORIENTATION_VERTICAL)
+    {
+      clutter_list_view_get_cross_size (self, min_width_p, nat_width_p);
+      return;
+    }
+
+  if (min_width_p != NULL)
+    *min_width_p = 0.f;
+
+  if (nat_width_p != NULL)
+    *nat_width_p = self->priv->estimated_extent;
+}
+
+static void
+clutter_list_view_get_preferred_height (ClutterActor *actor,
+                                        gfloat        for_width,
+                                        gfloat       *min_height_p,
+                                        gfloat       *nat_height_p)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (actor);
+
+  if (self->priv->orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    {
+      clutter_list_view_get_cross_size (self, min_height_p, nat_height_p);
+      return;
+    }
+
+  if (min_height_p != NULL)
+    *min_height_p = 0.f;
+
+  if (nat_height_p != NULL)
+    *nat_height_p = self->priv->estimated_extent;
+}
+
+static void
+clutter_list_view_set_property (GObject      *gobject,
+                                guint         prop_id,
+                                const GValue *value,
+                                GParamSpec   *pspec)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_ORIENTATION:
+      clutter_list_view_set_orientation (self, g_value_get_enum (value));
+      break;
+
+    case PROP_OVERSCAN:
+      clutter_list_view_set_overscan (self, g_value_get_uint (value));
+      break;
+
+    case PROP_ESTIMATED_ITEM_SIZE:
+      clutter_list_view_set_estimated_item_size (self, g_value_get_float (value));
+      break;
+
+    case PROP_SCROLL_OFFSET:
+      clutter_list_view_set_scroll_offset (self, g_value_get_float (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+clutter_list_view_get_property (GObject    *gobject,
+                                guint       prop_id,
+                                GValue     *value,
+                                GParamSpec *pspec)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (gobject)->priv;
+
+  switch (prop_id)
+    {
+    case PROP_MODEL:
+      g_value_set_object (value, priv->model);
+      break;
+
+    case PROP_ORIENTATION:
+      g_value_set_enum (value, priv->orientation);
+      break;
+
+    case PROP_OVERSCAN:
+      g_value_set_uint (value, priv->overscan);
+      break;
+
+    case PROP_ESTIMATED_ITEM_SIZE:
+      g_value_set_float (value, priv->estimated_item_size);
+      break;
+
+    case PROP_SCROLL_OFFSET:
+      g_value_set_float (value, priv->scroll_offset);
+      break;
+
+    case PROP_ESTIMATED_EXTENT:
+      g_value_set_float (value, priv->estimated_extent);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+clutter_list_view_dispose (GObject *gobject)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (gobject)->priv;
+
+  if (priv->update_id != 0)
+    {
+      clutter_threads_remove_repaint_func (priv->update_id);
+      priv->update_id = 0;
+    }
+
+  if (priv->model != NULL)
+    {
+      g_signal_handlers_disconnect_by_func (priv->model,
+                                            clutter_list_view_items_changed,
+                                            gobject);
+      g_clear_object (&priv->model);
+    }
+
+  if (priv->func_notify != NULL)
+    priv->func_notify (priv->func_data);
+
+  priv->create_func = NULL;
+  priv->bind_func = NULL;
+  priv->func_data = NULL;
+  priv->func_notify = NULL;
+
+  /* the actors are children of the view, and they are going to
+   * be destroyed when chaining up
+   */
+  g_ptr_array_set_size (priv->items, 0);
+  g_ptr_array_set_size (priv->pool, 0);
+
+  G_OBJECT_CLASS (clutter_list_view_parent_class)->dispose (gobject);
+}
+
+static void
+clutter_list_view_finalize (GObject *gobject)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (gobject)->priv;
+
+  g_ptr_array_unref (priv->items);
+  g_ptr_array_unref (priv->pool);
+
+  G_OBJECT_CLASS (clutter_list_view_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_list_view_class_init (ClutterListViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterActorClass *actor_class = CLUTTER_ACTOR_CLASS (klass);
+
+  gobject_class->set_property = clutter_list_view_set_property;
+  gobject_class->get_property = clutter_list_view_get_property;
+  gobject_class->dispose = clutter_list_view_dispose;
+  gobject_class->finalize = clutter_list_view_finalize;
+
+  actor_class->get_preferred_width = clutter_list_view_get_preferred_width;
+  actor_class->get_preferred_height = clutter_list_view_get_preferred_height;
+  actor_class->allocate = clutter_list_view_allocate;
+
+  /**
+   * ClutterListView:model:
+   *
+   * The #GListModel holding the items displayed by the view.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_MODEL] =
+    g_param_spec_object ("model",
+                         P_("Model"),
+                         P_("The model of the items"),
+                         G_TYPE_LIST_MODEL,
+                         G_PARAM_READABLE |
+                         G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterListView:orientation:
+   *
+   * The direction along which the items are laid out.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_ORIENTATION] =
+    g_param_spec_enum ("orientation",
+                       P_("Orientation"),
+                       P_("The orientation of the list"),
+                       CLUTTER_TYPE_ORIENTATION,
+                       CLUTTER_ORIENTATION_VERTICAL,
+                       G_PARAM_READWRITE |
+                       G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterListView:overscan:
+   *
+   * The number of items bound on each side of the visible portion
+   * of the list, so that they are ready to be displayed when
+   * scrolling.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_OVERSCAN] =
+    g_param_spec_uint ("overscan",
+                       P_("Overscan"),
+                       P_("The number of items outside of the visible area"),
+                       0, G_MAXUINT,
+                       DEFAULT_OVERSCAN,
+                       G_PARAM_READWRITE |
+                       G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterListView:estimated-item-size:
+   *
+   * The size of an item along the orientation of the view, used
+   * until the size of at least one item is known.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_ESTIMATED_ITEM_SIZE] =
+    g_param_spec_float ("estimated-item-size",
+                        P_("Estimated Item Size"),
+                        P_("The estimated size of an item"),
+                        1.f, G_MAXFLOAT,
+                        DEFAULT_ESTIMATED_ITEM_SIZE,
+                        G_PARAM_READWRITE |
+                        G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterListView:scroll-offset:
+   *
+   * The offset of the visible portion of the list, along the
+   * orientation of the view.
+   *
+   * The offset is clamped between 0 and the difference between
+   * the #ClutterListView:estimated-extent and the size of the view.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_SCROLL_OFFSET] =
+    g_param_spec_float ("scroll-offset",
+                        P_("Scroll Offset"),
+                        P_("The offset of the visible area"),
+                        0.f, G_MAXFLOAT,
+                        0.f,
+                        G_PARAM_READWRITE |
+                        G_PARAM_STATIC_STRINGS |
+                        CLUTTER_PARAM_ANIMATABLE);
+
+  /**
+   * ClutterListView:estimated-extent:
+   *
+   * The estimated size of the whole list, along the orientation
+   * of the view.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_ESTIMATED_EXTENT] =
+    g_param_spec_float ("estimated-extent",
+                        P_("Estimated Extent"),
+                        P_("The estimated size of the list"),
+                        0.f, G_MAXFLOAT,
+                        0.f,
+                        G_PARAM_READABLE |
+                        G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
+}
+
+static void
+clutter_list_view_init (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv;
+
+  self->priv = priv = clutter_list_view_get_instance_private (self);
+
+  priv->orientation = CLUTTER_ORIENTATION_VERTICAL;
+  priv->overscan = DEFAULT_OVERSCAN;
+  priv->estimated_item_size = DEFAULT_ESTIMATED_ITEM_SIZE;
+
+  priv->items = g_ptr_array_new ();
+  priv->pool = g_ptr_array_new ();
+  priv->stale_item = G_MAXUINT;
+
+  clutter_actor_set_clip_to_allocation (CLUTTER_ACTOR (self), TRUE);
+}
+
+/**
+ * clutter_list_view_new:
+ *
+ * Creates a new #ClutterListView.
+ *
+ * Return value: The newly created #ClutterListView
+ *   instance.
+ *
+ * Since: 1.26
+ */
+ClutterActor *
+clutter_list_view_new (void)
+{
+  return g_object_new (CLUTTER_TYPE_LIST_VIEW, NULL);
+}
+
+/**
+ * clutter_list_view_set_model:
+ * @view: a #ClutterListView
+ * @model: (allow-none): a #GListModel
+ * @create_func: (allow-none): a function creating the actors for the items
+ * @bind_func: (allow-none): a function binding an actor to an item
+ * @user_data: data passed to @create_func and @bind_func
+ * @notify: function called when unsetting the model
+ *
+ * Sets the model of the items displayed by @view, and the functions
+ * used to create the actors displaying the items.
+ *
+ * Any actor previously created by @view is destroyed.
+ *
+ * Since: 1.26
+ */
+void
+clutter_list_view_set_model (ClutterListView           *view,
+                             GListModel                *model,
+                             ClutterListViewCreateFunc  create_func,
+                             ClutterListViewBindFunc    bind_func,
+                             gpointer                   user_data,
+                             GDestroyNotify             notify)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
+  g_return_if_fail (model == NULL || create_func != NULL);
+
+  priv = view->priv;
+
+  if (model != NULL)
+    g_object_ref (model);
+
+  if (priv->model != NULL)
+    {
+      g_signal_handlers_disconnect_by_func (priv->model,
+                                            clutter_list_view_items_changed,
+                                            view);
+      g_clear_object (&priv->model);
+    }
+
+  if (priv->func_notify != NULL)
+    priv->func_notify (priv->func_data);
+
+  /* the actors created for the old model cannot be reused */
+  g_ptr_array_set_size (priv->items, 0);
+  g_ptr_array_set_size (priv->pool, 0);
+  clutter_actor_destroy_all_children (CLUTTER_ACTOR (view));
+
+  clutter_list_view_reset (view);
+
+  priv->create_func = create_func;
+  priv->bind_func = bind_func;
+  priv->func_data = user_data;
+  priv->func_notify = notify;
+
+  if (model != NULL)
+    {
+      priv->model = model;
+      g_signal_connect (priv->model, "items-changed",
+                        G_CALLBACK (clutter_list_view_items_changed),
+                        view);
+    }
+
+  clutter_list_view_update_items (view);
+  clutter_list_view_update_extent (view);
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_MODEL]);
+}
+
+/**
+ * clutter_list_view_get_model:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the model set using clutter_list_view_set_model().
+ *
+ * Return value: (transfer none): a #GListModel, or %NULL
+ *
+ * Since: 1.26
+ */
+GListModel *
+clutter_list_view_get_model (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), NULL);
+
+  return view->priv->model;
+}
+
+/**
+ * clutter_list_view_set_orientation:
+ * @view: a #ClutterListView
+ * @orientation: the orientation of the list
+ *
+ * Sets the #ClutterListView:orientation property.
+ *
+ * Since: 1.26
+ */
+void
+clutter_list_view_set_orientation (ClutterListView    *view,
+                                   ClutterOrientation  orientation)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+
+  priv = view->priv;
+
+  if (priv->orientation == orientation)
+    return;
+
+  priv->orientation = orientation;
+
+  /* the measured sizes are along the old orientation */
+  clutter_list_view_reset (view);
+  clutter_list_view_update_items (view);
+  clutter_list_view_update_extent (view);
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_ORIENTATION]);
+}
+
+/**
+ * clutter_list_view_get_orientation:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the #ClutterListView:orientation property.
+ *
+ * Return value: the orientation of the list
+ *
+ * Since: 1.26
+ */
+ClutterOrientation
+clutter_list_view_get_orientation (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view),
+                        CLUTTER_ORIENTATION_VERTICAL);
+
+  return view->priv->orientation;
+}
+
+/**
+ * clutter_list_view_set_overscan:
+ * @view: a #ClutterListView
+ * @n_items: the number of items on each side of the visible area
+ *
+ * Sets the #ClutterListView:overscan property.
+ *
+ * Since: 1.26
+ */
+void
+clutter_list_view_set_overscan (ClutterListView *view,
+                                guint            n_items)
+{
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+
+  if (view->priv->overscan == n_items)
+    return;
+
+  view->priv->overscan = n_items;
+
+  clutter_list_view_update_items (view);
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_OVERSCAN]);
+}
+
+/**
+ * clutter_list_view_get_overscan:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the #ClutterListView:overscan property.
+ *
+ * Return value: the number of items on each side of the visible area
+ *
+ * Since: 1.26
+ */
+guint
+clutter_list_view_get_overscan (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), 0);
+
+  return view->priv->overscan;
+}
+
+/**
+ * clutter_list_view_set_estimated_item_size:
+ * @view: a #ClutterListView
+ * @size: the estimated size of an item, in pixels
+ *
+ * Sets the #ClutterListView:estimated-item-size property.
+ *
+ * Since: 1.26
+ */
+void
+clutter_list_view_set_estimated_item_size (ClutterListView *view,
+                                           gfloat           size)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (size >= 1.f);
+
+  priv = view->priv;
+
+  if (priv->estimated_item_size == size)
+    return;
+
+  priv->estimated_item_size = size;
+
+  if (priv->n_measured == 0)
+    {
+      clutter_list_view_update_items (view);
+      clutter_list_view_update_extent (view);
+    }
+
+  g_object_notify_by_pspec (G_OBJECT (view),
+                            obj_props[PROP_ESTIMATED_ITEM_SIZE]);
+}
+
+/**
+ * clutter_list_view_get_estimated_item_size:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the #ClutterListView:estimated-item-size property.
+ *
+ * Return value: the estimated size of an item
+ *
+ * Since: 1.26
+ */
+gfloat
+clutter_list_view_get_estimated_item_size (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), 0.f);
+
+  return view->priv->estimated_item_size;
+}
+
+/**
+ * clutter_list_view_set_scroll_offset:
+ * @view: a #ClutterListView
+ * @offset: the offset of the visible area
+ *
+ * Scrolls @view so that the visible portion of the list starts
+ * at @offset.
+ *
+ * Since: 1.26
+ */
+void
+clutter_list_view_set_scroll_offset (ClutterListView *view,
+                                     gfloat           offset)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+
+  priv = view->priv;
+
+  offset = CLAMP (offset, 0.f,
+                  MAX (0.f, priv->estimated_extent - priv->viewport_size));
+
+  if (priv->scroll_offset == offset)
+    return;
+
+  priv->scroll_offset = offset;
+
+  if (CLUTTER_ACTOR_IN_RELAYOUT (view))
+    clutter_list_view_queue_update (view);
+  else
+    clutter_list_view_update_items (view);
+
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_SCROLL_OFFSET]);
+}
+
+/**
+ * clutter_list_view_get_scroll_offset:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the #ClutterListView:scroll-offset property.
+ *
+ * Return value: the offset of the visible area
+ *
+ * Since: 1.26
+ */
+gfloat
+clutter_list_view_get_scroll_offset (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), 0.f);
+
+  return view->priv->scroll_offset;
+}
+
+/**
+ * clutter_list_view_get_estimated_extent:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the #ClutterListView:estimated-extent property.
+ *
+ * Return value: the estimated size of the whole list
+ *
+ * Since: 1.26
+ */
+gfloat
+clutter_list_view_get_estimated_extent (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), 0.f);
+
+  return view->priv->estimated_extent;
+}
+
+/**
+ * clutter_list_view_scroll_to_item:
+ * @view: a #ClutterListView
+ * @position: the position of an item of the model
+ *
+ * Scrolls @view so that the item at @position is at the start
+ * of the visible area.
+ *
+ * Since: 1.26
+ */
+void
+clutter_list_view_scroll_to_item (ClutterListView *view,
+                                  guint            position)
+{
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+
+  clutter_list_view_set_scroll_offset (view,
+                                       position * clutter_list_view_get_item_size (view));
+}
+
+/**
+ * clutter_list_view_get_item_actor:
+ * @view: a #ClutterListView
+ * @position: the position of an item of the model
+ *
+ * Retrieves the actor currently bound to the item at @position.
+ *
+ * Only the items inside the visible area, and the ones inside the
+ * overscan on either side of it, have an actor. The items at or after
+ * a change of the model have no actor until the next frame.
+ *
+ * Return value: (transfer none): a #ClutterActor, or %NULL
+ *
+ * Since: 1.26
+ */
+ClutterActor *
+clutter_list_view_get_item_actor (ClutterListView *view,
+                                  guint            position)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), NULL);
+
+  priv = view->priv;
+
+  if (position < priv->first_item ||
+      position >= priv->first_item + priv->items->len ||
+      position >= priv->stale_item)
+    return NULL;
+
+  return g_ptr_array_index (priv->items, position - priv->first_item);
+}
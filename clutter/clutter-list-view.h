@@ -0,0 +1,161 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2016  Intel Corporation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_LIST_VIEW_H__
+#define __CLUTTER_LIST_VIEW_H__
+
+#if !defined(__CLUTTER_H_INSIDE__) && !defined(CLUTTER_COMPILATION)
+#error "Only <clutter/clutter.h> can be included directly."
+#endif
+
+#include <clutter/clutter-types.h>
+#include <clutter/clutter-actor.h>
+
+G_BEGIN_DECLS
+
+#define CLUTTER_TYPE_LIST_VIEW                  (clutter_list_view_get_type ())
+#define CLUTTER_LIST_VIEW(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_LIST_VIEW, ClutterListView))
+#define CLUTTER_IS_LIST_VIEW(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_LIST_VIEW))
+#define CLUTTER_LIST_VIEW_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), CLUTTER_TYPE_LIST_VIEW, ClutterListViewClass))
+#define CLUTTER_IS_LIST_VIEW_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), CLUTTER_TYPE_LIST_VIEW))
+#define CLUTTER_LIST_VIEW_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_LIST_VIEW, ClutterListViewClass))
+
+typedef struct _ClutterListViewPrivate          ClutterListViewPrivate;
+typedef struct _ClutterListViewClass            ClutterListViewClass;
+
+/**
+ * ClutterListView:
+ *
+ * The #ClutterListView structure contains only
+ * private data, and should be accessed using the provided API.
+ *
+ * Since: 1.26
+ */
+struct _ClutterListView
+{
+  /*< private >*/
+  ClutterActor parent_instance;
+
+  ClutterListViewPrivate *priv;
+};
+
+/**
+ * ClutterListViewClass:
+ *
+ * The #ClutterListViewClass structure contains only
+ * private data.
+ *
+ * Since: 1.26
+ */
+struct _ClutterListViewClass
+{
+  /*< private >*/
+  ClutterActorClass parent_class;
+
+  gpointer _padding[8];
+};
+
+/**
+ * ClutterListViewCreateFunc:
+ * @view: a #ClutterListView
+ * @user_data: data passed to clutter_list_view_set_model()
+ *
+ * Creates a new actor used to display the items of the model
+ * of a #ClutterListView.
+ *
+ * The returned actor will be bound to different items of the
+ * model during its lifetime, using #ClutterListViewBindFunc.
+ *
+ * Returns: (transfer full): a newly created #ClutterActor
+ *
+ * Since: 1.26
+ */
+typedef ClutterActor * (* ClutterListViewCreateFunc) (ClutterListView *view,
+                                                      gpointer         user_data);
+
+/**
+ * ClutterListViewBindFunc:
+ * @view: a #ClutterListView
+ * @actor: an actor created by #ClutterListViewCreateFunc
+ * @item: (type GObject): the item of the model
+ * @position: the position of @item inside the model
+ * @user_data: data passed to clutter_list_view_set_model()
+ *
+ * Updates @actor so that it displays @item.
+ *
+ * Since: 1.26
+ */
+typedef void (* ClutterListViewBindFunc) (ClutterListView *view,
+                                          ClutterActor    *actor,
+                                          gpointer         item,
+                                          guint            position,
+                                          gpointer         user_data);
+
+CLUTTER_AVAILABLE_IN_1_26
+GType clutter_list_view_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_26
+ClutterActor *          clutter_list_view_new                           (void);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_list_view_set_model                     (ClutterListView           *view,
+                                                                         GListModel                *model,
+                                                                         ClutterListViewCreateFunc  create_func,
+                                                                         ClutterListViewBindFunc    bind_func,
+                                                                         gpointer                   user_data,
+                                                                         GDestroyNotify             notify);
+CLUTTER_AVAILABLE_IN_1_26
+GListModel *            clutter_list_view_get_model                     (ClutterListView           *view);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_list_view_set_orientation               (ClutterListView           *view,
+                                                                         ClutterOrientation         orientation);
+CLUTTER_AVAILABLE_IN_1_26
+ClutterOrientation      clutter_list_view_get_orientation               (ClutterListView           *view);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_list_view_set_overscan                  (ClutterListView           *view,
+                                                                         guint                      n_items);
+CLUTTER_AVAILABLE_IN_1_26
+guint                   clutter_list_view_get_overscan                  (ClutterListView           *view);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_list_view_set_estimated_item_size       (ClutterListView           *view,
+                                                                         gfloat                     size);
+CLUTTER_AVAILABLE_IN_1_26
+gfloat                  clutter_list_view_get_estimated_item_size       (ClutterListView           *view);
+
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_list_view_set_scroll_offset             (ClutterListView           *view,
+                                                                         gfloat                     offset);
+CLUTTER_AVAILABLE_IN_1_26
+gfloat                  clutter_list_view_get_scroll_offset             (ClutterListView           *view);
+CLUTTER_AVAILABLE_IN_1_26
+gfloat                  clutter_list_view_get_estimated_extent          (ClutterListView           *view);
+CLUTTER_AVAILABLE_IN_1_26
+void                    clutter_list_view_scroll_to_item                (ClutterListView           *view,
+                                                                         guint                      position);
+
+CLUTTER_AVAILABLE_IN_1_26
+ClutterActor *          clutter_list_view_get_item_actor                (ClutterListView           *view,
+                                                                         guint                      position);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_LIST_VIEW_H__ */
@@ -114,8 +114,15 @@ static gboolean clutter_disable_mipmap_text  = FALSE;
 static gboolean clutter_use_fuzzy_picking    = FALSE;
 static gboolean clutter_enable_accessibility = TRUE;
 static gboolean clutter_sync_to_vblank       = TRUE;
+static gboolean clutter_use_easing_tables    = FALSE;
 
 static guint clutter_default_fps             = 60;
+static gint clutter_max_redraw_rects         = 8;
+static guint clutter_size_request_cache_size = 16;
+static guint clutter_image_cache_size        = 0;
+static guint clutter_offscreen_pool_size     = 32;
+
+static gchar *clutter_frame_trace_file       = NULL;
 
 static ClutterTextDirection clutter_text_direction = CLUTTER_TEXT_DIRECTION_LTR;
 
@@ -154,6 +161,7 @@ static const GDebugKey clutter_debug_keys[] = {
 static const GDebugKey clutter_pick_debug_keys[] = {
   { "nop-picking", CLUTTER_DEBUG_NOP_PICKING },
   { "dump-pick-buffers", CLUTTER_DEBUG_DUMP_PICK_BUFFERS },
+  { "geometric-picking", CLUTTER_DEBUG_GEOMETRIC_PICKING },
 };
 
 static const GDebugKey clutter_paint_debug_keys[] = {
@@ -165,6 +173,7 @@ static const GDebugKey clutter_paint_debug_keys[] = {
   { "disable-offscreen-redirect", CLUTTER_DEBUG_DISABLE_OFFSCREEN_REDIRECT },
   { "continuous-redraw", CLUTTER_DEBUG_CONTINUOUS_REDRAW },
   { "paint-deform-tiles", CLUTTER_DEBUG_PAINT_DEFORM_TILES },
+  { "disable-batching", CLUTTER_DEBUG_DISABLE_BATCHING },
 };
 
 static void
@@ -303,6 +312,56 @@ clutter_config_read_from_key_file (GKeyFile *keyfile)
   else
     clutter_default_fps = int_value;
 
+  int_value =
+    g_key_file_get_integer (keyfile, ENVIRONMENT_GROUP,
+                            "MaxRedrawRects",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_max_redraw_rects = CLAMP (int_value, 1, 64);
+
+  int_value =
+    g_key_file_get_integer (keyfile, ENVIRONMENT_GROUP,
+                            "SizeRequestCacheSize",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_size_request_cache_size = CLAMP (int_value, 1, 1024);
+
+  int_value =
+    g_key_file_get_integer (keyfile, ENVIRONMENT_GROUP,
+                            "ImageCacheSize",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_image_cache_size = CLAMP (int_value, 0, 65536);
+
+  int_value =
+    g_key_file_get_integer (keyfile, ENVIRONMENT_GROUP,
+                            "OffscreenPoolSize",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_offscreen_pool_size = CLAMP (int_value, 0, 4096);
+
+  bool_value =
+    g_key_file_get_boolean (keyfile, ENVIRONMENT_GROUP,
+                            "UseEasingTables",
+                            &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    clutter_use_easing_tables = bool_value;
+
   str_value =
     g_key_file_get_string (keyfile, ENVIRONMENT_GROUP,
                            "TextDirection",
@@ -319,6 +378,19 @@ clutter_config_read_from_key_file (GKeyFile *keyfile)
     }
 
   g_free (str_value);
+
+  str_value =
+    g_key_file_get_string (keyfile, ENVIRONMENT_GROUP,
+                           "FrameTraceFile",
+                           &key_error);
+
+  if (key_error != NULL)
+    g_clear_error (&key_error);
+  else
+    {
+      g_free (clutter_frame_trace_file);
+      clutter_frame_trace_file = str_value;
+    }
 }
 
 #ifdef CLUTTER_ENABLE_DEBUG
@@ -1518,6 +1590,49 @@ pre_parse_hook (GOptionContext  *context,
       clutter_default_fps = CLAMP (default_fps, 1, 1000);
     }
 
+  env_string = g_getenv ("CLUTTER_MAX_REDRAW_RECTS");
+  if (env_string)
+    {
+      gint max_redraw_rects = g_ascii_strtoll (env_string, NULL, 10);
+
+      clutter_max_redraw_rects = CLAMP (max_redraw_rects, 1, 64);
+    }
+
+  env_string = g_getenv ("CLUTTER_SIZE_REQUEST_CACHE_SIZE");
+  if (env_string)
+    {
+      gint cache_size = g_ascii_strtoll (env_string, NULL, 10);
+
+      clutter_size_request_cache_size = CLAMP (cache_size, 1, 1024);
+    }
+
+  env_string = g_getenv ("CLUTTER_IMAGE_CACHE_SIZE");
+  if (env_string)
+    {
+      gint cache_size = g_ascii_strtoll (env_string, NULL, 10);
+
+      clutter_image_cache_size = CLAMP (cache_size, 0, 65536);
+    }
+
+  env_string = g_getenv ("CLUTTER_OFFSCREEN_POOL_SIZE");
+  if (env_string)
+    {
+      gint pool_size = g_ascii_strtoll (env_string, NULL, 10);
+
+      clutter_offscreen_pool_size = CLAMP (pool_size, 0, 4096);
+    }
+
+  env_string = g_getenv ("CLUTTER_EASING_TABLES");
+  if (env_string)
+    clutter_use_easing_tables = TRUE;
+
+  env_string = g_getenv ("CLUTTER_FRAME_TRACE_FILE");
+  if (env_string != NULL && *env_string != '\0')
+    {
+      g_free (clutter_frame_trace_file);
+      clutter_frame_trace_file = g_strdup (env_string);
+    }
+
   env_string = g_getenv ("CLUTTER_DISABLE_MIPMAPPED_TEXT");
   if (env_string)
     clutter_disable_mipmap_text = TRUE;
@@ -2530,6 +2645,110 @@ _clutter_process_event_details (ClutterActor        *stage,
     }
 }
 
+/* the maximum number of points picked in one batch */
+#define MAX_PICK_POINTS         64
+
+static void
+add_pick_point (GArray *points,
+                gfloat  x,
+                gfloat  y)
+{
+  ClutterPoint point;
+  guint i;
+
+  /* the stage is picked at integer coordinates */
+  point.x = (gint) x;
+  point.y = (gint) y;
+
+  for (i = 0; i < points->len; i++)
+    {
+      const ClutterPoint *p = &g_array_index (points, ClutterPoint, i);
+
+      if (p->x == point.x && p->y == point.y)
+        return;
+    }
+
+  if (points->len < MAX_PICK_POINTS)
+    g_array_append_val (points, point);
+}
+
+/*< private >
+ * _clutter_pick_queued_events:
+ * @stage: a #ClutterStage
+ * @events: (element-type ClutterEvent): the events about to be processed
+ *
+ * Picks the actors underneath all the pointer motion and touch events
+ * in @events with a single paint of the scene graph, so that processing
+ * each event will not require a separate pick, as long as the scene
+ * graph does not change in the meantime.
+ */
+void
+_clutter_pick_queued_events (ClutterStage *stage,
+                             GList        *events)
+{
+  ClutterActor *stage_actor = CLUTTER_ACTOR (stage);
+  GArray *points;
+  GList *l;
+
+  points = g_array_new (FALSE, FALSE, sizeof (ClutterPoint));
+
+  for (l = events; l != NULL; l = l->next)
+    {
+      ClutterEvent *event = l->data;
+      ClutterInputDevice *device;
+      ClutterEventSequence *sequence = NULL;
+      ClutterPoint device_point;
+      gfloat x, y;
+
+      if (event->any.stage != stage || event->any.source != NULL)
+        continue;
+
+      switch (event->type)
+        {
+        case CLUTTER_MOTION:
+          break;
+
+        case CLUTTER_TOUCH_BEGIN:
+        case CLUTTER_TOUCH_UPDATE:
+        case CLUTTER_TOUCH_END:
+          sequence = clutter_event_get_event_sequence (event);
+          break;
+
+        default:
+          continue;
+        }
+
+      clutter_event_get_coords (event, &x, &y);
+      if (is_off_stage (stage_actor, x, y))
+        continue;
+
+      add_pick_point (points, x, y);
+
+      /* the input device is picked at its current coordinates, which
+       * might be more recent than the ones of the event
+       */
+      device = clutter_event_get_device (event);
+      if (device != NULL &&
+          clutter_input_device_get_coords (device, sequence, &device_point) &&
+          !is_off_stage (stage_actor, device_point.x, device_point.y))
+        add_pick_point (points, device_point.x, device_point.y);
+    }
+
+  if (points->len > 1)
+    {
+      CLUTTER_NOTE (EVENT, "Picking %u points for %u queued events",
+                    points->len,
+                    g_list_length (events));
+
+      _clutter_stage_pick_hints (stage,
+                                 (ClutterPoint *) points->data,
+                                 points->len,
+                                 CLUTTER_PICK_REACTIVE);
+    }
+
+  g_array_free (points, TRUE);
+}
+
 /*
  * _clutter_process_event
  * @event: a #ClutterEvent.
@@ -3711,6 +3930,93 @@ _clutter_get_sync_to_vblank (void)
   return clutter_sync_to_vblank;
 }
 
+/*< private >
+ * _clutter_get_max_redraw_rects:
+ *
+ * Retrieves the maximum number of rectangles that a stage should
+ * use to clip its redraws before falling back to their bounding box.
+ *
+ * Return value: the maximum number of redraw rectangles
+ */
+int
+_clutter_get_max_redraw_rects (void)
+{
+  return clutter_max_redraw_rects;
+}
+
+/*< private >
+ * _clutter_get_size_request_cache_size:
+ *
+ * Retrieves the maximum number of preferred sizes that an actor
+ * should cache for each orientation.
+ *
+ * Return value: the size of the size request cache
+ */
+guint
+_clutter_get_size_request_cache_size (void)
+{
+  return clutter_size_request_cache_size;
+}
+
+/*< private >
+ * _clutter_get_image_cache_size:
+ *
+ * Retrieves the amount of texture memory that the #ClutterImage
+ * instances with a reloadable source should use.
+ *
+ * Return value: the size of the image cache, in bytes, or 0 if
+ *   the image cache is unlimited
+ */
+gsize
+_clutter_get_image_cache_size (void)
+{
+  return (gsize) clutter_image_cache_size * 1024 * 1024;
+}
+
+/*< private >
+ * _clutter_get_offscreen_pool_size:
+ *
+ * Retrieves the amount of texture memory that the offscreen targets
+ * not used by any #ClutterOffscreenEffect can keep.
+ *
+ * Return value: the size of the offscreen pool, in bytes
+ */
+gsize
+_clutter_get_offscreen_pool_size (void)
+{
+  return (gsize) clutter_offscreen_pool_size * 1024 * 1024;
+}
+
+/*< private >
+ * _clutter_get_use_easing_tables:
+ *
+ * Retrieves whether the timelines should evaluate the expensive easing
+ * modes by interpolating a table of samples, instead of calling the
+ * easing functions on each frame.
+ *
+ * Return value: %TRUE if the easing tables should be used
+ */
+gboolean
+_clutter_get_use_easing_tables (void)
+{
+  return clutter_use_easing_tables;
+}
+
+/*< private >
+ * _clutter_get_frame_trace_file:
+ *
+ * Retrieves the path of the file that should be used to write the
+ * timings of each frame, as set by the CLUTTER_FRAME_TRACE_FILE
+ * environment variable or by the FrameTraceFile key in the settings.
+ *
+ * Return value: the path of the trace file, or %NULL
+ */
+const char *
+_clutter_get_frame_trace_file (void)
+{
+  return clutter_frame_trace_file;
+}
+
 void
 _clutter_debug_messagev (const char *format,
                          va_list     var_args)
@@ -35,10 +35,12 @@
 
 #include "clutter-master-clock.h"
 #include "clutter-master-clock-default.h"
+#include "clutter-actor-private.h"
 #include "clutter-debug.h"
 #include "clutter-private.h"
 #include "clutter-stage-manager-private.h"
 #include "clutter-stage-private.h"
+#include "clutter-transition-batch.h"
 
 #ifdef CLUTTER_ENABLE_DEBUG
 #define clutter_warn_if_over_budget(master_clock,start_time,section)    G_STMT_START  { \
@@ -63,6 +65,9 @@ struct _ClutterMasterClockDefault
   /* the list of timelines handled by the clock */
   GSList *timelines;
 
+  /* the transitions advanced in bulk during a frame */
+  ClutterTransitionBatch *batch;
+
   /* the current state of the clock, in usecs */
   gint64 cur_tick;
 
@@ -361,7 +366,15 @@ master_clock_process_events (ClutterMasterClockDefault *master_clock,
 
   /* Process queued events */
   for (l = stages; l != NULL; l = l->next)
-    _clutter_stage_process_queued_events (l->data);
+    {
+      gint64 stage_start = g_get_monotonic_time ();
+
+      _clutter_stage_process_queued_events (l->data);
+
+      _clutter_stage_add_frame_phase (l->data, CLUTTER_FRAME_PHASE_EVENTS,
+                                      stage_start,
+                                      g_get_monotonic_time ());
+    }
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
@@ -374,18 +387,19 @@ master_clock_process_events (ClutterMasterClockDefault *master_clock,
 /*
  * master_clock_advance_timelines:
  * @master_clock: a #ClutterMasterClock
+ * @stages: the stages updated in this frame
  *
  * Advances all the timelines held by the master clock. This function
  * should be called before calling _clutter_stage_do_update() to
  * make sure that all the timelines are advanced and the scene is updated.
  */
 static void
-master_clock_advance_timelines (ClutterMasterClockDefault *master_clock)
+master_clock_advance_timelines (ClutterMasterClockDefault *master_clock,
+                                GSList                    *stages)
 {
   GSList *timelines, *l;
-#ifdef CLUTTER_ENABLE_DEBUG
   gint64 start = g_get_monotonic_time ();
-#endif
+  gint64 end;
 
   /* we protect ourselves from timelines being removed during
    * the advancement by other timelines by copying the list of
@@ -410,12 +424,41 @@ master_clock_advance_timelines (ClutterMasterClockDefault *master_clock)
   timelines = g_slist_copy (master_clock->timelines);
   g_slist_foreach (timelines, (GFunc) g_object_ref, NULL);
 
+  /* the property notifications of the animated actors are emitted
+   * once all the timelines have been advanced
+   */
+  _clutter_actor_begin_deferred_notifies ();
+
+  /* the transitions that do not need to emit signals in this frame
+   * are advanced in bulk; the pending batch is applied before any
+   * other timeline is advanced, so that signal handlers see the same
+   * values they would see if every timeline was advanced in order
+   */
   for (l = timelines; l != NULL; l = l->next)
-    _clutter_timeline_do_tick (l->data, master_clock->cur_tick / 1000);
+    {
+      if (_clutter_transition_batch_add (master_clock->batch,
+                                         l->data,
+                                         master_clock->cur_tick / 1000))
+        continue;
+
+      _clutter_transition_batch_run (master_clock->batch);
+      _clutter_timeline_do_tick (l->data, master_clock->cur_tick / 1000);
+    }
+
+  _clutter_transition_batch_run (master_clock->batch);
+
+  _clutter_actor_end_deferred_notifies ();
 
   g_slist_foreach (timelines, (GFunc) g_object_unref, NULL);
   g_slist_free (timelines);
 
+  /* the timelines are shared by all the stages */
+  end = g_get_monotonic_time ();
+  for (l = stages; l != NULL; l = l->next)
+    _clutter_stage_add_frame_phase (l->data, CLUTTER_FRAME_PHASE_ANIMATIONS,
+                                    start,
+                                    end);
+
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
     clutter_warn_if_over_budget (master_clock, start, "Animations");
@@ -531,7 +574,7 @@ clutter_clock_dispatch (GSource     *source,
   ClutterClockSource *clock_source = (ClutterClockSource *) source;
   ClutterMasterClockDefault *master_clock = clock_source->master_clock;
   gboolean stages_updated = FALSE;
-  GSList *stages;
+  GSList *stages, *l;
 
   CLUTTER_NOTE (SCHEDULER, "Master clock [tick]");
 
@@ -552,6 +595,9 @@ clutter_clock_dispatch (GSource     *source,
 
   master_clock->idle = FALSE;
 
+  for (l = stages; l != NULL; l = l->next)
+    _clutter_stage_begin_frame_timing (l->data, master_clock->cur_tick);
+
   /* Each frame is split into three separate phases: */
 
   /* 1. process all the events; each stage goes through its events queue
@@ -561,7 +607,7 @@ clutter_clock_dispatch (GSource     *source,
   master_clock_process_events (master_clock, stages);
 
   /* 2. advance the timelines */
-  master_clock_advance_timelines (master_clock);
+  master_clock_advance_timelines (master_clock, stages);
 
   /* 3. relayout and redraw the stages */
   stages_updated = master_clock_update_stages (master_clock, stages);
@@ -573,6 +619,9 @@ clutter_clock_dispatch (GSource     *source,
 
   master_clock_reschedule_stage_updates (master_clock, stages);
 
+  for (l = stages; l != NULL; l = l->next)
+    _clutter_stage_end_frame_timing (l->data);
+
   g_slist_foreach (stages, (GFunc) g_object_unref, NULL);
   g_slist_free (stages);
 
@@ -589,6 +638,7 @@ clutter_master_clock_default_finalize (GObject *gobject)
   ClutterMasterClockDefault *master_clock = CLUTTER_MASTER_CLOCK_DEFAULT (gobject);
 
   g_slist_free (master_clock->timelines);
+  _clutter_transition_batch_free (master_clock->batch);
 
   G_OBJECT_CLASS (clutter_master_clock_default_parent_class)->finalize (gobject);
 }
@@ -609,6 +659,8 @@ clutter_master_clock_default_init (ClutterMasterClockDefault *self)
   source = clutter_clock_source_new (self);
   self->source = source;
 
+  self->batch = _clutter_transition_batch_new ();
+
   self->idle = FALSE;
   self->ensure_next_iteration = FALSE;
   self->paused = FALSE;
@@ -25,6 +25,7 @@
 #define __CLUTTER_MASTER_CLOCK_H__
 
 #include <clutter/clutter-timeline.h>
+#include "clutter-easing.h"
 
 G_BEGIN_DECLS
 
@@ -68,6 +69,13 @@ void                    _clutter_timeline_advance                       (Clutter
 gint64                  _clutter_timeline_get_delta                     (ClutterTimeline    *timeline);
 void                    _clutter_timeline_do_tick                       (ClutterTimeline    *timeline,
                                                                          gint64              tick_time);
+gboolean                _clutter_timeline_can_batch_tick                (ClutterTimeline      *timeline,
+                                                                         gint64                tick_time);
+void                    _clutter_timeline_do_batched_tick               (ClutterTimeline      *timeline,
+                                                                         gint64                tick_time,
+                                                                         gint64               *elapsed,
+                                                                         gint64               *duration,
+                                                                         const ClutterEasingTable **table);
 
 G_END_DECLS
 
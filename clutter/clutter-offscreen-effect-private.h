@@ -5,6 +5,16 @@
 
 G_BEGIN_DECLS
 
+typedef struct _ClutterOffscreenTarget  ClutterOffscreenTarget;
+
+CoglHandle      _clutter_offscreen_effect_get_texture   (ClutterOffscreenEffect *effect);
+
+ClutterOffscreenTarget *        _clutter_offscreen_target_lease         (int                     width,
+                                                                         int                     height);
+void                            _clutter_offscreen_target_release       (ClutterOffscreenTarget *target);
+CoglHandle                      _clutter_offscreen_target_get_texture   (ClutterOffscreenTarget *target);
+CoglHandle                      _clutter_offscreen_target_get_offscreen (ClutterOffscreenTarget *target);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_OFFSCREEN_EFFECT_PRIVATE_H__ */
@@ -73,16 +73,61 @@
 #include "cogl/cogl.h"
 
 #include "clutter-actor-private.h"
+#include "clutter-backend.h"
 #include "clutter-debug.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 #include "clutter-stage-private.h"
 
+/* the granularity of the size of the pooled targets, so that actors
+ * of slightly different sizes can share them
+ */
+#define OFFSCREEN_POOL_ALIGN    64
+
+typedef struct _ClutterOffscreenPool    ClutterOffscreenPool;
+
+struct _ClutterOffscreenTarget
+{
+  CoglHandle texture;
+  CoglHandle offscreen;
+
+  int width;
+  int height;
+  CoglPixelFormat format;
+
+  gsize n_bytes;
+
+  /* whether the texture was handed out by get_texture(), in which case
+   * it can be referenced outside of the effect, and must never be
+   * leased to another effect
+   */
+  gboolean exposed;
+};
+
+struct _ClutterOffscreenPool
+{
+  /* the targets that are not leased, most recently used first */
+  GQueue idle_targets;
+
+  gsize idle_bytes;
+  gsize leased_bytes;
+
+  guint n_hits;
+  guint n_misses;
+  guint n_evictions;
+};
+
 struct _ClutterOffscreenEffectPrivate
 {
   CoglHandle offscreen;
   CoglPipeline *target;
   CoglHandle texture;
 
+  /* the target leased from the pool, if any; when set, the offscreen
+   * and texture above are owned by it
+   */
+  ClutterOffscreenTarget *lease;
+
   ClutterActor *actor;
   ClutterActor *stage;
 
@@ -113,6 +158,328 @@ G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ClutterOffscreenEffect,
                                      clutter_offscreen_effect,
                                      CLUTTER_TYPE_EFFECT)
 
+static CoglUserDataKey offscreen_pool_key;
+
+static void clutter_offscreen_effect_real_paint_target (ClutterOffscreenEffect *effect);
+
+static void
+clutter_offscreen_target_free (ClutterOffscreenTarget *target)
+{
+  cogl_handle_unref (target->offscreen);
+  cogl_handle_unref (target->texture);
+
+  g_slice_free (ClutterOffscreenTarget, target);
+}
+
+static void
+clutter_offscreen_pool_free (gpointer data)
+{
+  ClutterOffscreenPool *pool = data;
+  ClutterOffscreenTarget *target;
+
+  while ((target = g_queue_pop_head (&pool->idle_targets)) != NULL)
+    clutter_offscreen_target_free (target);
+
+  g_slice_free (ClutterOffscreenPool, pool);
+}
+
+/* the pool is tied to the Cogl context, since the targets cannot be
+ * shared across contexts
+ */
+static ClutterOffscreenPool *
+clutter_offscreen_pool_get_default (void)
+{
+  CoglContext *ctx =
+    clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  ClutterOffscreenPool *pool;
+
+  pool = cogl_object_get_user_data (COGL_OBJECT (ctx), &offscreen_pool_key);
+  if (pool == NULL)
+    {
+      pool = g_slice_new0 (ClutterOffscreenPool);
+      g_queue_init (&pool->idle_targets);
+
+      cogl_object_set_user_data (COGL_OBJECT (ctx), &offscreen_pool_key,
+                                 pool,
+                                 clutter_offscreen_pool_free);
+    }
+
+  return pool;
+}
+
+static void
+clutter_offscreen_pool_note_stats (ClutterOffscreenPool *pool)
+{
+  guint n_leases = pool->n_hits + pool->n_misses;
+
+  CLUTTER_NOTE (PAINT, "Offscreen pool: %u hits, %u misses (%.1f%% hit rate), "
+                       "%u evictions, %" G_GSIZE_FORMAT " bytes resident "
+                       "(%" G_GSIZE_FORMAT " leased)",
+                pool->n_hits,
+                pool->n_misses,
+                n_leases > 0 ? 100.0 * pool->n_hits / n_leases : 0.0,
+                pool->n_evictions,
+                pool->idle_bytes + pool->leased_bytes,
+                pool->leased_bytes);
+}
+
+static inline int
+clutter_offscreen_pool_align (int size)
+{
+  return (size + OFFSCREEN_POOL_ALIGN - 1) & ~(OFFSCREEN_POOL_ALIGN - 1);
+}
+
+/* Leases a target of @width by @height pixels; the size should have
+ * been aligned with clutter_offscreen_pool_align() for the target to
+ * be shared with differently sized actors
+ */
+static ClutterOffscreenTarget *
+clutter_offscreen_pool_lease (ClutterOffscreenPool *pool,
+                              int                   width,
+                              int                   height,
+                              CoglPixelFormat       format)
+{
+  ClutterOffscreenTarget *target;
+  GList *l;
+
+  for (l = pool->idle_targets.head; l != NULL; l = l->next)
+    {
+      target = l->data;
+
+      if (target->width == width &&
+          target->height == height &&
+          target->format == format)
+        {
+          g_queue_delete_link (&pool->idle_targets, l);
+
+          pool->idle_bytes -= target->n_bytes;
+          pool->leased_bytes += target->n_bytes;
+          pool->n_hits += 1;
+
+          clutter_offscreen_pool_note_stats (pool);
+
+          return target;
+        }
+    }
+
+  target = g_slice_new0 (ClutterOffscreenTarget);
+  target->width = width;
+  target->height = height;
+  target->format = format;
+
+  target->texture = cogl_texture_new_with_size (width, height,
+                                                COGL_TEXTURE_NO_SLICING,
+                                                format);
+  if (target->texture == NULL)
+    {
+      g_slice_free (ClutterOffscreenTarget, target);
+      return NULL;
+    }
+
+  target->offscreen = cogl_offscreen_new_to_texture (target->texture);
+  if (target->offscreen == NULL)
+    {
+      cogl_handle_unref (target->texture);
+      g_slice_free (ClutterOffscreenTarget, target);
+      return NULL;
+    }
+
+  target->n_bytes = (gsize) width * height * 4;
+
+  pool->leased_bytes += target->n_bytes;
+  pool->n_misses += 1;
+
+  clutter_offscreen_pool_note_stats (pool);
+
+  return target;
+}
+
+static void
+clutter_offscreen_pool_release (ClutterOffscreenPool   *pool,
+                                ClutterOffscreenTarget *target)
+{
+  gsize budget = _clutter_get_offscreen_pool_size ();
+
+  pool->leased_bytes -= target->n_bytes;
+
+  /* the texture might still be used by whoever retrieved it, so it
+   * cannot be drawn into by another effect
+   */
+  if (target->exposed)
+    {
+      clutter_offscreen_target_free (target);
+      return;
+    }
+
+  g_queue_push_head (&pool->idle_targets, target);
+  pool->idle_bytes += target->n_bytes;
+
+  /* evict the least recently used targets */
+  while (pool->idle_bytes > budget)
+    {
+      target = g_queue_pop_tail (&pool->idle_targets);
+
+      pool->idle_bytes -= target->n_bytes;
+      pool->n_evictions += 1;
+
+      clutter_offscreen_target_free (target);
+    }
+}
+
+/**
+ * clutter_offscreen_effect_get_pool_stats:
+ * @n_hits: (out) (optional): return location for the number of offscreen
+ *   buffers reused from the pool
+ * @n_misses: (out) (optional): return location for the number of
+ *   offscreen buffers that had to be allocated
+ * @n_evictions: (out) (optional): return location for the number of
+ *   unused offscreen buffers released to keep the pool within its size
+ * @resident_bytes: (out) (optional): return location for the memory
+ *   used by all the pooled offscreen buffers, in use or not
+ *
+ * Retrieves the statistics of the pool of offscreen buffers shared by
+ * the #ClutterOffscreenEffect instances that do not override the
+ * #ClutterOffscreenEffectClass.create_texture() virtual function.
+ *
+ * The size of the pool can be set using the CLUTTER_OFFSCREEN_POOL_SIZE
+ * environment variable.
+ *
+ * Since: 1.26
+ */
+void
+clutter_offscreen_effect_get_pool_stats (guint *n_hits,
+                                         guint *n_misses,
+                                         guint *n_evictions,
+                                         gsize *resident_bytes)
+{
+  ClutterOffscreenPool *pool = clutter_offscreen_pool_get_default ();
+
+  if (n_hits != NULL)
+    *n_hits = pool->n_hits;
+
+  if (n_misses != NULL)
+    *n_misses = pool->n_misses;
+
+  if (n_evictions != NULL)
+    *n_evictions = pool->n_evictions;
+
+  if (resident_bytes != NULL)
+    *resident_bytes = pool->idle_bytes + pool->leased_bytes;
+}
+
+/*< private >
+ * _clutter_offscreen_target_lease:
+ * @width: the minimum width of the target
+ * @height: the minimum height of the target
+ *
+ * Leases an offscreen target from the pool shared with the
+ * #ClutterOffscreenEffect instances, for the intermediate passes
+ * of an effect.
+ *
+ * The size of the target is rounded up, so that it can be shared by
+ * differently sized actors; only its top left corner should be used.
+ *
+ * Return value: a target, to be released with
+ *   _clutter_offscreen_target_release(), or %NULL
+ */
+ClutterOffscreenTarget *
+_clutter_offscreen_target_lease (int width,
+                                 int height)
+{
+  ClutterOffscreenTarget *target;
+
+  target = clutter_offscreen_pool_lease (clutter_offscreen_pool_get_default (),
+                                         clutter_offscreen_pool_align (MAX (width, 1)),
+                                         clutter_offscreen_pool_align (MAX (height, 1)),
+                                         COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  if (target == NULL)
+    g_warning ("%s: Unable to create an Offscreen buffer", G_STRLOC);
+
+  return target;
+}
+
+/*< private >
+ * _clutter_offscreen_target_release:
+ * @target: a target returned by _clutter_offscreen_target_lease()
+ *
+ * Gives @target back to the pool. Its texture must not be used
+ * anymore, as it can be drawn into by another effect.
+ */
+void
+_clutter_offscreen_target_release (ClutterOffscreenTarget *target)
+{
+  clutter_offscreen_pool_release (clutter_offscreen_pool_get_default (),
+                                  target);
+}
+
+CoglHandle
+_clutter_offscreen_target_get_texture (ClutterOffscreenTarget *target)
+{
+  return target->texture;
+}
+
+CoglHandle
+_clutter_offscreen_target_get_offscreen (ClutterOffscreenTarget *target)
+{
+  return target->offscreen;
+}
+
+static void
+clutter_offscreen_effect_release_target (ClutterOffscreenEffect *self)
+{
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+
+  if (priv->lease != NULL)
+    {
+      clutter_offscreen_pool_release (clutter_offscreen_pool_get_default (),
+                                      priv->lease);
+
+      priv->lease = NULL;
+      priv->offscreen = NULL;
+      priv->texture = NULL;
+    }
+  else
+    {
+      if (priv->offscreen != NULL)
+        {
+          cogl_handle_unref (priv->offscreen);
+          priv->offscreen = NULL;
+        }
+
+      if (priv->texture != NULL)
+        {
+          cogl_handle_unref (priv->texture);
+          priv->texture = NULL;
+        }
+    }
+
+  /* the pipeline must not keep a pooled texture alive */
+  if (priv->target != NULL)
+    cogl_pipeline_set_layer_texture (priv->target, 0, NULL);
+}
+
+/* a pooled texture can be larger than the area of the actor, which
+ * is painted in its top left corner
+ */
+static void
+clutter_offscreen_effect_get_used_size (ClutterOffscreenEffect *self,
+                                        int                    *width,
+                                        int                    *height)
+{
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+
+  if (priv->lease != NULL)
+    {
+      *width = MAX (priv->fbo_width, 1);
+      *height = MAX (priv->fbo_height, 1);
+    }
+  else
+    {
+      *width = cogl_texture_get_width (priv->texture);
+      *height = cogl_texture_get_height (priv->texture);
+    }
+}
+
 static void
 clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
                                     ClutterActor     *actor)
@@ -125,11 +492,7 @@ clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
   meta_class->set_actor (meta, actor);
 
   /* clear out the previous state */
-  if (priv->offscreen != NULL)
-    {
-      cogl_handle_unref (priv->offscreen);
-      priv->offscreen = NULL;
-    }
+  clutter_offscreen_effect_release_target (self);
 
   /* we keep a back pointer here, to avoid going through the ActorMeta */
   priv->actor = clutter_actor_meta_get_actor (meta);
@@ -145,6 +508,64 @@ clutter_offscreen_effect_real_create_texture (ClutterOffscreenEffect *effect,
                                      COGL_PIXEL_FORMAT_RGBA_8888_PRE);
 }
 
+static gboolean
+clutter_offscreen_effect_create_target (ClutterOffscreenEffect *self,
+                                        int                     fbo_width,
+                                        int                     fbo_height)
+{
+  ClutterOffscreenEffectClass *klass = CLUTTER_OFFSCREEN_EFFECT_GET_CLASS (self);
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+
+  /* targets can only be pooled if the sub-class does not provide its
+   * own textures
+   */
+  if (klass->create_texture == clutter_offscreen_effect_real_create_texture)
+    {
+      int width = MAX (fbo_width, 1);
+      int height = MAX (fbo_height, 1);
+
+      /* the default paint_target() only paints the part of the target
+       * that we use, so it can be larger than the actor; sub-classes
+       * painting the target themselves expect it to fit the actor
+       */
+      if (klass->paint_target == clutter_offscreen_effect_real_paint_target)
+        {
+          width = clutter_offscreen_pool_align (width);
+          height = clutter_offscreen_pool_align (height);
+        }
+
+      priv->lease =
+        clutter_offscreen_pool_lease (clutter_offscreen_pool_get_default (),
+                                      width,
+                                      height,
+                                      COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+      if (priv->lease == NULL)
+        {
+          g_warning ("%s: Unable to create an Offscreen buffer", G_STRLOC);
+          return FALSE;
+        }
+
+      priv->texture = priv->lease->texture;
+      priv->offscreen = priv->lease->offscreen;
+
+      return TRUE;
+    }
+
+  priv->texture =
+    clutter_offscreen_effect_create_texture (self, fbo_width, fbo_height);
+  if (priv->texture == NULL)
+    return FALSE;
+
+  priv->offscreen = cogl_offscreen_new_to_texture (priv->texture);
+  if (priv->offscreen == NULL)
+    {
+      g_warning ("%s: Unable to create an Offscreen buffer", G_STRLOC);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
 static gboolean
 update_fbo (ClutterEffect *effect, int fbo_width, int fbo_height)
 {
@@ -182,29 +603,12 @@ update_fbo (ClutterEffect *effect, int fbo_width, int fbo_height)
                                        COGL_PIPELINE_FILTER_NEAREST);
     }
 
-  if (priv->texture != NULL)
-    {
-      cogl_handle_unref (priv->texture);
-      priv->texture = NULL;
-    }
-
-  priv->texture =
-    clutter_offscreen_effect_create_texture (self, fbo_width, fbo_height);
-  if (priv->texture == NULL)
-    return FALSE;
-
-  cogl_pipeline_set_layer_texture (priv->target, 0, priv->texture);
-
-  priv->fbo_width = fbo_width;
-  priv->fbo_height = fbo_height;
+  /* give the previous target back, so that other effects can use it */
+  clutter_offscreen_effect_release_target (self);
 
-  if (priv->offscreen != NULL)
-    cogl_handle_unref (priv->offscreen);
-
-  priv->offscreen = cogl_offscreen_new_to_texture (priv->texture);
-  if (priv->offscreen == NULL)
+  if (!clutter_offscreen_effect_create_target (self, fbo_width, fbo_height))
     {
-      g_warning ("%s: Unable to create an Offscreen buffer", G_STRLOC);
+      clutter_offscreen_effect_release_target (self);
 
       cogl_handle_unref (priv->target);
       priv->target = NULL;
@@ -215,6 +619,11 @@ update_fbo (ClutterEffect *effect, int fbo_width, int fbo_height)
       return FALSE;
     }
 
+  cogl_pipeline_set_layer_texture (priv->target, 0, priv->texture);
+
+  priv->fbo_width = fbo_width;
+  priv->fbo_height = fbo_height;
+
   return TRUE;
 }
 
@@ -354,6 +763,9 @@ clutter_offscreen_effect_real_paint_target (ClutterOffscreenEffect *effect)
 {
   ClutterOffscreenEffectPrivate *priv = effect->priv;
   guint8 paint_opacity;
+  int width, height;
+
+  clutter_offscreen_effect_get_used_size (effect, &width, &height);
 
   paint_opacity = clutter_actor_get_paint_opacity (priv->actor);
 
@@ -369,11 +781,10 @@ clutter_offscreen_effect_real_paint_target (ClutterOffscreenEffect *effect)
    * box then we will overlay where the actor would have drawn if it
    * hadn't been redirected offscreen.
    */
-  cogl_rectangle_with_texture_coords (0, 0,
-                                      cogl_texture_get_width (priv->texture),
-                                      cogl_texture_get_height (priv->texture),
+  cogl_rectangle_with_texture_coords (0, 0, width, height,
                                       0.0, 0.0,
-                                      1.0, 1.0);
+                                      (float) width / cogl_texture_get_width (priv->texture),
+                                      (float) height / cogl_texture_get_height (priv->texture));
 }
 
 static void
@@ -453,15 +864,11 @@ clutter_offscreen_effect_finalize (GObject *gobject)
   ClutterOffscreenEffect *self = CLUTTER_OFFSCREEN_EFFECT (gobject);
   ClutterOffscreenEffectPrivate *priv = self->priv;
 
-  if (priv->offscreen)
-    cogl_handle_unref (priv->offscreen);
+  clutter_offscreen_effect_release_target (self);
 
   if (priv->target)
     cogl_handle_unref (priv->target);
 
-  if (priv->texture)
-    cogl_handle_unref (priv->texture);
-
   G_OBJECT_CLASS (clutter_offscreen_effect_parent_class)->finalize (gobject);
 }
 
@@ -504,6 +911,12 @@ clutter_offscreen_effect_init (ClutterOffscreenEffect *self)
  * used instead of clutter_offscreen_effect_get_target() when the
  * effect subclass wants to paint using its own material.
  *
+ * The returned texture can be larger than the area painted by the
+ * actor, which is in its top left corner; use
+ * clutter_offscreen_effect_get_target_rect() to retrieve its size.
+ * A texture returned by this function is never reused by another
+ * effect.
+ *
  * Return value: (transfer none): a #CoglHandle or %COGL_INVALID_HANDLE. The
  *   returned texture is owned by Clutter and it should not be
  *   modified or freed
@@ -516,6 +929,30 @@ clutter_offscreen_effect_get_texture (ClutterOffscreenEffect *effect)
   g_return_val_if_fail (CLUTTER_IS_OFFSCREEN_EFFECT (effect),
                         NULL);
 
+  /* the texture can now be referenced by the caller, so it must not
+   * be handed to another effect once we are done with it
+   */
+  if (effect->priv->lease != NULL)
+    effect->priv->lease->exposed = TRUE;
+
+  return effect->priv->texture;
+}
+
+/*< private >
+ * _clutter_offscreen_effect_get_texture:
+ * @effect: a #ClutterOffscreenEffect
+ *
+ * Retrieves the texture used as a render target by @effect, like
+ * clutter_offscreen_effect_get_texture(), but without preventing it
+ * from being reused by other effects.
+ *
+ * The caller must retrieve the texture again each time it paints.
+ *
+ * Return value: (transfer none): a #CoglHandle or %COGL_INVALID_HANDLE
+ */
+CoglHandle
+_clutter_offscreen_effect_get_texture (ClutterOffscreenEffect *effect)
+{
   return effect->priv->texture;
 }
 
@@ -613,6 +1050,7 @@ clutter_offscreen_effect_get_target_size (ClutterOffscreenEffect *effect,
                                           gfloat                 *height)
 {
   ClutterOffscreenEffectPrivate *priv;
+  int target_width, target_height;
 
   g_return_val_if_fail (CLUTTER_IS_OFFSCREEN_EFFECT (effect), FALSE);
 
@@ -621,11 +1059,13 @@ clutter_offscreen_effect_get_target_size (ClutterOffscreenEffect *effect,
   if (priv->texture == NULL)
     return FALSE;
 
+  clutter_offscreen_effect_get_used_size (effect, &target_width, &target_height);
+
   if (width)
-    *width = cogl_texture_get_width (priv->texture);
+    *width = target_width;
 
   if (height)
-    *height = cogl_texture_get_height (priv->texture);
+    *height = target_height;
 
   return TRUE;
 }
@@ -652,6 +1092,7 @@ clutter_offscreen_effect_get_target_rect (ClutterOffscreenEffect *effect,
                                           ClutterRect            *rect)
 {
   ClutterOffscreenEffectPrivate *priv;
+  int width, height;
 
   g_return_val_if_fail (CLUTTER_IS_OFFSCREEN_EFFECT (effect), FALSE);
   g_return_val_if_fail (rect != NULL, FALSE);
@@ -661,11 +1102,13 @@ clutter_offscreen_effect_get_target_rect (ClutterOffscreenEffect *effect,
   if (priv->texture == NULL)
     return FALSE;
 
+  clutter_offscreen_effect_get_used_size (effect, &width, &height);
+
   clutter_rect_init (rect,
                      priv->x_offset,
                      priv->y_offset,
-                     cogl_texture_get_width (priv->texture),
-                     cogl_texture_get_height (priv->texture));
+                     width,
+                     height);
 
   return TRUE;
 }
@@ -117,6 +117,12 @@ CLUTTER_AVAILABLE_IN_1_14
 gboolean        clutter_offscreen_effect_get_target_rect        (ClutterOffscreenEffect *effect,
                                                                  ClutterRect            *rect);
 
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_offscreen_effect_get_pool_stats         (guint                  *n_hits,
+                                                                 guint                  *n_misses,
+                                                                 guint                  *n_evictions,
+                                                                 gsize                  *resident_bytes);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_OFFSCREEN_EFFECT_H__ */
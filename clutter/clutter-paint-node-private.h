@@ -116,6 +116,13 @@ ClutterPaintNode *      _clutter_dummy_node_new                         (Clutter
 void                    _clutter_paint_node_paint                       (ClutterPaintNode            *root);
 void                    _clutter_paint_node_dump_tree                   (ClutterPaintNode            *root);
 
+void                    _clutter_paint_batch_add_rectangle              (CoglPipeline                *pipeline,
+                                                                         const float                 *coords);
+void                    _clutter_paint_batch_flush                      (void);
+void                    _clutter_paint_batch_get_stats                  (guint                       *n_draws,
+                                                                         guint                       *n_merged);
+void                    _clutter_paint_batch_reset_stats                (void);
+
 G_GNUC_INTERNAL
 void                    clutter_paint_node_remove_child                 (ClutterPaintNode      *node,
                                                                          ClutterPaintNode      *child);
@@ -64,6 +64,8 @@
 
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 
+#include <math.h>
+
 #include <pango/pango.h>
 #include <cogl/cogl.h>
 #include <json-glib/json-glib.h>
@@ -1145,3 +1147,226 @@ clutter_paint_node_get_framebuffer (ClutterPaintNode *node)
 
   return cogl_get_draw_framebuffer ();
 }
+
+/*
+ * Batching of rectangles
+ *
+ * The rectangles painted by consecutive pipeline nodes using the same
+ * CoglPipeline are accumulated into a single batch, and submitted with
+ * one draw call. Rectangles painted with a different modelview can be
+ * added to the same batch as long as the transformation between the
+ * two modelviews is a scale and a translation in the plane of the
+ * rectangles, in which case the rectangles are transformed on the CPU.
+ *
+ * Anything else that may draw, or change the clip of the framebuffer,
+ * must call _clutter_paint_batch_flush() first.
+ */
+
+#define BATCH_EPSILON   1e-5f
+
+typedef struct {
+  CoglFramebuffer *framebuffer;
+  CoglPipeline *pipeline;
+
+  /* the modelview of the first rectangle of the batch */
+  CoglMatrix modelview;
+  CoglMatrix inverse_modelview;
+  guint has_inverse : 1;
+
+  /* the last modelview added to the batch, and the scale and
+   * translation that map it into the batch modelview
+   */
+  CoglMatrix last_modelview;
+  float scale_x, scale_y;
+  float translate_x, translate_y;
+
+  /* 8 floats for each rectangle, as accepted by
+   * cogl_framebuffer_draw_textured_rectangles()
+   */
+  GArray *coords;
+
+  guint n_draws;
+  guint n_merged;
+} ClutterPaintBatch;
+
+static ClutterPaintBatch paint_batch = { NULL, };
+
+static gboolean
+matrix_component_is (float value,
+                     float expected)
+{
+  return fabsf (value - expected) < BATCH_EPSILON;
+}
+
+/* Computes the transformation from @modelview to the modelview of
+ * the batch, if it can be expressed as a scale and a translation
+ */
+static gboolean
+clutter_paint_batch_map_modelview (ClutterPaintBatch *batch,
+                                   const CoglMatrix  *modelview)
+{
+  CoglMatrix relative;
+
+  if (cogl_matrix_equal (modelview, &batch->last_modelview))
+    return TRUE;
+
+  if (!batch->has_inverse)
+    {
+      if (!cogl_matrix_get_inverse (&batch->modelview,
+                                    &batch->inverse_modelview))
+        return FALSE;
+
+      batch->has_inverse = TRUE;
+    }
+
+  cogl_matrix_multiply (&relative, &batch->inverse_modelview, modelview);
+
+  /* the rectangles are on the z = 0 plane, so we can ignore the
+   * z column, but the result must still lie on the same plane
+   */
+  if (!matrix_component_is (relative.xy, 0.f) ||
+      !matrix_component_is (relative.yx, 0.f) ||
+      !matrix_component_is (relative.zx, 0.f) ||
+      !matrix_component_is (relative.zy, 0.f) ||
+      !matrix_component_is (relative.zw, 0.f) ||
+      !matrix_component_is (relative.wx, 0.f) ||
+      !matrix_component_is (relative.wy, 0.f) ||
+      !matrix_component_is (relative.ww, 1.f))
+    return FALSE;
+
+  batch->last_modelview = *modelview;
+  batch->scale_x = relative.xx;
+  batch->scale_y = relative.yy;
+  batch->translate_x = relative.xw;
+  batch->translate_y = relative.yw;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_paint_batch_add_rectangle:
+ * @pipeline: the #CoglPipeline used to paint the rectangle
+ * @coords: the coordinates of the rectangle, followed by its
+ *   texture coordinates
+ *
+ * Adds a rectangle to the current batch, using the current draw
+ * framebuffer and modelview; if the rectangle cannot be added,
+ * the current batch is flushed and a new one is started.
+ */
+void
+_clutter_paint_batch_add_rectangle (CoglPipeline *pipeline,
+                                    const float  *coords)
+{
+  ClutterPaintBatch *batch = &paint_batch;
+  CoglFramebuffer *framebuffer;
+  CoglMatrix modelview;
+  float rect[8];
+
+  framebuffer = cogl_get_draw_framebuffer ();
+
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_DISABLE_BATCHING))
+    {
+      cogl_framebuffer_draw_textured_rectangle (framebuffer, pipeline,
+                                                coords[0], coords[1],
+                                                coords[2], coords[3],
+                                                coords[4], coords[5],
+                                                coords[6], coords[7]);
+      batch->n_draws += 1;
+      return;
+    }
+
+  if (batch->coords == NULL)
+    batch->coords = g_array_sized_new (FALSE, FALSE, sizeof (float), 8 * 64);
+
+  cogl_framebuffer_get_modelview_matrix (framebuffer, &modelview);
+
+  if (batch->coords->len != 0 &&
+      (batch->pipeline != pipeline ||
+       batch->framebuffer != framebuffer ||
+       !clutter_paint_batch_map_modelview (batch, &modelview)))
+    _clutter_paint_batch_flush ();
+
+  if (batch->coords->len == 0)
+    {
+      batch->framebuffer = cogl_object_ref (framebuffer);
+      batch->pipeline = cogl_object_ref (pipeline);
+      batch->modelview = modelview;
+      batch->last_modelview = modelview;
+      batch->has_inverse = FALSE;
+      batch->scale_x = batch->scale_y = 1.f;
+      batch->translate_x = batch->translate_y = 0.f;
+    }
+  else
+    batch->n_merged += 1;
+
+  rect[0] = coords[0] * batch->scale_x + batch->translate_x;
+  rect[1] = coords[1] * batch->scale_y + batch->translate_y;
+  rect[2] = coords[2] * batch->scale_x + batch->translate_x;
+  rect[3] = coords[3] * batch->scale_y + batch->translate_y;
+  rect[4] = coords[4];
+  rect[5] = coords[5];
+  rect[6] = coords[6];
+  rect[7] = coords[7];
+
+  g_array_append_vals (batch->coords, rect, 8);
+}
+
+/*< private >
+ * _clutter_paint_batch_flush:
+ *
+ * Submits the rectangles accumulated by the current batch, if any.
+ */
+void
+_clutter_paint_batch_flush (void)
+{
+  ClutterPaintBatch *batch = &paint_batch;
+  CoglFramebuffer *framebuffer;
+
+  if (batch->coords == NULL || batch->coords->len == 0)
+    return;
+
+  framebuffer = batch->framebuffer;
+
+  cogl_framebuffer_push_matrix (framebuffer);
+  cogl_framebuffer_set_modelview_matrix (framebuffer, &batch->modelview);
+  cogl_framebuffer_draw_textured_rectangles (framebuffer,
+                                             batch->pipeline,
+                                             (const float *) batch->coords->data,
+                                             batch->coords->len / 8);
+  cogl_framebuffer_pop_matrix (framebuffer);
+
+  batch->n_draws += 1;
+
+  g_array_set_size (batch->coords, 0);
+  cogl_object_unref (batch->pipeline);
+  batch->pipeline = NULL;
+  cogl_object_unref (batch->framebuffer);
+  batch->framebuffer = NULL;
+}
+
+/*< private >
+ * _clutter_paint_batch_get_stats:
+ * @n_draws: (out): return location for the number of draw calls
+ * @n_merged: (out): return location for the number of rectangles
+ *   that were merged into another draw call
+ *
+ * Retrieves the counters of the paint batching since the last call
+ * to _clutter_paint_batch_reset_stats().
+ */
+void
+_clutter_paint_batch_get_stats (guint *n_draws,
+                                guint *n_merged)
+{
+  if (n_draws != NULL)
+    *n_draws = paint_batch.n_draws;
+
+  if (n_merged != NULL)
+    *n_merged = paint_batch.n_merged;
+}
+
+void
+_clutter_paint_batch_reset_stats (void)
+{
+  paint_batch.n_draws = 0;
+  paint_batch.n_merged = 0;
+}
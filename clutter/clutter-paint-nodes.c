@@ -52,6 +52,10 @@
 static CoglPipeline *default_color_pipeline   = NULL;
 static CoglPipeline *default_texture_pipeline = NULL;
 
+/* the pipelines used by color nodes, indexed by color */
+#define MAX_COLOR_PIPELINES     256
+static CoglUserDataKey color_pipelines_key;
+
 /*< private >
  * _clutter_paint_node_init_types:
  *
@@ -84,6 +88,32 @@ _clutter_paint_node_init_types (void)
                                      COGL_PIPELINE_WRAP_MODE_AUTOMATIC);
 }
 
+/* the shared color pipelines are tied to the Cogl context, and are
+ * released with it
+ */
+static GHashTable *
+clutter_color_node_get_pipelines (void)
+{
+  CoglContext *ctx =
+    clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  GHashTable *pipelines;
+
+  pipelines = cogl_object_get_user_data (COGL_OBJECT (ctx),
+                                         &color_pipelines_key);
+  if (pipelines == NULL)
+    {
+      pipelines = g_hash_table_new_full (NULL, NULL,
+                                         NULL,
+                                         cogl_object_unref);
+
+      cogl_object_set_user_data (COGL_OBJECT (ctx), &color_pipelines_key,
+                                 pipelines,
+                                 (CoglUserDataDestroyCallback) g_hash_table_unref);
+    }
+
+  return pipelines;
+}
+
 /*
  * Root node, private
  *
@@ -113,6 +143,8 @@ clutter_root_node_pre_draw (ClutterPaintNode *node)
 {
   ClutterRootNode *rnode = (ClutterRootNode *) node;
 
+  _clutter_paint_batch_flush ();
+
   cogl_framebuffer_clear (rnode->framebuffer,
                           rnode->clear_flags,
                           &rnode->clear_color);
@@ -423,21 +455,20 @@ clutter_pipeline_node_draw (ClutterPaintNode *node)
           break;
 
         case PAINT_OP_TEX_RECT:
-          cogl_rectangle_with_texture_coords (op->op.texrect[0],
-                                              op->op.texrect[1],
-                                              op->op.texrect[2],
-                                              op->op.texrect[3],
-                                              op->op.texrect[4],
-                                              op->op.texrect[5],
-                                              op->op.texrect[6],
-                                              op->op.texrect[7]);
+          /* consecutive rectangles with the same pipeline are
+           * submitted together
+           */
+          _clutter_paint_batch_add_rectangle (pnode->pipeline,
+                                              op->op.texrect);
           break;
 
         case PAINT_OP_PATH:
+          _clutter_paint_batch_flush ();
           cogl_path_fill (op->op.path);
           break;
 
         case PAINT_OP_PRIMITIVE:
+          _clutter_paint_batch_flush ();
           cogl_framebuffer_draw_primitive (fb,
                                            pnode->pipeline,
                                            op->op.primitive);
@@ -600,8 +631,25 @@ clutter_color_node_new (const ClutterColor *color)
 
   if (color != NULL)
     {
+      gpointer key = GUINT_TO_POINTER (clutter_color_to_pixel (color));
+      GHashTable *color_pipelines;
+      CoglPipeline *pipeline;
       CoglColor cogl_color;
 
+      /* share the pipelines between nodes using the same color, so
+       * that their rectangles can be batched together
+       */
+      color_pipelines = clutter_color_node_get_pipelines ();
+
+      pipeline = g_hash_table_lookup (color_pipelines, key);
+      if (pipeline != NULL)
+        {
+          cogl_object_unref (cnode->pipeline);
+          cnode->pipeline = cogl_object_ref (pipeline);
+
+          return (ClutterPaintNode *) cnode;
+        }
+
       cogl_color_init_from_4ub (&cogl_color,
                                 color->red,
                                 color->green,
@@ -610,6 +658,13 @@ clutter_color_node_new (const ClutterColor *color)
       cogl_color_premultiply (&cogl_color);
 
       cogl_pipeline_set_color (cnode->pipeline, &cogl_color);
+
+      if (g_hash_table_size (color_pipelines) >= MAX_COLOR_PIPELINES)
+        g_hash_table_remove_all (color_pipelines);
+
+      g_hash_table_insert (color_pipelines,
+                           key,
+                           cogl_object_ref (cnode->pipeline));
     }
 
   return (ClutterPaintNode *) cnode;
@@ -786,6 +841,8 @@ clutter_text_node_draw (ClutterPaintNode *node)
   if (node->operations == NULL)
     return;
 
+  _clutter_paint_batch_flush ();
+
   fb = clutter_paint_node_get_framebuffer (node);
 
   pango_layout_get_pixel_extents (tnode->layout, NULL, &extents);
@@ -970,6 +1027,9 @@ clutter_clip_node_pre_draw (ClutterPaintNode *node)
   if (node->operations == NULL)
     return FALSE;
 
+  /* the batched rectangles must not be affected by the clip */
+  _clutter_paint_batch_flush ();
+
   fb = clutter_paint_node_get_framebuffer (node);
 
   for (i = 0; i < node->operations->len; i++)
@@ -1012,6 +1072,8 @@ clutter_clip_node_post_draw (ClutterPaintNode *node)
   if (node->operations == NULL)
     return;
 
+  _clutter_paint_batch_flush ();
+
   fb = clutter_paint_node_get_framebuffer (node);
 
   for (i = 0; i < node->operations->len; i++)
@@ -1113,6 +1175,8 @@ clutter_layer_node_pre_draw (ClutterPaintNode *node)
   if (node->operations == NULL)
     return FALSE;
 
+  _clutter_paint_batch_flush ();
+
   /* copy the same modelview from the current framebuffer to the one we
    * are going to use
    */
@@ -1152,6 +1216,8 @@ clutter_layer_node_post_draw (ClutterPaintNode *node)
   CoglFramebuffer *fb;
   guint i;
 
+  _clutter_paint_batch_flush ();
+
   /* switch to the previous framebuffer */
   cogl_pop_matrix ();
   cogl_pop_framebuffer ();
@@ -92,6 +92,9 @@ enum
 
 static GParamSpec *obj_props[PROP_LAST];
 
+/* the number of samples of the arc length table of each curve */
+#define CURVE_ARC_SAMPLES       32
+
 typedef struct _ClutterPathNodeFull ClutterPathNodeFull;
 
 struct _ClutterPathNodeFull
@@ -101,6 +104,20 @@ struct _ClutterPathNodeFull
   ClutterBezier *bezier;
 
   guint length;
+
+  /* the length of the path up to the end of the node */
+  guint end;
+
+  /* the floating point length of the node, and of the path up to
+   * the end of the node
+   */
+  gfloat arc_length;
+  gfloat arc_end;
+
+  /* for curves, the arc length at CURVE_ARC_SAMPLES + 1 evenly spaced
+   * values of the curve parameter
+   */
+  gfloat *arc_table;
 };
 
 struct _ClutterPathPrivate
@@ -109,6 +126,10 @@ struct _ClutterPathPrivate
   gboolean nodes_dirty;
 
   guint total_length;
+  gfloat total_arc_length;
+
+  /* the nodes in order, for searching them by length */
+  GPtrArray *node_index;
 };
 
 /* Character tests that don't pay attention to the locale */
@@ -238,6 +259,9 @@ clutter_path_finalize (GObject *object)
 
   clutter_path_clear (self);
 
+  if (self->priv->node_index != NULL)
+    g_ptr_array_unref (self->priv->node_index);
+
   G_OBJECT_CLASS (clutter_path_parent_class)->finalize (object);
 }
 
@@ -1231,6 +1255,49 @@ clutter_path_node_distance (const ClutterKnot *start,
   return (guint) t;
 }
 
+static gfloat
+clutter_path_node_arc_distance (const ClutterKnot *start,
+                                const ClutterKnot *end)
+{
+  gfloat x_d = end->x - start->x;
+  gfloat y_d = end->y - start->y;
+
+  return sqrtf ((x_d * x_d) + (y_d * y_d));
+}
+
+/* builds the table used to move along a curve at constant speed */
+static void
+clutter_path_node_build_arc_table (ClutterPathNodeFull *node)
+{
+  ClutterPoint prev, point;
+  int i;
+
+  if (node->arc_table == NULL)
+    node->arc_table = g_new (gfloat, CURVE_ARC_SAMPLES + 1);
+
+  _clutter_bezier_get_point (node->bezier, 0.0, &prev);
+  node->arc_table[0] = 0.f;
+
+  for (i = 1; i <= CURVE_ARC_SAMPLES; i++)
+    {
+      gfloat x_d, y_d;
+
+      _clutter_bezier_get_point (node->bezier,
+                                 (gdouble) i / CURVE_ARC_SAMPLES,
+                                 &point);
+
+      x_d = point.x - prev.x;
+      y_d = point.y - prev.y;
+
+      node->arc_table[i] = node->arc_table[i - 1]
+                         + sqrtf ((x_d * x_d) + (y_d * y_d));
+
+      prev = point;
+    }
+
+  node->arc_length = node->arc_table[CURVE_ARC_SAMPLES];
+}
+
 static void
 clutter_path_ensure_node_data (ClutterPath *path)
 {
@@ -1245,6 +1312,12 @@ clutter_path_ensure_node_data (ClutterPath *path)
       ClutterKnot points[3];
 
       priv->total_length = 0;
+      priv->total_arc_length = 0.f;
+
+      if (priv->node_index == NULL)
+        priv->node_index = g_ptr_array_new ();
+      else
+        g_ptr_array_set_size (priv->node_index, 0);
 
       for (l = priv->nodes; l; l = l->next)
         {
@@ -1255,6 +1328,7 @@ clutter_path_ensure_node_data (ClutterPath *path)
             {
             case CLUTTER_PATH_MOVE_TO:
               node->length = 0;
+              node->arc_length = 0.f;
 
               /* Store the actual position in point[1] */
               if (relative)
@@ -1288,6 +1362,9 @@ clutter_path_ensure_node_data (ClutterPath *path)
 
               node->length = clutter_path_node_distance (node->k.points + 1,
                                                          node->k.points + 2);
+              node->arc_length =
+                clutter_path_node_arc_distance (node->k.points + 1,
+                                                node->k.points + 2);
               break;
 
             case CLUTTER_PATH_CURVE_TO:
@@ -1318,6 +1395,8 @@ clutter_path_ensure_node_data (ClutterPath *path)
 
               node->length = _clutter_bezier_get_length (node->bezier);
 
+              clutter_path_node_build_arc_table (node);
+
               break;
 
             case CLUTTER_PATH_CLOSE:
@@ -1328,16 +1407,67 @@ clutter_path_ensure_node_data (ClutterPath *path)
 
               node->length = clutter_path_node_distance (node->k.points + 1,
                                                          node->k.points + 2);
+              node->arc_length =
+                clutter_path_node_arc_distance (node->k.points + 1,
+                                                node->k.points + 2);
               break;
             }
 
           priv->total_length += node->length;
+          priv->total_arc_length += node->arc_length;
+
+          node->end = priv->total_length;
+          node->arc_end = priv->total_arc_length;
+
+          g_ptr_array_add (priv->node_index, node);
         }
 
       priv->nodes_dirty = FALSE;
     }
 }
 
+/* finds the first node ending after @distance, or the last node */
+static guint
+clutter_path_find_node (ClutterPathPrivate *priv,
+                        guint               distance)
+{
+  guint lo = 0, hi = priv->node_index->len - 1;
+
+  while (lo < hi)
+    {
+      guint mid = (lo + hi) / 2;
+      ClutterPathNodeFull *node = g_ptr_array_index (priv->node_index, mid);
+
+      if (distance >= node->end)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+/* like clutter_path_find_node(), using the floating point lengths */
+static guint
+clutter_path_find_node_arc (ClutterPathPrivate *priv,
+                            gfloat              distance)
+{
+  guint lo = 0, hi = priv->node_index->len - 1;
+
+  while (lo < hi)
+    {
+      guint mid = (lo + hi) / 2;
+      ClutterPathNodeFull *node = g_ptr_array_index (priv->node_index, mid);
+
+      if (distance >= node->arc_end)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
 /**
  * clutter_path_get_position:
  * @path: a #ClutterPath
@@ -1358,8 +1488,7 @@ clutter_path_get_position (ClutterPath *path,
                            ClutterKnot *position)
 {
   ClutterPathPrivate *priv;
-  GSList *l;
-  guint point_distance, length = 0, node_num = 0;
+  guint point_distance, length, node_num;
   ClutterPathNodeFull *node;
 
   g_return_val_if_fail (CLUTTER_IS_PATH (path), 0);
@@ -1381,16 +1510,9 @@ clutter_path_get_position (ClutterPath *path,
   point_distance = progress * priv->total_length;
 
   /* Find the node that covers this point */
-  for (l = priv->nodes;
-       l->next && point_distance >= (((ClutterPathNodeFull *) l->data)->length
-                                     + length);
-       l = l->next)
-    {
-      length += ((ClutterPathNodeFull *) l->data)->length;
-      node_num++;
-    }
-
-  node = l->data;
+  node_num = clutter_path_find_node (priv, point_distance);
+  node = g_ptr_array_index (priv->node_index, node_num);
+  length = node->end - node->length;
 
   /* Convert the point distance to a distance along the node */
   point_distance -= length;
@@ -1454,6 +1576,186 @@ clutter_path_get_length (ClutterPath *path)
   return path->priv->total_length;
 }
 
+static void
+clutter_path_node_get_point (const ClutterPathNodeFull *node,
+                             gfloat                     distance,
+                             ClutterPoint              *point)
+{
+  gfloat *table = node->arc_table;
+  guint lo, hi;
+  gdouble t;
+
+  distance = CLAMP (distance, 0.f, node->arc_length);
+
+  switch (node->k.type & ~CLUTTER_PATH_RELATIVE)
+    {
+    case CLUTTER_PATH_MOVE_TO:
+      point->x = node->k.points[1].x;
+      point->y = node->k.points[1].y;
+      break;
+
+    case CLUTTER_PATH_LINE_TO:
+    case CLUTTER_PATH_CLOSE:
+      if (node->arc_length == 0.f)
+        {
+          point->x = node->k.points[1].x;
+          point->y = node->k.points[1].y;
+        }
+      else
+        {
+          gfloat f = distance / node->arc_length;
+
+          point->x = node->k.points[1].x
+                   + (node->k.points[2].x - node->k.points[1].x) * f;
+          point->y = node->k.points[1].y
+                   + (node->k.points[2].y - node->k.points[1].y) * f;
+        }
+      break;
+
+    case CLUTTER_PATH_CURVE_TO:
+      if (node->arc_length == 0.f)
+        {
+          _clutter_bezier_get_point (node->bezier, 1.0, point);
+          break;
+        }
+
+      /* find the sample interval containing the distance, and map
+       * the distance to the curve parameter linearly inside it
+       */
+      lo = 0;
+      hi = CURVE_ARC_SAMPLES;
+      while (hi - lo > 1)
+        {
+          guint mid = (lo + hi) / 2;
+
+          if (distance >= table[mid])
+            lo = mid;
+          else
+            hi = mid;
+        }
+
+      if (table[hi] > table[lo])
+        t = lo + (distance - table[lo]) / (table[hi] - table[lo]);
+      else
+        t = lo;
+
+      _clutter_bezier_get_point (node->bezier, t / CURVE_ARC_SAMPLES, point);
+      break;
+    }
+}
+
+/**
+ * clutter_path_get_point:
+ * @path: a #ClutterPath
+ * @progress: a position along the path as a fraction of its length
+ * @point: (out caller-allocates): return location for the position
+ *
+ * Computes the position along the path where 0.0 is the beginning and
+ * 1.0 is the end of the path, like clutter_path_get_position(), but
+ * using floating point precision; the position moves at a constant
+ * speed along the curves of @path.
+ *
+ * Return value: index of the node used to calculate the position.
+ *
+ * Since: 1.26
+ */
+guint
+clutter_path_get_point (ClutterPath  *path,
+                        gdouble       progress,
+                        ClutterPoint *point)
+{
+  ClutterPathPrivate *priv;
+  ClutterPathNodeFull *node;
+  guint node_num;
+  gfloat distance;
+
+  g_return_val_if_fail (CLUTTER_IS_PATH (path), 0);
+  g_return_val_if_fail (progress >= 0.0 && progress <= 1.0, 0);
+  g_return_val_if_fail (point != NULL, 0);
+
+  priv = path->priv;
+
+  clutter_path_ensure_node_data (path);
+
+  if (priv->nodes == NULL)
+    {
+      point->x = point->y = 0.f;
+      return 0;
+    }
+
+  distance = progress * priv->total_arc_length;
+
+  node_num = clutter_path_find_node_arc (priv, distance);
+  node = g_ptr_array_index (priv->node_index, node_num);
+
+  clutter_path_node_get_point (node,
+                               distance - (node->arc_end - node->arc_length),
+                               point);
+
+  return node_num;
+}
+
+/**
+ * clutter_path_get_points:
+ * @path: a #ClutterPath
+ * @progress: (array length=n_points): positions along the path, as
+ *   fractions of its length
+ * @points: (array length=n_points) (out caller-allocates): return location
+ *   for the positions
+ * @n_points: the number of positions
+ *
+ * Computes the positions along the path for each value in @progress,
+ * like calling clutter_path_get_point() for each of them. This function
+ * is faster when many positions are needed, as for particles following
+ * a path; it is fastest when @progress is sorted.
+ *
+ * Since: 1.26
+ */
+void
+clutter_path_get_points (ClutterPath   *path,
+                         const gdouble *progress,
+                         ClutterPoint  *points,
+                         guint          n_points)
+{
+  ClutterPathPrivate *priv;
+  ClutterPathNodeFull *node = NULL;
+  guint i;
+
+  g_return_if_fail (CLUTTER_IS_PATH (path));
+  g_return_if_fail (n_points == 0 || (progress != NULL && points != NULL));
+
+  priv = path->priv;
+
+  clutter_path_ensure_node_data (path);
+
+  for (i = 0; i < n_points; i++)
+    {
+      gfloat distance, start;
+
+      if (priv->nodes == NULL)
+        {
+          points[i].x = points[i].y = 0.f;
+          continue;
+        }
+
+      distance = CLAMP (progress[i], 0.0, 1.0) * priv->total_arc_length;
+
+      /* consecutive positions are likely to be on the same node */
+      if (node == NULL ||
+          distance < node->arc_end - node->arc_length ||
+          distance >= node->arc_end)
+        {
+          guint node_num = clutter_path_find_node_arc (priv, distance);
+
+          node = g_ptr_array_index (priv->node_index, node_num);
+        }
+
+      start = node->arc_end - node->arc_length;
+
+      clutter_path_node_get_point (node, distance - start, points + i);
+    }
+}
+
 static ClutterPathNodeFull *
 clutter_path_node_full_new (void)
 {
@@ -1466,6 +1768,8 @@ clutter_path_node_full_free (ClutterPathNodeFull *node)
   if (node->bezier)
     _clutter_bezier_free (node->bezier);
 
+  g_free (node->arc_table);
+
   g_slice_free (ClutterPathNodeFull, node);
 }
 
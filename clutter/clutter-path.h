@@ -176,6 +176,16 @@ guint        clutter_path_get_position         (ClutterPath           *path,
 CLUTTER_AVAILABLE_IN_1_0
 guint        clutter_path_get_length           (ClutterPath           *path);
 
+CLUTTER_AVAILABLE_IN_1_26
+guint        clutter_path_get_point            (ClutterPath           *path,
+                                                gdouble                progress,
+                                                ClutterPoint          *point);
+CLUTTER_AVAILABLE_IN_1_26
+void         clutter_path_get_points           (ClutterPath           *path,
+                                                const gdouble         *progress,
+                                                ClutterPoint          *points,
+                                                guint                  n_points);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_PATH_H__ */
@@ -57,7 +57,7 @@ typedef struct _ClutterVertex4          ClutterVertex4;
 }
 
 #define CLUTTER_REGISTER_INTERVAL_PROGRESS(func)                      { \
-  clutter_interval_register_progress_func (g_define_type_id, func);     \
+  _clutter_register_progress_function (g_define_type_id, func, TRUE);   \
 }
 
 #define CLUTTER_PRIVATE_FLAGS(a)	 (((ClutterActor *) (a))->private_flags)
@@ -216,6 +216,12 @@ void            _clutter_id_to_color            (guint         id,
 
 void            _clutter_set_sync_to_vblank     (gboolean      sync_to_vblank);
 gboolean        _clutter_get_sync_to_vblank     (void);
+int             _clutter_get_max_redraw_rects   (void);
+guint           _clutter_get_size_request_cache_size (void);
+gsize           _clutter_get_image_cache_size   (void);
+gsize           _clutter_get_offscreen_pool_size (void);
+gboolean        _clutter_get_use_easing_tables  (void);
+const char *    _clutter_get_frame_trace_file   (void);
 
 /* use this function as the accumulator if you have a signal with
  * a G_TYPE_BOOLEAN return value; this will stop the emission as
@@ -303,6 +309,10 @@ typedef enum _ClutterCullResult
 } ClutterCullResult;
 
 gboolean        _clutter_has_progress_function  (GType gtype);
+gboolean        _clutter_has_custom_progress_function (GType gtype);
+void            _clutter_register_progress_function (GType               value_type,
+                                                     ClutterProgressFunc func,
+                                                     gboolean            is_default);
 gboolean        _clutter_run_progress_function  (GType gtype,
                                                  const GValue *initial,
                                                  const GValue *final,
@@ -0,0 +1,63 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2016  Intel Corporation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CLUTTER_PROPERTY_TRANSITION_PRIVATE_H__
+#define __CLUTTER_PROPERTY_TRANSITION_PRIVATE_H__
+
+#include <clutter/clutter-property-transition.h>
+
+G_BEGIN_DECLS
+
+/* the maximum number of components of an animated value */
+#define CLUTTER_ANIMATED_VALUE_COMPONENTS       4
+
+/*< private >
+ * ClutterAnimatedValueType:
+ * @CLUTTER_ANIMATED_VALUE_NONE: the value must be set through the
+ *   #ClutterAnimatable interface
+ * @CLUTTER_ANIMATED_VALUE_FLOAT: a float, in the first component
+ * @CLUTTER_ANIMATED_VALUE_DOUBLE: a double, in the first component
+ * @CLUTTER_ANIMATED_VALUE_UINT: an unsigned integer, in the first component
+ * @CLUTTER_ANIMATED_VALUE_COLOR: a #ClutterColor, as red, green, blue
+ *   and alpha components
+ * @CLUTTER_ANIMATED_VALUE_POINT: a #ClutterPoint, as x and y components
+ *
+ * The types of the values that a #ClutterPropertyTransition can
+ * interpolate and set without using #GValue.
+ */
+typedef enum {
+  CLUTTER_ANIMATED_VALUE_NONE,
+  CLUTTER_ANIMATED_VALUE_FLOAT,
+  CLUTTER_ANIMATED_VALUE_DOUBLE,
+  CLUTTER_ANIMATED_VALUE_UINT,
+  CLUTTER_ANIMATED_VALUE_COLOR,
+  CLUTTER_ANIMATED_VALUE_POINT
+} ClutterAnimatedValueType;
+
+ClutterAnimatedValueType        _clutter_property_transition_get_animated_values        (ClutterPropertyTransition *transition,
+                                                                                         gdouble                   *initial,
+                                                                                         gdouble                   *final);
+void                            _clutter_property_transition_set_animated_value         (ClutterPropertyTransition *transition,
+                                                                                         const gdouble             *value);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_PROPERTY_TRANSITION_PRIVATE_H__ */
@@ -34,9 +34,11 @@
 #include "config.h"
 #endif
 
-#include "clutter-property-transition.h"
+#include "clutter-property-transition-private.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-animatable.h"
+#include "clutter-color.h"
 #include "clutter-debug.h"
 #include "clutter-interval.h"
 #include "clutter-private.h"
@@ -47,6 +49,12 @@ struct _ClutterPropertyTransitionPrivate
   char *property_name;
 
   GParamSpec *pspec;
+
+  /* the interval for which fast_path is valid; we hold a reference
+   * on it, so that a new interval cannot reuse its address
+   */
+  ClutterInterval *fast_path_interval;
+  ClutterAnimatedValueType fast_path;
 };
 
 enum
@@ -107,6 +115,7 @@ clutter_property_transition_attached (ClutterTransition *transition,
 
   priv->pspec =
     clutter_animatable_find_property (animatable, priv->property_name);
+  g_clear_object (&priv->fast_path_interval);
 
   if (priv->pspec == NULL)
     return;
@@ -126,6 +135,214 @@ clutter_property_transition_detached (ClutterTransition *transition,
   ClutterPropertyTransitionPrivate *priv = self->priv;
 
   priv->pspec = NULL; 
+  g_clear_object (&priv->fast_path_interval);
+}
+
+/*
+ * clutter_property_transition_check_fast_path:
+ *
+ * Checks whether the value of the property can be interpolated and set
+ * directly on the #ClutterActor, without going through the #GValue based
+ * #ClutterAnimatable and #ClutterInterval API; the interpolation must be
+ * the same that #ClutterInterval would have used.
+ */
+static ClutterAnimatedValueType
+clutter_property_transition_check_fast_path (ClutterPropertyTransition *self,
+                                             ClutterAnimatable         *animatable,
+                                             ClutterInterval           *interval)
+{
+  ClutterPropertyTransitionPrivate *priv = self->priv;
+  GType p_type, i_type;
+
+  if (!CLUTTER_IS_ACTOR (animatable))
+    return CLUTTER_ANIMATED_VALUE_NONE;
+
+  /* sub-classes of ClutterInterval can override the interpolation */
+  if (G_OBJECT_TYPE (interval) != CLUTTER_TYPE_INTERVAL)
+    return CLUTTER_ANIMATED_VALUE_NONE;
+
+  p_type = G_PARAM_SPEC_VALUE_TYPE (priv->pspec);
+  i_type = clutter_interval_get_value_type (interval);
+  if (p_type != i_type)
+    return CLUTTER_ANIMATED_VALUE_NONE;
+
+  if (!_clutter_actor_can_set_animated_property (CLUTTER_ACTOR (animatable),
+                                                 priv->pspec))
+    return CLUTTER_ANIMATED_VALUE_NONE;
+
+  /* a progress function registered by the application replaces the
+   * linear interpolation, including the default one of #ClutterColor
+   * and #ClutterPoint
+   */
+  if (_clutter_has_custom_progress_function (i_type))
+    return CLUTTER_ANIMATED_VALUE_NONE;
+
+  if (i_type == CLUTTER_TYPE_COLOR)
+    return CLUTTER_ANIMATED_VALUE_COLOR;
+
+  if (i_type == CLUTTER_TYPE_POINT)
+    return CLUTTER_ANIMATED_VALUE_POINT;
+
+  if (i_type == G_TYPE_FLOAT)
+    return CLUTTER_ANIMATED_VALUE_FLOAT;
+
+  if (i_type == G_TYPE_DOUBLE)
+    return CLUTTER_ANIMATED_VALUE_DOUBLE;
+
+  if (i_type == G_TYPE_UINT)
+    return CLUTTER_ANIMATED_VALUE_UINT;
+
+  return CLUTTER_ANIMATED_VALUE_NONE;
+}
+
+/*
+ * clutter_property_transition_load_values:
+ *
+ * Stores the initial and final values of @interval as arrays of
+ * %CLUTTER_ANIMATED_VALUE_COMPONENTS doubles, if the fast path can
+ * be used; the values can then be interpolated linearly, component
+ * by component, with the same results of #ClutterInterval and of
+ * the progress functions of #ClutterColor and #ClutterPoint.
+ */
+static ClutterAnimatedValueType
+clutter_property_transition_load_values (ClutterPropertyTransition *self,
+                                         ClutterAnimatable         *animatable,
+                                         ClutterInterval           *interval,
+                                         gdouble                   *initial,
+                                         gdouble                   *final)
+{
+  ClutterPropertyTransitionPrivate *priv = self->priv;
+  const GValue *a, *b;
+  guint i;
+
+  if (priv->fast_path_interval != interval)
+    {
+      priv->fast_path =
+        clutter_property_transition_check_fast_path (self,
+                                                     animatable,
+                                                     interval);
+      g_set_object (&priv->fast_path_interval, interval);
+
+      CLUTTER_NOTE (ANIMATION, "Property '%s' of %s[%p] %s the fast path",
+                    priv->property_name,
+                    G_OBJECT_TYPE_NAME (animatable),
+                    animatable,
+                    priv->fast_path != CLUTTER_ANIMATED_VALUE_NONE
+                      ? "uses"
+                      : "does not use");
+    }
+
+  if (priv->fast_path == CLUTTER_ANIMATED_VALUE_NONE)
+    return CLUTTER_ANIMATED_VALUE_NONE;
+
+  for (i = 0; i < CLUTTER_ANIMATED_VALUE_COMPONENTS; i++)
+    initial[i] = final[i] = 0.0;
+
+  a = clutter_interval_peek_initial_value (interval);
+  b = clutter_interval_peek_final_value (interval);
+
+  switch (priv->fast_path)
+    {
+    case CLUTTER_ANIMATED_VALUE_FLOAT:
+      initial[0] = g_value_get_float (a);
+      final[0] = g_value_get_float (b);
+      break;
+
+    case CLUTTER_ANIMATED_VALUE_DOUBLE:
+      initial[0] = g_value_get_double (a);
+      final[0] = g_value_get_double (b);
+      break;
+
+    case CLUTTER_ANIMATED_VALUE_UINT:
+      initial[0] = g_value_get_uint (a);
+      final[0] = g_value_get_uint (b);
+      break;
+
+    case CLUTTER_ANIMATED_VALUE_COLOR:
+      {
+        const ClutterColor *ca = g_value_get_boxed (a);
+        const ClutterColor *cb = g_value_get_boxed (b);
+
+        initial[0] = ca->red;
+        initial[1] = ca->green;
+        initial[2] = ca->blue;
+        initial[3] = ca->alpha;
+
+        final[0] = cb->red;
+        final[1] = cb->green;
+        final[2] = cb->blue;
+        final[3] = cb->alpha;
+      }
+      break;
+
+    case CLUTTER_ANIMATED_VALUE_POINT:
+      {
+        const ClutterPoint *pa = g_value_get_boxed (a);
+        const ClutterPoint *pb = g_value_get_boxed (b);
+
+        initial[0] = pa->x;
+        initial[1] = pa->y;
+
+        final[0] = pb->x;
+        final[1] = pb->y;
+      }
+      break;
+
+    case CLUTTER_ANIMATED_VALUE_NONE:
+      g_assert_not_reached ();
+    }
+
+  return priv->fast_path;
+}
+
+static void
+clutter_property_transition_apply_value (ClutterPropertyTransition *self,
+                                         ClutterActor              *actor,
+                                         const gdouble             *value)
+{
+  ClutterPropertyTransitionPrivate *priv = self->priv;
+
+  switch (priv->fast_path)
+    {
+    case CLUTTER_ANIMATED_VALUE_FLOAT:
+      _clutter_actor_set_animated_float (actor, priv->pspec, value[0]);
+      break;
+
+    case CLUTTER_ANIMATED_VALUE_DOUBLE:
+      _clutter_actor_set_animated_double (actor, priv->pspec, value[0]);
+      break;
+
+    case CLUTTER_ANIMATED_VALUE_UINT:
+      _clutter_actor_set_animated_uint (actor, priv->pspec, value[0]);
+      break;
+
+    case CLUTTER_ANIMATED_VALUE_COLOR:
+      {
+        ClutterColor res;
+
+        res.red = value[0];
+        res.green = value[1];
+        res.blue = value[2];
+        res.alpha = value[3];
+
+        _clutter_actor_set_animated_color (actor, priv->pspec, &res);
+      }
+      break;
+
+    case CLUTTER_ANIMATED_VALUE_POINT:
+      {
+        ClutterPoint res;
+
+        res.x = value[0];
+        res.y = value[1];
+
+        _clutter_actor_set_animated_point (actor, priv->pspec, &res);
+      }
+      break;
+
+    case CLUTTER_ANIMATED_VALUE_NONE:
+      g_assert_not_reached ();
+    }
 }
 
 static void
@@ -136,6 +353,8 @@ clutter_property_transition_compute_value (ClutterTransition *transition,
 {
   ClutterPropertyTransition *self = CLUTTER_PROPERTY_TRANSITION (transition);
   ClutterPropertyTransitionPrivate *priv = self->priv;
+  gdouble initial[CLUTTER_ANIMATED_VALUE_COMPONENTS];
+  gdouble final[CLUTTER_ANIMATED_VALUE_COMPONENTS];
   GValue value = G_VALUE_INIT;
   GType p_type, i_type;
   gboolean res;
@@ -146,6 +365,22 @@ clutter_property_transition_compute_value (ClutterTransition *transition,
 
   clutter_property_transition_ensure_interval (self, animatable, interval);
 
+  if (clutter_property_transition_load_values (self, animatable, interval,
+                                               initial,
+                                               final) != CLUTTER_ANIMATED_VALUE_NONE)
+    {
+      gdouble res[CLUTTER_ANIMATED_VALUE_COMPONENTS];
+      guint i;
+
+      for (i = 0; i < CLUTTER_ANIMATED_VALUE_COMPONENTS; i++)
+        res[i] = initial[i] + (final[i] - initial[i]) * progress;
+
+      clutter_property_transition_apply_value (self,
+                                               CLUTTER_ACTOR (animatable),
+                                               res);
+      return;
+    }
+
   p_type = G_PARAM_SPEC_VALUE_TYPE (priv->pspec);
   i_type = clutter_interval_get_value_type (interval);
 
@@ -239,6 +474,7 @@ clutter_property_transition_finalize (GObject *gobject)
   priv = CLUTTER_PROPERTY_TRANSITION (gobject)->priv;
 
   g_free (priv->property_name);
+  g_clear_object (&priv->fast_path_interval);
 
   G_OBJECT_CLASS (clutter_property_transition_parent_class)->finalize (gobject);
 }
@@ -325,6 +561,7 @@ clutter_property_transition_set_property_name (ClutterPropertyTransition *transi
   g_free (priv->property_name);
   priv->property_name = g_strdup (property_name);
   priv->pspec = NULL;
+  g_clear_object (&priv->fast_path_interval);
 
   animatable =
     clutter_transition_get_animatable (CLUTTER_TRANSITION (transition));
@@ -358,3 +595,65 @@ clutter_property_transition_get_property_name (ClutterPropertyTransition *transi
 
   return transition->priv->property_name;
 }
+
+/*< private >
+ * _clutter_property_transition_get_animated_values:
+ * @transition: a #ClutterPropertyTransition
+ * @initial: (out caller-allocates): return location for the initial value
+ * @final: (out caller-allocates): return location for the final value
+ *
+ * Retrieves the initial and final values of @transition as arrays of
+ * %CLUTTER_ANIMATED_VALUE_COMPONENTS doubles, so that they can be
+ * interpolated linearly, component by component, and set using
+ * _clutter_property_transition_set_animated_value().
+ *
+ * Return value: the type of the values, or %CLUTTER_ANIMATED_VALUE_NONE
+ *   if the values must be computed using the #ClutterTransition API
+ */
+ClutterAnimatedValueType
+_clutter_property_transition_get_animated_values (ClutterPropertyTransition *transition,
+                                                  gdouble                   *initial,
+                                                  gdouble                   *final)
+{
+  ClutterPropertyTransitionPrivate *priv = transition->priv;
+  ClutterAnimatable *animatable;
+  ClutterInterval *interval;
+
+  if (priv->pspec == NULL)
+    return CLUTTER_ANIMATED_VALUE_NONE;
+
+  animatable =
+    clutter_transition_get_animatable (CLUTTER_TRANSITION (transition));
+  interval = clutter_transition_get_interval (CLUTTER_TRANSITION (transition));
+  if (animatable == NULL || interval == NULL)
+    return CLUTTER_ANIMATED_VALUE_NONE;
+
+  clutter_property_transition_ensure_interval (transition, animatable, interval);
+
+  return clutter_property_transition_load_values (transition, animatable,
+                                                  interval,
+                                                  initial,
+                                                  final);
+}
+
+/*< private >
+ * _clutter_property_transition_set_animated_value:
+ * @transition: a #ClutterPropertyTransition
+ * @value: the interpolated value
+ *
+ * Sets a value interpolated between the values returned by
+ * _clutter_property_transition_get_animated_values().
+ */
+void
+_clutter_property_transition_set_animated_value (ClutterPropertyTransition *transition,
+                                                 const gdouble             *value)
+{
+  ClutterAnimatable *animatable;
+
+  animatable =
+    clutter_transition_get_animatable (CLUTTER_TRANSITION (transition));
+
+  clutter_property_transition_apply_value (transition,
+                                           CLUTTER_ACTOR (animatable),
+                                           value);
+}
@@ -0,0 +1,707 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2016  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterSpatialIndex: a dynamic bounding volume hierarchy of boxes.
+ *
+ * The index is a binary tree in which every leaf holds the box of an
+ * entry, and every internal node holds the union of the boxes of its
+ * children. The tree is kept balanced using rotations, so that queries
+ * and updates are O(log n).
+ *
+ * The box stored for each entry is padded by a small margin, so that
+ * entries moving by a few pixels do not need to be re-inserted.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-spatial-index.h"
+
+#include "clutter-debug.h"
+#include "clutter-private.h"
+
+#define NULL_NODE       (-1)
+
+/* the padding around each entry, in pixels */
+#define BOX_MARGIN      (4.f)
+
+typedef struct _SpatialNode     SpatialNode;
+
+struct _SpatialNode
+{
+  ClutterActorBox box;
+
+  gpointer data;
+
+  /* the last mark that touched the node; only valid for leaves */
+  guint mark;
+
+  /* the parent node, or the next free node if the node is unused */
+  gint parent;
+
+  gint child1;
+  gint child2;
+
+  /* 0 for leaves, -1 for unused nodes */
+  gint height;
+};
+
+struct _ClutterSpatialIndex
+{
+  GArray *nodes;
+
+  gint root;
+  gint free_list;
+
+  guint n_entries;
+
+  guint current_mark;
+};
+
+#define NODE(idx,i)     (&g_array_index ((idx)->nodes, SpatialNode, (i)))
+#define IS_LEAF(n)      ((n)->child1 == NULL_NODE)
+
+static inline void
+box_union (const ClutterActorBox *a,
+           const ClutterActorBox *b,
+           ClutterActorBox       *res)
+{
+  res->x1 = MIN (a->x1, b->x1);
+  res->y1 = MIN (a->y1, b->y1);
+  res->x2 = MAX (a->x2, b->x2);
+  res->y2 = MAX (a->y2, b->y2);
+}
+
+static inline float
+box_perimeter (const ClutterActorBox *box)
+{
+  return 2.f * ((box->x2 - box->x1) + (box->y2 - box->y1));
+}
+
+static inline gboolean
+box_contains_box (const ClutterActorBox *outer,
+                  const ClutterActorBox *inner)
+{
+  return outer->x1 <= inner->x1 && outer->y1 <= inner->y1 &&
+         outer->x2 >= inner->x2 && outer->y2 >= inner->y2;
+}
+
+static inline gboolean
+box_overlaps (const ClutterActorBox *a,
+              const ClutterActorBox *b)
+{
+  return a->x1 < b->x2 && b->x1 < a->x2 &&
+         a->y1 < b->y2 && b->y1 < a->y2;
+}
+
+static gint
+allocate_node (ClutterSpatialIndex *index_)
+{
+  SpatialNode *node;
+  gint retval;
+
+  if (index_->free_list != NULL_NODE)
+    {
+      retval = index_->free_list;
+      node = NODE (index_, retval);
+      index_->free_list = node->parent;
+    }
+  else
+    {
+      SpatialNode empty = { { 0, }, };
+
+      retval = index_->nodes->len;
+      g_array_append_val (index_->nodes, empty);
+      node = NODE (index_, retval);
+    }
+
+  node->data = NULL;
+  node->mark = 0;
+  node->parent = NULL_NODE;
+  node->child1 = NULL_NODE;
+  node->child2 = NULL_NODE;
+  node->height = 0;
+
+  return retval;
+}
+
+static void
+free_node (ClutterSpatialIndex *index_,
+           gint                 i)
+{
+  SpatialNode *node = NODE (index_, i);
+
+  node->data = NULL;
+  node->height = -1;
+  node->parent = index_->free_list;
+  index_->free_list = i;
+}
+
+static inline void
+fix_node (ClutterSpatialIndex *index_,
+          gint                 i)
+{
+  SpatialNode *node = NODE (index_, i);
+  SpatialNode *c1 = NODE (index_, node->child1);
+  SpatialNode *c2 = NODE (index_, node->child2);
+
+  box_union (&c1->box, &c2->box, &node->box);
+  node->height = 1 + MAX (c1->height, c2->height);
+}
+
+/* Performs a left or right rotation if the subtree rooted in @a is
+ * imbalanced, and returns the new root of the subtree
+ */
+static gint
+balance (ClutterSpatialIndex *index_,
+         gint                 ia)
+{
+  SpatialNode *a = NODE (index_, ia);
+  SpatialNode *b, *c;
+  gint ib, ic, delta;
+
+  if (IS_LEAF (a) || a->height < 2)
+    return ia;
+
+  ib = a->child1;
+  ic = a->child2;
+  b = NODE (index_, ib);
+  c = NODE (index_, ic);
+
+  delta = c->height - b->height;
+
+  if (delta > 1)
+    {
+      /* rotate C up */
+      gint i_f = c->child1;
+      gint i_g = c->child2;
+      SpatialNode *f = NODE (index_, i_f);
+      SpatialNode *g = NODE (index_, i_g);
+
+      c->child1 = ia;
+      c->parent = a->parent;
+      a->parent = ic;
+
+      if (c->parent != NULL_NODE)
+        {
+          SpatialNode *p = NODE (index_, c->parent);
+
+          if (p->child1 == ia)
+            p->child1 = ic;
+          else
+            p->child2 = ic;
+        }
+      else
+        index_->root = ic;
+
+      if (f->height > g->height)
+        {
+          c->child2 = i_f;
+          a->child2 = i_g;
+          g->parent = ia;
+        }
+      else
+        {
+          c->child2 = i_g;
+          a->child2 = i_f;
+          f->parent = ia;
+        }
+
+      fix_node (index_, ia);
+      fix_node (index_, ic);
+
+      return ic;
+    }
+
+  if (delta < -1)
+    {
+      /* rotate B up */
+      gint i_d = b->child1;
+      gint i_e = b->child2;
+      SpatialNode *d = NODE (index_, i_d);
+      SpatialNode *e = NODE (index_, i_e);
+
+      b->child1 = ia;
+      b->parent = a->parent;
+      a->parent = ib;
+
+      if (b->parent != NULL_NODE)
+        {
+          SpatialNode *p = NODE (index_, b->parent);
+
+          if (p->child1 == ia)
+            p->child1 = ib;
+          else
+            p->child2 = ib;
+        }
+      else
+        index_->root = ib;
+
+      if (d->height > e->height)
+        {
+          b->child2 = i_d;
+          a->child1 = i_e;
+          e->parent = ia;
+        }
+      else
+        {
+          b->child2 = i_e;
+          a->child1 = i_d;
+          d->parent = ia;
+        }
+
+      fix_node (index_, ia);
+      fix_node (index_, ib);
+
+      return ib;
+    }
+
+  return ia;
+}
+
+/* walks back from @i to the root, refitting the boxes and re-balancing */
+static void
+refit_ancestors (ClutterSpatialIndex *index_,
+                 gint                 i)
+{
+  while (i != NULL_NODE)
+    {
+      i = balance (index_, i);
+      fix_node (index_, i);
+
+      i = NODE (index_, i)->parent;
+    }
+}
+
+static void
+insert_leaf (ClutterSpatialIndex *index_,
+             gint                 leaf)
+{
+  ClutterActorBox leaf_box;
+  SpatialNode *node;
+  gint sibling, old_parent, new_parent;
+
+  if (index_->root == NULL_NODE)
+    {
+      index_->root = leaf;
+      NODE (index_, leaf)->parent = NULL_NODE;
+      return;
+    }
+
+  leaf_box = NODE (index_, leaf)->box;
+
+  /* descend the tree, looking for the cheapest sibling for the leaf
+   * using the perimeter of the boxes as the cost function
+   */
+  sibling = index_->root;
+  node = NODE (index_, sibling);
+  while (!IS_LEAF (node))
+    {
+      SpatialNode *c1 = NODE (index_, node->child1);
+      SpatialNode *c2 = NODE (index_, node->child2);
+      ClutterActorBox combined;
+      float perimeter, cost, inheritance_cost, cost1, cost2;
+
+      perimeter = box_perimeter (&node->box);
+
+      box_union (&node->box, &leaf_box, &combined);
+
+      /* the cost of creating a new parent for this node and the leaf */
+      cost = 2.f * box_perimeter (&combined);
+
+      /* the minimum cost of pushing the leaf further down the tree */
+      inheritance_cost = 2.f * (box_perimeter (&combined) - perimeter);
+
+      box_union (&c1->box, &leaf_box, &combined);
+      cost1 = box_perimeter (&combined) + inheritance_cost;
+      if (!IS_LEAF (c1))
+        cost1 -= box_perimeter (&c1->box);
+
+      box_union (&c2->box, &leaf_box, &combined);
+      cost2 = box_perimeter (&combined) + inheritance_cost;
+      if (!IS_LEAF (c2))
+        cost2 -= box_perimeter (&c2->box);
+
+      if (cost < cost1 && cost < cost2)
+        break;
+
+      sibling = cost1 < cost2 ? node->child1 : node->child2;
+      node = NODE (index_, sibling);
+    }
+
+  /* create a new parent for the sibling and the leaf; we need to be
+   * careful here, as allocating a new node may re-allocate the array
+   */
+  old_parent = NODE (index_, sibling)->parent;
+  new_parent = allocate_node (index_);
+
+  node = NODE (index_, new_parent);
+  node->parent = old_parent;
+  node->child1 = sibling;
+  node->child2 = leaf;
+  box_union (&leaf_box, &NODE (index_, sibling)->box, &node->box);
+  node->height = NODE (index_, sibling)->height + 1;
+
+  if (old_parent != NULL_NODE)
+    {
+      SpatialNode *p = NODE (index_, old_parent);
+
+      if (p->child1 == sibling)
+        p->child1 = new_parent;
+      else
+        p->child2 = new_parent;
+    }
+  else
+    index_->root = new_parent;
+
+  NODE (index_, sibling)->parent = new_parent;
+  NODE (index_, leaf)->parent = new_parent;
+
+  refit_ancestors (index_, new_parent);
+}
+
+static void
+remove_leaf (ClutterSpatialIndex *index_,
+             gint                 leaf)
+{
+  SpatialNode *parent;
+  gint i_parent, i_grandparent, sibling;
+
+  if (leaf == index_->root)
+    {
+      index_->root = NULL_NODE;
+      return;
+    }
+
+  i_parent = NODE (index_, leaf)->parent;
+  parent = NODE (index_, i_parent);
+  i_grandparent = parent->parent;
+  sibling = parent->child1 == leaf ? parent->child2 : parent->child1;
+
+  if (i_grandparent != NULL_NODE)
+    {
+      SpatialNode *grandparent = NODE (index_, i_grandparent);
+
+      /* replace the parent with the sibling */
+      if (grandparent->child1 == i_parent)
+        grandparent->child1 = sibling;
+      else
+        grandparent->child2 = sibling;
+
+      NODE (index_, sibling)->parent = i_grandparent;
+      free_node (index_, i_parent);
+
+      refit_ancestors (index_, i_grandparent);
+    }
+  else
+    {
+      index_->root = sibling;
+      NODE (index_, sibling)->parent = NULL_NODE;
+      free_node (index_, i_parent);
+    }
+}
+
+static inline void
+set_fat_box (SpatialNode           *node,
+             const ClutterActorBox *box)
+{
+  node->box.x1 = box->x1 - BOX_MARGIN;
+  node->box.y1 = box->y1 - BOX_MARGIN;
+  node->box.x2 = box->x2 + BOX_MARGIN;
+  node->box.y2 = box->y2 + BOX_MARGIN;
+}
+
+/*< private >
+ * _clutter_spatial_index_new:
+ *
+ * Creates a new, empty spatial index.
+ *
+ * Return value: the newly created #ClutterSpatialIndex
+ */
+ClutterSpatialIndex *
+_clutter_spatial_index_new (void)
+{
+  ClutterSpatialIndex *index_;
+
+  index_ = g_slice_new (ClutterSpatialIndex);
+  index_->nodes = g_array_sized_new (FALSE, FALSE, sizeof (SpatialNode), 64);
+  index_->root = NULL_NODE;
+  index_->free_list = NULL_NODE;
+  index_->n_entries = 0;
+  index_->current_mark = 0;
+
+  return index_;
+}
+
+void
+_clutter_spatial_index_free (ClutterSpatialIndex *index_)
+{
+  if (index_ == NULL)
+    return;
+
+  g_array_free (index_->nodes, TRUE);
+  g_slice_free (ClutterSpatialIndex, index_);
+}
+
+/*< private >
+ * _clutter_spatial_index_insert:
+ * @index_: a #ClutterSpatialIndex
+ * @box: the box of the entry
+ * @data: the data associated to the entry
+ *
+ * Adds a new entry to the index.
+ *
+ * Return value: the identifier of the entry, to be used with
+ *   _clutter_spatial_index_update() and _clutter_spatial_index_remove()
+ */
+gint
+_clutter_spatial_index_insert (ClutterSpatialIndex   *index_,
+                               const ClutterActorBox *box,
+                               gpointer               data)
+{
+  SpatialNode *node;
+  gint leaf;
+
+  leaf = allocate_node (index_);
+
+  node = NODE (index_, leaf);
+  set_fat_box (node, box);
+  node->data = data;
+
+  insert_leaf (index_, leaf);
+
+  index_->n_entries += 1;
+
+  return leaf;
+}
+
+void
+_clutter_spatial_index_remove (ClutterSpatialIndex *index_,
+                               gint                 id_)
+{
+  g_return_if_fail (id_ >= 0 && id_ < (gint) index_->nodes->len);
+  g_return_if_fail (IS_LEAF (NODE (index_, id_)));
+
+  remove_leaf (index_, id_);
+  free_node (index_, id_);
+
+  index_->n_entries -= 1;
+}
+
+/*< private >
+ * _clutter_spatial_index_update:
+ * @index_: a #ClutterSpatialIndex
+ * @id_: the identifier of the entry
+ * @box: the new box of the entry
+ *
+ * Updates the box of an entry. If the new box is still contained
+ * inside the padded box of the entry this function does not change
+ * the index.
+ *
+ * Return value: %TRUE if the entry was re-inserted in the index
+ */
+gboolean
+_clutter_spatial_index_update (ClutterSpatialIndex   *index_,
+                               gint                   id_,
+                               const ClutterActorBox *box)
+{
+  SpatialNode *node;
+
+  g_return_val_if_fail (id_ >= 0 && id_ < (gint) index_->nodes->len, FALSE);
+
+  node = NODE (index_, id_);
+
+  g_return_val_if_fail (IS_LEAF (node), FALSE);
+
+  /* the padded box still contains the new one, but we also don't
+   * want to keep a box that is much bigger than needed
+   */
+  if (box_contains_box (&node->box, box) &&
+      box->x1 - node->box.x1 <= 2.f * BOX_MARGIN &&
+      box->y1 - node->box.y1 <= 2.f * BOX_MARGIN &&
+      node->box.x2 - box->x2 <= 2.f * BOX_MARGIN &&
+      node->box.y2 - box->y2 <= 2.f * BOX_MARGIN)
+    return FALSE;
+
+  remove_leaf (index_, id_);
+
+  node = NODE (index_, id_);
+  set_fat_box (node, box);
+
+  insert_leaf (index_, id_);
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_spatial_index_get_box:
+ * @index_: a #ClutterSpatialIndex
+ * @id_: the identifier of the entry
+ * @box: (out): return location for the box
+ *
+ * Retrieves the padded box of an entry.
+ */
+void
+_clutter_spatial_index_get_box (ClutterSpatialIndex *index_,
+                                gint                 id_,
+                                ClutterActorBox     *box)
+{
+  g_return_if_fail (id_ >= 0 && id_ < (gint) index_->nodes->len);
+
+  *box = NODE (index_, id_)->box;
+}
+
+guint
+_clutter_spatial_index_get_n_entries (ClutterSpatialIndex *index_)
+{
+  return index_->n_entries;
+}
+
+/*< private >
+ * _clutter_spatial_index_query_box:
+ * @index_: a #ClutterSpatialIndex
+ * @box: the box to query
+ * @func: function called for each entry overlapping @box
+ * @user_data: data to pass to @func
+ *
+ * Calls @func for each entry whose box overlaps @box.
+ */
+void
+_clutter_spatial_index_query_box (ClutterSpatialIndex     *index_,
+                                  const ClutterActorBox   *box,
+                                  ClutterSpatialIndexFunc  func,
+                                  gpointer                 user_data)
+{
+  gint stack_static[64];
+  gint *stack = stack_static;
+  gint stack_size = G_N_ELEMENTS (stack_static);
+  gint n_stack = 0;
+
+  if (index_->root == NULL_NODE)
+    return;
+
+  stack[n_stack++] = index_->root;
+
+  while (n_stack > 0)
+    {
+      gint i = stack[--n_stack];
+      SpatialNode *node = NODE (index_, i);
+
+      if (!box_overlaps (&node->box, box))
+        continue;
+
+      if (IS_LEAF (node))
+        {
+          if (!func (i, node->data, user_data))
+            break;
+
+          continue;
+        }
+
+      if (n_stack + 2 > stack_size)
+        {
+          gint *new_stack = g_new (gint, stack_size * 2);
+
+          memcpy (new_stack, stack, sizeof (gint) * n_stack);
+
+          if (stack != stack_static)
+            g_free (stack);
+
+          stack = new_stack;
+          stack_size *= 2;
+        }
+
+      stack[n_stack++] = node->child1;
+      stack[n_stack++] = node->child2;
+    }
+
+  if (stack != stack_static)
+    g_free (stack);
+}
+
+void
+_clutter_spatial_index_query_point (ClutterSpatialIndex     *index_,
+                                    gfloat                   x,
+                                    gfloat                   y,
+                                    ClutterSpatialIndexFunc  func,
+                                    gpointer                 user_data)
+{
+  ClutterActorBox box;
+
+  /* a point is a box with an infinitesimal size */
+  box.x1 = x;
+  box.y1 = y;
+  box.x2 = x + 1e-3f;
+  box.y2 = y + 1e-3f;
+
+  _clutter_spatial_index_query_box (index_, &box, func, user_data);
+}
+
+static gboolean
+mark_entry (gint     id_,
+            gpointer data,
+            gpointer user_data)
+{
+  ClutterSpatialIndex *index_ = user_data;
+
+  NODE (index_, id_)->mark = index_->current_mark;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_spatial_index_mark_box:
+ * @index_: a #ClutterSpatialIndex
+ * @box: the box to query
+ *
+ * Marks all the entries whose box overlaps @box with a new mark.
+ *
+ * The mark can be checked using _clutter_spatial_index_is_marked();
+ * every call to this function invalidates all previous marks.
+ *
+ * Return value: the new mark
+ */
+guint
+_clutter_spatial_index_mark_box (ClutterSpatialIndex   *index_,
+                                 const ClutterActorBox *box)
+{
+  index_->current_mark += 1;
+
+  /* 0 is the mark of entries that have never been marked */
+  if (G_UNLIKELY (index_->current_mark == 0))
+    index_->current_mark = 1;
+
+  _clutter_spatial_index_query_box (index_, box, mark_entry, index_);
+
+  return index_->current_mark;
+}
+
+gboolean
+_clutter_spatial_index_is_marked (ClutterSpatialIndex *index_,
+                                  gint                 id_,
+                                  guint                mark)
+{
+  g_return_val_if_fail (id_ >= 0 && id_ < (gint) index_->nodes->len, FALSE);
+
+  return NODE (index_, id_)->mark == mark;
+}
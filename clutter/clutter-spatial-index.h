@@ -0,0 +1,82 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2016  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterSpatialIndex: a dynamic bounding volume hierarchy of boxes.
+ */
+
+#ifndef __CLUTTER_SPATIAL_INDEX_H__
+#define __CLUTTER_SPATIAL_INDEX_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterSpatialIndex     ClutterSpatialIndex;
+
+/*< private >
+ * ClutterSpatialIndexFunc:
+ * @id_: the identifier of the entry
+ * @data: the data associated to the entry
+ * @user_data: the data passed to the query function
+ *
+ * Function called for each entry of a #ClutterSpatialIndex that
+ * matches a query.
+ *
+ * Return value: %TRUE to continue the query, %FALSE to stop it
+ */
+typedef gboolean (* ClutterSpatialIndexFunc) (gint     id_,
+                                              gpointer data,
+                                              gpointer user_data);
+
+ClutterSpatialIndex *   _clutter_spatial_index_new              (void);
+void                    _clutter_spatial_index_free             (ClutterSpatialIndex     *index_);
+
+gint                    _clutter_spatial_index_insert           (ClutterSpatialIndex     *index_,
+                                                                 const ClutterActorBox   *box,
+                                                                 gpointer                 data);
+void                    _clutter_spatial_index_remove           (ClutterSpatialIndex     *index_,
+                                                                 gint                     id_);
+gboolean                _clutter_spatial_index_update           (ClutterSpatialIndex     *index_,
+                                                                 gint                     id_,
+                                                                 const ClutterActorBox   *box);
+void                    _clutter_spatial_index_get_box          (ClutterSpatialIndex     *index_,
+                                                                 gint                     id_,
+                                                                 ClutterActorBox         *box);
+guint                   _clutter_spatial_index_get_n_entries    (ClutterSpatialIndex     *index_);
+
+void                    _clutter_spatial_index_query_box        (ClutterSpatialIndex     *index_,
+                                                                 const ClutterActorBox   *box,
+                                                                 ClutterSpatialIndexFunc  func,
+                                                                 gpointer                 user_data);
+void                    _clutter_spatial_index_query_point      (ClutterSpatialIndex     *index_,
+                                                                 gfloat                   x,
+                                                                 gfloat                   y,
+                                                                 ClutterSpatialIndexFunc  func,
+                                                                 gpointer                 user_data);
+
+guint                   _clutter_spatial_index_mark_box         (ClutterSpatialIndex     *index_,
+                                                                 const ClutterActorBox   *box);
+gboolean                _clutter_spatial_index_is_marked        (ClutterSpatialIndex     *index_,
+                                                                 gint                     id_,
+                                                                 guint                    mark);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_SPATIAL_INDEX_H__ */
@@ -26,6 +26,7 @@
 #include <clutter/clutter-stage.h>
 #include <clutter/clutter-input-device.h>
 #include <clutter/clutter-private.h>
+#include <clutter/clutter-spatial-index.h>
 
 #include <cogl/cogl.h>
 
@@ -33,11 +34,24 @@ G_BEGIN_DECLS
 
 typedef struct _ClutterStageQueueRedrawEntry ClutterStageQueueRedrawEntry;
 
+typedef enum {
+  CLUTTER_FRAME_PHASE_EVENTS,
+  CLUTTER_FRAME_PHASE_ANIMATIONS,
+  CLUTTER_FRAME_PHASE_RELAYOUT,
+  CLUTTER_FRAME_PHASE_PAINT,
+  CLUTTER_FRAME_PHASE_SWAP,
+
+  CLUTTER_N_FRAME_PHASES
+} ClutterFramePhase;
+
 /* stage */
 ClutterStageWindow *_clutter_stage_get_default_window    (void);
 
 void                _clutter_stage_do_paint              (ClutterStage                *stage,
                                                           const cairo_rectangle_int_t *clip);
+void                _clutter_stage_paint_clip            (ClutterStage                *stage,
+                                                          const cairo_rectangle_int_t *clip);
+void                _clutter_stage_emit_after_paint      (ClutterStage                *stage);
 
 void                _clutter_stage_set_window            (ClutterStage          *stage,
                                                           ClutterStageWindow    *stage_window);
@@ -58,6 +72,8 @@ void                _clutter_stage_get_viewport          (ClutterStage
 void                _clutter_stage_dirty_viewport        (ClutterStage          *stage);
 void                _clutter_stage_maybe_setup_viewport  (ClutterStage          *stage);
 void                _clutter_stage_maybe_relayout        (ClutterActor          *stage);
+void                _clutter_stage_queue_relayout_root   (ClutterStage          *stage,
+                                                          ClutterActor          *actor);
 gboolean            _clutter_stage_needs_update          (ClutterStage          *stage);
 gboolean            _clutter_stage_do_update             (ClutterStage          *stage);
 
@@ -72,16 +88,40 @@ gint64    _clutter_stage_get_update_time                  (ClutterStage *stage);
 void     _clutter_stage_clear_update_time                 (ClutterStage *stage);
 gboolean _clutter_stage_has_full_redraw_queued            (ClutterStage *stage);
 
+void     _clutter_stage_begin_frame_timing                (ClutterStage      *stage,
+                                                           gint64             frame_time);
+void     _clutter_stage_add_frame_phase                   (ClutterStage      *stage,
+                                                           ClutterFramePhase  phase,
+                                                           gint64             start,
+                                                           gint64             end);
+void     _clutter_stage_begin_frame_swap                  (ClutterStage      *stage);
+void     _clutter_stage_end_frame_timing                  (ClutterStage      *stage);
+
 ClutterActor *_clutter_stage_do_pick (ClutterStage    *stage,
                                       gint             x,
                                       gint             y,
                                       ClutterPickMode  mode);
+void          _clutter_stage_do_pick_multiple   (ClutterStage       *stage,
+                                                 const ClutterPoint *points,
+                                                 guint               n_points,
+                                                 ClutterPickMode     mode,
+                                                 ClutterActor      **actors);
+void          _clutter_stage_pick_hints         (ClutterStage       *stage,
+                                                 const ClutterPoint *points,
+                                                 guint               n_points,
+                                                 ClutterPickMode     mode);
+void          _clutter_stage_clear_pick_hints   (ClutterStage       *stage);
+void          _clutter_stage_invalidate_pick    (ClutterStage       *stage);
+
 
 ClutterPaintVolume *_clutter_stage_paint_volume_stack_allocate (ClutterStage *stage);
 void                _clutter_stage_paint_volume_stack_free_all (ClutterStage *stage);
 
 const ClutterPlane *_clutter_stage_get_clip (ClutterStage *stage);
 
+ClutterSpatialIndex *_clutter_stage_get_spatial_index      (ClutterStage *stage);
+guint                _clutter_stage_get_spatial_index_mark (ClutterStage *stage);
+
 ClutterStageQueueRedrawEntry *_clutter_stage_queue_actor_redraw            (ClutterStage                 *stage,
                                                                             ClutterStageQueueRedrawEntry *entry,
                                                                             ClutterActor                 *actor,
@@ -47,7 +47,10 @@
 #endif
 
 #include <math.h>
+#include <errno.h>
+#include <stdio.h>
 #include <cairo.h>
+#include <glib/gstdio.h>
 
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
@@ -69,6 +72,7 @@
 #include "clutter-main.h"
 #include "clutter-marshal.h"
 #include "clutter-master-clock.h"
+#include "clutter-paint-node-private.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-private.h"
 #include "clutter-stage-manager-private.h"
@@ -104,6 +108,27 @@ struct _ClutterStageQueueRedrawEntry
   ClutterPaintVolume clip;
 };
 
+typedef struct _ClutterStagePickHint
+{
+  gint x;
+  gint y;
+  ClutterPickMode mode;
+  ClutterActor *actor;
+} ClutterStagePickHint;
+
+typedef struct _ClutterStagePickCacheEntry
+{
+  gint x;
+  gint y;
+  ClutterPickMode mode;
+  ClutterActor *actor;
+  guint generation;
+} ClutterStagePickCacheEntry;
+
+#define PICK_CACHE_SIZE         8
+
+#define N_FRAME_TIMINGS         120
+
 struct _ClutterStagePrivate
 {
   /* the stage implementation */
@@ -130,6 +155,11 @@ struct _ClutterStagePrivate
 
   GList *pending_queue_redraws;
 
+  /* the actors that queued a relayout that did not need to go up to
+   * the stage; see _clutter_stage_queue_relayout_root()
+   */
+  GPtrArray *relayout_roots;
+
   CoglFramebuffer *active_framebuffer;
 
   gint sync_delay;
@@ -139,6 +169,47 @@ struct _ClutterStagePrivate
 
   ClutterIDPool *pick_id_pool;
 
+  /* the results of the last batched pick */
+  ClutterStagePickHint *pick_hints;
+  guint n_pick_hints;
+
+  /* the target of the pick paint of multiple points, so that it does
+   * not need to paint in the back buffer; and the framebuffer being
+   * painted in pick mode, while doing so
+   */
+  CoglOffscreen *pick_offscreen;
+  CoglFramebuffer *pick_framebuffer;
+
+  /* the results of the last picks; an entry is only valid as long
+   * as its generation matches the scene generation, which changes
+   * every time the scene graph changes
+   */
+  ClutterStagePickCacheEntry pick_cache[PICK_CACHE_SIZE];
+  guint pick_cache_next;
+  guint scene_generation;
+  guint pick_cache_hits;
+  guint pick_cache_misses;
+
+  /* the paint boxes of the actors on the stage */
+  ClutterSpatialIndex *spatial_index;
+  guint spatial_index_mark;
+
+  /* the timings of the last frames, in a ring buffer; frame timings
+   * are enabled only if this is not NULL
+   */
+  ClutterFrameTiming *frame_timings;
+  guint frame_timings_next;
+  guint n_frame_timings;
+
+  /* the frame being timed */
+  ClutterFrameTiming current_timing;
+  gint64 current_frame_start;
+  gint64 current_phase_starts[CLUTTER_N_FRAME_PHASES];
+  gint64 current_swap_start;
+
+  /* the identifier of the stage inside the frame trace */
+  guint frame_trace_id;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   gulong redraw_count;
 #endif /* CLUTTER_ENABLE_DEBUG */
@@ -162,6 +233,9 @@ struct _ClutterStagePrivate
   guint accept_focus           : 1;
   guint motion_events_enabled  : 1;
   guint has_custom_perspective : 1;
+  guint geometric_picking      : 1;
+  guint retain_paint_nodes     : 1;
+  guint in_frame_timing        : 1;
 };
 
 enum
@@ -201,6 +275,8 @@ static const ClutterColor default_stage_color = { 255, 255, 255, 255 };
 
 static void clutter_stage_maybe_finish_queue_redraws (ClutterStage *stage);
 static void free_queue_redraw_entry (ClutterStageQueueRedrawEntry *entry);
+static void clutter_stage_clear_pick_offscreen (ClutterStage *stage);
+static void clutter_stage_release_frame_trace (ClutterStage *stage);
 
 static void clutter_container_iface_init (ClutterContainerIface *iface);
 
@@ -610,6 +686,12 @@ _clutter_stage_update_active_framebuffer (ClutterStage *stage)
    * offscreen framebuffer.
    */
 
+  if (priv->pick_framebuffer != NULL)
+    {
+      priv->active_framebuffer = priv->pick_framebuffer;
+      return;
+    }
+
   priv->active_framebuffer =
     _clutter_stage_window_get_active_framebuffer (priv->impl);
 
@@ -628,6 +710,29 @@ _clutter_stage_update_active_framebuffer (ClutterStage *stage)
 void
 _clutter_stage_do_paint (ClutterStage                *stage,
                          const cairo_rectangle_int_t *clip)
+{
+  if (stage->priv->impl == NULL)
+    return;
+
+  _clutter_stage_paint_clip (stage, clip);
+
+  g_signal_emit (stage, stage_signals[AFTER_PAINT], 0);
+}
+
+/*< private >
+ * _clutter_stage_paint_clip:
+ * @stage: a #ClutterStage
+ * @clip: (allow-none): the area to paint, or %NULL
+ *
+ * Paints the scene graph inside @clip, like _clutter_stage_do_paint(),
+ * without emitting the #ClutterStage::after-paint signal; stage
+ * windows painting the scene graph multiple times to redraw
+ * disjoint areas should call _clutter_stage_emit_after_paint()
+ * once they are done.
+ */
+void
+_clutter_stage_paint_clip (ClutterStage                *stage,
+                           const cairo_rectangle_int_t *clip)
 {
   ClutterStagePrivate *priv = stage->priv;
   float clip_poly[8];
@@ -682,10 +787,46 @@ _clutter_stage_do_paint (ClutterStage                *stage,
                                              &priv->inverse_projection,
                                              priv->current_clip_planes);
 
+  /* mark the actors that may intersect the area being painted, so
+   * that we can skip all the others, and their children, without
+   * transforming their paint volumes
+   */
+  if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
+    {
+      ClutterActorBox clip_box;
+
+      clip_box.x1 = clip_poly[0] / window_scale;
+      clip_box.y1 = clip_poly[1] / window_scale;
+      clip_box.x2 = clip_poly[4] / window_scale;
+      clip_box.y2 = clip_poly[5] / window_scale;
+
+      priv->spatial_index_mark =
+        _clutter_spatial_index_mark_box (priv->spatial_index, &clip_box);
+    }
+
   _clutter_stage_paint_volume_stack_free_all (stage);
   _clutter_stage_update_active_framebuffer (stage);
+  _clutter_paint_batch_reset_stats ();
   clutter_actor_paint (CLUTTER_ACTOR (stage));
 
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
+    {
+      guint n_draws, n_merged;
+
+      _clutter_paint_batch_get_stats (&n_draws, &n_merged);
+      CLUTTER_NOTE (PAINT, "Submitted %u batched draws, merging %u rectangles",
+                    n_draws,
+                    n_merged);
+    }
+#endif /* CLUTTER_ENABLE_DEBUG */
+
+  priv->spatial_index_mark = 0;
+}
+
+void
+_clutter_stage_emit_after_paint (ClutterStage *stage)
+{
   g_signal_emit (stage, stage_signals[AFTER_PAINT], 0);
 }
 
@@ -768,6 +909,8 @@ clutter_stage_unrealize (ClutterActor *self)
 {
   ClutterStagePrivate *priv = CLUTTER_STAGE (self)->priv;
 
+  clutter_stage_clear_pick_offscreen (CLUTTER_STAGE (self));
+
   /* and then unrealize the implementation */
   g_assert (priv->impl != NULL);
   _clutter_stage_window_unrealize (priv->impl);
@@ -961,7 +1104,7 @@ void
 _clutter_stage_process_queued_events (ClutterStage *stage)
 {
   ClutterStagePrivate *priv;
-  GList *events, *l;
+  GList *events, *l, *next;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
@@ -980,7 +1123,9 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
   priv->event_queue->tail = NULL;
   priv->event_queue->length = 0;
 
-  for (l = events; l != NULL; l = l->next)
+  /* Drop the motion events we are going to skip, and pick the
+   * others all at once */
+  for (l = events; l != NULL; l = next)
     {
       ClutterEvent *event;
       ClutterEvent *next_event;
@@ -988,6 +1133,8 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
       ClutterInputDevice *next_device;
       gboolean check_device = FALSE;
 
+      next = l->next;
+
       event = l->data;
       next_event = l->next ? l->next->data : NULL;
 
@@ -1013,7 +1160,7 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
                             "Omitting motion event at %d, %d",
                             (int) event->motion.x,
                             (int) event->motion.y);
-              goto next_event;
+              goto omit_event;
             }
           else if (event->type == CLUTTER_TOUCH_UPDATE &&
                    next_event->type == CLUTTER_TOUCH_UPDATE &&
@@ -1024,16 +1171,29 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
                             "Omitting touch update event at %d, %d",
                             (int) event->touch.x,
                             (int) event->touch.y);
-              goto next_event;
+              goto omit_event;
             }
         }
 
-      _clutter_process_event (event);
+      continue;
 
-    next_event:
+    omit_event:
       clutter_event_free (event);
+      events = g_list_delete_link (events, l);
     }
 
+  _clutter_pick_queued_events (stage, events);
+
+  for (l = events; l != NULL; l = l->next)
+    {
+      ClutterEvent *event = l->data;
+
+      _clutter_process_event (event);
+      clutter_event_free (event);
+    }
+
+  _clutter_stage_clear_pick_hints (stage);
+
   g_list_free (events);
 
   g_object_unref (stage);
@@ -1079,6 +1239,10 @@ _clutter_stage_maybe_relayout (ClutterActor *actor)
 
       CLUTTER_SET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
 
+#ifdef CLUTTER_ENABLE_DEBUG
+      _clutter_actor_reset_size_request_stats ();
+#endif
+
       natural_width = natural_height = 0;
       clutter_actor_get_preferred_size (CLUTTER_ACTOR (stage),
                                         NULL, NULL,
@@ -1096,16 +1260,83 @@ _clutter_stage_maybe_relayout (ClutterActor *actor)
       clutter_actor_allocate (CLUTTER_ACTOR (stage),
                               &box, CLUTTER_ALLOCATION_NONE);
 
+      /* the relayout roots that were not reached by the allocation
+       * of the stage are allocated in place; any root queued while
+       * doing so is left for the next relayout
+       */
+      if (priv->relayout_roots->len > 0)
+        {
+          GPtrArray *roots = priv->relayout_roots;
+          guint i;
+
+          priv->relayout_roots =
+            g_ptr_array_new_with_free_func (g_object_unref);
+
+          for (i = 0; i < roots->len; i++)
+            {
+              ClutterActor *root = g_ptr_array_index (roots, i);
+
+              if (CLUTTER_ACTOR_IN_DESTRUCTION (root) ||
+                  _clutter_actor_get_stage_internal (root) != actor)
+                continue;
+
+              _clutter_actor_relayout_root (root);
+            }
+
+          g_ptr_array_unref (roots);
+        }
+
+#ifdef CLUTTER_ENABLE_DEBUG
+      {
+        guint n_hits, n_misses, n_evictions;
+
+        _clutter_actor_get_size_request_stats (&n_hits, &n_misses, &n_evictions);
+        CLUTTER_NOTE (LAYOUT, "Size request cache: %u hits, %u misses, "
+                              "%u evictions",
+                      n_hits,
+                      n_misses,
+                      n_evictions);
+      }
+#endif /* CLUTTER_ENABLE_DEBUG */
+
       CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
     }
 }
 
+/*< private >
+ * _clutter_stage_queue_relayout_root:
+ * @stage: a #ClutterStage
+ * @actor: an actor on @stage
+ *
+ * Queues a relayout of @actor that does not involve its parent.
+ *
+ * The actor is allocated using its current allocation the next time
+ * the stage is laid out, unless the stage reaches it first.
+ */
+void
+_clutter_stage_queue_relayout_root (ClutterStage *stage,
+                                    ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  g_ptr_array_add (priv->relayout_roots, g_object_ref (actor));
+
+  if (!priv->relayout_pending)
+    {
+      _clutter_stage_schedule_update (stage);
+      priv->relayout_pending = TRUE;
+    }
+
+  _clutter_stage_invalidate_pick (stage);
+}
+
 static void
 clutter_stage_do_redraw (ClutterStage *stage)
 {
   ClutterBackend *backend = clutter_get_default_backend ();
   ClutterActor *actor = CLUTTER_ACTOR (stage);
   ClutterStagePrivate *priv = stage->priv;
+  gint64 start = 0;
 
   if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
     return;
@@ -1125,10 +1356,38 @@ clutter_stage_do_redraw (ClutterStage *stage)
         priv->fps_timer = g_timer_new ();
     }
 
+  if (priv->in_frame_timing)
+    {
+      start = g_get_monotonic_time ();
+      priv->current_swap_start = 0;
+    }
+
   _clutter_stage_maybe_setup_viewport (stage);
 
   _clutter_stage_window_redraw (priv->impl);
 
+  if (priv->in_frame_timing)
+    {
+      gint64 end = g_get_monotonic_time ();
+
+      /* stage windows that do not report the beginning of the swap
+       * get the whole redraw accounted as painting
+       */
+      if (priv->current_swap_start >= start)
+        {
+          _clutter_stage_add_frame_phase (stage, CLUTTER_FRAME_PHASE_PAINT,
+                                          start,
+                                          priv->current_swap_start);
+          _clutter_stage_add_frame_phase (stage, CLUTTER_FRAME_PHASE_SWAP,
+                                          priv->current_swap_start,
+                                          end);
+        }
+      else
+        _clutter_stage_add_frame_phase (stage, CLUTTER_FRAME_PHASE_PAINT,
+                                        start,
+                                        end);
+    }
+
   if (_clutter_context_get_show_fps ())
     {
       priv->timer_n_frames += 1;
@@ -1176,7 +1435,18 @@ _clutter_stage_do_update (ClutterStage *stage)
    * check or clear the pending redraws flag since a relayout may
    * queue a redraw.
    */
-  _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
+  if (priv->in_frame_timing && priv->relayout_pending)
+    {
+      gint64 start = g_get_monotonic_time ();
+
+      _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
+
+      _clutter_stage_add_frame_phase (stage, CLUTTER_FRAME_PHASE_RELAYOUT,
+                                      start,
+                                      g_get_monotonic_time ());
+    }
+  else
+    _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
 
   if (!priv->redraw_pending)
     return FALSE;
@@ -1214,6 +1484,8 @@ clutter_stage_real_queue_relayout (ClutterActor *self)
       priv->relayout_pending = TRUE;
     }
 
+  _clutter_stage_invalidate_pick (stage);
+
   /* chain up */
   parent_class = CLUTTER_ACTOR_CLASS (clutter_stage_parent_class);
   parent_class->queue_relayout (self);
@@ -1368,41 +1640,117 @@ read_pixels_to_file (char *filename_stem,
   read_count++;
 }
 
-ClutterActor *
-_clutter_stage_do_pick (ClutterStage   *stage,
-                        gint            x,
-                        gint            y,
-                        ClutterPickMode mode)
+/* picking the stage resolves a pixel of the framebuffer into an actor */
+static ClutterActor *
+clutter_stage_pixel_to_actor (ClutterStage *stage,
+                              const guchar *pixel)
+{
+  if (pixel[0] == 0xff && pixel[1] == 0xff && pixel[2] == 0xff)
+    return CLUTTER_ACTOR (stage);
+  else
+    {
+      guint32 id_ = _clutter_pixel_to_id ((guchar *) pixel);
+
+      return _clutter_stage_get_actor_by_pick_id (stage, id_);
+    }
+}
+
+/* the largest area, in pixels, that we read back in one go when
+ * picking multiple points; larger areas are read one pixel at a time
+ */
+#define MAX_PICK_READ_AREA      (256 * 256)
+
+/* the granularity of the size of the pick offscreen, to avoid
+ * reallocating it every time the area being picked grows
+ */
+#define PICK_OFFSCREEN_ALIGN    64
+
+static void
+clutter_stage_clear_pick_offscreen (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (priv->pick_offscreen != NULL)
+    {
+      cogl_object_unref (priv->pick_offscreen);
+      priv->pick_offscreen = NULL;
+    }
+}
+
+/* Retrieves an offscreen framebuffer of at least @width by @height
+ * pixels, to paint the pick of multiple points in
+ */
+static CoglOffscreen *
+clutter_stage_get_pick_offscreen (ClutterStage *stage,
+                                  int           width,
+                                  int           height)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  CoglTexture *texture;
+
+  if (priv->pick_offscreen != NULL)
+    {
+      CoglFramebuffer *fb = COGL_FRAMEBUFFER (priv->pick_offscreen);
+
+      if (cogl_framebuffer_get_width (fb) >= width &&
+          cogl_framebuffer_get_height (fb) >= height)
+        return priv->pick_offscreen;
+
+      width = MAX (width, cogl_framebuffer_get_width (fb));
+      height = MAX (height, cogl_framebuffer_get_height (fb));
+
+      clutter_stage_clear_pick_offscreen (stage);
+    }
+
+  width = (width + PICK_OFFSCREEN_ALIGN - 1) & ~(PICK_OFFSCREEN_ALIGN - 1);
+  height = (height + PICK_OFFSCREEN_ALIGN - 1) & ~(PICK_OFFSCREEN_ALIGN - 1);
+
+  texture = cogl_texture_new_with_size (width, height,
+                                        COGL_TEXTURE_NO_SLICING |
+                                        COGL_TEXTURE_NO_AUTO_MIPMAP,
+                                        COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+  if (texture == NULL)
+    return NULL;
+
+  /* the offscreen holds a reference on its texture */
+  priv->pick_offscreen = cogl_offscreen_new_to_texture (texture);
+  cogl_object_unref (texture);
+
+  CLUTTER_NOTE (PICK, "Allocated a %ix%i offscreen for picking",
+                width, height);
+
+  return priv->pick_offscreen;
+}
+
+/* Paints the scene in pick mode once, and resolves all the points
+ * in @points; the points must be inside the stage
+ */
+static void
+clutter_stage_pick_paint (ClutterStage       *stage,
+                          const ClutterPoint *points,
+                          const guint        *indices,
+                          guint               n_indices,
+                          ClutterPickMode     mode,
+                          ClutterActor      **actors)
 {
   ClutterActor *actor = CLUTTER_ACTOR (stage);
   ClutterStagePrivate *priv = stage->priv;
   ClutterMainContext *context;
-  guchar pixel[4] = { 0xff, 0xff, 0xff, 0xff };
   CoglColor stage_pick_id;
   gboolean dither_enabled_save;
-  ClutterActor *retval;
+  CoglOffscreen *offscreen = NULL;
   CoglFramebuffer *fb;
+  cairo_rectangle_int_t area;
   gint dirty_x;
   gint dirty_y;
   gint read_x;
   gint read_y;
   float stage_width, stage_height;
   int window_scale;
+  guchar *pixels;
+  guint i;
 
-  priv = stage->priv;
-
-  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
-    return actor;
-
-  if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_NOP_PICKING))
-    return actor;
-
-  if (G_UNLIKELY (priv->impl == NULL))
-    return actor;
-
-  clutter_actor_get_size (CLUTTER_ACTOR (stage), &stage_width, &stage_height);
-  if (x < 0 || x >= stage_width || y < 0 || y >= stage_height)
-    return actor;
+  clutter_actor_get_size (actor, &stage_width, &stage_height);
 
   context = _clutter_context_get_default ();
   clutter_stage_ensure_current (stage);
@@ -1415,20 +1763,93 @@ _clutter_stage_do_pick (ClutterStage   *stage,
   /* needed for when a context switch happens */
   _clutter_stage_maybe_setup_viewport (stage);
 
-  _clutter_stage_window_get_dirty_pixel (priv->impl, &dirty_x, &dirty_y);
+  if (n_indices == 1)
+    {
+      gint x = points[indices[0]].x;
+      gint y = points[indices[0]].y;
 
-  if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
-    cogl_framebuffer_push_scissor_clip (fb, dirty_x * window_scale, dirty_y * window_scale, 1, 1);
+      /* paint the single pixel we need in a part of the back buffer
+       * that is going to be redrawn anyway
+       */
+      _clutter_stage_window_get_dirty_pixel (priv->impl, &dirty_x, &dirty_y);
 
-  cogl_set_viewport (priv->viewport[0] * window_scale - x * window_scale + dirty_x * window_scale,
-                     priv->viewport[1] * window_scale - y * window_scale + dirty_y * window_scale,
-                     priv->viewport[2] * window_scale,
-                     priv->viewport[3] * window_scale);
+      if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
+        cogl_framebuffer_push_scissor_clip (fb, dirty_x * window_scale, dirty_y * window_scale, 1, 1);
 
-  read_x = dirty_x * window_scale;
-  read_y = dirty_y * window_scale;
+      cogl_set_viewport (priv->viewport[0] * window_scale - x * window_scale + dirty_x * window_scale,
+                         priv->viewport[1] * window_scale - y * window_scale + dirty_y * window_scale,
+                         priv->viewport[2] * window_scale,
+                         priv->viewport[3] * window_scale);
+
+      area.x = x;
+      area.y = y;
+      area.width = area.height = 1;
+
+      read_x = dirty_x * window_scale;
+      read_y = dirty_y * window_scale;
+
+      CLUTTER_NOTE (PICK, "Performing pick at %i,%i", x, y);
+    }
+  else
+    {
+      gint x1 = G_MAXINT, y1 = G_MAXINT;
+      gint x2 = G_MININT, y2 = G_MININT;
+
+      for (i = 0; i < n_indices; i++)
+        {
+          gint x = points[indices[i]].x;
+          gint y = points[indices[i]].y;
+
+          x1 = MIN (x1, x);
+          y1 = MIN (y1, y);
+          x2 = MAX (x2, x);
+          y2 = MAX (y2, y);
+        }
+
+      area.x = x1;
+      area.y = y1;
+      area.width = x2 - x1 + 1;
+      area.height = y2 - y1 + 1;
+
+      /* the pick paint covers the bounding box of all the points,
+       * which is not necessarily going to be redrawn, so we paint it
+       * offscreen instead of in the back buffer
+       */
+      offscreen = clutter_stage_get_pick_offscreen (stage,
+                                                    area.width * window_scale,
+                                                    area.height * window_scale);
+      if (offscreen == NULL)
+        {
+          CLUTTER_NOTE (PICK, "Unable to allocate the pick offscreen, "
+                              "picking %u points one at a time",
+                        n_indices);
 
-  CLUTTER_NOTE (PICK, "Performing pick at %i,%i", x, y);
+          for (i = 0; i < n_indices; i++)
+            clutter_stage_pick_paint (stage, points, indices + i, 1, mode, actors);
+
+          return;
+        }
+
+      fb = COGL_FRAMEBUFFER (offscreen);
+
+      cogl_push_framebuffer (fb);
+      priv->pick_framebuffer = fb;
+
+      /* the origin of the offscreen is the origin of the area */
+      cogl_set_projection_matrix (&priv->projection);
+      cogl_set_viewport ((priv->viewport[0] - area.x) * window_scale,
+                         (priv->viewport[1] - area.y) * window_scale,
+                         priv->viewport[2] * window_scale,
+                         priv->viewport[3] * window_scale);
+
+      read_x = 0;
+      read_y = 0;
+
+      CLUTTER_NOTE (PICK, "Performing pick of %u points inside %i,%i %ix%i",
+                    n_indices,
+                    area.x, area.y,
+                    area.width, area.height);
+    }
 
   cogl_color_init_from_4ub (&stage_pick_id, 255, 255, 255, 255);
   cogl_clear (&stage_pick_id, COGL_BUFFER_BIT_COLOR | COGL_BUFFER_BIT_DEPTH);
@@ -1444,17 +1865,63 @@ _clutter_stage_do_pick (ClutterStage   *stage,
   _clutter_stage_do_paint (stage, NULL);
   context->pick_mode = CLUTTER_PICK_NONE;
 
-  /* Read the color of the screen co-ords pixel. RGBA_8888_PRE is used
+  /* Read the color of the screen co-ords pixels. RGBA_8888_PRE is used
      even though we don't care about the alpha component because under
      GLES this is the only format that is guaranteed to work so Cogl
      will end up having to do a conversion if any other format is
      used. The format is requested as pre-multiplied because Cogl
      assumes that all pixels in the framebuffer are premultiplied so
      it avoids a conversion. */
-  cogl_read_pixels (read_x, read_y, 1, 1,
-                    COGL_READ_PIXELS_COLOR_BUFFER,
-                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
-                    pixel);
+  if (n_indices == 1)
+    {
+      guchar pixel[4] = { 0xff, 0xff, 0xff, 0xff };
+
+      cogl_read_pixels (read_x, read_y, 1, 1,
+                        COGL_READ_PIXELS_COLOR_BUFFER,
+                        COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                        pixel);
+
+      actors[indices[0]] = clutter_stage_pixel_to_actor (stage, pixel);
+    }
+  else if (area.width * window_scale * area.height * window_scale <= MAX_PICK_READ_AREA)
+    {
+      gint width = area.width * window_scale;
+      gint height = area.height * window_scale;
+
+      pixels = g_malloc (width * height * 4);
+
+      cogl_read_pixels (read_x, read_y, width, height,
+                        COGL_READ_PIXELS_COLOR_BUFFER,
+                        COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                        pixels);
+
+      for (i = 0; i < n_indices; i++)
+        {
+          gint x = ((gint) points[indices[i]].x - area.x) * window_scale;
+          gint y = ((gint) points[indices[i]].y - area.y) * window_scale;
+
+          actors[indices[i]] =
+            clutter_stage_pixel_to_actor (stage, pixels + (y * width + x) * 4);
+        }
+
+      g_free (pixels);
+    }
+  else
+    {
+      for (i = 0; i < n_indices; i++)
+        {
+          guchar pixel[4] = { 0xff, 0xff, 0xff, 0xff };
+          gint x = ((gint) points[indices[i]].x - area.x) * window_scale;
+          gint y = ((gint) points[indices[i]].y - area.y) * window_scale;
+
+          cogl_read_pixels (read_x + x, read_y + y, 1, 1,
+                            COGL_READ_PIXELS_COLOR_BUFFER,
+                            COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                            pixel);
+
+          actors[indices[i]] = clutter_stage_pixel_to_actor (stage, pixel);
+        }
+    }
 
   if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS))
     {
@@ -1463,7 +1930,12 @@ _clutter_stage_do_pick (ClutterStage   *stage,
                      _clutter_actor_get_debug_name (actor),
                      NULL);
 
-      read_pixels_to_file (file_name, 0, 0, stage_width, stage_height);
+      if (offscreen != NULL)
+        read_pixels_to_file (file_name, 0, 0,
+                             area.width * window_scale,
+                             area.height * window_scale);
+      else
+        read_pixels_to_file (file_name, 0, 0, stage_width, stage_height);
 
       g_free (file_name);
     }
@@ -1471,23 +1943,258 @@ _clutter_stage_do_pick (ClutterStage   *stage,
   /* Restore whether GL_DITHER was enabled */
   cogl_framebuffer_set_dither_enabled (fb, dither_enabled_save);
 
-  if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
+  if (offscreen != NULL)
+    {
+      priv->pick_framebuffer = NULL;
+      cogl_pop_framebuffer ();
+    }
+  else if (G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
     cogl_framebuffer_pop_clip (fb);
 
   _clutter_stage_dirty_viewport (stage);
+}
 
-  if (pixel[0] == 0xff && pixel[1] == 0xff && pixel[2] == 0xff)
-    retval = actor;
-  else
+/*< private >
+ * _clutter_stage_do_pick_multiple:
+ * @stage: a #ClutterStage
+ * @points: (array length=n_points): the points to pick, in stage
+ *   coordinates
+ * @n_points: the number of points
+ * @mode: the pick mode
+ * @actors: (array length=n_points) (out caller-allocates): return
+ *   location for the actors at each point
+ *
+ * Picks all the @points with a single traversal of the scene graph.
+ */
+void
+_clutter_stage_do_pick_multiple (ClutterStage       *stage,
+                                 const ClutterPoint *points,
+                                 guint               n_points,
+                                 ClutterPickMode     mode,
+                                 ClutterActor      **actors)
+{
+  ClutterActor *actor = CLUTTER_ACTOR (stage);
+  ClutterStagePrivate *priv = stage->priv;
+  float stage_width, stage_height;
+  guint *pending;
+  guint n_pending;
+  guint i;
+
+  for (i = 0; i < n_points; i++)
+    actors[i] = actor;
+
+  if (n_points == 0)
+    return;
+
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
+    return;
+
+  if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_NOP_PICKING))
+    return;
+
+  if (G_UNLIKELY (priv->impl == NULL))
+    return;
+
+  clutter_actor_get_size (actor, &stage_width, &stage_height);
+
+  pending = g_new (guint, n_points);
+  n_pending = 0;
+
+  for (i = 0; i < n_points; i++)
     {
-      guint32 id_ = _clutter_pixel_to_id (pixel);
+      gint x = points[i].x;
+      gint y = points[i].y;
+
+      if (x < 0 || x >= stage_width || y < 0 || y >= stage_height)
+        continue;
+
+      if (priv->geometric_picking ||
+          G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_GEOMETRIC_PICKING))
+        {
+          ClutterActor *hit = NULL;
+
+          CLUTTER_NOTE (PICK, "Performing geometric pick at %i,%i", x, y);
 
-      retval = _clutter_stage_get_actor_by_pick_id (stage, id_);
+          /* we test the center of the pixel, which is what the
+           * rasterizer samples when painting in pick mode
+           */
+          if (_clutter_actor_geometric_pick (actor,
+                                             &priv->projection,
+                                             priv->viewport,
+                                             mode,
+                                             x + 0.5f, y + 0.5f,
+                                             &hit))
+            {
+              actors[i] = hit != NULL ? hit : actor;
+              continue;
+            }
+
+          CLUTTER_NOTE (PICK, "Geometric pick failed, falling back to pick paint");
+        }
+
+      pending[n_pending++] = i;
+    }
+
+  if (n_pending > 0)
+    clutter_stage_pick_paint (stage, points, pending, n_pending, mode, actors);
+
+  g_free (pending);
+}
+
+ClutterActor *
+_clutter_stage_do_pick (ClutterStage   *stage,
+                        gint            x,
+                        gint            y,
+                        ClutterPickMode mode)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterStagePickCacheEntry *entry;
+  ClutterActor *retval = NULL;
+  ClutterPoint point;
+  guint i;
+
+  for (i = 0; i < PICK_CACHE_SIZE; i++)
+    {
+      entry = &priv->pick_cache[i];
+
+      if (entry->generation == priv->scene_generation &&
+          entry->x == x && entry->y == y && entry->mode == mode)
+        {
+          priv->pick_cache_hits += 1;
+
+          CLUTTER_NOTE (PICK, "Pick cache hit at %i,%i (hits: %u, misses: %u)",
+                        x, y,
+                        priv->pick_cache_hits,
+                        priv->pick_cache_misses);
+
+          return entry->actor;
+        }
     }
 
+  /* use the results of the last batched pick, if it is still valid */
+  for (i = 0; i < priv->n_pick_hints; i++)
+    {
+      ClutterStagePickHint *hint = &priv->pick_hints[i];
+
+      if (hint->x == x && hint->y == y && hint->mode == mode)
+        {
+          CLUTTER_NOTE (PICK, "Using the batched pick at %i,%i", x, y);
+          retval = hint->actor;
+          break;
+        }
+    }
+
+  if (retval == NULL)
+    {
+      priv->pick_cache_misses += 1;
+
+      CLUTTER_NOTE (PICK, "Pick cache miss at %i,%i (hits: %u, misses: %u)",
+                    x, y,
+                    priv->pick_cache_hits,
+                    priv->pick_cache_misses);
+
+      point.x = x;
+      point.y = y;
+
+      _clutter_stage_do_pick_multiple (stage, &point, 1, mode, &retval);
+    }
+
+  /* the pick itself does not change the scene, so we can store the
+   * result with the current generation
+   */
+  entry = &priv->pick_cache[priv->pick_cache_next];
+  entry->x = x;
+  entry->y = y;
+  entry->mode = mode;
+  entry->actor = retval;
+  entry->generation = priv->scene_generation;
+
+  priv->pick_cache_next = (priv->pick_cache_next + 1) % PICK_CACHE_SIZE;
+
   return retval;
 }
 
+/*< private >
+ * _clutter_stage_pick_hints:
+ * @stage: a #ClutterStage
+ * @points: (array length=n_points): the points to pick
+ * @n_points: the number of points
+ * @mode: the pick mode
+ *
+ * Picks all the @points at once, and stores the results so that
+ * the following calls to _clutter_stage_do_pick() for the same
+ * points will not need to pick them again, until the scene graph
+ * changes or _clutter_stage_clear_pick_hints() is called.
+ */
+void
+_clutter_stage_pick_hints (ClutterStage       *stage,
+                           const ClutterPoint *points,
+                           guint               n_points,
+                           ClutterPickMode     mode)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterActor **actors;
+  guint i;
+
+  _clutter_stage_clear_pick_hints (stage);
+
+  if (n_points < 2)
+    return;
+
+  actors = g_new (ClutterActor *, n_points);
+
+  _clutter_stage_do_pick_multiple (stage, points, n_points, mode, actors);
+
+  priv->pick_hints = g_new (ClutterStagePickHint, n_points);
+  priv->n_pick_hints = n_points;
+
+  for (i = 0; i < n_points; i++)
+    {
+      ClutterStagePickHint *hint = &priv->pick_hints[i];
+
+      hint->x = points[i].x;
+      hint->y = points[i].y;
+      hint->mode = mode;
+      hint->actor = actors[i];
+    }
+
+  g_free (actors);
+}
+
+void
+_clutter_stage_clear_pick_hints (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  g_clear_pointer (&priv->pick_hints, g_free);
+  priv->n_pick_hints = 0;
+}
+
+/*< private >
+ * _clutter_stage_invalidate_pick:
+ * @stage: a #ClutterStage
+ *
+ * Advances the scene generation of @stage, which invalidates all the
+ * cached pick results. This should be called every time something
+ * that might affect the result of a pick changes.
+ */
+void
+_clutter_stage_invalidate_pick (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  priv->scene_generation += 1;
+
+  /* generation 0 is reserved for the unused cache entries */
+  if (G_UNLIKELY (priv->scene_generation == 0))
+    {
+      memset (priv->pick_cache, 0, sizeof (priv->pick_cache));
+      priv->scene_generation = 1;
+    }
+
+  _clutter_stage_clear_pick_hints (stage);
+}
+
 static gboolean
 clutter_stage_real_delete_event (ClutterStage *stage,
                                  ClutterEvent *event)
@@ -1704,6 +2411,9 @@ clutter_stage_dispose (GObject *object)
 
   _clutter_clear_events_queue_for_stage (stage);
 
+  clutter_stage_clear_pick_offscreen (stage);
+  clutter_stage_release_frame_trace (stage);
+
   if (priv->impl != NULL)
     {
       CLUTTER_NOTE (BACKEND, "Disposing of the stage implementation");
@@ -1715,6 +2425,8 @@ clutter_stage_dispose (GObject *object)
       priv->impl = NULL;
     }
 
+  g_ptr_array_set_size (priv->relayout_roots, 0);
+
   clutter_actor_destroy_all_children (CLUTTER_ACTOR (object));
 
   g_list_free_full (priv->pending_queue_redraws,
@@ -1743,6 +2455,14 @@ clutter_stage_finalize (GObject *object)
 
   _clutter_id_pool_free (priv->pick_id_pool);
 
+  _clutter_spatial_index_free (priv->spatial_index);
+
+  g_ptr_array_unref (priv->relayout_roots);
+
+  g_free (priv->pick_hints);
+
+  g_free (priv->frame_timings);
+
   if (priv->fps_timer != NULL)
     g_timer_destroy (priv->fps_timer);
 
@@ -2226,7 +2946,18 @@ clutter_stage_init (ClutterStage *self)
   priv->paint_volume_stack =
     g_array_new (FALSE, FALSE, sizeof (ClutterPaintVolume));
 
-  priv->pick_id_pool = _clutter_id_pool_new (256);
+  priv->pick_id_pool = _clutter_id_pool_new (256);
+
+  /* generation 0 is reserved for the unused pick cache entries */
+  priv->scene_generation = 1;
+
+  /* the trace needs the frame timings of every stage */
+  if (_clutter_get_frame_trace_file () != NULL)
+    priv->frame_timings = g_new0 (ClutterFrameTiming, N_FRAME_TIMINGS);
+
+  priv->spatial_index = _clutter_spatial_index_new ();
+
+  priv->relayout_roots = g_ptr_array_new_with_free_func (g_object_unref);
 }
 
 /**
@@ -2336,6 +3067,9 @@ clutter_stage_set_perspective_internal (ClutterStage       *stage,
   cogl_matrix_get_inverse (&priv->projection,
                            &priv->inverse_projection);
 
+  /* every paint box on the stage needs to be updated */
+  _clutter_actor_invalidate_transform (CLUTTER_ACTOR (stage));
+
   priv->dirty_projection = TRUE;
   clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
 }
@@ -2483,6 +3217,8 @@ _clutter_stage_set_viewport (ClutterStage *stage,
 
   priv->dirty_viewport = TRUE;
 
+  _clutter_actor_invalidate_transform (CLUTTER_ACTOR (stage));
+
   queue_full_redraw (stage);
 }
 
@@ -2809,6 +3545,37 @@ clutter_stage_get_actor_at_pos (ClutterStage    *stage,
   return _clutter_stage_do_pick (stage, x, y, pick_mode);
 }
 
+/**
+ * clutter_stage_get_actors_at_positions:
+ * @stage: a #ClutterStage
+ * @pick_mode: how the scene graph should be painted
+ * @positions: (array length=n_positions): the coordinates to check
+ * @n_positions: the number of coordinates in @positions
+ * @actors: (array length=n_positions) (out caller-allocates) (transfer none):
+ *   return location for an array of @n_positions actors
+ *
+ * Checks the scene at each of the passed @positions, and stores a
+ * pointer to the #ClutterActor at those coordinates inside @actors.
+ *
+ * This function is equivalent to calling clutter_stage_get_actor_at_pos()
+ * for each position, but it paints the scene graph only once.
+ *
+ * Since: 1.26
+ */
+void
+clutter_stage_get_actors_at_positions (ClutterStage        *stage,
+                                       ClutterPickMode      pick_mode,
+                                       const ClutterPoint  *positions,
+                                       guint                n_positions,
+                                       ClutterActor       **actors)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (n_positions == 0 || positions != NULL);
+  g_return_if_fail (n_positions == 0 || actors != NULL);
+
+  _clutter_stage_do_pick_multiple (stage, positions, n_positions, pick_mode, actors);
+}
+
 /**
  * clutter_stage_event:
  * @stage: a #ClutterStage
@@ -3429,6 +4196,7 @@ _clutter_stage_maybe_setup_viewport (ClutterStage *stage)
   if (priv->dirty_viewport)
     {
       ClutterPerspective perspective;
+      CoglMatrix old_view;
       int window_scale;
       float z_2d;
 
@@ -3467,6 +4235,8 @@ _clutter_stage_maybe_setup_viewport (ClutterStage *stage)
       else
         z_2d = calculate_z_translation (perspective.z_near);
 
+      old_view = priv->view;
+
       cogl_matrix_init_identity (&priv->view);
       cogl_matrix_view_2d_in_perspective (&priv->view,
                                           perspective.fovy,
@@ -3476,6 +4246,9 @@ _clutter_stage_maybe_setup_viewport (ClutterStage *stage)
                                           priv->viewport[2] * window_scale,
                                           priv->viewport[3] * window_scale);
 
+      if (!cogl_matrix_equal (&old_view, &priv->view))
+        _clutter_actor_invalidate_transform (CLUTTER_ACTOR (stage));
+
       clutter_stage_apply_scale (stage);
 
       priv->dirty_viewport = FALSE;
@@ -3928,6 +4701,20 @@ _clutter_stage_get_clip (ClutterStage *stage)
   return stage->priv->current_clip_planes;
 }
 
+ClutterSpatialIndex *
+_clutter_stage_get_spatial_index (ClutterStage *stage)
+{
+  return stage->priv->spatial_index;
+}
+
+/* The mark of the entries of the spatial index that intersect the
+ * area currently being painted, or 0 when not painting. */
+guint
+_clutter_stage_get_spatial_index_mark (ClutterStage *stage)
+{
+  return stage->priv->spatial_index_mark;
+}
+
 /* When an actor queues a redraw we add it to a list on the stage that
  * gets processed once all updates to the stage have been finished.
  *
@@ -3950,6 +4737,9 @@ _clutter_stage_queue_actor_redraw (ClutterStage *stage,
   CLUTTER_NOTE (CLIPPING, "stage_queue_actor_redraw (actor=%s, clip=%p): ",
                 _clutter_actor_get_debug_name (actor), clip);
 
+  /* the scene graph changed, so the cached picks might be stale */
+  _clutter_stage_invalidate_pick (stage);
+
   if (!priv->redraw_pending)
     {
       ClutterMasterClock *master_clock;
@@ -4230,6 +5020,9 @@ _clutter_stage_release_pick_id (ClutterStage *stage,
   g_assert (priv->pick_id_pool != NULL);
 
   _clutter_id_pool_remove (priv->pick_id_pool, pick_id);
+
+  /* the actor is not pickable any more */
+  _clutter_stage_invalidate_pick (stage);
 }
 
 ClutterActor *
@@ -4491,6 +5284,465 @@ clutter_stage_skip_sync_delay (ClutterStage *stage)
     _clutter_stage_window_schedule_update (stage_window, -1);
 }
 
+/**
+ * clutter_stage_set_geometric_picking:
+ * @stage: a #ClutterStage
+ * @enabled: whether to enable geometric picking
+ *
+ * Sets whether @stage should resolve picks by intersecting the pick
+ * point with the transformed allocation of each actor, instead of
+ * painting the scene graph in pick mode and reading back the color
+ * of a pixel.
+ *
+ * Actors overriding the #ClutterActorClass.pick virtual function
+ * without overriding #ClutterActorClass.hit_test, or with handlers
+ * connected to the #ClutterActor::pick signal, or with effects
+ * overriding the #ClutterEffectClass.pick virtual function, will
+ * cause a fall back to the pick paint.
+ *
+ * Geometric picking can also be enabled for all stages by setting
+ * the `CLUTTER_PICK` environment variable to `geometric-picking`.
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+void
+clutter_stage_set_geometric_picking (ClutterStage *stage,
+                                     gboolean      enabled)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  stage->priv->geometric_picking = !!enabled;
+}
+
+/**
+ * clutter_stage_get_geometric_picking:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set with clutter_stage_set_geometric_picking().
+ *
+ * Return value: %TRUE if geometric picking is enabled
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+gboolean
+clutter_stage_get_geometric_picking (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->geometric_picking;
+}
+
+/**
+ * clutter_stage_set_retain_paint_nodes:
+ * @stage: a #ClutterStage
+ * @retain: whether the actors should retain their paint nodes
+ *
+ * Sets whether the actors on @stage should keep the tree of
+ * #ClutterPaintNode they create when painting across frames, and
+ * replay it instead of building a new one on every paint.
+ *
+ * The tree of an actor is rebuilt only after the actor queues a
+ * redraw, or when its size or paint opacity change; actors whose
+ * #ClutterActorClass.paint_node implementation depends on state
+ * that does not queue a redraw when changed will not be updated
+ * correctly.
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+void
+clutter_stage_set_retain_paint_nodes (ClutterStage *stage,
+                                      gboolean      retain)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+
+  retain = !!retain;
+
+  if (priv->retain_paint_nodes == retain)
+    return;
+
+  priv->retain_paint_nodes = retain;
+
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+}
+
+/**
+ * clutter_stage_get_retain_paint_nodes:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set with clutter_stage_set_retain_paint_nodes().
+ *
+ * Return value: %TRUE if the actors retain their paint nodes
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+gboolean
+clutter_stage_get_retain_paint_nodes (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->retain_paint_nodes;
+}
+
+/**
+ * clutter_stage_set_frame_timings_enabled:
+ * @stage: a #ClutterStage
+ * @enabled: whether the frame timings should be collected
+ *
+ * Sets whether @stage should collect the time spent in each phase of
+ * the frames it takes part in: event processing, animations, relayout,
+ * paint and swap.
+ *
+ * The timings of the last frames are kept by @stage, and can be
+ * retrieved using clutter_stage_get_frame_timings(). Disabling the
+ * collection discards them.
+ *
+ * Frame timings are enabled by default on every stage when the
+ * CLUTTER_FRAME_TRACE_FILE environment variable is set.
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+void
+clutter_stage_set_frame_timings_enabled (ClutterStage *stage,
+                                         gboolean      enabled)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  priv = stage->priv;
+
+  if (enabled == (priv->frame_timings != NULL))
+    return;
+
+  if (enabled)
+    priv->frame_timings = g_new0 (ClutterFrameTiming, N_FRAME_TIMINGS);
+  else
+    {
+      g_clear_pointer (&priv->frame_timings, g_free);
+      priv->in_frame_timing = FALSE;
+    }
+
+  priv->frame_timings_next = 0;
+  priv->n_frame_timings = 0;
+}
+
+/**
+ * clutter_stage_get_frame_timings_enabled:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set with clutter_stage_set_frame_timings_enabled().
+ *
+ * Return value: %TRUE if the frame timings are being collected
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+gboolean
+clutter_stage_get_frame_timings_enabled (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->frame_timings != NULL;
+}
+
+/**
+ * clutter_stage_get_frame_timings:
+ * @stage: a #ClutterStage
+ * @timings: (array length=n_timings) (out caller-allocates) (allow-none):
+ *   return location for the timings
+ * @n_timings: the number of elements of @timings
+ *
+ * Copies the timings of the last frames of @stage, from the oldest to
+ * the most recent, into @timings.
+ *
+ * If @timings is %NULL, this function returns the number of frame
+ * timings available.
+ *
+ * Frame timings are only collected if they were enabled using
+ * clutter_stage_set_frame_timings_enabled().
+ *
+ * Return value: the number of timings copied into @timings
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+guint
+clutter_stage_get_frame_timings (ClutterStage       *stage,
+                                 ClutterFrameTiming *timings,
+                                 guint               n_timings)
+{
+  ClutterStagePrivate *priv;
+  guint i, first;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), 0);
+
+  priv = stage->priv;
+
+  if (timings == NULL)
+    return priv->n_frame_timings;
+
+  n_timings = MIN (n_timings, priv->n_frame_timings);
+
+  first = priv->frame_timings_next + N_FRAME_TIMINGS - n_timings;
+
+  for (i = 0; i < n_timings; i++)
+    timings[i] = priv->frame_timings[(first + i) % N_FRAME_TIMINGS];
+
+  return n_timings;
+}
+
+static const char *frame_phase_names[CLUTTER_N_FRAME_PHASES] = {
+  "events",
+  "animations",
+  "relayout",
+  "paint",
+  "swap",
+};
+
+static gint64 *
+clutter_frame_timing_get_phase (ClutterFrameTiming *timing,
+                                ClutterFramePhase   phase)
+{
+  switch (phase)
+    {
+    case CLUTTER_FRAME_PHASE_EVENTS:
+      return &timing->events;
+
+    case CLUTTER_FRAME_PHASE_ANIMATIONS:
+      return &timing->animations;
+
+    case CLUTTER_FRAME_PHASE_RELAYOUT:
+      return &timing->relayout;
+
+    case CLUTTER_FRAME_PHASE_PAINT:
+      return &timing->paint;
+
+    case CLUTTER_FRAME_PHASE_SWAP:
+      return &timing->swap;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  return NULL;
+}
+
+/* the trace file is shared by all the stages, and it is closed once
+ * the last stage writing to it is disposed
+ */
+static FILE *frame_trace = NULL;
+static guint n_frame_trace_stages = 0;
+static gboolean frame_trace_started = FALSE;
+static gboolean frame_trace_failed = FALSE;
+
+static FILE *
+clutter_stage_get_frame_trace (ClutterStage *stage)
+{
+  static guint n_traced_stages = 0;
+  ClutterStagePrivate *priv = stage->priv;
+  const char *path;
+
+  if (priv->frame_trace_id != 0)
+    return frame_trace;
+
+  path = _clutter_get_frame_trace_file ();
+  if (path == NULL || frame_trace_failed)
+    return NULL;
+
+  if (frame_trace == NULL)
+    {
+      /* a stage coming after the file was closed appends to it */
+      frame_trace = g_fopen (path, frame_trace_started ? "a" : "w");
+      if (frame_trace == NULL)
+        {
+          g_warning ("Unable to open the frame trace file '%s': %s",
+                     path,
+                     g_strerror (errno));
+          frame_trace_failed = TRUE;
+          return NULL;
+        }
+
+      /* the closing bracket of the array is optional in the trace
+       * event format, which allows us to just append events
+       */
+      if (!frame_trace_started)
+        fputs ("[\n", frame_trace);
+
+      frame_trace_started = TRUE;
+    }
+
+  n_frame_trace_stages += 1;
+  priv->frame_trace_id = ++n_traced_stages;
+
+  fprintf (frame_trace,
+           "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+           "\"tid\":%u,\"args\":{\"name\":\"Stage %u\"}},\n",
+           priv->frame_trace_id,
+           priv->frame_trace_id);
+
+  return frame_trace;
+}
+
+static void
+clutter_stage_release_frame_trace (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (priv->frame_trace_id == 0)
+    return;
+
+  priv->frame_trace_id = 0;
+
+  n_frame_trace_stages -= 1;
+  if (n_frame_trace_stages == 0)
+    {
+      fclose (frame_trace);
+      frame_trace = NULL;
+    }
+}
+
+static void
+clutter_stage_write_frame_trace (ClutterStage *stage,
+                                 FILE         *trace)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  ClutterFrameTiming *timing = &priv->current_timing;
+  int i;
+
+  fprintf (trace,
+           "{\"name\":\"frame\",\"cat\":\"clutter\",\"ph\":\"X\","
+           "\"ts\":%" G_GINT64_FORMAT ",\"dur\":%" G_GINT64_FORMAT ","
+           "\"pid\":1,\"tid\":%u},\n",
+           priv->current_frame_start,
+           timing->total,
+           priv->frame_trace_id);
+
+  for (i = 0; i < CLUTTER_N_FRAME_PHASES; i++)
+    {
+      if (priv->current_phase_starts[i] == 0)
+        continue;
+
+      fprintf (trace,
+               "{\"name\":\"%s\",\"cat\":\"clutter\",\"ph\":\"X\","
+               "\"ts\":%" G_GINT64_FORMAT ",\"dur\":%" G_GINT64_FORMAT ","
+               "\"pid\":1,\"tid\":%u},\n",
+               frame_phase_names[i],
+               priv->current_phase_starts[i],
+               *clutter_frame_timing_get_phase (timing, i),
+               priv->frame_trace_id);
+    }
+
+  fflush (trace);
+}
+
+/*< private >
+ * _clutter_stage_begin_frame_timing:
+ * @stage: a #ClutterStage
+ * @frame_time: the time of the frame, in microseconds
+ *
+ * Starts timing a new frame of @stage, if frame timings are enabled.
+ */
+void
+_clutter_stage_begin_frame_timing (ClutterStage *stage,
+                                   gint64        frame_time)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (priv->frame_timings == NULL)
+    return;
+
+  memset (&priv->current_timing, 0, sizeof (ClutterFrameTiming));
+  memset (priv->current_phase_starts, 0, sizeof (priv->current_phase_starts));
+
+  priv->current_timing.frame_time = frame_time;
+  priv->current_frame_start = g_get_monotonic_time ();
+  priv->in_frame_timing = TRUE;
+}
+
+/*< private >
+ * _clutter_stage_add_frame_phase:
+ * @stage: a #ClutterStage
+ * @phase: the phase of the frame
+ * @start: the time at which the phase started, in microseconds
+ * @end: the time at which the phase ended, in microseconds
+ *
+ * Accounts the time between @start and @end to the @phase of the
+ * frame currently being timed.
+ */
+void
+_clutter_stage_add_frame_phase (ClutterStage      *stage,
+                                ClutterFramePhase  phase,
+                                gint64             start,
+                                gint64             end)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (!priv->in_frame_timing)
+    return;
+
+  if (priv->current_phase_starts[phase] == 0)
+    priv->current_phase_starts[phase] = start;
+
+  *clutter_frame_timing_get_phase (&priv->current_timing, phase) += end - start;
+}
+
+/*< private >
+ * _clutter_stage_begin_frame_swap:
+ * @stage: a #ClutterStage
+ *
+ * Marks the end of the painting and the beginning of the swap of
+ * the frame currently being timed. This should be called by the
+ * #ClutterStageWindow implementations that can tell them apart.
+ */
+void
+_clutter_stage_begin_frame_swap (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (!priv->in_frame_timing)
+    return;
+
+  priv->current_swap_start = g_get_monotonic_time ();
+}
+
+/*< private >
+ * _clutter_stage_end_frame_timing:
+ * @stage: a #ClutterStage
+ *
+ * Stores the timings of the current frame of @stage, and writes
+ * them to the frame trace file, if any.
+ */
+void
+_clutter_stage_end_frame_timing (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  FILE *trace;
+
+  if (!priv->in_frame_timing)
+    return;
+
+  priv->in_frame_timing = FALSE;
+  priv->current_timing.total =
+    g_get_monotonic_time () - priv->current_frame_start;
+
+  priv->frame_timings[priv->frame_timings_next] = priv->current_timing;
+  priv->frame_timings_next = (priv->frame_timings_next + 1) % N_FRAME_TIMINGS;
+  priv->n_frame_timings = MIN (priv->n_frame_timings + 1, N_FRAME_TIMINGS);
+
+  trace = clutter_stage_get_frame_trace (stage);
+  if (trace != NULL)
+    clutter_stage_write_frame_trace (stage, trace);
+}
+
 void
 _clutter_stage_set_scale_factor (ClutterStage *stage,
                                  int           factor)
@@ -219,6 +219,12 @@ ClutterActor *  clutter_stage_get_actor_at_pos                  (ClutterStage
                                                                  ClutterPickMode        pick_mode,
                                                                  gint                   x,
                                                                  gint                   y);
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_get_actors_at_positions           (ClutterStage          *stage,
+                                                                 ClutterPickMode        pick_mode,
+                                                                 const ClutterPoint    *positions,
+                                                                 guint                  n_positions,
+                                                                 ClutterActor         **actors);
 CLUTTER_AVAILABLE_IN_ALL
 guchar *        clutter_stage_read_pixels                       (ClutterStage          *stage,
                                                                  gint                   x,
@@ -238,11 +244,69 @@ CLUTTER_AVAILABLE_IN_ALL
 void            clutter_stage_ensure_redraw                     (ClutterStage          *stage);
 
 #ifdef CLUTTER_ENABLE_EXPERIMENTAL_API
+typedef struct _ClutterFrameTiming      ClutterFrameTiming;
+
+/**
+ * ClutterFrameTiming:
+ * @frame_time: the time of the frame, as used by the master clock to
+ *   advance the timelines, in microseconds
+ * @events: the time spent processing the queued events of the stage,
+ *   in microseconds
+ * @animations: the time spent advancing the timelines, in microseconds
+ * @relayout: the time spent relayouting the stage, in microseconds
+ * @paint: the time spent painting the stage, in microseconds
+ * @swap: the time spent presenting the contents of the stage, in
+ *   microseconds
+ * @total: the time spent on the whole frame, in microseconds
+ *
+ * The timings of the phases of a single frame of a #ClutterStage.
+ *
+ * The timelines are shared by all the stages, so the @animations
+ * phase is the same for every stage updated in the same frame.
+ *
+ * Since: 1.26
+ * Stability: unstable
+ */
+struct _ClutterFrameTiming
+{
+  gint64 frame_time;
+
+  gint64 events;
+  gint64 animations;
+  gint64 relayout;
+  gint64 paint;
+  gint64 swap;
+
+  gint64 total;
+};
+
 CLUTTER_AVAILABLE_IN_1_14
 void            clutter_stage_set_sync_delay                    (ClutterStage          *stage,
                                                                  gint                   sync_delay);
 CLUTTER_AVAILABLE_IN_1_14
 void            clutter_stage_skip_sync_delay                   (ClutterStage          *stage);
+
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_geometric_picking             (ClutterStage          *stage,
+                                                                 gboolean               enabled);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_stage_get_geometric_picking             (ClutterStage          *stage);
+
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_retain_paint_nodes            (ClutterStage          *stage,
+                                                                 gboolean               retain);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_stage_get_retain_paint_nodes            (ClutterStage          *stage);
+
+CLUTTER_AVAILABLE_IN_1_26
+void            clutter_stage_set_frame_timings_enabled         (ClutterStage          *stage,
+                                                                 gboolean               enabled);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean        clutter_stage_get_frame_timings_enabled         (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_26
+guint           clutter_stage_get_frame_timings                 (ClutterStage          *stage,
+                                                                 ClutterFrameTiming    *timings,
+                                                                 guint                  n_timings);
 #endif
 
 G_END_DECLS
@@ -176,6 +176,13 @@ struct _ClutterTextPrivate
   /* Signal handler for when the :text-direction changes */
   guint direction_changed_id;
 
+  /* the layouts being shaped in the worker thread, and the layouts
+   * displayed in the meantime, if :async-layout is set
+   */
+  GSList *shape_jobs;
+  PangoLayout *fallback_layout;
+  PangoLayout *placeholder_layout;
+
   /* bitfields */
   guint alignment               : 2;
   guint wrap                    : 1;
@@ -201,6 +208,7 @@ struct _ClutterTextPrivate
   guint show_password_hint      : 1;
   guint password_hint_visible   : 1;
   guint resolved_direction      : 4;
+  guint async_layout            : 1;
 };
 
 enum
@@ -236,6 +244,7 @@ enum
   PROP_SINGLE_LINE_MODE,
   PROP_SELECTED_TEXT_COLOR,
   PROP_SELECTED_TEXT_COLOR_SET,
+  PROP_ASYNC_LAYOUT,
 
   PROP_LAST
 };
@@ -486,6 +495,42 @@ clutter_text_ensure_effective_attributes (ClutterText *self)
     }
 }
 
+static PangoDirection
+clutter_text_resolve_direction (ClutterText *text,
+                                const gchar *contents,
+                                gsize        contents_len)
+{
+  ClutterTextPrivate *priv = text->priv;
+  PangoDirection pango_dir;
+
+  if (priv->password_char != 0)
+    pango_dir = PANGO_DIRECTION_NEUTRAL;
+  else
+    pango_dir = pango_find_base_dir (contents, contents_len);
+
+  if (pango_dir == PANGO_DIRECTION_NEUTRAL)
+    {
+      ClutterBackend *backend = clutter_get_default_backend ();
+      ClutterTextDirection text_dir;
+
+      if (clutter_actor_has_key_focus (CLUTTER_ACTOR (text)))
+        pango_dir = _clutter_backend_get_keymap_direction (backend);
+      else
+        {
+          text_dir = clutter_actor_get_text_direction (CLUTTER_ACTOR (text));
+
+          if (text_dir == CLUTTER_TEXT_DIRECTION_RTL)
+            pango_dir = PANGO_DIRECTION_RTL;
+          else
+            pango_dir = PANGO_DIRECTION_LTR;
+       }
+    }
+
+  priv->resolved_direction = pango_dir;
+
+  return pango_dir;
+}
+
 static PangoLayout *
 clutter_text_create_layout_no_cache (ClutterText       *text,
 				     gint               width,
@@ -534,33 +579,10 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
     {
       PangoDirection pango_dir;
 
-      if (priv->password_char != 0)
-        pango_dir = PANGO_DIRECTION_NEUTRAL;
-      else
-        pango_dir = pango_find_base_dir (contents, contents_len);
-
-      if (pango_dir == PANGO_DIRECTION_NEUTRAL)
-        {
-          ClutterBackend *backend = clutter_get_default_backend ();
-          ClutterTextDirection text_dir;
-
-          if (clutter_actor_has_key_focus (CLUTTER_ACTOR (text)))
-            pango_dir = _clutter_backend_get_keymap_direction (backend);
-          else
-            {
-              text_dir = clutter_actor_get_text_direction (CLUTTER_ACTOR (text));
-
-              if (text_dir == CLUTTER_TEXT_DIRECTION_RTL)
-                pango_dir = PANGO_DIRECTION_RTL;
-              else
-                pango_dir = PANGO_DIRECTION_LTR;
-           }
-        }
+      pango_dir = clutter_text_resolve_direction (text, contents, contents_len);
 
       pango_context_set_base_dir (clutter_actor_get_pango_context (CLUTTER_ACTOR (text)), pango_dir);
 
-      priv->resolved_direction = pango_dir;
-
       pango_layout_set_text (layout, contents, contents_len);
     }
 
@@ -585,12 +607,923 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
   return layout;
 }
 
+/* The layouts of non-editable text actors are shared by all the
+ * actors displaying the same contents using the same settings, so
+ * that labels repeated across the scene are shaped only once.
+ *
+ * The shared layouts are created using a PangoContext owned by the
+ * cache, and they must not be modified once they are in the cache.
+ * The least recently used layouts are evicted when the estimated
+ * memory used by the layouts goes over SHARED_LAYOUTS_BUDGET; the
+ * text actors using an evicted layout keep a reference on it.
+ *
+ * The layouts shaped by the worker thread keep the font map of their
+ * ShapeBatch alive, with its fonts and glyph caches; each of those
+ * font maps is counted as SHAPER_FONT_MAP_SIZE in the budget for as
+ * long as any shared layout uses it, so that the font maps of the old
+ * batches are released by evicting their layouts.
+ */
+#define SHARED_LAYOUTS_BUDGET   (4 * 1024 * 1024)
+#define SHAPER_FONT_MAP_SIZE    (512 * 1024)
+
+typedef struct _SharedLayout    SharedLayout;
+
+struct _SharedLayout
+{
+  gchar *contents;
+  PangoAttrList *attrs;
+  PangoFontDescription *font_desc;
+  gint width;
+  gint height;
+  guint ellipsize        : 3;
+  guint alignment        : 2;
+  guint wrap_mode        : 3;
+  guint justify          : 1;
+  guint single_line_mode : 1;
+  guint direction        : 4;
+  guint hash;
+
+  PangoLayout *layout;
+  gsize size;
+
+  GList link;
+};
+
+static GHashTable *shared_layouts = NULL;
+static GQueue shared_layouts_lru = G_QUEUE_INIT;
+static gsize shared_layouts_size = 0;
+static gint32 shared_layouts_serial = 0;
+static guint shared_layouts_n_hits = 0;
+static guint shared_layouts_n_misses = 0;
+
+/* one context for each base direction */
+static PangoContext *shared_contexts[2] = { NULL, NULL };
+
+/* the number of shared layouts using a worker font map */
+static GQuark quark_shared_layouts_count = 0;
+
+static gint
+compare_attributes (gconstpointer a,
+                    gconstpointer b)
+{
+  return pango_attribute_equal (a, b) ? 0 : 1;
+}
+
+static gboolean
+attr_lists_equal (PangoAttrList *a,
+                  PangoAttrList *b)
+{
+  PangoAttrIterator *iter_a, *iter_b;
+  gboolean equal = TRUE;
+
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  iter_a = pango_attr_list_get_iterator (a);
+  iter_b = pango_attr_list_get_iterator (b);
+
+  while (equal)
+    {
+      GSList *attrs_a, *attrs_b, *l;
+      gint start_a, end_a, start_b, end_b;
+      gboolean has_next_a, has_next_b;
+
+      pango_attr_iterator_range (iter_a, &start_a, &end_a);
+      pango_attr_iterator_range (iter_b, &start_b, &end_b);
+
+      if (start_a != start_b || end_a != end_b)
+        {
+          equal = FALSE;
+          break;
+        }
+
+      attrs_a = pango_attr_iterator_get_attrs (iter_a);
+      attrs_b = pango_attr_iterator_get_attrs (iter_b);
+
+      if (g_slist_length (attrs_a) != g_slist_length (attrs_b))
+        equal = FALSE;
+
+      for (l = attrs_a; equal && l != NULL; l = l->next)
+        {
+          if (g_slist_find_custom (attrs_b, l->data, compare_attributes) == NULL)
+            equal = FALSE;
+        }
+
+      g_slist_free_full (attrs_a, (GDestroyNotify) pango_attribute_destroy);
+      g_slist_free_full (attrs_b, (GDestroyNotify) pango_attribute_destroy);
+
+      has_next_a = pango_attr_iterator_next (iter_a);
+      has_next_b = pango_attr_iterator_next (iter_b);
+
+      if (has_next_a != has_next_b)
+        equal = FALSE;
+
+      if (!has_next_a)
+        break;
+    }
+
+  pango_attr_iterator_destroy (iter_a);
+  pango_attr_iterator_destroy (iter_b);
+
+  return equal;
+}
+
+static guint
+shared_layout_hash (gconstpointer data)
+{
+  const SharedLayout *shared = data;
+
+  return shared->hash;
+}
+
+static gboolean
+shared_layout_equal (gconstpointer data_a,
+                     gconstpointer data_b)
+{
+  const SharedLayout *a = data_a;
+  const SharedLayout *b = data_b;
+
+  return a->hash == b->hash &&
+         a->width == b->width &&
+         a->height == b->height &&
+         a->ellipsize == b->ellipsize &&
+         a->alignment == b->alignment &&
+         a->wrap_mode == b->wrap_mode &&
+         a->justify == b->justify &&
+         a->single_line_mode == b->single_line_mode &&
+         a->direction == b->direction &&
+         strcmp (a->contents, b->contents) == 0 &&
+         pango_font_description_equal (a->font_desc, b->font_desc) &&
+         attr_lists_equal (a->attrs, b->attrs);
+}
+
+/* accounts for the font map of @layout, if it was shaped by the
+ * worker thread; @delta is 1 when the layout is added to the shared
+ * layouts, and -1 when it is removed
+ */
+static void
+shared_layouts_track_font_map (PangoLayout *layout,
+                               gint         delta)
+{
+  PangoFontMap *font_map;
+  guint n_layouts;
+
+  font_map = pango_context_get_font_map (pango_layout_get_context (layout));
+  if (font_map == clutter_get_font_map ())
+    return;
+
+  if (G_UNLIKELY (quark_shared_layouts_count == 0))
+    quark_shared_layouts_count =
+      g_quark_from_static_string ("-clutter-text-shared-layouts-count");
+
+  n_layouts = GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (font_map),
+                                                    quark_shared_layouts_count));
+
+  if (delta > 0 && n_layouts == 0)
+    shared_layouts_size += SHAPER_FONT_MAP_SIZE;
+  else if (delta < 0 && n_layouts == 1)
+    shared_layouts_size -= SHAPER_FONT_MAP_SIZE;
+
+  g_object_set_qdata (G_OBJECT (font_map),
+                      quark_shared_layouts_count,
+                      GUINT_TO_POINTER (n_layouts + delta));
+}
+
+static void
+shared_layout_free (gpointer data)
+{
+  SharedLayout *shared = data;
+
+  g_queue_unlink (&shared_layouts_lru, &shared->link);
+  shared_layouts_size -= shared->size;
+  shared_layouts_track_font_map (shared->layout, -1);
+
+  g_object_unref (shared->layout);
+  g_free (shared->contents);
+  if (shared->attrs != NULL)
+    pango_attr_list_unref (shared->attrs);
+  pango_font_description_free (shared->font_desc);
+
+  g_slice_free (SharedLayout, shared);
+}
+
+static void
+shared_layouts_flush (void)
+{
+  guint i;
+
+  if (shared_layouts != NULL)
+    g_hash_table_remove_all (shared_layouts);
+
+  for (i = 0; i < G_N_ELEMENTS (shared_contexts); i++)
+    g_clear_object (&shared_contexts[i]);
+}
+
+static PangoContext *
+shared_layouts_get_context (ClutterText    *text,
+                            PangoDirection  direction)
+{
+  guint i = direction == PANGO_DIRECTION_RTL ? 1 : 0;
+
+  if (shared_contexts[i] == NULL)
+    {
+      shared_contexts[i] =
+        clutter_actor_create_pango_context (CLUTTER_ACTOR (text));
+
+      pango_context_set_base_dir (shared_contexts[i], direction);
+    }
+
+  return shared_contexts[i];
+}
+
+/* the size of a layout is dominated by the glyph strings and the
+ * logical attributes Pango keeps for each character
+ */
+static inline gsize
+shared_layout_estimate_size (const SharedLayout *shared)
+{
+  return sizeof (SharedLayout) + 1024 + strlen (shared->contents) * 32;
+}
+
+/* fills @key with the state of @text; the contents are owned by
+ * the key, while the attributes and the font description are not
+ */
+static void
+shared_layout_key_init (ClutterText        *text,
+                        gint                width,
+                        gint                height,
+                        PangoEllipsizeMode  ellipsize,
+                        SharedLayout       *key)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  clutter_text_ensure_effective_attributes (text);
+
+  key->contents = clutter_text_get_display_text (text);
+  key->attrs = priv->effective_attrs;
+  key->font_desc = priv->font_desc;
+  key->width = width;
+  key->height = height;
+  key->ellipsize = ellipsize;
+  key->alignment = priv->alignment;
+  key->wrap_mode = priv->wrap_mode;
+  key->justify = priv->justify;
+  key->single_line_mode = priv->single_line_mode;
+  key->direction = clutter_text_resolve_direction (text,
+                                                   key->contents,
+                                                   strlen (key->contents));
+
+  key->hash = g_str_hash (key->contents)
+            ^ pango_font_description_hash (key->font_desc)
+            ^ ((guint) width * 31)
+            ^ ((guint) height * 17)
+            ^ (ellipsize << 28)
+            ^ (key->direction << 24);
+}
+
+/* sets up @layout from @key alone, so that it can be used off the
+ * main thread
+ */
+static void
+shared_layout_setup (const SharedLayout *key,
+                     PangoLayout        *layout)
+{
+  pango_layout_set_font_description (layout, key->font_desc);
+  pango_layout_set_text (layout, key->contents, -1);
+
+  if (key->attrs != NULL)
+    pango_layout_set_attributes (layout, key->attrs);
+
+  pango_layout_set_alignment (layout, key->alignment);
+  pango_layout_set_single_paragraph_mode (layout, key->single_line_mode);
+  pango_layout_set_justify (layout, key->justify);
+  pango_layout_set_wrap (layout, key->wrap_mode);
+
+  pango_layout_set_ellipsize (layout, key->ellipsize);
+  pango_layout_set_width (layout, key->width);
+  pango_layout_set_height (layout, key->height);
+}
+
+static SharedLayout *
+shared_layouts_lookup (const SharedLayout *key)
+{
+  ClutterBackend *backend = clutter_get_default_backend ();
+  SharedLayout *shared;
+  gint32 serial;
+
+  /* the shared contexts do not track the changes in the font
+   * settings, so we drop everything when they change
+   */
+  serial = _clutter_backend_get_units_serial (backend);
+  if (serial != shared_layouts_serial)
+    {
+      shared_layouts_flush ();
+      shared_layouts_serial = serial;
+    }
+
+  if (G_UNLIKELY (shared_layouts == NULL))
+    shared_layouts = g_hash_table_new_full (shared_layout_hash,
+                                            shared_layout_equal,
+                                            shared_layout_free,
+                                            NULL);
+
+  shared = g_hash_table_lookup (shared_layouts, key);
+  if (shared == NULL)
+    {
+      shared_layouts_n_misses += 1;
+      return NULL;
+    }
+
+  shared_layouts_n_hits += 1;
+
+  g_queue_unlink (&shared_layouts_lru, &shared->link);
+  g_queue_push_head_link (&shared_layouts_lru, &shared->link);
+
+  return shared;
+}
+
+/* adds @layout to the shared layouts, copying @key */
+static void
+shared_layouts_insert (const SharedLayout *key,
+                       PangoLayout        *layout)
+{
+  SharedLayout *shared;
+
+  shared = g_slice_dup (SharedLayout, key);
+  shared->contents = g_strdup (key->contents);
+  if (shared->attrs != NULL)
+    pango_attr_list_ref (shared->attrs);
+  shared->font_desc = pango_font_description_copy (key->font_desc);
+  shared->layout = g_object_ref (layout);
+
+  shared->size = shared_layout_estimate_size (shared);
+  shared->link.data = shared;
+  shared->link.prev = shared->link.next = NULL;
+
+  g_hash_table_add (shared_layouts, shared);
+  g_queue_push_head_link (&shared_layouts_lru, &shared->link);
+  shared_layouts_size += shared->size;
+  shared_layouts_track_font_map (shared->layout, 1);
+
+  /* keep at least the layout we just added */
+  while (shared_layouts_size > SHARED_LAYOUTS_BUDGET &&
+         shared_layouts_lru.tail != &shared->link)
+    g_hash_table_remove (shared_layouts, shared_layouts_lru.tail->data);
+
+  CLUTTER_NOTE (ACTOR, "Shared layout added for '%s' "
+                "(%u hits, %u misses, %u layouts)",
+                shared->contents,
+                shared_layouts_n_hits,
+                shared_layouts_n_misses,
+                g_hash_table_size (shared_layouts));
+}
+
+/*
+ * clutter_text_get_shared_layout:
+ * @text: a #ClutterText
+ * @width: the width of the layout, in Pango units, or -1
+ * @height: the height of the layout, in Pango units, or -1
+ * @ellipsize: the ellipsization mode of the layout
+ *
+ * Retrieves a layout for the contents of @text from the cache of
+ * shared layouts, creating it if needed.
+ *
+ * Return value: (transfer full): a #PangoLayout that must not be
+ *   modified
+ */
+static PangoLayout *
+clutter_text_get_shared_layout (ClutterText        *text,
+                                gint                width,
+                                gint                height,
+                                PangoEllipsizeMode  ellipsize)
+{
+  SharedLayout key, *shared;
+  PangoLayout *layout;
+
+  shared_layout_key_init (text, width, height, ellipsize, &key);
+
+  shared = shared_layouts_lookup (&key);
+  if (shared != NULL)
+    {
+      CLUTTER_NOTE (ACTOR, "ClutterText: %p: shared layout hit for '%s'",
+                    text,
+                    key.contents);
+
+      g_free (key.contents);
+
+      return g_object_ref (shared->layout);
+    }
+
+  layout = pango_layout_new (shared_layouts_get_context (text, key.direction));
+  shared_layout_setup (&key, layout);
+
+  cogl_pango_ensure_glyph_cache_for_layout (layout);
+
+  shared_layouts_insert (&key, layout);
+
+  g_free (key.contents);
+
+  return layout;
+}
+
+/* When the :async-layout property is set, the layouts missing from
+ * the shared layouts are shaped by a worker thread.
+ *
+ * Pango objects must not be used by more than one thread at a time,
+ * so the worker shapes the layouts using a font map and contexts of
+ * its own, grouped in a ShapeBatch. A batch is handed over to the
+ * main thread, with all the layouts shaped using it, once all its
+ * jobs are done; the worker never touches it again, and the jobs
+ * queued afterwards go to a new batch. Each batch has its own cache
+ * of glyphs, so a batch is closed after SHAPE_BATCH_MAX_JOBS jobs to
+ * avoid starving the actors waiting for their layouts. The font maps
+ * of the batches are kept alive by the shared layouts, and are
+ * counted in their budget.
+ */
+#define SHAPE_BATCH_MAX_JOBS    32
+
+typedef struct _ShapeBatch      ShapeBatch;
+typedef struct _ShapeJob        ShapeJob;
+
+struct _ShapeBatch
+{
+  CoglPangoFontMap *font_map;
+  PangoContext *contexts[2];
+
+  /* protected by shaper_lock */
+  guint n_queued;
+  guint n_pending;
+  GSList *jobs;
+};
+
+struct _ShapeJob
+{
+  /* owns all its fields */
+  SharedLayout key;
+  gint32 serial;
+
+  ShapeBatch *batch;
+  PangoLayout *layout;
+
+  /* the text actor waiting for the layout; only accessed by the
+   * main thread, and set to NULL if the job is cancelled
+   */
+  ClutterText *text;
+
+  volatile gint cancelled;
+
+  /* protected by shaper_lock */
+  gboolean done;
+};
+
+static GThreadPool *shaper_pool = NULL;
+static GMutex shaper_lock;
+static GCond shaper_cond;
+static ShapeBatch *shaper_current_batch = NULL;
+static GSList *shaper_done_batches = NULL;
+static guint shaper_dispatch_id = 0;
+
+static ShapeBatch *
+shape_batch_new (ClutterText *text)
+{
+  CoglPangoFontMap *default_font_map;
+  ShapeBatch *batch;
+  gdouble resolution;
+  guint i;
+
+  default_font_map = COGL_PANGO_FONT_MAP (clutter_get_font_map ());
+  resolution = clutter_backend_get_resolution (clutter_get_default_backend ());
+
+  batch = g_slice_new0 (ShapeBatch);
+  batch->font_map = COGL_PANGO_FONT_MAP (cogl_pango_font_map_new ());
+  cogl_pango_font_map_set_resolution (batch->font_map, resolution);
+  cogl_pango_font_map_set_use_mipmapping (batch->font_map,
+                                          cogl_pango_font_map_get_use_mipmapping (default_font_map));
+
+  for (i = 0; i < G_N_ELEMENTS (batch->contexts); i++)
+    {
+      batch->contexts[i] =
+        clutter_actor_create_pango_context (CLUTTER_ACTOR (text));
+
+      pango_context_set_font_map (batch->contexts[i],
+                                  PANGO_FONT_MAP (batch->font_map));
+      pango_context_set_base_dir (batch->contexts[i],
+                                  i == 1 ? PANGO_DIRECTION_RTL
+                                         : PANGO_DIRECTION_LTR);
+    }
+
+  return batch;
+}
+
+static void
+shape_batch_free (ShapeBatch *batch)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (batch->contexts); i++)
+    g_object_unref (batch->contexts[i]);
+
+  g_object_unref (batch->font_map);
+
+  g_slice_free (ShapeBatch, batch);
+}
+
+static void
+shape_job_free (ShapeJob *job)
+{
+  g_free (job->key.contents);
+  if (job->key.attrs != NULL)
+    pango_attr_list_unref (job->key.attrs);
+  pango_font_description_free (job->key.font_desc);
+
+  if (job->layout != NULL)
+    g_object_unref (job->layout);
+
+  g_slice_free (ShapeJob, job);
+}
+
+static void clutter_text_adopt_shaped_layout (ClutterText *text,
+                                              ShapeJob    *job);
+
+/* runs on the main thread */
+static gboolean
+shaper_dispatch (gpointer data G_GNUC_UNUSED)
+{
+  GSList *batches, *l;
+
+  g_mutex_lock (&shaper_lock);
+  batches = shaper_done_batches;
+  shaper_done_batches = NULL;
+  shaper_dispatch_id = 0;
+  g_mutex_unlock (&shaper_lock);
+
+  for (l = batches; l != NULL; l = l->next)
+    {
+      ShapeBatch *batch = l->data;
+      GSList *jobs, *j;
+
+      /* the jobs are prepended as they are done */
+      jobs = g_slist_reverse (batch->jobs);
+      batch->jobs = NULL;
+
+      for (j = jobs; j != NULL; j = j->next)
+        {
+          ShapeJob *job = j->data;
+
+          /* even if nobody waits for it any more, the layout can be
+           * shared, as long as the font settings did not change
+           */
+          if (job->layout != NULL &&
+              job->serial == _clutter_backend_get_units_serial (clutter_get_default_backend ()) &&
+              shared_layouts_lookup (&job->key) == NULL)
+            {
+              cogl_pango_ensure_glyph_cache_for_layout (job->layout);
+              shared_layouts_insert (&job->key, job->layout);
+            }
+
+          if (job->text != NULL)
+            clutter_text_adopt_shaped_layout (job->text, job);
+
+          shape_job_free (job);
+        }
+
+      g_slist_free (jobs);
+
+      shape_batch_free (batch);
+    }
+
+  g_slist_free (batches);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* runs on the worker thread */
+static void
+shaper_worker (gpointer data,
+               gpointer user_data G_GNUC_UNUSED)
+{
+  ShapeJob *job = data;
+  ShapeBatch *batch = job->batch;
+
+  if (!g_atomic_int_get (&job->cancelled))
+    {
+      PangoContext *context;
+      PangoRectangle ink_rect, logical_rect;
+
+      context = batch->contexts[job->key.direction == PANGO_DIRECTION_RTL ? 1 : 0];
+
+      job->layout = pango_layout_new (context);
+      shared_layout_setup (&job->key, job->layout);
+
+      /* this shapes all the lines and measures all the glyphs */
+      pango_layout_get_extents (job->layout, &ink_rect, &logical_rect);
+    }
+
+  g_mutex_lock (&shaper_lock);
+
+  batch->jobs = g_slist_prepend (batch->jobs, job);
+  batch->n_pending -= 1;
+
+  if (batch->n_pending == 0)
+    {
+      GSList *l;
+
+      /* no job can be added to the batch once it's handed over */
+      if (shaper_current_batch == batch)
+        shaper_current_batch = NULL;
+
+      for (l = batch->jobs; l != NULL; l = l->next)
+        ((ShapeJob *) l->data)->done = TRUE;
+
+      shaper_done_batches = g_slist_prepend (shaper_done_batches, batch);
+
+      if (shaper_dispatch_id == 0)
+        shaper_dispatch_id = clutter_threads_add_idle (shaper_dispatch, NULL);
+
+      g_cond_broadcast (&shaper_cond);
+    }
+
+  g_mutex_unlock (&shaper_lock);
+}
+
+static void
+clutter_text_queue_shape_job (ClutterText        *text,
+                              const SharedLayout *key)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ShapeJob *job;
+
+  if (G_UNLIKELY (shaper_pool == NULL))
+    shaper_pool = g_thread_pool_new (shaper_worker, NULL, 1, FALSE, NULL);
+
+  job = g_slice_new0 (ShapeJob);
+  job->key = *key;
+  job->key.contents = g_strdup (key->contents);
+  job->key.attrs = key->attrs != NULL ? pango_attr_list_copy (key->attrs) : NULL;
+  job->key.font_desc = pango_font_description_copy (key->font_desc);
+  job->serial = _clutter_backend_get_units_serial (clutter_get_default_backend ());
+  job->text = text;
+
+  priv->shape_jobs = g_slist_prepend (priv->shape_jobs, job);
+
+  CLUTTER_NOTE (ACTOR, "ClutterText: %p: shaping '%s' in a worker thread",
+                text,
+                key->contents);
+
+  g_mutex_lock (&shaper_lock);
+
+  if (shaper_current_batch == NULL)
+    shaper_current_batch = shape_batch_new (text);
+
+  job->batch = shaper_current_batch;
+  job->batch->n_pending += 1;
+  job->batch->n_queued += 1;
+
+  if (job->batch->n_queued == SHAPE_BATCH_MAX_JOBS)
+    shaper_current_batch = NULL;
+
+  g_thread_pool_push (shaper_pool, job, NULL);
+
+  g_mutex_unlock (&shaper_lock);
+}
+
+static void
+clutter_text_cancel_shape_jobs (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  GSList *l;
+
+  /* the jobs are freed once the worker is done with them */
+  for (l = priv->shape_jobs; l != NULL; l = l->next)
+    {
+      ShapeJob *job = l->data;
+
+      job->text = NULL;
+      g_atomic_int_set (&job->cancelled, TRUE);
+    }
+
+  g_slist_free (priv->shape_jobs);
+  priv->shape_jobs = NULL;
+}
+
+/*
+ * clutter_text_get_shared_layout_async:
+ * @text: a #ClutterText
+ * @width: the width of the layout, in Pango units, or -1
+ * @height: the height of the layout, in Pango units, or -1
+ * @ellipsize: the ellipsization mode of the layout
+ *
+ * Like clutter_text_get_shared_layout(), but instead of creating a
+ * missing layout it queues a job to shape it in the worker thread.
+ *
+ * Return value: (transfer full): a #PangoLayout that must not be
+ *   modified, or %NULL if the layout is being shaped
+ */
+static PangoLayout *
+clutter_text_get_shared_layout_async (ClutterText        *text,
+                                      gint                width,
+                                      gint                height,
+                                      PangoEllipsizeMode  ellipsize)
+{
+  ClutterTextPrivate *priv = text->priv;
+  SharedLayout key, *shared;
+  GSList *l;
+
+  shared_layout_key_init (text, width, height, ellipsize, &key);
+
+  shared = shared_layouts_lookup (&key);
+  if (shared != NULL)
+    {
+      g_free (key.contents);
+
+      return g_object_ref (shared->layout);
+    }
+
+  for (l = priv->shape_jobs; l != NULL; l = l->next)
+    {
+      ShapeJob *job = l->data;
+
+      if (shared_layout_equal (&job->key, &key))
+        break;
+    }
+
+  if (l == NULL)
+    clutter_text_queue_shape_job (text, &key);
+
+  g_free (key.contents);
+
+  return NULL;
+}
+
+static PangoLayout *
+clutter_text_get_newest_cached_layout (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  LayoutCache *newest = NULL;
+  int i;
+
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    {
+      LayoutCache *cache = priv->cached_layouts + i;
+
+      if (cache->layout != NULL &&
+          (newest == NULL || cache->age > newest->age))
+        newest = cache;
+    }
+
+  return newest != NULL ? newest->layout : NULL;
+}
+
+/*
+ * clutter_text_get_fallback_layout:
+ * @text: a #ClutterText
+ *
+ * Retrieves the layout used while the layout of @text is being
+ * shaped: the last layout @text displayed with its previous
+ * contents, if any; otherwise, the most recent layout of the
+ * current contents, if any, for a different size; otherwise, an
+ * empty layout, whose size is estimated from the contents.
+ *
+ * Return value: (transfer none): a #PangoLayout
+ */
+static PangoLayout *
+clutter_text_get_fallback_layout (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+  PangoLayout *newest;
+
+  if (priv->fallback_layout != NULL)
+    return priv->fallback_layout;
+
+  newest = clutter_text_get_newest_cached_layout (text);
+  if (newest != NULL)
+    return newest;
+
+  if (priv->placeholder_layout == NULL)
+    {
+      priv->placeholder_layout =
+        clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
+
+      pango_layout_set_font_description (priv->placeholder_layout,
+                                         priv->font_desc);
+    }
+
+  return priv->placeholder_layout;
+}
+
+static inline gboolean
+clutter_text_is_fallback_layout (ClutterText *text,
+                                 PangoLayout *layout)
+{
+  return layout == text->priv->fallback_layout ||
+         layout == text->priv->placeholder_layout;
+}
+
+/* estimates the extents of the contents of @text without shaping
+ * them, in Pango units
+ */
+static void
+clutter_text_get_estimated_extents (ClutterText    *text,
+                                    PangoRectangle *logical_rect)
+{
+  ClutterTextPrivate *priv = text->priv;
+  gdouble font_size;
+  guint n_chars;
+
+  font_size = (gdouble) pango_font_description_get_size (priv->font_desc);
+
+  if (!pango_font_description_get_size_is_absolute (priv->font_desc))
+    font_size *= clutter_backend_get_resolution (clutter_get_default_backend ()) / 72.0;
+
+  n_chars = clutter_text_buffer_get_length (get_buffer (text));
+
+  /* the glyphs of most scripts are narrower than the em box */
+  logical_rect->x = 0;
+  logical_rect->y = 0;
+  logical_rect->width = n_chars * font_size * 0.5;
+  logical_rect->height = font_size * 1.2;
+}
+
+static void
+clutter_text_adopt_shaped_layout (ClutterText *text,
+                                  ShapeJob    *job)
+{
+  ClutterTextPrivate *priv = text->priv;
+  LayoutCache *slot = NULL;
+  int i;
+
+  priv->shape_jobs = g_slist_remove (priv->shape_jobs, job);
+  job->text = NULL;
+
+  if (job->layout == NULL)
+    return;
+
+  /* store the layout in a free slot, or in the oldest one */
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    {
+      LayoutCache *cache = priv->cached_layouts + i;
+
+      if (cache->layout == NULL)
+        {
+          slot = cache;
+          break;
+        }
+
+      if (slot == NULL || cache->age < slot->age)
+        slot = cache;
+    }
+
+  if (slot->layout != NULL)
+    g_object_unref (slot->layout);
+
+  slot->layout = g_object_ref (job->layout);
+  slot->age = priv->cache_age++;
+
+  if (priv->shape_jobs == NULL)
+    g_clear_object (&priv->fallback_layout);
+
+  clutter_text_dirty_paint_volume (text);
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
+}
+
+static inline gboolean
+clutter_text_can_share_layout (ClutterText *text)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  /* editable text depends on the cursor and on the input method,
+   * and we don't want to keep passwords around
+   */
+  return !priv->editable &&
+         priv->password_char == 0 &&
+         priv->font_desc != NULL;
+}
+
 static void
 clutter_text_dirty_cache (ClutterText *text)
 {
   ClutterTextPrivate *priv = text->priv;
   int i;
 
+  if (priv->async_layout)
+    {
+      PangoLayout *newest = clutter_text_get_newest_cached_layout (text);
+
+      /* keep showing the most recent layout until the new one has
+       * been shaped
+       */
+      if (newest != NULL)
+        {
+          g_clear_object (&priv->fallback_layout);
+          priv->fallback_layout = g_object_ref (newest);
+        }
+
+      clutter_text_cancel_shape_jobs (text);
+    }
+
   /* Delete the cached layouts so they will be recreated the next time
      they are needed */
   for (i = 0; i < N_CACHED_LAYOUTS; i++)
@@ -858,14 +1791,43 @@ clutter_text_create_layout (ClutterText *text,
                 allocation_height);
 
   /* If we make it here then we didn't have a cached version so we
-     need to recreate the layout */
+     need to recreate the layout, or to get it from the shared ones */
+  if (priv->async_layout && clutter_text_can_share_layout (text))
+    {
+      PangoLayout *layout;
+
+      /* the layout will be stored in the cache once it's shaped */
+      layout = clutter_text_get_shared_layout_async (text,
+                                                     width,
+                                                     height,
+                                                     ellipsize);
+      if (layout == NULL)
+        return clutter_text_get_fallback_layout (text);
+
+      if (oldest_cache->layout)
+        g_object_unref (oldest_cache->layout);
+
+      oldest_cache->layout = layout;
+      oldest_cache->age = priv->cache_age++;
+
+      return oldest_cache->layout;
+    }
+
   if (oldest_cache->layout)
     g_object_unref (oldest_cache->layout);
 
-  oldest_cache->layout =
-    clutter_text_create_layout_no_cache (text, width, height, ellipsize);
+  if (clutter_text_can_share_layout (text))
+    {
+      oldest_cache->layout =
+        clutter_text_get_shared_layout (text, width, height, ellipsize);
+    }
+  else
+    {
+      oldest_cache->layout =
+        clutter_text_create_layout_no_cache (text, width, height, ellipsize);
 
-  cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
+      cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
+    }
 
   /* Mark the 'time' this cache was created and advance the time */
   oldest_cache->age = priv->cache_age++;
@@ -1313,6 +2275,10 @@ clutter_text_set_property (GObject      *gobject,
       clutter_text_set_selected_text_color (self, clutter_value_get_color (value));
       break;
 
+    case PROP_ASYNC_LAYOUT:
+      clutter_text_set_async_layout (self, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -1442,6 +2408,10 @@ clutter_text_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->selected_text_color_set);
       break;
 
+    case PROP_ASYNC_LAYOUT:
+      g_value_set_boolean (value, priv->async_layout);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -1456,6 +2426,10 @@ clutter_text_dispose (GObject *gobject)
   /* get rid of the entire cache */
   clutter_text_dirty_cache (self);
 
+  clutter_text_cancel_shape_jobs (self);
+  g_clear_object (&priv->fallback_layout);
+  g_clear_object (&priv->placeholder_layout);
+
   if (priv->direction_changed_id)
     {
       g_signal_handler_disconnect (self, priv->direction_changed_id);
@@ -2533,7 +3507,10 @@ clutter_text_get_preferred_width (ClutterActor *self,
 
   layout = clutter_text_create_layout (text, -1, -1);
 
-  pango_layout_get_extents (layout, NULL, &logical_rect);
+  if (clutter_text_is_fallback_layout (text, layout))
+    clutter_text_get_estimated_extents (text, &logical_rect);
+  else
+    pango_layout_get_extents (layout, NULL, &logical_rect);
 
   /* the X coordinate of the logical rectangle might be non-zero
    * according to the Pango documentation; hence, we need to offset
@@ -2584,6 +3561,7 @@ clutter_text_get_preferred_height (ClutterActor *self,
       PangoRectangle logical_rect = { 0, };
       gint logical_height;
       gfloat layout_height;
+      gboolean is_fallback;
 
       if (priv->single_line_mode)
         for_width = -1;
@@ -2591,7 +3569,12 @@ clutter_text_get_preferred_height (ClutterActor *self,
       layout = clutter_text_create_layout (CLUTTER_TEXT (self),
                                            for_width, -1);
 
-      pango_layout_get_extents (layout, NULL, &logical_rect);
+      is_fallback = clutter_text_is_fallback_layout (CLUTTER_TEXT (self),
+                                                     layout);
+      if (is_fallback)
+        clutter_text_get_estimated_extents (CLUTTER_TEXT (self), &logical_rect);
+      else
+        pango_layout_get_extents (layout, NULL, &logical_rect);
 
       /* the Y coordinate of the logical rectangle might be non-zero
        * according to the Pango documentation; hence, we need to offset
@@ -2605,7 +3588,9 @@ clutter_text_get_preferred_height (ClutterActor *self,
           /* if we wrap and ellipsize then the minimum height is
            * going to be at least the size of the first line
            */
-          if ((priv->ellipsize && priv->wrap) && !priv->single_line_mode)
+          if ((priv->ellipsize && priv->wrap) &&
+              !priv->single_line_mode &&
+              !is_fallback)
             {
               PangoLayoutLine *line;
               gfloat line_height;
@@ -3869,6 +4854,28 @@ clutter_text_class_init (ClutterTextClass *klass)
   obj_props[PROP_SELECTED_TEXT_COLOR_SET] = pspec;
   g_object_class_install_property (gobject_class, PROP_SELECTED_TEXT_COLOR_SET, pspec);
 
+  /**
+   * ClutterText:async-layout:
+   *
+   * Whether the contents of a non-editable #ClutterText should be
+   * laid out in a worker thread.
+   *
+   * While the layout is not ready, the #ClutterText will keep
+   * displaying its previous contents, and will estimate its
+   * preferred size from the length of the new contents.
+   *
+   * See also clutter_text_wait_for_layout().
+   *
+   * Since: 1.26
+   */
+  pspec = g_param_spec_boolean ("async-layout",
+                                P_("Asynchronous Layout"),
+                                P_("Whether the text should be laid out in a worker thread"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  obj_props[PROP_ASYNC_LAYOUT] = pspec;
+  g_object_class_install_property (gobject_class, PROP_ASYNC_LAYOUT, pspec);
+
   /**
    * ClutterText::text-changed:
    * @self: the #ClutterText that emitted the signal
@@ -4465,6 +5472,16 @@ clutter_text_set_editable (ClutterText *self,
     {
       priv->editable = editable;
 
+      /* editable text ignores the markup attributes, and its
+       * layouts are not shared with other actors
+       */
+      if (priv->effective_attrs != NULL)
+        {
+          pango_attr_list_unref (priv->effective_attrs);
+          priv->effective_attrs = NULL;
+        }
+
+      clutter_text_dirty_cache (self);
       clutter_text_queue_redraw (CLUTTER_ACTOR (self));
 
       g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_EDITABLE]);
@@ -5239,6 +6256,9 @@ clutter_text_set_markup (ClutterText *self,
  *
  * Retrieves the current #PangoLayout used by a #ClutterText actor.
  *
+ * The layouts of non-editable actors may be shared with other
+ * #ClutterText actors displaying the same contents.
+ *
  * Return value: (transfer none): a #PangoLayout. The returned object is owned by
  *   the #ClutterText actor and should not be modified or freed
  *
@@ -6176,6 +7196,105 @@ clutter_text_get_single_line_mode (ClutterText *self)
   return self->priv->single_line_mode;
 }
 
+/**
+ * clutter_text_set_async_layout:
+ * @self: a #ClutterText
+ * @async_layout: whether the text should be laid out in a worker thread
+ *
+ * Sets whether the contents of @self should be laid out in a worker
+ * thread, instead of blocking the main loop.
+ *
+ * Only the contents of non-editable #ClutterText actors without a
+ * password character are laid out in a worker thread.
+ *
+ * Since: 1.26
+ */
+void
+clutter_text_set_async_layout (ClutterText *self,
+                               gboolean     async_layout)
+{
+  ClutterTextPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TEXT (self));
+
+  priv = self->priv;
+
+  async_layout = !!async_layout;
+
+  if (priv->async_layout == async_layout)
+    return;
+
+  priv->async_layout = async_layout;
+
+  if (!priv->async_layout)
+    {
+      clutter_text_cancel_shape_jobs (self);
+      g_clear_object (&priv->fallback_layout);
+      g_clear_object (&priv->placeholder_layout);
+
+      clutter_text_dirty_paint_volume (self);
+      clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+    }
+
+  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_ASYNC_LAYOUT]);
+}
+
+/**
+ * clutter_text_get_async_layout:
+ * @self: a #ClutterText
+ *
+ * Retrieves whether the contents of @self are laid out in a worker
+ * thread.
+ *
+ * Return value: %TRUE if the contents are laid out in a worker thread
+ *
+ * Since: 1.26
+ */
+gboolean
+clutter_text_get_async_layout (ClutterText *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_TEXT (self), FALSE);
+
+  return self->priv->async_layout;
+}
+
+/**
+ * clutter_text_wait_for_layout:
+ * @self: a #ClutterText
+ *
+ * Blocks until the layouts of @self that are being shaped in
+ * the worker thread are ready, and makes @self use them.
+ *
+ * This function is useful to take a snapshot of a #ClutterText
+ * with the #ClutterText:async-layout property set.
+ *
+ * Since: 1.26
+ */
+void
+clutter_text_wait_for_layout (ClutterText *self)
+{
+  GSList *l;
+
+  g_return_if_fail (CLUTTER_IS_TEXT (self));
+
+  if (self->priv->shape_jobs == NULL)
+    return;
+
+  g_mutex_lock (&shaper_lock);
+
+  for (l = self->priv->shape_jobs; l != NULL; l = l->next)
+    {
+      ShapeJob *job = l->data;
+
+      while (!job->done)
+        g_cond_wait (&shaper_cond, &shaper_lock);
+    }
+
+  g_mutex_unlock (&shaper_lock);
+
+  shaper_dispatch (NULL);
+}
+
 /**
  * clutter_text_set_preedit_string:
  * @self: a #ClutterText
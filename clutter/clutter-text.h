@@ -270,6 +270,13 @@ void                  clutter_text_set_single_line_mode (ClutterText          *s
                                                          gboolean              single_line);
 CLUTTER_AVAILABLE_IN_1_0
 gboolean              clutter_text_get_single_line_mode (ClutterText          *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                  clutter_text_set_async_layout     (ClutterText          *self,
+                                                         gboolean              async_layout);
+CLUTTER_AVAILABLE_IN_1_26
+gboolean              clutter_text_get_async_layout     (ClutterText          *self);
+CLUTTER_AVAILABLE_IN_1_26
+void                  clutter_text_wait_for_layout      (ClutterText          *self);
 
 CLUTTER_AVAILABLE_IN_1_8
 void                  clutter_text_set_selected_text_color  (ClutterText          *self,
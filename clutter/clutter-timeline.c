@@ -150,6 +150,11 @@ struct _ClutterTimelinePrivate
   ClutterPoint cb_1;
   ClutterPoint cb_2;
 
+  /* the easing function of the progress mode; owned by the timeline
+   * only for the parametrized modes, and shared otherwise
+   */
+  ClutterEasingTable *easing_table;
+
   guint is_playing         : 1;
 
   /* If we've just started playing and haven't yet gotten
@@ -203,6 +208,10 @@ enum
 static guint timeline_signals[LAST_SIGNAL] = { 0, };
 
 static void clutter_scriptable_iface_init (ClutterScriptableIface *iface);
+static gdouble clutter_timeline_progress_func (ClutterTimeline *timeline,
+                                              gdouble          elapsed,
+                                              gdouble          duration,
+                                              gpointer         user_data);
 
 G_DEFINE_TYPE_WITH_CODE (ClutterTimeline, clutter_timeline, G_TYPE_OBJECT,
                          G_ADD_PRIVATE (ClutterTimeline)
@@ -525,6 +534,57 @@ clutter_timeline_get_property (GObject    *object,
     }
 }
 
+/* must be called before changing the progress mode or its parameters */
+static void
+clutter_timeline_clear_easing_table (ClutterTimeline *timeline)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+
+  if (priv->progress_mode == CLUTTER_STEPS ||
+      priv->progress_mode == CLUTTER_CUBIC_BEZIER)
+    clutter_easing_table_free (priv->easing_table);
+
+  priv->easing_table = NULL;
+}
+
+static const ClutterEasingTable *
+clutter_timeline_get_easing_table (ClutterTimeline *timeline)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+  gboolean sampled;
+
+  /* the linear progress is not evaluated through the progress function */
+  if (priv->progress_func == NULL)
+    return clutter_easing_table_get_for_mode (CLUTTER_LINEAR, FALSE);
+
+  if (G_LIKELY (priv->easing_table != NULL))
+    return priv->easing_table;
+
+  sampled = _clutter_get_use_easing_tables ();
+
+  switch (priv->progress_mode)
+    {
+    case CLUTTER_STEPS:
+      priv->easing_table =
+        clutter_easing_table_new_steps (priv->n_steps, priv->step_mode);
+      break;
+
+    case CLUTTER_CUBIC_BEZIER:
+      priv->easing_table =
+        clutter_easing_table_new_cubic_bezier (priv->cb_1.x, priv->cb_1.y,
+                                               priv->cb_2.x, priv->cb_2.y,
+                                               sampled);
+      break;
+
+    default:
+      priv->easing_table = (ClutterEasingTable *)
+        clutter_easing_table_get_for_mode (priv->progress_mode, sampled);
+      break;
+    }
+
+  return priv->easing_table;
+}
+
 static void
 clutter_timeline_finalize (GObject *object)
 {
@@ -541,6 +601,8 @@ clutter_timeline_finalize (GObject *object)
       _clutter_master_clock_remove_timeline (master_clock, self);
     }
 
+  clutter_timeline_clear_easing_table (self);
+
   G_OBJECT_CLASS (clutter_timeline_parent_class)->finalize (object);
 }
 
@@ -1775,6 +1837,107 @@ _clutter_timeline_do_tick (ClutterTimeline *timeline,
     }
 }
 
+/*< private >
+ * _clutter_timeline_can_batch_tick:
+ * @timeline: a #ClutterTimeline
+ * @tick_time: time of advance
+ *
+ * Checks whether the frame at @tick_time can be advanced using
+ * _clutter_timeline_do_batched_tick(), without modifying @timeline.
+ *
+ * Only the frames that would not do anything besides emitting the
+ * #ClutterTimeline::new-frame signal can be batched: the timeline must
+ * not have markers, handlers connected to the #ClutterTimeline::new-frame
+ * signal, or a parametrized or custom progress function, and the frame
+ * must not start or complete the timeline.
+ *
+ * Return value: %TRUE if the frame can be batched
+ */
+gboolean
+_clutter_timeline_can_batch_tick (ClutterTimeline *timeline,
+                                  gint64           tick_time)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+  gint64 msecs, new_elapsed;
+
+  if (!priv->is_playing || priv->waiting_first_tick)
+    return FALSE;
+
+  if (priv->markers_by_name != NULL &&
+      g_hash_table_size (priv->markers_by_name) != 0)
+    return FALSE;
+
+  /* custom progress functions cannot be batched */
+  if (priv->progress_func != NULL &&
+      priv->progress_func != clutter_timeline_progress_func)
+    return FALSE;
+
+  msecs = tick_time - priv->last_frame_time;
+  if (msecs <= 0)
+    return FALSE;
+
+  if (priv->direction == CLUTTER_TIMELINE_FORWARD)
+    {
+      new_elapsed = priv->elapsed_time + msecs;
+      if (new_elapsed >= priv->duration)
+        return FALSE;
+    }
+  else
+    {
+      new_elapsed = priv->elapsed_time - msecs;
+      if (new_elapsed <= 0)
+        return FALSE;
+    }
+
+  /* the class handler is not taken into account */
+  if (g_signal_has_handler_pending (timeline,
+                                    timeline_signals[NEW_FRAME],
+                                    0,
+                                    TRUE))
+    return FALSE;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_timeline_do_batched_tick:
+ * @timeline: a #ClutterTimeline
+ * @tick_time: time of advance
+ * @elapsed: (out): return location for the new elapsed time
+ * @duration: (out): return location for the duration
+ * @table: (out) (transfer none): return location for the easing table
+ *   of the progress mode
+ *
+ * Advances @timeline like _clutter_timeline_do_tick(), without emitting
+ * any signal, so that the master clock can compute the progress of the
+ * timeline together with the other batched timelines.
+ *
+ * This function must only be called if _clutter_timeline_can_batch_tick()
+ * returned %TRUE for the same @tick_time.
+ */
+void
+_clutter_timeline_do_batched_tick (ClutterTimeline           *timeline,
+                                   gint64                     tick_time,
+                                   gint64                    *elapsed,
+                                   gint64                    *duration,
+                                   const ClutterEasingTable **table)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+  gint64 msecs = tick_time - priv->last_frame_time;
+
+  priv->last_frame_time += msecs;
+  priv->msecs_delta = msecs;
+
+  if (priv->direction == CLUTTER_TIMELINE_FORWARD)
+    priv->elapsed_time += msecs;
+  else
+    priv->elapsed_time -= msecs;
+
+  *elapsed = priv->elapsed_time;
+  *duration = priv->duration;
+  *table = clutter_timeline_get_easing_table (timeline);
+}
+
 /**
  * clutter_timeline_add_marker:
  * @timeline: a #ClutterTimeline
@@ -2227,6 +2390,8 @@ clutter_timeline_set_progress_func (ClutterTimeline             *timeline,
   if (priv->progress_notify != NULL)
     priv->progress_notify (priv->progress_data);
 
+  clutter_timeline_clear_easing_table (timeline);
+
   priv->progress_func = func;
   priv->progress_data = data;
   priv->progress_notify = notify;
@@ -2245,52 +2410,9 @@ clutter_timeline_progress_func (ClutterTimeline *timeline,
                                 gdouble          duration,
                                 gpointer         user_data G_GNUC_UNUSED)
 {
-  ClutterTimelinePrivate *priv = timeline->priv;
-
-  /* parametrized easing functions need to be handled separately */
-  switch (priv->progress_mode)
-    {
-    case CLUTTER_STEPS:
-      if (priv->step_mode == CLUTTER_STEP_MODE_START)
-        return clutter_ease_steps_start (elapsed, duration, priv->n_steps);
-      else if (priv->step_mode == CLUTTER_STEP_MODE_END)
-        return clutter_ease_steps_end (elapsed, duration, priv->n_steps);
-      else
-        g_assert_not_reached ();
-      break;
-
-    case CLUTTER_STEP_START:
-      return clutter_ease_steps_start (elapsed, duration, 1);
-
-    case CLUTTER_STEP_END:
-      return clutter_ease_steps_end (elapsed, duration, 1);
-
-    case CLUTTER_CUBIC_BEZIER:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        priv->cb_1.x, priv->cb_1.y,
-                                        priv->cb_2.x, priv->cb_2.y);
-
-    case CLUTTER_EASE:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.25, 0.1, 0.25, 1.0);
-
-    case CLUTTER_EASE_IN:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.42, 0.0, 1.0, 1.0);
-
-    case CLUTTER_EASE_OUT:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.0, 0.0, 0.58, 1.0);
-
-    case CLUTTER_EASE_IN_OUT:
-      return clutter_ease_cubic_bezier (elapsed, duration,
-                                        0.42, 0.0, 0.58, 1.0);
-
-    default:
-      break;
-    }
-
-  return clutter_easing_for_mode (priv->progress_mode, elapsed, duration);
+  return clutter_easing_table_evaluate (clutter_timeline_get_easing_table (timeline),
+                                        elapsed,
+                                        duration);
 }
 
 /**
@@ -2322,6 +2444,8 @@ clutter_timeline_set_progress_mode (ClutterTimeline      *timeline,
   if (priv->progress_notify != NULL)
     priv->progress_notify (priv->progress_data);
 
+  clutter_timeline_clear_easing_table (timeline);
+
   priv->progress_mode = mode;
 
   /* short-circuit linear progress */
@@ -2438,6 +2562,8 @@ clutter_timeline_set_step_progress (ClutterTimeline *timeline,
       priv->step_mode == step_mode)
     return;
 
+  clutter_timeline_clear_easing_table (timeline);
+
   priv->n_steps = n_steps;
   priv->step_mode = step_mode;
   clutter_timeline_set_progress_mode (timeline, CLUTTER_STEPS);
@@ -2506,6 +2632,8 @@ clutter_timeline_set_cubic_bezier_progress (ClutterTimeline    *timeline,
 
   priv = timeline->priv;
 
+  clutter_timeline_clear_easing_table (timeline);
+
   priv->cb_1 = *c_1;
   priv->cb_2 = *c_2;
 
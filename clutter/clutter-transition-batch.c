@@ -0,0 +1,233 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2016  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTransitionBatch: advances property transitions in bulk.
+ *
+ * Most of the timelines handled by the master clock are property
+ * transitions tweening a property of an actor, with nobody listening
+ * to their signals. For those, the master clock advances the timeline
+ * without emitting ::new-frame, and collects the elapsed time, the
+ * duration, the easing table and the initial and final values in
+ * a batch. The batch stores each of them in its own array, so that
+ * the progress and the interpolated values of all the transitions are
+ * computed by tight loops over contiguous memory, before being set on
+ * the actors.
+ *
+ * The timelines that have markers or signal handlers, or that are
+ * completing in the current frame, are advanced as usual.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-transition-batch.h"
+
+#include "clutter-debug.h"
+#include "clutter-easing.h"
+#include "clutter-master-clock.h"
+#include "clutter-private.h"
+#include "clutter-property-transition-private.h"
+
+#define N_COMPONENTS    CLUTTER_ANIMATED_VALUE_COMPONENTS
+
+struct _ClutterTransitionBatch
+{
+  guint n_items;
+  guint size;
+
+  ClutterPropertyTransition **transitions;
+
+  const ClutterEasingTable **tables;
+  gdouble *elapsed;
+  gdouble *duration;
+  gdouble *progress;
+
+  /* N_COMPONENTS values for each item */
+  gdouble *initial;
+  gdouble *final;
+  gdouble *values;
+};
+
+ClutterTransitionBatch *
+_clutter_transition_batch_new (void)
+{
+  return g_slice_new0 (ClutterTransitionBatch);
+}
+
+void
+_clutter_transition_batch_free (ClutterTransitionBatch *batch)
+{
+  if (batch == NULL)
+    return;
+
+  g_free (batch->transitions);
+  g_free (batch->tables);
+  g_free (batch->elapsed);
+  g_free (batch->duration);
+  g_free (batch->progress);
+  g_free (batch->initial);
+  g_free (batch->final);
+  g_free (batch->values);
+
+  g_slice_free (ClutterTransitionBatch, batch);
+}
+
+static void
+clutter_transition_batch_grow (ClutterTransitionBatch *batch)
+{
+  guint size = MAX (batch->size * 2, 64);
+
+  batch->transitions = g_renew (ClutterPropertyTransition *, batch->transitions, size);
+  batch->tables = g_renew (const ClutterEasingTable *, batch->tables, size);
+  batch->elapsed = g_renew (gdouble, batch->elapsed, size);
+  batch->duration = g_renew (gdouble, batch->duration, size);
+  batch->progress = g_renew (gdouble, batch->progress, size);
+  batch->initial = g_renew (gdouble, batch->initial, size * N_COMPONENTS);
+  batch->final = g_renew (gdouble, batch->final, size * N_COMPONENTS);
+  batch->values = g_renew (gdouble, batch->values, size * N_COMPONENTS);
+
+  batch->size = size;
+}
+
+/*< private >
+ * _clutter_transition_batch_add:
+ * @batch: a #ClutterTransitionBatch
+ * @timeline: a #ClutterTimeline
+ * @tick_time: the time of the current frame, in milliseconds
+ *
+ * Advances @timeline and adds it to @batch, if @timeline is a
+ * #ClutterPropertyTransition that can be batched in this frame.
+ *
+ * The caller must keep a reference on @timeline until the batch
+ * has been run.
+ *
+ * Return value: %TRUE if @timeline was added to the batch, and %FALSE
+ *   if it must be advanced using _clutter_timeline_do_tick()
+ */
+gboolean
+_clutter_transition_batch_add (ClutterTransitionBatch *batch,
+                               ClutterTimeline        *timeline,
+                               gint64                  tick_time)
+{
+  ClutterPropertyTransition *transition;
+  ClutterAnimatedValueType value_type;
+  const ClutterEasingTable *table;
+  gint64 elapsed, duration;
+  guint i;
+
+  /* sub-classes can override the ClutterTransition implementation */
+  if (G_OBJECT_TYPE (timeline) != CLUTTER_TYPE_PROPERTY_TRANSITION)
+    return FALSE;
+
+  transition = CLUTTER_PROPERTY_TRANSITION (timeline);
+
+  /* fetching the values can fill the interval from the animated
+   * object, so we only do it for timelines that can be batched
+   */
+  if (!_clutter_timeline_can_batch_tick (timeline, tick_time))
+    return FALSE;
+
+  if (batch->n_items == batch->size)
+    clutter_transition_batch_grow (batch);
+
+  i = batch->n_items;
+
+  value_type =
+    _clutter_property_transition_get_animated_values (transition,
+                                                      batch->initial + i * N_COMPONENTS,
+                                                      batch->final + i * N_COMPONENTS);
+  if (value_type == CLUTTER_ANIMATED_VALUE_NONE)
+    return FALSE;
+
+  _clutter_timeline_do_batched_tick (timeline, tick_time,
+                                     &elapsed,
+                                     &duration,
+                                     &table);
+
+  batch->transitions[i] = transition;
+  batch->tables[i] = table;
+  batch->elapsed[i] = elapsed;
+  batch->duration[i] = duration;
+
+  batch->n_items += 1;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_transition_batch_run:
+ * @batch: a #ClutterTransitionBatch
+ *
+ * Computes the values of all the transitions in @batch, sets them
+ * on the animated actors, and empties @batch.
+ */
+void
+_clutter_transition_batch_run (ClutterTransitionBatch *batch)
+{
+  const gdouble *initial = batch->initial;
+  const gdouble *final = batch->final;
+  const gdouble *progress = batch->progress;
+  gdouble *values = batch->values;
+  guint n_items = batch->n_items;
+  guint i, j;
+
+  if (n_items == 0)
+    return;
+
+  CLUTTER_NOTE (SCHEDULER, "Advancing %u batched transitions", n_items);
+
+  /* the transitions sharing the same easing mode are usually added
+   * next to each other, and the timelines share the table of the mode,
+   * so we can evaluate the easing functions on runs of elapsed times;
+   * the results are the same of the timeline progress
+   */
+  for (i = 0; i < n_items; i = j)
+    {
+      for (j = i + 1; j < n_items; j++)
+        {
+          if (batch->tables[j] != batch->tables[i])
+            break;
+        }
+
+      clutter_easing_table_evaluate_array (batch->tables[i],
+                                           batch->elapsed + i,
+                                           batch->duration + i,
+                                           batch->progress + i,
+                                           j - i);
+    }
+
+  /* this is the same interpolation used by ClutterPropertyTransition */
+  for (i = 0; i < n_items; i++)
+    {
+      for (j = 0; j < N_COMPONENTS; j++)
+        {
+          guint k = i * N_COMPONENTS + j;
+
+          values[k] = initial[k] + (final[k] - initial[k]) * progress[i];
+        }
+    }
+
+  for (i = 0; i < n_items; i++)
+    _clutter_property_transition_set_animated_value (batch->transitions[i],
+                                                     values + i * N_COMPONENTS);
+
+  batch->n_items = 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2016  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTransitionBatch: advances property transitions in bulk.
+ */
+
+#ifndef __CLUTTER_TRANSITION_BATCH_H__
+#define __CLUTTER_TRANSITION_BATCH_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterTransitionBatch  ClutterTransitionBatch;
+
+ClutterTransitionBatch *        _clutter_transition_batch_new   (void);
+void                            _clutter_transition_batch_free  (ClutterTransitionBatch *batch);
+
+gboolean                        _clutter_transition_batch_add   (ClutterTransitionBatch *batch,
+                                                                 ClutterTimeline        *timeline,
+                                                                 gint64                  tick_time);
+void                            _clutter_transition_batch_run   (ClutterTransitionBatch *batch);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TRANSITION_BATCH_H__ */
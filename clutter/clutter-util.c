@@ -521,6 +521,9 @@ typedef struct
 {
   GType value_type;
   ClutterProgressFunc func;
+
+  /* whether the function was registered by Clutter for its own type */
+  gboolean is_default;
 } ProgressData;
 
 G_LOCK_DEFINE_STATIC (progress_funcs);
@@ -537,6 +540,37 @@ _clutter_has_progress_function (GType gtype)
   return g_hash_table_lookup (progress_funcs, type_name) != NULL;
 }
 
+/*< private >
+ * _clutter_has_custom_progress_function:
+ * @gtype: a #GType
+ *
+ * Checks whether a progress function for @gtype was registered with
+ * clutter_interval_register_progress_func(), replacing the default
+ * one provided by Clutter, if any.
+ *
+ * Return value: %TRUE if the interpolation of @gtype was overridden
+ */
+gboolean
+_clutter_has_custom_progress_function (GType gtype)
+{
+  ProgressData *pdata;
+  gboolean res;
+
+  G_LOCK (progress_funcs);
+
+  if (progress_funcs == NULL)
+    res = FALSE;
+  else
+    {
+      pdata = g_hash_table_lookup (progress_funcs, g_type_name (gtype));
+      res = pdata != NULL && !pdata->is_default;
+    }
+
+  G_UNLOCK (progress_funcs);
+
+  return res;
+}
+
 gboolean
 _clutter_run_progress_function (GType gtype,
                                 const GValue *initial,
@@ -622,6 +656,25 @@ progress_data_destroy (gpointer data_)
 void
 clutter_interval_register_progress_func (GType               value_type,
                                          ClutterProgressFunc func)
+{
+  _clutter_register_progress_function (value_type, func, FALSE);
+}
+
+/*< private >
+ * _clutter_register_progress_function:
+ * @value_type: a #GType
+ * @func: a #ClutterProgressFunc, or %NULL to unset a previously
+ *   set progress function
+ * @is_default: whether @func is the interpolation that Clutter
+ *   provides for its own @value_type
+ *
+ * Sets the progress function for @value_type; see
+ * clutter_interval_register_progress_func().
+ */
+void
+_clutter_register_progress_function (GType               value_type,
+                                     ClutterProgressFunc func,
+                                     gboolean            is_default)
 {
   ProgressData *progress_func;
   const char *type_name;
@@ -648,13 +701,17 @@ clutter_interval_register_progress_func (GType               value_type,
           g_slice_free (ProgressData, progress_func);
         }
       else
-        progress_func->func = func;
+        {
+          progress_func->func = func;
+          progress_func->is_default = is_default;
+        }
     }
   else
     {
       progress_func = g_slice_new (ProgressData);
       progress_func->value_type = value_type;
       progress_func->func = func;
+      progress_func->is_default = is_default;
 
       g_hash_table_replace (progress_funcs,
                             (gpointer) type_name,
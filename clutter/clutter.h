@@ -76,6 +76,7 @@
 #include "clutter-keysyms.h"
 #include "clutter-layout-manager.h"
 #include "clutter-layout-meta.h"
+#include "clutter-list-view.h"
 #include "clutter-macros.h"
 #include "clutter-main.h"
 #include "clutter-offscreen-effect.h"
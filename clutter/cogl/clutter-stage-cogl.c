@@ -332,6 +332,45 @@ clutter_stage_cogl_ignoring_redraw_clips (ClutterStageWindow *stage_window)
     return FALSE;
 }
 
+/* Limits the number of rectangles of @region, replacing them with
+ * their bounding box if there are too many of them, or if they cover
+ * most of the bounding box anyway
+ */
+static void
+clutter_stage_cogl_limit_region (cairo_region_t *region)
+{
+  cairo_rectangle_int_t extents;
+  gint64 area, extents_area;
+  int n_rects, i;
+
+  n_rects = cairo_region_num_rectangles (region);
+  if (n_rects <= 1)
+    return;
+
+  cairo_region_get_extents (region, &extents);
+
+  if (n_rects <= _clutter_get_max_redraw_rects ())
+    {
+      area = 0;
+      for (i = 0; i < n_rects; i++)
+        {
+          cairo_rectangle_int_t rect;
+
+          cairo_region_get_rectangle (region, i, &rect);
+          area += (gint64) rect.width * rect.height;
+        }
+
+      /* painting the scene once for each rectangle is not worth it
+       * if we would not save much of the painted area
+       */
+      extents_area = (gint64) extents.width * extents.height;
+      if (area * 4 < extents_area * 3)
+        return;
+    }
+
+  cairo_region_union_rectangle (region, &extents);
+}
+
 /* A redraw clip represents (in stage coordinates) the bounding box of
  * something that needs to be redraw. Typically they are added to the
  * StageWindow as a result of clutter_actor_queue_clipped_redraw() by
@@ -342,9 +381,12 @@ clutter_stage_cogl_ignoring_redraw_clips (ClutterStageWindow *stage_window)
  *
  * What we do with this information:
  * - we keep track of the bounding box for all redraw clips
- * - when we come to redraw; we scissor the redraw to that box and use
- *   glBlitFramebuffer to present the redraw to the front
- *   buffer.
+ * - we keep track of the region covered by all redraw clips, up
+ *   to a maximum number of rectangles, after which we fall back
+ *   to the bounding box
+ * - when we come to redraw; we scissor the redraw to each rectangle
+ *   of the region and use glBlitFramebuffer to present the redraw
+ *   to the front buffer.
  */
 static void
 clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
@@ -363,6 +405,7 @@ clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
     {
       stage_cogl->bounding_redraw_clip.width = 0;
       stage_cogl->initialized_redraw_clip = TRUE;
+      g_clear_pointer (&stage_cogl->redraw_region, cairo_region_destroy);
       return;
     }
 
@@ -373,12 +416,18 @@ clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
   if (!stage_cogl->initialized_redraw_clip)
     {
       stage_cogl->bounding_redraw_clip = *stage_clip;
+
+      g_clear_pointer (&stage_cogl->redraw_region, cairo_region_destroy);
+      stage_cogl->redraw_region = cairo_region_create_rectangle (stage_clip);
     }
   else if (stage_cogl->bounding_redraw_clip.width > 0)
     {
       _clutter_util_rectangle_union (&stage_cogl->bounding_redraw_clip,
                                      stage_clip,
                                      &stage_cogl->bounding_redraw_clip);
+
+      cairo_region_union_rectangle (stage_cogl->redraw_region, stage_clip);
+      clutter_stage_cogl_limit_region (stage_cogl->redraw_region);
     }
 
   stage_cogl->initialized_redraw_clip = TRUE;
@@ -392,7 +441,7 @@ clutter_stage_cogl_get_redraw_clip_bounds (ClutterStageWindow    *stage_window,
 
   if (stage_cogl->using_clipped_redraw)
     {
-      *stage_clip = stage_cogl->bounding_redraw_clip;
+      *stage_clip = stage_cogl->current_redraw_clip;
 
       return TRUE;
     }
@@ -409,6 +458,64 @@ valid_buffer_age (ClutterStageCogl *stage_cogl, int age)
   return age < MIN (stage_cogl->damage_index, DAMAGE_HISTORY_MAX);
 }
 
+static void
+clutter_stage_cogl_draw_redraw_clips (ClutterStageCogl *stage_cogl,
+                                      cairo_region_t   *region,
+                                      int               window_scale)
+{
+  CoglFramebuffer *fb = COGL_FRAMEBUFFER (stage_cogl->onscreen);
+  CoglContext *ctx = cogl_framebuffer_get_context (fb);
+  static CoglPipeline *outline = NULL;
+  ClutterActor *actor = CLUTTER_ACTOR (stage_cogl->wrapper);
+  CoglMatrix modelview;
+  int i, n_rects;
+
+  if (outline == NULL)
+    {
+      outline = cogl_pipeline_new (ctx);
+      cogl_pipeline_set_color4ub (outline, 0xff, 0x00, 0x00, 0xff);
+    }
+
+  cogl_framebuffer_push_matrix (fb);
+  cogl_matrix_init_identity (&modelview);
+  _clutter_actor_apply_modelview_transform (actor, &modelview);
+  cogl_framebuffer_set_modelview_matrix (fb, &modelview);
+
+  n_rects = cairo_region_num_rectangles (region);
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_rectangle_int_t clip;
+      CoglPrimitive *prim;
+      float x_1, x_2, y_1, y_2;
+
+      cairo_region_get_rectangle (region, i, &clip);
+
+      x_1 = clip.x * window_scale;
+      x_2 = (clip.x + clip.width) * window_scale;
+      y_1 = clip.y * window_scale;
+      y_2 = (clip.y + clip.height) * window_scale;
+
+      {
+        CoglVertexP2 quad[4] = {
+          { x_1, y_1 },
+          { x_2, y_1 },
+          { x_2, y_2 },
+          { x_1, y_2 }
+        };
+
+        prim = cogl_primitive_new_p2 (ctx,
+                                      COGL_VERTICES_MODE_LINE_LOOP,
+                                      4, /* n_vertices */
+                                      quad);
+      }
+
+      cogl_framebuffer_draw_primitive (fb, outline, prim);
+      cogl_object_unref (prim);
+    }
+
+  cogl_framebuffer_pop_matrix (fb);
+}
+
 /* XXX: This is basically identical to clutter_stage_glx_redraw */
 static void
 clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
@@ -421,10 +528,13 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
   gboolean can_blit_sub_buffer;
   gboolean has_buffer_age;
   ClutterActor *wrapper;
+  cairo_rectangle_int_t clip_bounds;
   cairo_rectangle_int_t *clip_region;
-  int damage[4], ndamage;
+  cairo_region_t *redraw_region;
+  int *damage, ndamage;
   gboolean force_swap;
   int window_scale;
+  int i;
 
   wrapper = CLUTTER_ACTOR (stage_cogl->wrapper);
 
@@ -446,6 +556,7 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 		 stage_cogl->bounding_redraw_clip.height == geom.height));
 
   may_use_clipped_redraw = FALSE;
+  redraw_region = NULL;
   if (_clutter_stage_window_can_clip_redraws (stage_window) &&
       (can_blit_sub_buffer || has_buffer_age) &&
       have_clip &&
@@ -454,7 +565,13 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
       stage_cogl->frame_count > 3)
     {
       may_use_clipped_redraw = TRUE;
-      clip_region = &stage_cogl->bounding_redraw_clip;
+      clip_bounds = stage_cogl->bounding_redraw_clip;
+      clip_region = &clip_bounds;
+
+      if (stage_cogl->redraw_region != NULL)
+        redraw_region = cairo_region_copy (stage_cogl->redraw_region);
+      else
+        redraw_region = cairo_region_create_rectangle (clip_region);
     }
   else
     clip_region = NULL;
@@ -471,28 +588,38 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 
   if (has_buffer_age)
     {
-      cairo_rectangle_int_t *current_damage =
+      cairo_region_t **current_damage =
 	&stage_cogl->damage_history[DAMAGE_HISTORY (stage_cogl->damage_index++)];
 
+      g_clear_pointer (current_damage, cairo_region_destroy);
+
       if (use_clipped_redraw)
 	{
-	  int age = cogl_onscreen_get_buffer_age (stage_cogl->onscreen), i;
+	  int age = cogl_onscreen_get_buffer_age (stage_cogl->onscreen);
 
-	  *current_damage = *clip_region;
+	  *current_damage = cairo_region_copy (redraw_region);
 
 	  if (valid_buffer_age (stage_cogl, age))
 	    {
 	      for (i = 1; i <= age; i++)
-		_clutter_util_rectangle_union (clip_region,
-					       &stage_cogl->damage_history[DAMAGE_HISTORY (stage_cogl->damage_index - i - 1)],
-					       clip_region);
+                {
+                  cairo_region_t *old_damage =
+                    stage_cogl->damage_history[DAMAGE_HISTORY (stage_cogl->damage_index - i - 1)];
+
+                  if (old_damage != NULL)
+                    cairo_region_union (redraw_region, old_damage);
+                }
+
+              clutter_stage_cogl_limit_region (redraw_region);
+              cairo_region_get_extents (redraw_region, clip_region);
 
-	      CLUTTER_NOTE (CLIPPING, "Reusing back buffer(age=%d) - repairing region: x=%d, y=%d, width=%d, height=%d\n",
+	      CLUTTER_NOTE (CLIPPING, "Reusing back buffer(age=%d) - repairing region: x=%d, y=%d, width=%d, height=%d (%d rectangles)\n",
 			    age,
 			    clip_region->x,
 			    clip_region->y,
 			    clip_region->width,
-			    clip_region->height);
+			    clip_region->height,
+                            cairo_region_num_rectangles (redraw_region));
 	      force_swap = TRUE;
 	    }
 	  else
@@ -503,35 +630,52 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 	}
       else
 	{
-	  current_damage->x = 0;
-	  current_damage->y = 0;
-	  current_damage->width  = geom.width;
-	  current_damage->height = geom.height;
+          cairo_rectangle_int_t full_damage;
+
+	  full_damage.x = 0;
+	  full_damage.y = 0;
+	  full_damage.width  = geom.width;
+	  full_damage.height = geom.height;
+
+          *current_damage = cairo_region_create_rectangle (&full_damage);
 	}
     }
 
   if (use_clipped_redraw)
     {
       CoglFramebuffer *fb = COGL_FRAMEBUFFER (stage_cogl->onscreen);
-
-      CLUTTER_NOTE (CLIPPING,
-                    "Stage clip pushed: x=%d, y=%d, width=%d, height=%d\n",
-                    clip_region->x,
-                    clip_region->y,
-                    clip_region->width,
-                    clip_region->height);
+      int n_rects = cairo_region_num_rectangles (redraw_region);
 
       stage_cogl->using_clipped_redraw = TRUE;
 
-      cogl_framebuffer_push_scissor_clip (fb,
-                                          clip_region->x * window_scale,
-                                          clip_region->y * window_scale,
-                                          clip_region->width * window_scale,
-                                          clip_region->height * window_scale);
-      _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), clip_region);
-      cogl_framebuffer_pop_clip (fb);
+      /* the scene is painted once for each rectangle; culling will
+       * skip the actors outside of each of them
+       */
+      for (i = 0; i < n_rects; i++)
+        {
+          cairo_rectangle_int_t *rect = &stage_cogl->current_redraw_clip;
+
+          cairo_region_get_rectangle (redraw_region, i, rect);
+
+          CLUTTER_NOTE (CLIPPING,
+                        "Stage clip pushed: x=%d, y=%d, width=%d, height=%d\n",
+                        rect->x,
+                        rect->y,
+                        rect->width,
+                        rect->height);
+
+          cogl_framebuffer_push_scissor_clip (fb,
+                                              rect->x * window_scale,
+                                              rect->y * window_scale,
+                                              rect->width * window_scale,
+                                              rect->height * window_scale);
+          _clutter_stage_paint_clip (CLUTTER_STAGE (wrapper), rect);
+          cogl_framebuffer_pop_clip (fb);
+        }
 
       stage_cogl->using_clipped_redraw = FALSE;
+
+      _clutter_stage_emit_after_paint (CLUTTER_STAGE (wrapper));
     }
   else
     {
@@ -551,44 +695,10 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
   if (may_use_clipped_redraw &&
       G_UNLIKELY ((clutter_paint_debug_flags & CLUTTER_DEBUG_REDRAWS)))
     {
-      CoglFramebuffer *fb = COGL_FRAMEBUFFER (stage_cogl->onscreen);
-      CoglContext *ctx = cogl_framebuffer_get_context (fb);
-      static CoglPipeline *outline = NULL;
-      cairo_rectangle_int_t *clip = &stage_cogl->bounding_redraw_clip;
-      ClutterActor *actor = CLUTTER_ACTOR (wrapper);
-      float x_1 = clip->x * window_scale;
-      float x_2 = clip->x + clip->width * window_scale;
-      float y_1 = clip->y * window_scale;
-      float y_2 = clip->y + clip->height * window_scale;
-      CoglVertexP2 quad[4] = {
-        { x_1, y_1 },
-        { x_2, y_1 },
-        { x_2, y_2 },
-        { x_1, y_2 }
-      };
-      CoglPrimitive *prim;
-      CoglMatrix modelview;
-
-      if (outline == NULL)
-        {
-          outline = cogl_pipeline_new (ctx);
-          cogl_pipeline_set_color4ub (outline, 0xff, 0x00, 0x00, 0xff);
-        }
-
-      prim = cogl_primitive_new_p2 (ctx,
-                                    COGL_VERTICES_MODE_LINE_LOOP,
-                                    4, /* n_vertices */
-                                    quad);
-
-      cogl_framebuffer_push_matrix (fb);
-      cogl_matrix_init_identity (&modelview);
-      _clutter_actor_apply_modelview_transform (actor, &modelview);
-      cogl_framebuffer_set_modelview_matrix (fb, &modelview);
-      cogl_framebuffer_draw_primitive (COGL_FRAMEBUFFER (stage_cogl->onscreen),
-                                       outline,
-                                       prim);
-      cogl_framebuffer_pop_matrix (fb);
-      cogl_object_unref (prim);
+      if (stage_cogl->redraw_region != NULL)
+        clutter_stage_cogl_draw_redraw_clips (stage_cogl,
+                                              stage_cogl->redraw_region,
+                                              window_scale);
     }
 
   /* XXX: It seems there will be a race here in that the stage
@@ -601,26 +711,43 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
    */
   if (use_clipped_redraw || force_swap)
     {
-      damage[0] = clip_region->x * window_scale;
-      damage[1] = clip_region->y * window_scale;
-      damage[2] = clip_region->width * window_scale;
-      damage[3] = clip_region->height * window_scale;
-      ndamage = 1;
+      ndamage = cairo_region_num_rectangles (redraw_region);
+      damage = g_new (int, ndamage * 4);
+
+      for (i = 0; i < ndamage; i++)
+        {
+          cairo_rectangle_int_t rect;
+
+          cairo_region_get_rectangle (redraw_region, i, &rect);
+
+          damage[i * 4 + 0] = rect.x * window_scale;
+          damage[i * 4 + 1] = rect.y * window_scale;
+          damage[i * 4 + 2] = rect.width * window_scale;
+          damage[i * 4 + 3] = rect.height * window_scale;
+        }
     }
   else
     {
+      damage = NULL;
       ndamage = 0;
     }
 
+  _clutter_stage_begin_frame_swap (CLUTTER_STAGE (wrapper));
+
   /* push on the screen */
   if (use_clipped_redraw && !force_swap)
     {
       CLUTTER_NOTE (BACKEND,
                     "cogl_onscreen_swap_region (onscreen: %p, "
                                                 "x: %d, y: %d, "
-                                                "width: %d, height: %d)",
+                                                "width: %d, height: %d, "
+                                                "rectangles: %d)",
                     stage_cogl->onscreen,
-                    damage[0], damage[1], damage[2], damage[3]);
+                    clip_region->x * window_scale,
+                    clip_region->y * window_scale,
+                    clip_region->width * window_scale,
+                    clip_region->height * window_scale,
+                    ndamage);
 
       cogl_onscreen_swap_region (stage_cogl->onscreen,
 				 damage, ndamage);
@@ -640,8 +767,14 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 					      damage, ndamage);
     }
 
+  g_free (damage);
+
+  if (redraw_region != NULL)
+    cairo_region_destroy (redraw_region);
+
   /* reset the redraw clipping for the next paint... */
   stage_cogl->initialized_redraw_clip = FALSE;
+  g_clear_pointer (&stage_cogl->redraw_region, cairo_region_destroy);
 
   /* We have repaired the backbuffer */
   stage_cogl->dirty_backbuffer = FALSE;
@@ -680,11 +813,15 @@ clutter_stage_cogl_get_dirty_pixel (ClutterStageWindow *stage_window,
     }
   else
     {
-      cairo_rectangle_int_t *rect;
+      cairo_region_t *region;
+      cairo_rectangle_int_t rect = { 0, };
+
+      region = stage_cogl->damage_history[DAMAGE_HISTORY (stage_cogl->damage_index-1)];
+      if (region != NULL && !cairo_region_is_empty (region))
+        cairo_region_get_rectangle (region, 0, &rect);
 
-      rect = &stage_cogl->damage_history[DAMAGE_HISTORY (stage_cogl->damage_index-1)];
-      *x = rect->x;
-      *y = rect->y;
+      *x = rect.x;
+      *y = rect.y;
     }
 }
 
@@ -735,12 +872,27 @@ clutter_stage_cogl_set_property (GObject      *gobject,
     }
 }
 
+static void
+clutter_stage_cogl_finalize (GObject *gobject)
+{
+  ClutterStageCogl *self = CLUTTER_STAGE_COGL (gobject);
+  int i;
+
+  g_clear_pointer (&self->redraw_region, cairo_region_destroy);
+
+  for (i = 0; i < DAMAGE_HISTORY_MAX; i++)
+    g_clear_pointer (&self->damage_history[i], cairo_region_destroy);
+
+  G_OBJECT_CLASS (_clutter_stage_cogl_parent_class)->finalize (gobject);
+}
+
 static void
 _clutter_stage_cogl_class_init (ClutterStageCoglClass *klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->set_property = clutter_stage_cogl_set_property;
+  gobject_class->finalize = clutter_stage_cogl_finalize;
 
   g_object_class_override_property (gobject_class, PROP_WRAPPER, "wrapper");
   g_object_class_override_property (gobject_class, PROP_BACKEND, "backend");
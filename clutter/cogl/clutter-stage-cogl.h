@@ -50,16 +50,24 @@ struct _ClutterStageCogl
 
   cairo_rectangle_int_t bounding_redraw_clip;
 
-  /* Stores a list of previous damaged areas */
+  /* The rectangles inside bounding_redraw_clip that need to be
+   * redrawn; the number of rectangles is limited, so this can be
+   * replaced by the bounding box */
+  cairo_region_t *redraw_region;
+
+  /* The rectangle of the redraw region currently being painted */
+  cairo_rectangle_int_t current_redraw_clip;
+
+  /* Stores a list of previous damaged regions */
 #define DAMAGE_HISTORY_MAX 16
 #define DAMAGE_HISTORY(x) ((x) & (DAMAGE_HISTORY_MAX - 1))
-  cairo_rectangle_int_t damage_history[DAMAGE_HISTORY_MAX];
+  cairo_region_t *damage_history[DAMAGE_HISTORY_MAX];
   unsigned int damage_index;
 
   guint initialized_redraw_clip : 1;
 
   /* TRUE if the current paint cycle has a clipped redraw. In that
-     case bounding_redraw_clip specifies the the bounds. */
+     case current_redraw_clip specifies the the bounds. */
   guint using_clipped_redraw : 1;
 
   guint dirty_backbuffer     : 1;
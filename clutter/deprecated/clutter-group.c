@@ -452,6 +452,11 @@ clutter_group_class_init (ClutterGroupClass *klass)
   actor_class->hide_all = clutter_group_real_hide_all;
   actor_class->get_paint_volume = clutter_group_real_get_paint_volume;
 
+  /* our pick() paints the same silhouette as the default implementation,
+   * and then our children in paint order
+   */
+  _clutter_actor_class_set_geometric_pick (actor_class);
+
   gobject_class->dispose = clutter_group_dispose;
 }
 
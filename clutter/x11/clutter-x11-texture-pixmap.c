@@ -45,12 +45,15 @@
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
 
+#include <math.h>
+
 #include "clutter-x11-texture-pixmap.h"
 #include "clutter-x11.h"
 #include "clutter-backend-x11.h"
 
 #include "clutter-actor-private.h"
 #include "clutter-marshal.h"
+#include "clutter-master-clock.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-private.h"
 
@@ -121,6 +124,9 @@ struct _ClutterX11TexturePixmapPrivate
 
   Damage        damage;
 
+  /* the areas damaged since the last frame, in pixmap coordinates */
+  cairo_region_t *damage_region;
+
   gint          window_x, window_y;
   gint          window_width, window_height;
 
@@ -136,6 +142,10 @@ struct _ClutterX11TexturePixmapPrivate
 
 static int _damage_event_base = 0;
 
+/* the textures with a damage region, flushed before each frame */
+static GSList *damaged_textures = NULL;
+static guint   damage_repaint_func = 0;
+
 G_DEFINE_TYPE_WITH_PRIVATE (ClutterX11TexturePixmap,
                             clutter_x11_texture_pixmap,
                             CLUTTER_TYPE_TEXTURE)
@@ -160,18 +170,91 @@ check_extensions (ClutterX11TexturePixmap *texture)
   return TRUE;
 }
 
+static void
+clear_damage_region (ClutterX11TexturePixmap *texture)
+{
+  ClutterX11TexturePixmapPrivate *priv = texture->priv;
+
+  if (priv->damage_region == NULL)
+    return;
+
+  damaged_textures = g_slist_remove (damaged_textures, texture);
+
+  cairo_region_destroy (priv->damage_region);
+  priv->damage_region = NULL;
+}
+
+static gboolean
+flush_damage_regions (gpointer data)
+{
+  while (damaged_textures != NULL)
+    {
+      ClutterX11TexturePixmap *texture = damaged_textures->data;
+      ClutterX11TexturePixmapPrivate *priv = texture->priv;
+      cairo_region_t *region = priv->damage_region;
+      int i, n_rects;
+
+      damaged_textures = g_slist_delete_link (damaged_textures,
+                                              damaged_textures);
+      priv->damage_region = NULL;
+
+      /* the handlers may cause the texture to be destroyed */
+      g_object_ref (texture);
+
+      n_rects = cairo_region_num_rectangles (region);
+      for (i = 0; i < n_rects; i++)
+        {
+          cairo_rectangle_int_t rect;
+
+          cairo_region_get_rectangle (region, i, &rect);
+          g_signal_emit (texture, signals[QUEUE_DAMAGE_REDRAW],
+                         0,
+                         rect.x,
+                         rect.y,
+                         rect.width,
+                         rect.height);
+        }
+
+      cairo_region_destroy (region);
+      g_object_unref (texture);
+    }
+
+  return TRUE;
+}
+
 static void
 process_damage_event (ClutterX11TexturePixmap *texture,
                       XDamageNotifyEvent *damage_event)
 {
+  ClutterX11TexturePixmapPrivate *priv = texture->priv;
+  cairo_rectangle_int_t area;
+
   /* Cogl will deal with updating the texture and subtracting from the
-     damage region so we only need to queue a redraw */
-  g_signal_emit (texture, signals[QUEUE_DAMAGE_REDRAW],
-                 0,
-                 damage_event->area.x,
-                 damage_event->area.y,
-                 damage_event->area.width,
-                 damage_event->area.height);
+   * damage region so we only need to queue a redraw; since a client
+   * can damage its window many times in a frame, we accumulate the
+   * damaged areas and queue the redraws right before the next frame
+   */
+  area.x = damage_event->area.x;
+  area.y = damage_event->area.y;
+  area.width = damage_event->area.width;
+  area.height = damage_event->area.height;
+
+  if (priv->damage_region == NULL)
+    {
+      priv->damage_region = cairo_region_create_rectangle (&area);
+      damaged_textures = g_slist_prepend (damaged_textures, texture);
+
+      if (G_UNLIKELY (damage_repaint_func == 0))
+        {
+          damage_repaint_func =
+            clutter_threads_add_repaint_func (flush_damage_regions,
+                                              NULL, NULL);
+        }
+
+      _clutter_master_clock_ensure_next_iteration (_clutter_master_clock_get_default ());
+    }
+  else
+    cairo_region_union_rectangle (priv->damage_region, &area);
 }
 
 static ClutterX11FilterReturn
@@ -324,6 +407,8 @@ free_damage_resources (ClutterX11TexturePixmap *texture)
 
       clutter_x11_remove_filter (on_x_event_filter, (gpointer)texture);
 
+      clear_damage_region (texture);
+
       update_pixmap_damage_object (texture);
     }
 }
@@ -346,8 +431,9 @@ clutter_x11_texture_pixmap_real_queue_damage_redraw (
   ClutterX11TexturePixmapPrivate *priv = texture->priv;
   ClutterActor *self = CLUTTER_ACTOR (texture);
   ClutterActorBox allocation;
+  ClutterPaintVolume clip;
+  ClutterVertex origin;
   float scale_x, scale_y;
-  cairo_rectangle_int_t clip;
 
   /* NB: clutter_actor_queue_clipped_redraw expects a box in the actor's
    * coordinate space so we need to convert from pixmap coordinates to
@@ -374,11 +460,21 @@ clutter_x11_texture_pixmap_real_queue_damage_redraw (
   scale_x = (allocation.x2 - allocation.x1) / priv->pixmap_width;
   scale_y = (allocation.y2 - allocation.y1) / priv->pixmap_height;
 
-  clip.x = x * scale_x;
-  clip.y = y * scale_y;
-  clip.width = width * scale_x;
-  clip.height = height * scale_y;
-  clutter_actor_queue_redraw_with_clip (self, &clip);
+  /* round outwards, so that scaled textures do not leave stale
+   * pixels on the edges of the damaged area
+   */
+  origin.x = floorf (x * scale_x);
+  origin.y = floorf (y * scale_y);
+  origin.z = 0.f;
+
+  _clutter_paint_volume_init_static (&clip, self);
+  clutter_paint_volume_set_origin (&clip, &origin);
+  clutter_paint_volume_set_width (&clip, ceilf ((x + width) * scale_x) - origin.x);
+  clutter_paint_volume_set_height (&clip, ceilf ((y + height) * scale_y) - origin.y);
+
+  _clutter_actor_queue_redraw_with_clip (self, 0, &clip);
+
+  clutter_paint_volume_free (&clip);
 }
 
 static void
@@ -682,6 +778,13 @@ clutter_x11_texture_pixmap_class_init (ClutterX11TexturePixmapClass *klass)
    * clutter_x11_texture_pixmap_update_area). This usually means a
    * redraw needs to be queued for the actor.
    *
+   * The automatic damage updates are not emitted as soon as they are
+   * received: the areas damaged by the X server are accumulated into
+   * a region, and the signal is emitted once for each rectangle of
+   * that region right before the next frame is painted, so that a
+   * window damaged many times within a frame only queues a redraw for
+   * each distinct area.
+   *
    * The default handler will queue a clipped redraw in response to
    * the damage, using the assumption that the pixmap is being painted
    * to a rectangle covering the transformed allocation of the actor.
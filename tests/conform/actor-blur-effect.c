@@ -0,0 +1,196 @@
+#include <clutter/clutter.h>
+
+#define ACTOR_X         100
+#define ACTOR_Y         100
+#define ACTOR_SIZE      20
+#define BLUR_RADIUS     8
+
+/* the distance from the edges of the actor at which the blur is sampled */
+#define SAMPLE_OFFSET   4
+
+typedef struct {
+  ClutterActor *stage;
+
+  gboolean was_painted;
+
+  guint8 center;
+  guint8 left, right, top, bottom;
+  guint8 far;
+} BlurData;
+
+static guint8
+get_red (int x,
+         int y)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return data[0];
+}
+
+static void
+on_after_paint (ClutterActor *stage,
+                BlurData     *data)
+{
+  int x2 = ACTOR_X + ACTOR_SIZE - 1;
+  int y2 = ACTOR_Y + ACTOR_SIZE - 1;
+  int cx = ACTOR_X + ACTOR_SIZE / 2;
+  int cy = ACTOR_Y + ACTOR_SIZE / 2;
+
+  data->center = get_red (cx, cy);
+  data->left = get_red (ACTOR_X - SAMPLE_OFFSET, cy);
+  data->right = get_red (x2 + SAMPLE_OFFSET, cy);
+  data->top = get_red (cx, ACTOR_Y - SAMPLE_OFFSET);
+  data->bottom = get_red (cx, y2 + SAMPLE_OFFSET);
+  data->far = get_red (x2 + 4 * BLUR_RADIUS, cy);
+
+  data->was_painted = TRUE;
+}
+
+static void
+paint_frame (BlurData *data)
+{
+  data->was_painted = FALSE;
+
+  clutter_actor_queue_redraw (data->stage);
+
+  while (!data->was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (g_test_verbose ())
+    g_print ("center: 0x%02x, left: 0x%02x, right: 0x%02x, "
+             "top: 0x%02x, bottom: 0x%02x, far: 0x%02x\n",
+             data->center,
+             data->left, data->right,
+             data->top, data->bottom,
+             data->far);
+}
+
+static ClutterActor *
+add_blurred_actor (ClutterActor *stage,
+                   guint         downsample)
+{
+  ClutterActor *actor = clutter_actor_new ();
+  ClutterEffect *effect = clutter_blur_effect_new ();
+
+  clutter_actor_set_position (actor, ACTOR_X, ACTOR_Y);
+  clutter_actor_set_size (actor, ACTOR_SIZE, ACTOR_SIZE);
+  clutter_actor_set_background_color (actor, CLUTTER_COLOR_White);
+  clutter_actor_add_child (stage, actor);
+
+  clutter_blur_effect_set_radius (CLUTTER_BLUR_EFFECT (effect), BLUR_RADIUS);
+  clutter_blur_effect_set_downsample (CLUTTER_BLUR_EFFECT (effect), downsample);
+  clutter_actor_add_effect (actor, effect);
+
+  return actor;
+}
+
+static void
+check_blur (guint downsample)
+{
+  BlurData data = { NULL, };
+  ClutterActor *actor;
+  int tolerance;
+
+  data.stage = clutter_test_get_stage ();
+  clutter_actor_set_background_color (data.stage, CLUTTER_COLOR_Black);
+
+  actor = add_blurred_actor (data.stage, downsample);
+
+  g_signal_connect (data.stage, "after-paint",
+                    G_CALLBACK (on_after_paint),
+                    &data);
+
+  clutter_actor_show (data.stage);
+  paint_frame (&data);
+
+  /* the actor spreads out of its allocation, within the radius */
+  g_assert_cmpuint (data.center, >, 0xc0);
+  g_assert_cmpuint (data.left, >, 0);
+  g_assert_cmpuint (data.left, <, data.center);
+  g_assert_cmpuint (data.far, ==, 0);
+
+  /* the blur is the same in both directions, and the horizontal pass
+   * is not stretched by the downsampling
+   */
+  tolerance = downsample == 1 ? 0x04 : 0x30;
+
+  g_assert_cmpint (ABS (data.left - data.right), <=, tolerance);
+  g_assert_cmpint (ABS (data.top - data.bottom), <=, tolerance);
+  g_assert_cmpint (ABS (data.left - data.top), <=, tolerance);
+  g_assert_cmpint (ABS (data.right - data.bottom), <=, tolerance);
+
+  g_signal_handlers_disconnect_by_func (data.stage, on_after_paint, &data);
+
+  clutter_actor_destroy (actor);
+}
+
+static void
+actor_blur_effect_full (void)
+{
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return;
+
+  check_blur (1);
+}
+
+static void
+actor_blur_effect_downsample (void)
+{
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return;
+
+  check_blur (2);
+  check_blur (4);
+}
+
+static void
+actor_blur_effect_pool (void)
+{
+  BlurData data = { NULL, };
+  ClutterActor *actor;
+  guint n_hits_before, n_misses_before;
+  guint n_hits, n_misses;
+
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return;
+
+  data.stage = clutter_test_get_stage ();
+
+  g_signal_connect (data.stage, "after-paint",
+                    G_CALLBACK (on_after_paint),
+                    &data);
+
+  clutter_actor_show (data.stage);
+
+  actor = add_blurred_actor (data.stage, 2);
+  paint_frame (&data);
+  clutter_actor_destroy (actor);
+
+  clutter_offscreen_effect_get_pool_stats (&n_hits_before, &n_misses_before,
+                                           NULL, NULL);
+
+  /* both the offscreen buffer of the actor and the one of the
+   * horizontal pass are reused by another blur of the same size
+   */
+  actor = add_blurred_actor (data.stage, 2);
+  paint_frame (&data);
+
+  clutter_offscreen_effect_get_pool_stats (&n_hits, &n_misses, NULL, NULL);
+  g_assert_cmpuint (n_hits, >=, n_hits_before + 2);
+  g_assert_cmpuint (n_misses, ==, n_misses_before);
+
+  g_signal_handlers_disconnect_by_func (data.stage, on_after_paint, &data);
+
+  clutter_actor_destroy (actor);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/blur-effect/full", actor_blur_effect_full)
+  CLUTTER_TEST_UNIT ("/actor/blur-effect/downsample", actor_blur_effect_downsample)
+  CLUTTER_TEST_UNIT ("/actor/blur-effect/pool", actor_blur_effect_pool)
+)
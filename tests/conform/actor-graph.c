@@ -396,6 +396,96 @@ actor_remove_all (void)
   g_assert (actor == NULL);
 }
 
+static void
+check_child_index (ClutterActor *actor)
+{
+  ClutterActor *iter;
+  int i;
+
+  for (iter = clutter_actor_get_first_child (actor), i = 0;
+       iter != NULL;
+       iter = clutter_actor_get_next_sibling (iter), i += 1)
+    g_assert (clutter_actor_get_child_at_index (actor, i) == iter);
+
+  g_assert_cmpint (clutter_actor_get_n_children (actor), ==, i);
+}
+
+static void
+actor_child_index (void)
+{
+  ClutterActor *actor = clutter_actor_new ();
+  ClutterActor *child, *iter;
+  float last_depth;
+  int i;
+
+  g_object_ref_sink (actor);
+  g_object_add_weak_pointer (G_OBJECT (actor), (gpointer *) &actor);
+
+  /* enough children to make the actor build its child index */
+  for (i = 0; i < 100; i++)
+    clutter_actor_add_child (actor, clutter_actor_new ());
+
+  check_child_index (actor);
+
+  child = clutter_actor_new ();
+  clutter_actor_insert_child_at_index (actor, child, 50);
+  g_assert (clutter_actor_get_child_at_index (actor, 50) == child);
+  check_child_index (actor);
+
+  clutter_actor_insert_child_at_index (actor, clutter_actor_new (), 0);
+  g_assert (clutter_actor_get_child_at_index (actor, 51) == child);
+  check_child_index (actor);
+
+  iter = clutter_actor_get_child_at_index (actor, 10);
+  clutter_actor_remove_child (actor, iter);
+  g_assert (clutter_actor_get_child_at_index (actor, 50) == child);
+  check_child_index (actor);
+
+  clutter_actor_set_child_at_index (actor, child, 90);
+  g_assert (clutter_actor_get_child_at_index (actor, 90) == child);
+  check_child_index (actor);
+
+  clutter_actor_set_child_below_sibling (actor, child, NULL);
+  g_assert (clutter_actor_get_first_child (actor) == child);
+  check_child_index (actor);
+
+  clutter_actor_remove_all_children (actor);
+  g_assert_cmpint (clutter_actor_get_n_children (actor), ==, 0);
+
+  /* children are inserted in depth order, after the children with
+   * the same depth
+   */
+  for (i = 0; i < 100; i++)
+    {
+      child = clutter_actor_new ();
+      clutter_actor_set_z_position (child, (i * 7) % 13);
+      clutter_actor_add_child (actor, child);
+    }
+
+  check_child_index (actor);
+
+  last_depth = -1.f;
+  for (iter = clutter_actor_get_first_child (actor);
+       iter != NULL;
+       iter = clutter_actor_get_next_sibling (iter))
+    {
+      g_assert_cmpfloat (clutter_actor_get_z_position (iter), >=, last_depth);
+      last_depth = clutter_actor_get_z_position (iter);
+    }
+
+  child = clutter_actor_new ();
+  clutter_actor_set_z_position (child, 5.f);
+  clutter_actor_add_child (actor, child);
+  iter = clutter_actor_get_next_sibling (child);
+  g_assert_cmpfloat (clutter_actor_get_z_position (iter), ==, 6.f);
+  iter = clutter_actor_get_previous_sibling (child);
+  g_assert_cmpfloat (clutter_actor_get_z_position (iter), ==, 5.f);
+  check_child_index (actor);
+
+  clutter_actor_destroy (actor);
+  g_assert (actor == NULL);
+}
+
 static void
 actor_added (ClutterContainer *container,
              ClutterActor     *child,
@@ -544,6 +634,7 @@ CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/graph/lower-child", actor_lower_child)
   CLUTTER_TEST_UNIT ("/actor/graph/replace-child", actor_replace_child)
   CLUTTER_TEST_UNIT ("/actor/graph/remove-all", actor_remove_all)
+  CLUTTER_TEST_UNIT ("/actor/graph/child-index", actor_child_index)
   CLUTTER_TEST_UNIT ("/actor/graph/container-signals", actor_container_signals)
   CLUTTER_TEST_UNIT ("/actor/graph/contains", actor_contains)
 )
@@ -86,7 +86,136 @@ actor_margin_layout (void)
   clutter_test_assert_actor_at_point (stage, &p, flower[2]);
 }
 
+typedef struct {
+  ClutterActor *outer;
+  ClutterActor *header;
+  ClutterActor *panel;
+  ClutterActor *label;
+  ClutterActor *sibling;
+} RelayoutTree;
+
+static void
+relayout_tree_init (RelayoutTree *tree,
+                    ClutterActor *stage,
+                    gfloat        x)
+{
+  tree->outer = clutter_actor_new ();
+  clutter_actor_set_layout_manager (tree->outer, clutter_box_layout_new ());
+  clutter_box_layout_set_orientation (CLUTTER_BOX_LAYOUT (clutter_actor_get_layout_manager (tree->outer)),
+                                      CLUTTER_ORIENTATION_VERTICAL);
+  clutter_actor_set_x (tree->outer, x);
+  clutter_actor_add_child (stage, tree->outer);
+
+  tree->header = clutter_actor_new ();
+  clutter_actor_set_size (tree->header, 50, 20);
+  clutter_actor_add_child (tree->outer, tree->header);
+
+  /* a fixed size panel does not need its parent to be laid out
+   * again when one of its children changes size
+   */
+  tree->panel = clutter_actor_new ();
+  clutter_actor_set_layout_manager (tree->panel, clutter_box_layout_new ());
+  clutter_actor_set_size (tree->panel, 200, 100);
+  clutter_actor_add_child (tree->outer, tree->panel);
+
+  tree->label = clutter_actor_new ();
+  clutter_actor_set_background_color (tree->label, CLUTTER_COLOR_Red);
+  clutter_actor_set_size (tree->label, 40, 20);
+  clutter_actor_add_child (tree->panel, tree->label);
+
+  tree->sibling = clutter_actor_new ();
+  clutter_actor_set_background_color (tree->sibling, CLUTTER_COLOR_Green);
+  clutter_actor_set_size (tree->sibling, 30, 20);
+  clutter_actor_add_child (tree->panel, tree->sibling);
+}
+
+static void
+assert_same_allocation (ClutterActor *a,
+                        ClutterActor *b)
+{
+  ClutterActorBox box_a, box_b;
+
+  clutter_actor_get_allocation_box (a, &box_a);
+  clutter_actor_get_allocation_box (b, &box_b);
+
+  g_assert (clutter_actor_box_equal (&box_a, &box_b));
+}
+
+static void
+actor_relayout_root (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  RelayoutTree a, b;
+  ClutterActorBox box, outer;
+  ClutterPoint p;
+
+  relayout_tree_init (&a, stage, 0);
+  relayout_tree_init (&b, stage, 300);
+
+  clutter_point_init (&p, 20, 30);
+  clutter_test_assert_actor_at_point (stage, &p, a.label);
+
+  /* queueing a relayout on the panel itself forces the second tree
+   * to be laid out again from the stage
+   */
+  clutter_actor_queue_relayout (b.panel);
+
+  clutter_actor_set_width (a.label, 120);
+  clutter_actor_set_width (b.label, 120);
+
+  clutter_point_init (&p, 130, 30);
+  clutter_test_assert_actor_at_point (stage, &p, a.sibling);
+
+  clutter_actor_get_allocation_box (a.sibling, &box);
+  g_assert_cmpfloat (box.x1, ==, 120);
+
+  /* the second tree is offset by 300 pixels on the stage, while the
+   * allocations of the children are relative to their parent
+   */
+  clutter_actor_get_allocation_box (b.outer, &box);
+  clutter_actor_box_set_origin (&box, box.x1 - 300, box.y1);
+  clutter_actor_get_allocation_box (a.outer, &outer);
+  g_assert (clutter_actor_box_equal (&outer, &box));
+
+  assert_same_allocation (a.header, b.header);
+  assert_same_allocation (a.panel, b.panel);
+  assert_same_allocation (a.label, b.label);
+  assert_same_allocation (a.sibling, b.sibling);
+}
+
+static void
+actor_relayout_root_expand (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  RelayoutTree tree;
+  ClutterActorBox box;
+  ClutterPoint p;
+
+  /* the outer container has more space than its children need */
+  relayout_tree_init (&tree, stage, 0);
+  clutter_actor_set_size (tree.outer, 300, 300);
+
+  clutter_point_init (&p, 20, 30);
+  clutter_test_assert_actor_at_point (stage, &p, tree.label);
+
+  clutter_actor_get_allocation_box (tree.panel, &box);
+  g_assert_cmpfloat (clutter_actor_box_get_height (&box), ==, 100);
+
+  /* the panel has a fixed size, but it now expands with its child,
+   * so the outer container has to give it the remaining space
+   */
+  clutter_actor_set_y_expand (tree.label, TRUE);
+
+  clutter_point_init (&p, 20, 30);
+  clutter_test_assert_actor_at_point (stage, &p, tree.label);
+
+  clutter_actor_get_allocation_box (tree.panel, &box);
+  g_assert_cmpfloat (clutter_actor_box_get_height (&box), ==, 280);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/layout/basic", actor_basic_layout)
   CLUTTER_TEST_UNIT ("/actor/layout/margin", actor_margin_layout)
+  CLUTTER_TEST_UNIT ("/actor/layout/relayout-root", actor_relayout_root)
+  CLUTTER_TEST_UNIT ("/actor/layout/relayout-root-expand", actor_relayout_root_expand)
 )
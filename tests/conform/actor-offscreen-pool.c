@@ -0,0 +1,270 @@
+#include <clutter/clutter.h>
+
+/* the size of the pool, in megabytes */
+#define POOL_SIZE       1
+
+typedef struct _FooEffect       FooEffect;
+typedef struct _FooEffectClass  FooEffectClass;
+
+struct _FooEffectClass
+{
+  ClutterOffscreenEffectClass parent_class;
+};
+
+struct _FooEffect
+{
+  ClutterOffscreenEffect parent;
+};
+
+GType foo_effect_get_type (void);
+
+/* uses the default textures, which are shared through the pool */
+G_DEFINE_TYPE (FooEffect, foo_effect, CLUTTER_TYPE_OFFSCREEN_EFFECT)
+
+static void
+foo_effect_class_init (FooEffectClass *klass)
+{
+}
+
+static void
+foo_effect_init (FooEffect *self)
+{
+}
+
+typedef struct {
+  guint n_hits;
+  guint n_misses;
+  guint n_evictions;
+  gsize resident_bytes;
+} PoolStats;
+
+static void
+get_pool_stats (PoolStats *stats)
+{
+  clutter_offscreen_effect_get_pool_stats (&stats->n_hits,
+                                           &stats->n_misses,
+                                           &stats->n_evictions,
+                                           &stats->resident_bytes);
+
+  if (g_test_verbose ())
+    g_print ("pool: %u hits, %u misses, %u evictions, %" G_GSIZE_FORMAT " bytes\n",
+             stats->n_hits,
+             stats->n_misses,
+             stats->n_evictions,
+             stats->resident_bytes);
+}
+
+static void
+on_after_paint (ClutterActor *stage,
+                gboolean     *was_painted)
+{
+  *was_painted = TRUE;
+}
+
+static void
+wait_for_frame (ClutterActor *stage)
+{
+  gboolean was_painted = FALSE;
+  gulong paint_id;
+
+  paint_id = g_signal_connect (stage, "after-paint",
+                               G_CALLBACK (on_after_paint),
+                               &was_painted);
+
+  clutter_actor_queue_redraw (stage);
+
+  while (!was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (stage, paint_id);
+}
+
+static guint32
+get_pixel (int x,
+           int y)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return (((guint32) data[0] << 16) |
+          ((guint32) data[1] << 8) |
+          data[2]);
+}
+
+static void
+on_check_pixels (ClutterActor *stage,
+                 ClutterActor *actor)
+{
+  gfloat width, height;
+
+  clutter_actor_get_size (actor, &width, &height);
+
+  /* only the area of the actor is painted from the pooled target */
+  g_assert_cmphex (get_pixel (width / 2, height / 2), ==, 0xff0000);
+  g_assert_cmphex (get_pixel (width - 1, height - 1), ==, 0xff0000);
+  g_assert_cmphex (get_pixel (width + 1, height / 2), ==, 0x000000);
+  g_assert_cmphex (get_pixel (width / 2, height + 1), ==, 0x000000);
+}
+
+static ClutterActor *
+add_actor (ClutterActor *stage,
+           gfloat        width,
+           gfloat        height)
+{
+  ClutterActor *actor = clutter_actor_new ();
+
+  clutter_actor_set_size (actor, width, height);
+  clutter_actor_set_background_color (actor, CLUTTER_COLOR_Red);
+  clutter_actor_add_child (stage, actor);
+
+  return actor;
+}
+
+static void
+actor_offscreen_pool_miss (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *actor;
+  PoolStats before, after;
+
+  clutter_actor_show (stage);
+
+  get_pool_stats (&before);
+
+  /* no other test uses a target of this size */
+  actor = add_actor (stage, 200, 50);
+  clutter_actor_add_effect (actor, g_object_new (foo_effect_get_type (), NULL));
+  wait_for_frame (stage);
+
+  get_pool_stats (&after);
+  g_assert_cmpuint (after.n_misses, ==, before.n_misses + 1);
+  g_assert_cmpuint (after.n_hits, ==, before.n_hits);
+  g_assert_cmpuint (after.resident_bytes, >, before.resident_bytes);
+
+  clutter_actor_destroy (actor);
+}
+
+static void
+actor_offscreen_pool_hit (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *actor;
+  ClutterEffect *effect;
+  PoolStats before, after;
+  gulong paint_id;
+
+  clutter_actor_set_background_color (stage, CLUTTER_COLOR_Black);
+  clutter_actor_show (stage);
+
+  actor = add_actor (stage, 100, 100);
+  effect = g_object_new (foo_effect_get_type (), NULL);
+  clutter_actor_add_effect (actor, effect);
+  wait_for_frame (stage);
+
+  /* removing the effect gives the target back to the pool */
+  clutter_actor_remove_effect (actor, effect);
+  clutter_actor_destroy (actor);
+
+  get_pool_stats (&before);
+
+  /* an actor of a slightly different size can use the same target */
+  actor = add_actor (stage, 110, 120);
+  clutter_actor_add_effect (actor, g_object_new (foo_effect_get_type (), NULL));
+
+  paint_id = g_signal_connect (stage, "after-paint",
+                               G_CALLBACK (on_check_pixels),
+                               actor);
+  wait_for_frame (stage);
+  g_signal_handler_disconnect (stage, paint_id);
+
+  get_pool_stats (&after);
+  g_assert_cmpuint (after.n_hits, ==, before.n_hits + 1);
+  g_assert_cmpuint (after.n_misses, ==, before.n_misses);
+  g_assert_cmpuint (after.resident_bytes, ==, before.resident_bytes);
+
+  clutter_actor_destroy (actor);
+}
+
+static void
+actor_offscreen_pool_exposed (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *actor;
+  ClutterEffect *effect;
+  PoolStats before, after;
+
+  clutter_actor_show (stage);
+
+  actor = add_actor (stage, 60, 60);
+  effect = g_object_new (foo_effect_get_type (), NULL);
+  clutter_actor_add_effect (actor, effect);
+  wait_for_frame (stage);
+
+  /* a texture that was handed out is never leased again */
+  g_assert (clutter_offscreen_effect_get_texture (CLUTTER_OFFSCREEN_EFFECT (effect)) != NULL);
+
+  clutter_actor_remove_effect (actor, effect);
+
+  get_pool_stats (&before);
+
+  clutter_actor_add_effect (actor, g_object_new (foo_effect_get_type (), NULL));
+  wait_for_frame (stage);
+
+  get_pool_stats (&after);
+  g_assert_cmpuint (after.n_hits, ==, before.n_hits);
+  g_assert_cmpuint (after.n_misses, ==, before.n_misses + 1);
+
+  clutter_actor_destroy (actor);
+}
+
+static void
+actor_offscreen_pool_eviction (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *actors[2];
+  PoolStats before, after;
+  int i;
+
+  clutter_actor_show (stage);
+
+  /* each target fits in the pool, but not both of them */
+  actors[0] = add_actor (stage, 400, 400);
+  actors[1] = add_actor (stage, 300, 400);
+
+  for (i = 0; i < G_N_ELEMENTS (actors); i++)
+    clutter_actor_add_effect (actors[i], g_object_new (foo_effect_get_type (), NULL));
+
+  wait_for_frame (stage);
+
+  get_pool_stats (&before);
+
+  for (i = 0; i < G_N_ELEMENTS (actors); i++)
+    clutter_actor_destroy (actors[i]);
+
+  get_pool_stats (&after);
+  g_assert_cmpuint (after.n_evictions, >, before.n_evictions);
+  g_assert_cmpuint (after.resident_bytes, <=, POOL_SIZE * 1024 * 1024);
+}
+
+int
+main (int argc, char *argv[])
+{
+  char *pool_size = g_strdup_printf ("%d", POOL_SIZE);
+
+  /* the size of the pool is read when initializing Clutter */
+  g_setenv ("CLUTTER_OFFSCREEN_POOL_SIZE", pool_size, TRUE);
+  g_free (pool_size);
+
+  clutter_test_init (&argc, &argv);
+
+  clutter_test_add ("/actor/offscreen-pool/miss", actor_offscreen_pool_miss);
+  clutter_test_add ("/actor/offscreen-pool/hit", actor_offscreen_pool_hit);
+  clutter_test_add ("/actor/offscreen-pool/exposed", actor_offscreen_pool_exposed);
+  clutter_test_add ("/actor/offscreen-pool/eviction", actor_offscreen_pool_eviction);
+
+  return clutter_test_run ();
+}
@@ -0,0 +1,173 @@
+#define CLUTTER_DISABLE_DEPRECATION_WARNINGS
+#include <clutter/clutter.h>
+
+/* the overlay covers the right half of the first child and the left
+ * half of the second one; the sibling painted after the container
+ * covers the right half of the second child
+ */
+#define CHILD_SIZE      50
+#define OVERLAY_X1      25
+#define OVERLAY_X2      75
+#define SIBLING_X       60
+
+typedef struct _FooOverlay      FooOverlay;
+typedef struct _FooOverlayClass FooOverlayClass;
+
+struct _FooOverlayClass
+{
+  ClutterActorClass parent_class;
+};
+
+struct _FooOverlay
+{
+  ClutterActor parent;
+};
+
+GType foo_overlay_get_type (void);
+
+G_DEFINE_TYPE (FooOverlay, foo_overlay, CLUTTER_TYPE_ACTOR)
+
+static void
+paint_overlay (void)
+{
+  cogl_set_source_color4ub (0, 0, 255, 255);
+  cogl_rectangle (OVERLAY_X1, 0, OVERLAY_X2, CHILD_SIZE);
+}
+
+static void
+foo_overlay_paint (ClutterActor *actor)
+{
+  /* the children are painted first, and the overlay on top of them */
+  CLUTTER_ACTOR_CLASS (foo_overlay_parent_class)->paint (actor);
+
+  paint_overlay ();
+}
+
+static void
+foo_overlay_class_init (FooOverlayClass *klass)
+{
+  ClutterActorClass *actor_class = CLUTTER_ACTOR_CLASS (klass);
+
+  actor_class->paint = foo_overlay_paint;
+}
+
+static void
+foo_overlay_init (FooOverlay *self)
+{
+}
+
+typedef struct {
+  ClutterActor *stage;
+
+  gboolean was_painted;
+} PaintData;
+
+static guint32
+get_pixel (int x,
+           int y)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return (((guint32) data[0] << 16) |
+          ((guint32) data[1] << 8) |
+          data[2]);
+}
+
+static void
+on_after_paint (ClutterActor *stage,
+                PaintData    *data)
+{
+  int y = CHILD_SIZE / 2;
+
+  /* first child */
+  g_assert_cmphex (get_pixel (10, y), ==, 0xff0000);
+  /* overlay */
+  g_assert_cmphex (get_pixel (40, y), ==, 0x0000ff);
+  g_assert_cmphex (get_pixel (55, y), ==, 0x0000ff);
+  /* sibling */
+  g_assert_cmphex (get_pixel (80, y), ==, 0x00ff00);
+
+  data->was_painted = TRUE;
+}
+
+static void
+check_paint_order (ClutterActor *container)
+{
+  PaintData data = { NULL, };
+  ClutterActor *child, *sibling;
+  int i;
+
+  data.stage = clutter_test_get_stage ();
+
+  clutter_actor_set_size (container, 2 * CHILD_SIZE, CHILD_SIZE);
+  clutter_actor_add_child (data.stage, container);
+
+  /* the rectangles of the children share the same pipeline, and are
+   * batched together
+   */
+  for (i = 0; i < 2; i++)
+    {
+      child = clutter_actor_new ();
+      clutter_actor_set_position (child, i * CHILD_SIZE, 0);
+      clutter_actor_set_size (child, CHILD_SIZE, CHILD_SIZE);
+      clutter_actor_set_background_color (child, CLUTTER_COLOR_Red);
+      clutter_actor_add_child (container, child);
+    }
+
+  sibling = clutter_actor_new ();
+  clutter_actor_set_position (sibling, SIBLING_X, 0);
+  clutter_actor_set_size (sibling, 2 * CHILD_SIZE - SIBLING_X, CHILD_SIZE);
+  clutter_actor_set_background_color (sibling, CLUTTER_COLOR_Green);
+  clutter_actor_add_child (data.stage, sibling);
+
+  g_signal_connect (data.stage, "after-paint",
+                    G_CALLBACK (on_after_paint),
+                    &data);
+
+  clutter_actor_show (data.stage);
+
+  while (!data.was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handlers_disconnect_by_func (data.stage, on_after_paint, &data);
+
+  clutter_actor_destroy (sibling);
+  clutter_actor_destroy (container);
+}
+
+static void
+actor_paint_batch_chain_up (void)
+{
+  check_paint_order (g_object_new (foo_overlay_get_type (), NULL));
+}
+
+static void
+on_container_paint (ClutterActor *container)
+{
+  paint_overlay ();
+}
+
+static void
+actor_paint_batch_paint_handler (void)
+{
+  ClutterActor *container = clutter_actor_new ();
+
+  /* the handler runs after the default implementation has painted
+   * the children
+   */
+  g_signal_connect_after (container, "paint",
+                          G_CALLBACK (on_container_paint),
+                          NULL);
+
+  check_paint_order (container);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/paint-batch/chain-up", actor_paint_batch_chain_up)
+  CLUTTER_TEST_UNIT ("/actor/paint-batch/paint-handler", actor_paint_batch_paint_handler)
+)
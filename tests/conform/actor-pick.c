@@ -1,4 +1,5 @@
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
+#define CLUTTER_ENABLE_EXPERIMENTAL_API
 #include <clutter/clutter.h>
 
 #define STAGE_WIDTH  640
@@ -117,6 +118,42 @@ on_timeout (gpointer data)
   clutter_stage_get_actor_at_pos (CLUTTER_STAGE (state->stage),
                                   CLUTTER_PICK_REACTIVE, 10, 10);
 
+  /* Picking all the positions at once must give the same results as
+     picking them one by one */
+  {
+    ClutterPoint positions[ACTORS_X * ACTORS_Y];
+    ClutterActor *actors[ACTORS_X * ACTORS_Y];
+    int i;
+
+    for (y = 0; y < ACTORS_Y; y++)
+      for (x = 0; x < ACTORS_X; x++)
+        {
+          i = y * ACTORS_X + x;
+          positions[i].x = x * state->actor_width + state->actor_width / 2;
+          positions[i].y = y * state->actor_height + state->actor_height / 2;
+        }
+
+    clutter_stage_get_actors_at_positions (CLUTTER_STAGE (state->stage),
+                                           CLUTTER_PICK_ALL,
+                                           positions,
+                                           ACTORS_X * ACTORS_Y,
+                                           actors);
+
+    for (i = 0; i < ACTORS_X * ACTORS_Y; i++)
+      {
+        if (actors[i] != state->actors[i])
+          {
+            if (g_test_verbose ())
+              g_print ("multiple pick % 3i: %p / %p: FAIL\n",
+                       i, state->actors[i], actors[i]);
+
+            state->failed_pass = 0;
+            state->failed_idx = i;
+            state->pass = FALSE;
+          }
+      }
+  }
+
   for (test_num = 0; test_num < G_N_ELEMENTS (test_passes); test_num++)
     {
       if (test_num == 0)
@@ -255,7 +292,7 @@ on_timeout (gpointer data)
 }
 
 static void
-actor_pick (void)
+run_actor_pick (gboolean geometric)
 {
   int y, x;
   State state;
@@ -264,6 +301,8 @@ actor_pick (void)
 
   state.stage = clutter_test_get_stage ();
 
+  clutter_stage_set_geometric_picking (CLUTTER_STAGE (state.stage), geometric);
+
   state.actor_width = STAGE_WIDTH / ACTORS_X;
   state.actor_height = STAGE_HEIGHT / ACTORS_Y;
 
@@ -306,6 +345,170 @@ actor_pick (void)
   g_assert (state.pass);
 }
 
+static void
+actor_pick (void)
+{
+  run_actor_pick (FALSE);
+}
+
+static void
+actor_pick_geometric (void)
+{
+  run_actor_pick (TRUE);
+}
+
+static void
+actor_pick_geometric_text (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *group, *text, *hit;
+  ClutterPoint point;
+
+  clutter_stage_set_geometric_picking (CLUTTER_STAGE (stage), TRUE);
+
+  /* the text is wider than its glyphs, and than its parent */
+  group = clutter_actor_new ();
+  clutter_actor_set_size (group, 100, 100);
+  clutter_actor_add_child (stage, group);
+
+  text = clutter_text_new_with_text ("Sans 12px", "x");
+  clutter_actor_set_reactive (text, TRUE);
+  clutter_actor_set_size (text, 300, 50);
+  clutter_actor_add_child (group, text);
+
+  /* over the glyphs */
+  clutter_point_init (&point, 5, 5);
+  clutter_test_check_actor_at_point (stage, &point, text, &hit);
+  g_assert (hit == text);
+
+  /* outside of the ink rectangle, and of the paint box of the parent */
+  clutter_point_init (&point, 250, 25);
+  clutter_test_check_actor_at_point (stage, &point, text, &hit);
+  g_assert (hit == text);
+
+  /* outside of the allocation */
+  clutter_point_init (&point, 350, 25);
+  clutter_test_check_actor_at_point (stage, &point, stage, &hit);
+  g_assert (hit == stage);
+
+  clutter_actor_destroy (group);
+}
+
+static void
+on_pick (ClutterActor       *actor,
+         const ClutterColor *color,
+         guint              *n_picks)
+{
+  *n_picks += 1;
+}
+
+static void
+on_after_paint (ClutterActor *stage,
+                gboolean     *was_painted)
+{
+  *was_painted = TRUE;
+}
+
+static void
+wait_for_frame (ClutterActor *stage)
+{
+  gboolean was_painted = FALSE;
+  gulong paint_id;
+
+  paint_id = g_signal_connect (stage, "after-paint",
+                               G_CALLBACK (on_after_paint),
+                               &was_painted);
+
+  clutter_actor_queue_redraw (stage);
+
+  while (!was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (stage, paint_id);
+}
+
+/* picks at (@x, @y) and returns whether the scene had to be painted */
+static gboolean
+pick_at (ClutterActor    *stage,
+         ClutterPickMode  mode,
+         int              x,
+         int              y,
+         ClutterActor    *expected,
+         guint           *n_picks)
+{
+  guint old_n_picks = *n_picks;
+  ClutterActor *hit;
+
+  hit = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage), mode, x, y);
+
+  if (g_test_verbose ())
+    g_print ("pick at %d, %d: %s (%s)\n",
+             x, y,
+             clutter_actor_get_name (hit),
+             *n_picks != old_n_picks ? "painted" : "cached");
+
+  g_assert (hit == expected);
+
+  return *n_picks != old_n_picks;
+}
+
+static void
+actor_pick_cache (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *actor;
+  guint n_picks = 0;
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_name (actor, "actor");
+  clutter_actor_set_reactive (actor, TRUE);
+  clutter_actor_set_size (actor, 100, 100);
+  clutter_actor_add_child (stage, actor);
+
+  g_signal_connect (actor, "pick", G_CALLBACK (on_pick), &n_picks);
+
+  clutter_actor_show (stage);
+  wait_for_frame (stage);
+
+  /* repeated picks at the same position reuse the first result */
+  g_assert (pick_at (stage, CLUTTER_PICK_REACTIVE, 50, 50, actor, &n_picks));
+  g_assert (!pick_at (stage, CLUTTER_PICK_REACTIVE, 50, 50, actor, &n_picks));
+
+  /* the position and the mode are part of the key */
+  g_assert (pick_at (stage, CLUTTER_PICK_REACTIVE, 150, 50, stage, &n_picks));
+  g_assert (pick_at (stage, CLUTTER_PICK_ALL, 50, 50, actor, &n_picks));
+  g_assert (!pick_at (stage, CLUTTER_PICK_REACTIVE, 50, 50, actor, &n_picks));
+  g_assert (!pick_at (stage, CLUTTER_PICK_REACTIVE, 150, 50, stage, &n_picks));
+
+  /* moving the actor invalidates the results */
+  clutter_actor_set_x (actor, 100);
+  wait_for_frame (stage);
+
+  g_assert (pick_at (stage, CLUTTER_PICK_REACTIVE, 150, 50, actor, &n_picks));
+  g_assert (pick_at (stage, CLUTTER_PICK_REACTIVE, 50, 50, stage, &n_picks));
+  g_assert (!pick_at (stage, CLUTTER_PICK_REACTIVE, 150, 50, actor, &n_picks));
+
+  /* and so does changing its reactivity */
+  clutter_actor_set_reactive (actor, FALSE);
+
+  g_assert (pick_at (stage, CLUTTER_PICK_REACTIVE, 150, 50, stage, &n_picks));
+  g_assert (!pick_at (stage, CLUTTER_PICK_REACTIVE, 150, 50, stage, &n_picks));
+  g_assert (pick_at (stage, CLUTTER_PICK_ALL, 150, 50, actor, &n_picks));
+
+  /* or hiding it; the hidden actor is not painted in pick mode, so we
+   * only check the result
+   */
+  clutter_actor_hide (actor);
+  wait_for_frame (stage);
+
+  pick_at (stage, CLUTTER_PICK_ALL, 150, 50, stage, &n_picks);
+
+  clutter_actor_destroy (actor);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/pick", actor_pick)
+  CLUTTER_TEST_UNIT ("/actor/pick-cache", actor_pick_cache)
+  CLUTTER_TEST_UNIT ("/actor/pick-geometric", actor_pick_geometric)
+  CLUTTER_TEST_UNIT ("/actor/pick-geometric-text", actor_pick_geometric_text)
 )
@@ -0,0 +1,149 @@
+#include <clutter/clutter.h>
+
+#define SOURCE_X        0
+#define CLONE_X         100
+#define ACTOR_SIZE      50
+
+typedef struct {
+  ClutterActor *stage;
+
+  gboolean was_painted;
+
+  guint32 source_pixel;
+  guint32 clone_pixel;
+} PaintData;
+
+static guint32
+get_pixel (int x,
+           int y)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return (((guint32) data[0] << 16) |
+          ((guint32) data[1] << 8) |
+          data[2]);
+}
+
+static void
+on_after_paint (ClutterActor *stage,
+                PaintData    *data)
+{
+  data->source_pixel = get_pixel (SOURCE_X + ACTOR_SIZE / 2, ACTOR_SIZE / 2);
+  data->clone_pixel = get_pixel (CLONE_X + ACTOR_SIZE / 2, ACTOR_SIZE / 2);
+  data->was_painted = TRUE;
+}
+
+static void
+paint_frame (PaintData *data)
+{
+  data->was_painted = FALSE;
+
+  clutter_actor_queue_redraw (data->stage);
+
+  while (!data->was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (g_test_verbose ())
+    g_print ("source: 0x%06x, clone: 0x%06x\n",
+             data->source_pixel,
+             data->clone_pixel);
+}
+
+/* the clone is painted at half opacity over a black stage */
+static void
+check_pixels (PaintData *data,
+              guint32    color)
+{
+  guint32 channel;
+  int shift;
+
+  g_assert_cmphex (data->source_pixel, ==, color);
+
+  for (shift = 0; shift < 24; shift += 8)
+    {
+      channel = (data->clone_pixel >> shift) & 0xff;
+
+      if (((color >> shift) & 0xff) == 0)
+        g_assert_cmpuint (channel, ==, 0);
+      else
+        g_assert_cmpuint (ABS ((int) channel - 0x80), <=, 1);
+    }
+}
+
+static void
+actor_retained_paint_clone (void)
+{
+  PaintData data = { NULL, };
+  ClutterActor *source, *child, *clone;
+
+  data.stage = clutter_test_get_stage ();
+  clutter_actor_set_background_color (data.stage, CLUTTER_COLOR_Black);
+
+  /* the child is a descendant of the source of the clone, and it is
+   * painted both by its parent and by the clone
+   */
+  source = clutter_actor_new ();
+  clutter_actor_set_position (source, SOURCE_X, 0);
+  clutter_actor_set_size (source, ACTOR_SIZE, ACTOR_SIZE);
+  clutter_actor_add_child (data.stage, source);
+
+  child = clutter_actor_new ();
+  clutter_actor_set_size (child, ACTOR_SIZE, ACTOR_SIZE);
+  clutter_actor_set_background_color (child, CLUTTER_COLOR_Red);
+  clutter_actor_add_child (source, child);
+
+  clone = clutter_clone_new (source);
+  clutter_actor_set_position (clone, CLONE_X, 0);
+  clutter_actor_set_opacity (clone, 0x80);
+  clutter_actor_add_child (data.stage, clone);
+
+  g_signal_connect (data.stage, "after-paint",
+                    G_CALLBACK (on_after_paint),
+                    &data);
+
+  clutter_stage_set_retain_paint_nodes (CLUTTER_STAGE (data.stage), TRUE);
+  clutter_actor_show (data.stage);
+
+  /* the nodes of the child are retained from the first frame, and
+   * they must not be replayed with the opacity of the clone
+   */
+  paint_frame (&data);
+  check_pixels (&data, 0xff0000);
+
+  paint_frame (&data);
+  check_pixels (&data, 0xff0000);
+
+  /* changing the child discards its nodes */
+  clutter_actor_set_background_color (child, CLUTTER_COLOR_Green);
+  paint_frame (&data);
+  check_pixels (&data, 0x00ff00);
+
+  clutter_stage_set_retain_paint_nodes (CLUTTER_STAGE (data.stage), FALSE);
+  paint_frame (&data);
+  check_pixels (&data, 0x00ff00);
+
+  clutter_actor_set_background_color (child, CLUTTER_COLOR_Blue);
+  paint_frame (&data);
+  check_pixels (&data, 0x0000ff);
+
+  clutter_stage_set_retain_paint_nodes (CLUTTER_STAGE (data.stage), TRUE);
+  paint_frame (&data);
+  check_pixels (&data, 0x0000ff);
+
+  paint_frame (&data);
+  check_pixels (&data, 0x0000ff);
+
+  g_signal_handlers_disconnect_by_func (data.stage, on_after_paint, &data);
+
+  clutter_actor_destroy (clone);
+  clutter_actor_destroy (source);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/retained-paint/clone", actor_retained_paint_clone)
+)
@@ -14,6 +14,8 @@ struct _TestActor
 
   guint preferred_width_called  : 1;
   guint preferred_height_called : 1;
+
+  guint n_height_requests;
 };
 
 GType test_actor_get_type (void);
@@ -51,6 +53,7 @@ test_actor_get_preferred_height (ClutterActor *self,
   TestActor *test = (TestActor *) self;
 
   test->preferred_height_called = TRUE;
+  test->n_height_requests += 1;
 
   if (for_width == 10)
     {
@@ -138,6 +141,58 @@ actor_preferred_size (void)
   clutter_actor_destroy (test);
 }
 
+static void
+actor_size_cache (void)
+{
+  ClutterActor *test;
+  TestActor *self;
+  gfloat min_height, nat_height;
+  guint i, pass;
+
+  test = g_object_new (TEST_TYPE_ACTOR, NULL);
+  self = (TestActor *) test;
+
+  /* a height-for-width layout asks for many different widths */
+  for (pass = 0; pass < 2; pass++)
+    {
+      for (i = 0; i < 12; i++)
+        clutter_actor_get_preferred_height (test, i * 10, &min_height, &nat_height);
+
+      g_assert_cmpuint (self->n_height_requests, ==, 12);
+    }
+
+  /* -0 and 0 are the same size */
+  clutter_actor_get_preferred_height (test, -0.f, &min_height, &nat_height);
+  g_assert_cmpuint (self->n_height_requests, ==, 12);
+
+  /* the requests of an actor with a margin are cached as well */
+  clutter_actor_set_margin_left (test, 5);
+  self->n_height_requests = 0;
+
+  for (pass = 0; pass < 2; pass++)
+    {
+      for (i = 0; i < 12; i++)
+        clutter_actor_get_preferred_height (test, i * 10, &min_height, &nat_height);
+
+      g_assert_cmpuint (self->n_height_requests, ==, 12);
+    }
+
+  clutter_actor_get_preferred_height (test, 10, &min_height, &nat_height);
+  g_assert_cmpuint (self->n_height_requests, ==, 12);
+  g_assert_cmpfloat (min_height, ==, 100);
+
+  /* queueing a relayout drops the whole cache */
+  clutter_actor_queue_relayout (test);
+  self->n_height_requests = 0;
+
+  for (i = 0; i < 12; i++)
+    clutter_actor_get_preferred_height (test, i * 10, &min_height, &nat_height);
+
+  g_assert_cmpuint (self->n_height_requests, ==, 12);
+
+  clutter_actor_destroy (test);
+}
+
 static void
 actor_fixed_size (void)
 {
@@ -213,4 +268,5 @@ actor_fixed_size (void)
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/size/preferred", actor_preferred_size)
   CLUTTER_TEST_UNIT ("/actor/size/fixed", actor_fixed_size)
+  CLUTTER_TEST_UNIT ("/actor/size/cache", actor_size_cache)
 )
@@ -0,0 +1,174 @@
+#include <clutter/clutter.h>
+
+#define CANVAS_WIDTH    100
+#define CANVAS_HEIGHT   50
+
+/* the number of paints to wait for a threaded draw, 10ms apart */
+#define MAX_PAINTS      100
+
+typedef struct {
+  ClutterColor color;
+  cairo_rectangle_int_t clip;
+  gint n_draws;
+  GThread *main_thread;
+} DrawState;
+
+static gboolean
+on_draw (ClutterCanvas *canvas,
+         cairo_t       *cr,
+         int            width,
+         int            height,
+         DrawState     *state)
+{
+  double x1, y1, x2, y2;
+
+  g_assert_cmpint (width, ==, CANVAS_WIDTH);
+  g_assert_cmpint (height, ==, CANVAS_HEIGHT);
+
+  cairo_clip_extents (cr, &x1, &y1, &x2, &y2);
+  state->clip.x = x1;
+  state->clip.y = y1;
+  state->clip.width = x2 - x1;
+  state->clip.height = y2 - y1;
+
+  clutter_cairo_set_source_color (cr, &state->color);
+  cairo_paint (cr);
+
+  state->n_draws += 1;
+
+  return TRUE;
+}
+
+static void
+canvas_invalidate_area (void)
+{
+  static const ClutterColor red = { 0xff, 0x00, 0x00, 0xff };
+  static const ClutterColor blue = { 0x00, 0x00, 0xff, 0xff };
+  ClutterActor *stage = clutter_test_get_stage ();
+  cairo_rectangle_int_t area = { 10, 10, 20, 20 };
+  DrawState state = { { 0, }, };
+  ClutterContent *canvas;
+  ClutterActor *actor;
+  ClutterPoint point;
+
+  canvas = clutter_canvas_new ();
+  g_signal_connect (canvas, "draw", G_CALLBACK (on_draw), &state);
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_size (actor, CANVAS_WIDTH, CANVAS_HEIGHT);
+  clutter_actor_set_content (actor, canvas);
+  clutter_actor_add_child (stage, actor);
+
+  /* the first draw covers the whole canvas */
+  state.color = red;
+  clutter_canvas_set_size (CLUTTER_CANVAS (canvas), CANVAS_WIDTH, CANVAS_HEIGHT);
+  g_assert_cmpint (state.n_draws, ==, 1);
+  g_assert_cmpint (state.clip.width, ==, CANVAS_WIDTH);
+  g_assert_cmpint (state.clip.height, ==, CANVAS_HEIGHT);
+
+  clutter_point_init (&point, 50, 25);
+  clutter_test_assert_color_at_point (stage, &point, &red);
+
+  /* only the invalidated area is drawn, and the rest is kept */
+  state.color = blue;
+  clutter_canvas_invalidate_area (CLUTTER_CANVAS (canvas), &area);
+  g_assert_cmpint (state.n_draws, ==, 2);
+  g_assert_cmpint (state.clip.x, ==, area.x);
+  g_assert_cmpint (state.clip.y, ==, area.y);
+  g_assert_cmpint (state.clip.width, ==, area.width);
+  g_assert_cmpint (state.clip.height, ==, area.height);
+
+  clutter_point_init (&point, 20, 20);
+  clutter_test_assert_color_at_point (stage, &point, &blue);
+  clutter_point_init (&point, 50, 25);
+  clutter_test_assert_color_at_point (stage, &point, &red);
+
+  /* the area is clamped to the canvas */
+  area.x = CANVAS_WIDTH - 10;
+  area.y = -10;
+  clutter_canvas_invalidate_area (CLUTTER_CANVAS (canvas), &area);
+  g_assert_cmpint (state.n_draws, ==, 3);
+  g_assert_cmpint (state.clip.x, ==, CANVAS_WIDTH - 10);
+  g_assert_cmpint (state.clip.y, ==, 0);
+  g_assert_cmpint (state.clip.width, ==, 10);
+  g_assert_cmpint (state.clip.height, ==, 10);
+
+  /* areas outside of the canvas are ignored */
+  area.x = CANVAS_WIDTH;
+  clutter_canvas_invalidate_area (CLUTTER_CANVAS (canvas), &area);
+  g_assert_cmpint (state.n_draws, ==, 3);
+
+  clutter_actor_destroy (actor);
+  g_object_unref (canvas);
+}
+
+static gboolean
+on_threaded_draw (ClutterCanvas *canvas,
+                  cairo_t       *cr,
+                  int            width,
+                  int            height,
+                  DrawState     *state)
+{
+  g_assert (g_thread_self () != state->main_thread);
+
+  clutter_cairo_set_source_color (cr, &state->color);
+  cairo_paint (cr);
+
+  g_atomic_int_inc (&state->n_draws);
+
+  return TRUE;
+}
+
+static void
+canvas_threaded_draw (void)
+{
+  static const ClutterColor green = { 0x00, 0xff, 0x00, 0xff };
+  ClutterActor *stage = clutter_test_get_stage ();
+  DrawState state = { { 0, }, };
+  ClutterContent *canvas;
+  ClutterActor *actor;
+  ClutterPoint point;
+  int i;
+
+  state.main_thread = g_thread_self ();
+  state.color = green;
+
+  canvas = clutter_canvas_new ();
+  clutter_canvas_set_threaded_draw (CLUTTER_CANVAS (canvas), TRUE);
+  g_assert (clutter_canvas_get_threaded_draw (CLUTTER_CANVAS (canvas)));
+  g_signal_connect (canvas, "draw", G_CALLBACK (on_threaded_draw), &state);
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_size (actor, CANVAS_WIDTH, CANVAS_HEIGHT);
+  clutter_actor_set_content (actor, canvas);
+  clutter_actor_add_child (stage, actor);
+
+  clutter_canvas_set_size (CLUTTER_CANVAS (canvas), CANVAS_WIDTH, CANVAS_HEIGHT);
+
+  /* the draw handler returns before the worker hands the surface back
+   * to the main thread, so we cannot stop at the first draw; each check
+   * is a paint round trip, whose pre-paint stage uploads the finished
+   * draws
+   */
+  clutter_point_init (&point, 50, 25);
+  for (i = 0; i < MAX_PAINTS; i++)
+    {
+      ClutterColor color;
+
+      if (clutter_test_check_color_at_point (stage, &point, &green, &color))
+        break;
+
+      g_usleep (10000);
+    }
+
+  g_assert_cmpint (i, <, MAX_PAINTS);
+  g_assert_cmpint (g_atomic_int_get (&state.n_draws), >, 0);
+
+  clutter_actor_destroy (actor);
+  g_object_unref (canvas);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/canvas/invalidate-area", canvas_invalidate_area)
+  CLUTTER_TEST_UNIT ("/canvas/threaded-draw", canvas_threaded_draw)
+)
@@ -0,0 +1,317 @@
+#define COGL_ENABLE_EXPERIMENTAL_API
+#define CLUTTER_ENABLE_EXPERIMENTAL_API
+#include <clutter/clutter.h>
+
+/* the budget is set in megabytes, and each image uses 200x213x4 bytes */
+#define CACHE_SIZE      1
+#define CACHE_BYTES     (CACHE_SIZE * 1024 * 1024)
+#define IMAGE_BYTES     (200 * 213 * 4)
+#define N_IMAGES        12
+
+/* the number of frames to wait for an evicted image to be loaded again */
+#define MAX_FRAMES      100
+
+typedef struct {
+  ClutterActor *actors[N_IMAGES];
+  ClutterContent *images[N_IMAGES];
+  int n_loaded;
+} CacheData;
+
+static void
+on_image_loaded (GObject      *image,
+                 GAsyncResult *result,
+                 gpointer      user_data)
+{
+  CacheData *data = user_data;
+  GError *error = NULL;
+
+  g_assert (clutter_image_load_finish (CLUTTER_IMAGE (image), result, &error));
+  g_assert_no_error (error);
+
+  data->n_loaded += 1;
+}
+
+static void
+on_after_paint (ClutterActor *stage,
+                gboolean     *was_painted)
+{
+  *was_painted = TRUE;
+}
+
+static void
+wait_for_frame (ClutterActor *stage)
+{
+  gboolean was_painted = FALSE;
+  gulong paint_id;
+
+  paint_id = g_signal_connect (stage, "after-paint",
+                               G_CALLBACK (on_after_paint),
+                               &was_painted);
+
+  clutter_actor_queue_redraw (stage);
+
+  while (!was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (stage, paint_id);
+}
+
+typedef struct {
+  guint n_resident;
+  gsize resident_bytes;
+  guint n_evictions;
+  guint n_reloads;
+} CacheStats;
+
+static void
+get_cache_stats (CacheStats *stats)
+{
+  clutter_image_get_cache_stats (&stats->n_resident,
+                                 &stats->resident_bytes,
+                                 &stats->n_evictions,
+                                 &stats->n_reloads);
+
+  if (g_test_verbose ())
+    g_print ("resident: %u images, %" G_GSIZE_FORMAT " bytes; "
+             "%u evictions, %u reloads\n",
+             stats->n_resident,
+             stats->resident_bytes,
+             stats->n_evictions,
+             stats->n_reloads);
+}
+
+static void
+load_images (CacheData    *data,
+             ClutterActor *stage,
+             GFile        *file)
+{
+  int i;
+
+  for (i = 0; i < N_IMAGES; i++)
+    {
+      data->images[i] = clutter_image_new ();
+
+      data->actors[i] = clutter_actor_new ();
+      clutter_actor_set_size (data->actors[i], 20, 20);
+      clutter_actor_set_content (data->actors[i], data->images[i]);
+      clutter_actor_add_child (stage, data->actors[i]);
+
+      clutter_image_load_async (CLUTTER_IMAGE (data->images[i]), file, -1, -1,
+                                NULL,
+                                on_image_loaded,
+                                data);
+    }
+}
+
+static void
+wait_for_images (CacheData    *data,
+                 ClutterActor *stage)
+{
+  clutter_actor_show (stage);
+
+  while (data->n_loaded < N_IMAGES)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+hide_actors (CacheData *data,
+             int        visible)
+{
+  int i;
+
+  for (i = 0; i < N_IMAGES; i++)
+    {
+      if (i != visible)
+        clutter_actor_hide (data->actors[i]);
+    }
+}
+
+static void
+free_images (CacheData *data)
+{
+  int i;
+
+  for (i = 0; i < N_IMAGES; i++)
+    {
+      clutter_actor_destroy (data->actors[i]);
+      g_object_unref (data->images[i]);
+    }
+}
+
+static void
+image_cache_evict (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  CacheData data = { { NULL, }, };
+  CacheStats before, after;
+  int evicted, i;
+  char *path;
+  GFile *file;
+
+  path = g_build_filename (TESTS_DATADIR, "redhand.png", NULL);
+  file = g_file_new_for_path (path);
+
+  get_cache_stats (&before);
+
+  /* the actors are hidden, so that the images are not painted */
+  load_images (&data, stage, file);
+  hide_actors (&data, -1);
+  wait_for_images (&data, stage);
+
+  /* the images uploaded by the last frame are not evicted by the next */
+  for (i = 0; i < 3; i++)
+    wait_for_frame (stage);
+
+  get_cache_stats (&after);
+  g_assert_cmpuint (after.resident_bytes, <=, CACHE_BYTES);
+  g_assert_cmpuint (after.resident_bytes, ==, after.n_resident * IMAGE_BYTES);
+  g_assert_cmpuint (after.n_resident, <, N_IMAGES);
+  g_assert_cmpuint (after.n_evictions - before.n_evictions, ==, N_IMAGES - after.n_resident);
+
+  /* the evicted images keep their size */
+  for (evicted = 0; evicted < N_IMAGES; evicted++)
+    {
+      if (clutter_image_get_texture (CLUTTER_IMAGE (data.images[evicted])) == NULL)
+        break;
+    }
+
+  g_assert_cmpint (evicted, <, N_IMAGES);
+  g_assert (clutter_content_get_preferred_size (data.images[evicted], NULL, NULL));
+
+  /* painting an evicted image loads it again */
+  before = after;
+  clutter_actor_show (data.actors[evicted]);
+
+  for (i = 0; i < MAX_FRAMES; i++)
+    {
+      if (clutter_image_get_texture (CLUTTER_IMAGE (data.images[evicted])) != NULL)
+        break;
+
+      wait_for_frame (stage);
+    }
+
+  g_assert_cmpint (i, <, MAX_FRAMES);
+
+  /* and the visible image is kept while the budget is enforced */
+  for (i = 0; i < 3; i++)
+    wait_for_frame (stage);
+
+  g_assert (clutter_image_get_texture (CLUTTER_IMAGE (data.images[evicted])) != NULL);
+
+  get_cache_stats (&after);
+  g_assert_cmpuint (after.n_reloads, ==, before.n_reloads + 1);
+  g_assert_cmpuint (after.resident_bytes, <=, CACHE_BYTES);
+
+  free_images (&data);
+
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+image_cache_retained (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  CacheData data = { { NULL, }, };
+  CacheStats before, after;
+  int i;
+  char *path;
+  GFile *file;
+
+  path = g_build_filename (TESTS_DATADIR, "redhand.png", NULL);
+  file = g_file_new_for_path (path);
+
+  clutter_stage_set_retain_paint_nodes (CLUTTER_STAGE (stage), TRUE);
+
+  get_cache_stats (&before);
+
+  /* only the first image is visible, and it is replayed from the
+   * retained paint nodes after the first frame
+   */
+  load_images (&data, stage, file);
+  hide_actors (&data, 0);
+  wait_for_images (&data, stage);
+
+  for (i = 0; i < 5; i++)
+    wait_for_frame (stage);
+
+  /* the visible image is never evicted */
+  g_assert (clutter_image_get_texture (CLUTTER_IMAGE (data.images[0])) != NULL);
+
+  get_cache_stats (&after);
+  g_assert_cmpuint (after.resident_bytes, <=, CACHE_BYTES);
+  g_assert_cmpuint (after.n_evictions, >, before.n_evictions);
+  g_assert_cmpuint (after.n_reloads, ==, before.n_reloads);
+
+  clutter_stage_set_retain_paint_nodes (CLUTTER_STAGE (stage), FALSE);
+
+  free_images (&data);
+
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+image_cache_mapped (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  CacheData data = { { NULL, }, };
+  CacheStats before, after;
+  int i;
+  char *path;
+  GFile *file;
+
+  path = g_build_filename (TESTS_DATADIR, "redhand.png", NULL);
+  file = g_file_new_for_path (path);
+
+  get_cache_stats (&before);
+
+  /* fully transparent actors are mapped, but they are not painted;
+   * their images go over the budget, but evicting them would only
+   * load them again
+   */
+  load_images (&data, stage, file);
+
+  for (i = 0; i < N_IMAGES; i++)
+    clutter_actor_set_opacity (data.actors[i], 0);
+
+  wait_for_images (&data, stage);
+
+  for (i = 0; i < 3; i++)
+    wait_for_frame (stage);
+
+  get_cache_stats (&after);
+  g_assert_cmpuint (after.n_evictions, ==, before.n_evictions);
+  g_assert_cmpuint (after.n_resident, ==, before.n_resident + N_IMAGES);
+  g_assert_cmpuint (after.resident_bytes, >, CACHE_BYTES);
+
+  /* unmapping the actors lets the budget be enforced again */
+  hide_actors (&data, -1);
+
+  for (i = 0; i < 3; i++)
+    wait_for_frame (stage);
+
+  get_cache_stats (&after);
+  g_assert_cmpuint (after.n_evictions, >, before.n_evictions);
+  g_assert_cmpuint (after.resident_bytes, <=, CACHE_BYTES);
+
+  free_images (&data);
+
+  g_object_unref (file);
+  g_free (path);
+}
+
+int
+main (int argc, char *argv[])
+{
+  /* the budget is read when initializing Clutter */
+  g_setenv ("CLUTTER_IMAGE_CACHE_SIZE", G_STRINGIFY (CACHE_SIZE), TRUE);
+
+  clutter_test_init (&argc, &argv);
+
+  clutter_test_add ("/image/cache/evict", image_cache_evict);
+  clutter_test_add ("/image/cache/retained", image_cache_retained);
+  clutter_test_add ("/image/cache/mapped", image_cache_mapped);
+
+  return clutter_test_run ();
+}
@@ -0,0 +1,164 @@
+#include <clutter/clutter.h>
+
+#define IMAGE_WIDTH     200
+#define IMAGE_HEIGHT    213
+
+typedef struct {
+  gboolean done;
+  gboolean result;
+  GError *error;
+} LoadData;
+
+static void
+on_image_loaded (GObject      *image,
+                 GAsyncResult *result,
+                 gpointer      user_data)
+{
+  LoadData *data = user_data;
+
+  g_assert (!data->done);
+
+  data->result = clutter_image_load_finish (CLUTTER_IMAGE (image),
+                                            result,
+                                            &data->error);
+  data->done = TRUE;
+}
+
+static void
+load_image (ClutterContent *image,
+            const char     *filename,
+            GCancellable   *cancellable,
+            LoadData       *data)
+{
+  char *path = g_build_filename (TESTS_DATADIR, filename, NULL);
+  GFile *file = g_file_new_for_path (path);
+
+  clutter_image_load_async (CLUTTER_IMAGE (image), file, -1, -1,
+                            cancellable,
+                            on_image_loaded,
+                            data);
+
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+wait_for_loads (LoadData *loads,
+                int       n_loads)
+{
+  int i;
+
+  /* the decoded images are uploaded by the master clock */
+  clutter_actor_show (clutter_test_get_stage ());
+
+  for (i = 0; i < n_loads; i++)
+    {
+      while (!loads[i].done)
+        g_main_context_iteration (NULL, TRUE);
+    }
+}
+
+static void
+image_load_async (void)
+{
+  ClutterContent *image = clutter_image_new ();
+  LoadData data = { FALSE, };
+  gfloat width, height;
+
+  g_assert (!clutter_content_get_preferred_size (image, &width, &height));
+
+  load_image (image, "redhand.png", NULL, &data);
+  wait_for_loads (&data, 1);
+
+  g_assert_no_error (data.error);
+  g_assert (data.result);
+
+  g_assert (clutter_content_get_preferred_size (image, &width, &height));
+  g_assert_cmpfloat (width, ==, IMAGE_WIDTH);
+  g_assert_cmpfloat (height, ==, IMAGE_HEIGHT);
+
+  g_object_unref (image);
+}
+
+static void
+image_load_async_cancel (void)
+{
+  ClutterContent *image = clutter_image_new ();
+  GCancellable *cancellable = g_cancellable_new ();
+  LoadData data = { FALSE, };
+  gfloat width, height;
+
+  load_image (image, "redhand.png", cancellable, &data);
+  g_cancellable_cancel (cancellable);
+  wait_for_loads (&data, 1);
+
+  g_assert_error (data.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  g_assert (!data.result);
+  g_clear_error (&data.error);
+
+  /* a cancelled load does not replace the image data */
+  g_assert (!clutter_content_get_preferred_size (image, &width, &height));
+
+  g_object_unref (cancellable);
+  g_object_unref (image);
+}
+
+static void
+image_load_async_supersede (void)
+{
+  ClutterContent *image = clutter_image_new ();
+  LoadData data[2] = { { FALSE, }, { FALSE, } };
+  gfloat width, height;
+
+  /* the second load starts before the first one is complete */
+  load_image (image, "redhand.png", NULL, &data[0]);
+  load_image (image, "redhand.png", NULL, &data[1]);
+  wait_for_loads (data, 2);
+
+  g_assert_error (data[0].error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  g_assert (!data[0].result);
+  g_clear_error (&data[0].error);
+
+  g_assert_no_error (data[1].error);
+  g_assert (data[1].result);
+
+  g_assert (clutter_content_get_preferred_size (image, &width, &height));
+  g_assert_cmpfloat (width, ==, IMAGE_WIDTH);
+  g_assert_cmpfloat (height, ==, IMAGE_HEIGHT);
+
+  g_object_unref (image);
+}
+
+static void
+image_load_async_error (void)
+{
+  ClutterContent *image = clutter_image_new ();
+  LoadData data = { FALSE, };
+  gfloat width, height;
+
+  load_image (image, "does-not-exist.png", NULL, &data);
+  wait_for_loads (&data, 1);
+
+  g_assert (data.error != NULL);
+  g_assert (!data.result);
+  g_clear_error (&data.error);
+
+  g_assert (!clutter_content_get_preferred_size (image, &width, &height));
+
+  /* the image can still be loaded after a failure */
+  data.done = FALSE;
+  load_image (image, "redhand.png", NULL, &data);
+  wait_for_loads (&data, 1);
+
+  g_assert_no_error (data.error);
+  g_assert (data.result);
+
+  g_object_unref (image);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/image/load-async", image_load_async)
+  CLUTTER_TEST_UNIT ("/image/load-async/cancel", image_load_async_cancel)
+  CLUTTER_TEST_UNIT ("/image/load-async/supersede", image_load_async_supersede)
+  CLUTTER_TEST_UNIT ("/image/load-async/error", image_load_async_error)
+)
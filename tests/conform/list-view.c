@@ -0,0 +1,179 @@
+#include <clutter/clutter.h>
+
+#define N_ITEMS         10000
+#define ITEM_SIZE       10.f
+#define VIEW_SIZE       100.f
+
+static ClutterActor *
+create_item (ClutterListView *view,
+             gpointer         data)
+{
+  ClutterActor *actor = clutter_actor_new ();
+  guint *n_created = data;
+
+  clutter_actor_set_size (actor, VIEW_SIZE, ITEM_SIZE);
+  clutter_actor_set_reactive (actor, TRUE);
+
+  *n_created += 1;
+
+  return actor;
+}
+
+static void
+bind_item (ClutterListView *view,
+           ClutterActor    *actor,
+           gpointer         item,
+           guint            position,
+           gpointer         data)
+{
+  char *name = g_strdup_printf ("item-%u", position);
+
+  g_assert (G_IS_OBJECT (item));
+
+  clutter_actor_set_name (actor, name);
+  g_free (name);
+}
+
+static GListStore *
+create_store (void)
+{
+  GListStore *store = g_list_store_new (G_TYPE_OBJECT);
+  guint i;
+
+  for (i = 0; i < N_ITEMS; i++)
+    {
+      GObject *item = g_object_new (G_TYPE_OBJECT, NULL);
+
+      g_list_store_append (store, item);
+      g_object_unref (item);
+    }
+
+  return store;
+}
+
+static void
+list_view_recycle (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *view, *actor;
+  GListStore *store;
+  ClutterPoint point;
+  guint n_created = 0;
+  guint max_children, n_children;
+
+  store = create_store ();
+
+  view = clutter_list_view_new ();
+  clutter_actor_set_size (view, VIEW_SIZE, VIEW_SIZE);
+  clutter_actor_add_child (stage, view);
+
+  clutter_list_view_set_model (CLUTTER_LIST_VIEW (view),
+                               G_LIST_MODEL (store),
+                               create_item,
+                               bind_item,
+                               &n_created,
+                               NULL);
+
+  /* the visible items, one partially visible, and the overscan */
+  max_children = VIEW_SIZE / ITEM_SIZE + 1
+               + 2 * clutter_list_view_get_overscan (CLUTTER_LIST_VIEW (view));
+
+  clutter_point_init (&point, VIEW_SIZE / 2, ITEM_SIZE / 2);
+  clutter_test_check_actor_at_point (stage, &point, NULL, &actor);
+  g_assert (actor != NULL);
+  g_assert_cmpstr (clutter_actor_get_name (actor), ==, "item-0");
+
+  g_assert_cmpfloat (clutter_list_view_get_estimated_extent (CLUTTER_LIST_VIEW (view)),
+                     ==,
+                     N_ITEMS * ITEM_SIZE);
+
+  /* scroll by a few items, and then far away */
+  clutter_list_view_set_scroll_offset (CLUTTER_LIST_VIEW (view), 3 * ITEM_SIZE);
+  clutter_test_check_actor_at_point (stage, &point, NULL, &actor);
+  g_assert_cmpstr (clutter_actor_get_name (actor), ==, "item-3");
+
+  clutter_list_view_scroll_to_item (CLUTTER_LIST_VIEW (view), 5000);
+  clutter_test_check_actor_at_point (stage, &point, NULL, &actor);
+  g_assert_cmpstr (clutter_actor_get_name (actor), ==, "item-5000");
+  g_assert (clutter_list_view_get_item_actor (CLUTTER_LIST_VIEW (view), 5000) == actor);
+  g_assert (clutter_list_view_get_item_actor (CLUTTER_LIST_VIEW (view), 0) == NULL);
+
+  /* the actors are recycled instead of being created for each item */
+  g_assert_cmpuint (n_created, <=, max_children);
+  g_assert_cmpint (clutter_actor_get_n_children (view), <=, max_children);
+
+  /* removing the visible items binds the actors again on the next
+   * frame, and the stale actors are not handed out in the meantime
+   */
+  n_children = clutter_actor_get_n_children (view);
+  g_list_store_remove (store, 5000);
+  g_assert (clutter_list_view_get_item_actor (CLUTTER_LIST_VIEW (view), 5000) == NULL);
+  g_assert_cmpint (clutter_actor_get_n_children (view), ==, n_children);
+
+  clutter_test_check_actor_at_point (stage, &point, NULL, &actor);
+  g_assert_cmpstr (clutter_actor_get_name (actor), ==, "item-5000");
+  g_assert_cmpuint (n_created, <=, max_children);
+
+  clutter_actor_destroy (view);
+  g_object_unref (store);
+}
+
+static void
+on_allocation_changed (ClutterActor           *view,
+                       const ClutterActorBox  *box,
+                       ClutterAllocationFlags  flags,
+                       GListStore             *store)
+{
+  /* the children of the view must not be destroyed while it is
+   * being allocated
+   */
+  g_list_store_splice (store, 0, N_ITEMS / 2, NULL, 0);
+
+  g_signal_handlers_disconnect_by_func (view, on_allocation_changed, store);
+}
+
+static void
+list_view_change_in_allocation (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *view, *actor;
+  GListStore *store;
+  ClutterPoint point;
+  guint n_created = 0;
+
+  store = create_store ();
+
+  view = clutter_list_view_new ();
+  clutter_actor_set_size (view, VIEW_SIZE, VIEW_SIZE);
+  clutter_actor_add_child (stage, view);
+
+  clutter_list_view_set_model (CLUTTER_LIST_VIEW (view),
+                               G_LIST_MODEL (store),
+                               create_item,
+                               bind_item,
+                               &n_created,
+                               NULL);
+
+  clutter_point_init (&point, VIEW_SIZE / 2, ITEM_SIZE / 2);
+  clutter_test_check_actor_at_point (stage, &point, NULL, &actor);
+  g_assert_cmpstr (clutter_actor_get_name (actor), ==, "item-0");
+
+  /* a new allocation changes the model from within the view */
+  g_signal_connect (view, "allocation-changed",
+                    G_CALLBACK (on_allocation_changed),
+                    store);
+  clutter_actor_set_size (view, VIEW_SIZE, VIEW_SIZE * 2);
+
+  clutter_test_check_actor_at_point (stage, &point, NULL, &actor);
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (store)), ==, N_ITEMS / 2);
+  g_assert (clutter_actor_get_parent (actor) == view);
+  g_assert_cmpstr (clutter_actor_get_name (actor), ==, "item-0");
+
+  clutter_actor_destroy (view);
+  g_object_unref (store);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/list-view/recycle", list_view_recycle)
+  CLUTTER_TEST_UNIT ("/list-view/change-in-allocation", list_view_change_in_allocation)
+)
@@ -545,6 +545,86 @@ path_test_get_position (CallbackData *data)
   return TRUE;
 }
 
+static gboolean
+path_test_get_point (CallbackData *data)
+{
+  static const double progress[] = { 0.125, 0.375, 0.625, 0.875 };
+  static const float values[] = { 16.0f, 16.0f,
+                                  48.0f, 48.0f,
+                                  80.0f, 48.0f,
+                                  112.0f, 16.0f };
+  ClutterPoint points[G_N_ELEMENTS (progress)];
+  gint i;
+
+  set_triangle_path (data);
+
+  clutter_path_get_points (data->path,
+                           progress,
+                           points,
+                           G_N_ELEMENTS (progress));
+
+  for (i = 0; i < G_N_ELEMENTS (progress); i++)
+    {
+      ClutterPoint point;
+
+      clutter_path_get_point (data->path, progress[i], &point);
+
+      if (!float_fuzzy_equals (values[i * 2], point.x)
+          || !float_fuzzy_equals (values[i * 2 + 1], point.y)
+          || !clutter_point_equals (&point, &points[i]))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+path_test_get_point_curve (CallbackData *data)
+{
+  static const double progress[] = { 0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0 };
+  ClutterPoint points[G_N_ELEMENTS (progress)];
+  gint i;
+
+  /* A curve symmetric around x = 100, peaking at (100, 75), followed
+     by a line */
+  clutter_path_set_description (data->path,
+                                "M 0 0 C 0 100 200 100 200 0 L 200 100");
+
+  clutter_path_get_points (data->path,
+                           progress,
+                           points,
+                           G_N_ELEMENTS (progress));
+
+  for (i = 0; i < G_N_ELEMENTS (progress); i++)
+    {
+      ClutterPoint point;
+      ClutterKnot knot;
+
+      clutter_path_get_point (data->path, progress[i], &point);
+      clutter_path_get_position (data->path, progress[i], &knot);
+
+      if (g_test_verbose ())
+        g_print ("progress %g: point (%g, %g), position (%d, %d)\n",
+                 progress[i], point.x, point.y, knot.x, knot.y);
+
+      /* The integer positions are only an approximation of the
+         constant speed along the curve */
+      if (!clutter_point_equals (&point, &points[i])
+          || fabsf (point.x - knot.x) > 4.f
+          || fabsf (point.y - knot.y) > 4.f)
+        return FALSE;
+    }
+
+  /* The ends of the path and of the curve are exact */
+  if (!float_fuzzy_equals (points[0].x, 0.f)
+      || !float_fuzzy_equals (points[0].y, 0.f)
+      || !float_fuzzy_equals (points[G_N_ELEMENTS (progress) - 1].x, 200.f)
+      || !float_fuzzy_equals (points[G_N_ELEMENTS (progress) - 1].y, 100.f))
+    return FALSE;
+
+  return TRUE;
+}
+
 static gboolean
 path_test_get_length (CallbackData *data)
 {
@@ -655,6 +735,8 @@ path_tests[] =
     { "Convert to cairo path and back", path_test_convert_to_cairo_path },
     { "Clear", path_test_clear },
     { "Get position", path_test_get_position },
+    { "Get point", path_test_get_point },
+    { "Get point on a curve", path_test_get_point_curve },
     { "Check node boxed type", path_test_boxed_type },
     { "Get length", path_test_get_length }
   };
@@ -0,0 +1,462 @@
+#include <math.h>
+#include <clutter/clutter.h>
+
+/* a ClutterInterval sub-class forces the GValue based interpolation */
+typedef struct _ClutterInterval         SlowInterval;
+typedef struct _ClutterIntervalClass    SlowIntervalClass;
+
+GType slow_interval_get_type (void);
+
+G_DEFINE_TYPE (SlowInterval, slow_interval, CLUTTER_TYPE_INTERVAL)
+
+static void
+slow_interval_class_init (SlowIntervalClass *klass)
+{
+}
+
+static void
+slow_interval_init (SlowInterval *self)
+{
+}
+
+static ClutterInterval *
+create_interval (gboolean fast,
+                 GType    value_type)
+{
+  if (fast)
+    return clutter_interval_new_with_values (value_type, NULL, NULL);
+
+  return g_object_new (slow_interval_get_type (),
+                       "value-type", value_type,
+                       NULL);
+}
+
+static void
+advance_transition (ClutterTransition *transition,
+                    guint              msecs)
+{
+  clutter_timeline_advance (CLUTTER_TIMELINE (transition), msecs);
+  g_signal_emit_by_name (transition, "new-frame", msecs);
+}
+
+static void
+run_transition (ClutterActor    *actor,
+                const char      *property_name,
+                ClutterInterval *interval,
+                guint            msecs)
+{
+  ClutterTransition *transition;
+
+  transition = clutter_property_transition_new (property_name);
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), 1000);
+  clutter_transition_set_interval (transition, interval);
+  clutter_transition_set_animatable (transition, CLUTTER_ANIMATABLE (actor));
+
+  advance_transition (transition, msecs);
+
+  g_object_unref (transition);
+}
+
+static void
+property_transition_fast_path (void)
+{
+  static const ClutterColor red = { 255, 0, 0, 255 };
+  static const ClutterColor blue = { 0, 0, 255, 128 };
+  ClutterPoint start = CLUTTER_POINT_INIT (10.f, 20.f);
+  ClutterPoint end = CLUTTER_POINT_INIT (110.f, 70.f);
+  ClutterActor *actors[2];
+  ClutterColor colors[2];
+  ClutterPoint positions[2];
+  gfloat x[2];
+  guint8 opacity[2];
+  int i;
+
+  for (i = 0; i < 2; i++)
+    {
+      ClutterInterval *interval;
+      gboolean fast = i == 0;
+
+      actors[i] = clutter_actor_new ();
+      g_object_ref_sink (actors[i]);
+
+      interval = create_interval (fast, G_TYPE_FLOAT);
+      clutter_interval_set_initial (interval, 0.f);
+      clutter_interval_set_final (interval, 333.f);
+      run_transition (actors[i], "x", interval, 333);
+      g_object_unref (interval);
+
+      x[i] = clutter_actor_get_x (actors[i]);
+
+      interval = create_interval (fast, G_TYPE_UINT);
+      clutter_interval_set_initial (interval, 255);
+      clutter_interval_set_final (interval, 0);
+      run_transition (actors[i], "opacity", interval, 333);
+      g_object_unref (interval);
+
+      opacity[i] = clutter_actor_get_opacity (actors[i]);
+
+      interval = create_interval (fast, CLUTTER_TYPE_COLOR);
+      clutter_interval_set_initial (interval, &red);
+      clutter_interval_set_final (interval, &blue);
+      run_transition (actors[i], "background-color", interval, 333);
+      g_object_unref (interval);
+
+      clutter_actor_get_background_color (actors[i], &colors[i]);
+
+      interval = create_interval (fast, CLUTTER_TYPE_POINT);
+      clutter_interval_set_initial (interval, &start);
+      clutter_interval_set_final (interval, &end);
+      run_transition (actors[i], "position", interval, 333);
+      g_object_unref (interval);
+
+      clutter_actor_get_position (actors[i],
+                                  &positions[i].x,
+                                  &positions[i].y);
+
+      if (g_test_verbose ())
+        g_print ("%s path: x:%.3f, position:(%.3f, %.3f), opacity:%u, "
+                 "color:%02x%02x%02x%02x\n",
+                 fast ? "fast" : "GValue",
+                 x[i],
+                 positions[i].x, positions[i].y,
+                 opacity[i],
+                 colors[i].red,
+                 colors[i].green,
+                 colors[i].blue,
+                 colors[i].alpha);
+    }
+
+  g_assert_cmpfloat (x[0], ==, x[1]);
+  g_assert (clutter_point_equals (&positions[0], &positions[1]));
+  g_assert_cmpuint (opacity[0], ==, opacity[1]);
+  g_assert (clutter_color_equal (&colors[0], &colors[1]));
+
+  /* sanity check the values themselves */
+  g_assert_cmpuint (opacity[0], ==, 170);
+  g_assert_cmpfloat (fabsf (x[0] - 110.889f), <, 0.01f);
+  g_assert_cmpfloat (fabsf (positions[0].x - 43.3f), <, 0.01f);
+  g_assert_cmpfloat (fabsf (positions[0].y - 36.65f), <, 0.01f);
+
+  for (i = 0; i < 2; i++)
+    g_object_unref (actors[i]);
+}
+
+static void
+property_transition_new_interval (void)
+{
+  ClutterTransition *transition;
+  ClutterInterval *interval;
+  ClutterActor *actor;
+
+  actor = clutter_actor_new ();
+  g_object_ref_sink (actor);
+
+  transition = clutter_property_transition_new ("x");
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), 1000);
+  clutter_transition_set_animatable (transition, CLUTTER_ANIMATABLE (actor));
+
+  interval = create_interval (TRUE, G_TYPE_FLOAT);
+  clutter_interval_set_initial (interval, 0.f);
+  clutter_interval_set_final (interval, 100.f);
+  clutter_transition_set_interval (transition, interval);
+  g_object_unref (interval);
+
+  advance_transition (transition, 500);
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 50.f);
+
+  /* the new interval replaces the old one, which is released; a new
+   * interval must not use the fast path decided for the old one, even
+   * if it ends up at the same address
+   */
+  interval = create_interval (FALSE, G_TYPE_DOUBLE);
+  clutter_interval_set_initial (interval, 100.0);
+  clutter_interval_set_final (interval, 300.0);
+  clutter_transition_set_interval (transition, interval);
+  g_object_unref (interval);
+
+  advance_transition (transition, 500);
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 200.f);
+
+  /* and a plain interval of the same type goes back to the fast path */
+  interval = create_interval (TRUE, G_TYPE_FLOAT);
+  clutter_interval_set_initial (interval, 300.f);
+  clutter_interval_set_final (interval, 400.f);
+  clutter_transition_set_interval (transition, interval);
+  g_object_unref (interval);
+
+  advance_transition (transition, 250);
+  g_assert_cmpfloat (clutter_actor_get_x (actor), ==, 325.f);
+
+  g_object_unref (transition);
+  g_object_unref (actor);
+}
+
+typedef struct {
+  ClutterActor *actors[4];
+  guint n_frames;
+  guint n_progress;
+  gboolean marker_reached;
+} BatchData;
+
+enum {
+  BATCH_PLAIN,
+  BATCH_MARKER,
+  BATCH_PROGRESS,
+  BATCH_NEW_FRAME,
+};
+
+static gdouble
+batch_progress_func (ClutterTimeline *timeline,
+                     gdouble          elapsed,
+                     gdouble          duration,
+                     gpointer         user_data)
+{
+  BatchData *data = user_data;
+
+  data->n_progress += 1;
+
+  return elapsed / duration;
+}
+
+static void
+batch_marker_reached (ClutterTimeline *timeline,
+                      const char      *marker_name,
+                      gint             msecs,
+                      BatchData       *data)
+{
+  data->marker_reached = TRUE;
+}
+
+static void
+batch_new_frame (ClutterTimeline *timeline,
+                 gint             msecs,
+                 BatchData       *data)
+{
+  gfloat x = clutter_actor_get_x (data->actors[BATCH_NEW_FRAME]);
+  int i;
+
+  data->n_frames += 1;
+
+  if (g_test_verbose ())
+    g_print ("frame %u: x:%.3f\n", data->n_frames, x);
+
+  /* the transitions advanced before this one must already have been
+   * applied, whether they were batched or not
+   */
+  for (i = 0; i < BATCH_NEW_FRAME; i++)
+    g_assert_cmpfloat (clutter_actor_get_x (data->actors[i]), ==, x);
+}
+
+static void
+property_transition_batch (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterTransition *transitions[4];
+  BatchData data = { { NULL, }, 0, 0, FALSE };
+  GMainLoop *main_loop;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      data.actors[i] = clutter_actor_new ();
+      clutter_actor_set_size (data.actors[i], 10, 10);
+      clutter_actor_add_child (stage, data.actors[i]);
+
+      transitions[i] = clutter_property_transition_new ("x");
+      clutter_timeline_set_duration (CLUTTER_TIMELINE (transitions[i]), 500);
+      clutter_transition_set_from (transitions[i], G_TYPE_FLOAT, 0.f);
+      clutter_transition_set_to (transitions[i], G_TYPE_FLOAT, 500.f);
+    }
+
+  /* each of these prevents batching the transition */
+  clutter_timeline_add_marker_at_time (CLUTTER_TIMELINE (transitions[BATCH_MARKER]),
+                                       "half", 250);
+  g_signal_connect (transitions[BATCH_MARKER], "marker-reached",
+                    G_CALLBACK (batch_marker_reached),
+                    &data);
+
+  clutter_timeline_set_progress_func (CLUTTER_TIMELINE (transitions[BATCH_PROGRESS]),
+                                      batch_progress_func,
+                                      &data, NULL);
+
+  g_signal_connect_after (transitions[BATCH_NEW_FRAME], "new-frame",
+                          G_CALLBACK (batch_new_frame),
+                          &data);
+
+  main_loop = g_main_loop_new (NULL, FALSE);
+  g_signal_connect_swapped (transitions[BATCH_NEW_FRAME], "completed",
+                            G_CALLBACK (g_main_loop_quit),
+                            main_loop);
+
+  /* the transitions are advanced in the order they were added */
+  for (i = 0; i < 4; i++)
+    {
+      clutter_actor_add_transition (data.actors[i], "batch-x", transitions[i]);
+      g_object_unref (transitions[i]);
+    }
+
+  clutter_actor_show (stage);
+
+  g_main_loop_run (main_loop);
+  g_main_loop_unref (main_loop);
+
+  g_assert_cmpuint (data.n_frames, >, 0);
+  g_assert_cmpuint (data.n_progress, >, 0);
+  g_assert (data.marker_reached);
+
+  for (i = 0; i < 4; i++)
+    g_assert_cmpfloat (clutter_actor_get_x (data.actors[i]), ==, 500.f);
+}
+
+typedef struct {
+  guint n_frames;
+  guint n_notifies;
+  guint n_frame_notifies;
+} NotifyData;
+
+static void
+notify_new_frame (ClutterTimeline *timeline,
+                  gint             msecs,
+                  NotifyData      *data)
+{
+  data->n_frames += 1;
+  data->n_frame_notifies = 0;
+}
+
+static void
+notify_x (ClutterActor *actor,
+          GParamSpec   *pspec,
+          NotifyData   *data)
+{
+  data->n_notifies += 1;
+  data->n_frame_notifies += 1;
+
+  /* both transitions change the x coordinate, but the notifications
+   * are deferred until all the timelines have been advanced
+   */
+  g_assert_cmpuint (data->n_frame_notifies, <=, 1);
+}
+
+static void
+property_transition_notify (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterTransition *transition;
+  ClutterPoint start = CLUTTER_POINT_INIT (0.f, 0.f);
+  ClutterPoint end = CLUTTER_POINT_INIT (100.f, 100.f);
+  NotifyData data = { 0, };
+  GMainLoop *main_loop;
+  ClutterActor *actor;
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_size (actor, 10, 10);
+  clutter_actor_add_child (stage, actor);
+
+  g_signal_connect (actor, "notify::x",
+                    G_CALLBACK (notify_x),
+                    &data);
+
+  transition = clutter_property_transition_new ("position");
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), 500);
+  clutter_transition_set_from (transition, CLUTTER_TYPE_POINT, &start);
+  clutter_transition_set_to (transition, CLUTTER_TYPE_POINT, &end);
+  clutter_actor_add_transition (actor, "notify-position", transition);
+  g_object_unref (transition);
+
+  transition = clutter_property_transition_new ("x");
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), 500);
+  clutter_transition_set_from (transition, G_TYPE_FLOAT, 0.f);
+  clutter_transition_set_to (transition, G_TYPE_FLOAT, 200.f);
+
+  g_signal_connect (transition, "new-frame",
+                    G_CALLBACK (notify_new_frame),
+                    &data);
+
+  main_loop = g_main_loop_new (NULL, FALSE);
+  g_signal_connect_swapped (transition, "completed",
+                            G_CALLBACK (g_main_loop_quit),
+                            main_loop);
+
+  clutter_actor_add_transition (actor, "notify-x", transition);
+  g_object_unref (transition);
+
+  clutter_actor_show (stage);
+
+  g_main_loop_run (main_loop);
+  g_main_loop_unref (main_loop);
+
+  if (g_test_verbose ())
+    g_print ("%u notifications in %u frames\n", data.n_notifies, data.n_frames);
+
+  g_assert_cmpuint (data.n_frames, >, 0);
+  g_assert_cmpuint (data.n_notifies, >, 0);
+  g_assert_cmpuint (data.n_notifies, <=, data.n_frames);
+
+  clutter_actor_destroy (actor);
+}
+
+static gboolean use_custom_progress = FALSE;
+
+static gboolean
+custom_color_progress (const GValue *a,
+                       const GValue *b,
+                       gdouble       progress,
+                       GValue       *retval)
+{
+  ClutterColor res;
+
+  /* jump straight to the final value */
+  if (use_custom_progress)
+    progress = 1.0;
+
+  clutter_color_interpolate (clutter_value_get_color (a),
+                             clutter_value_get_color (b),
+                             progress,
+                             &res);
+  clutter_value_set_color (retval, &res);
+
+  return TRUE;
+}
+
+static void
+property_transition_custom_progress (void)
+{
+  static const ClutterColor red = { 255, 0, 0, 255 };
+  static const ClutterColor blue = { 0, 0, 255, 255 };
+  ClutterInterval *interval;
+  ClutterActor *actor;
+  ClutterColor color;
+
+  actor = clutter_actor_new ();
+  g_object_ref_sink (actor);
+
+  /* the progress function registered by the application replaces the
+   * default interpolation of ClutterColor, even on the fast path; it
+   * cannot be unregistered without losing the default one, so it is
+   * left in place, interpolating linearly, at the end of the test
+   */
+  clutter_interval_register_progress_func (CLUTTER_TYPE_COLOR,
+                                           custom_color_progress);
+  use_custom_progress = TRUE;
+
+  interval = create_interval (TRUE, CLUTTER_TYPE_COLOR);
+  clutter_interval_set_initial (interval, &red);
+  clutter_interval_set_final (interval, &blue);
+  run_transition (actor, "background-color", interval, 333);
+  g_object_unref (interval);
+
+  use_custom_progress = FALSE;
+
+  clutter_actor_get_background_color (actor, &color);
+  g_assert (clutter_color_equal (&color, &blue));
+
+  g_object_unref (actor);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/property-transition/fast-path", property_transition_fast_path)
+  CLUTTER_TEST_UNIT ("/property-transition/new-interval", property_transition_new_interval)
+  CLUTTER_TEST_UNIT ("/property-transition/batch", property_transition_batch)
+  CLUTTER_TEST_UNIT ("/property-transition/notify", property_transition_notify)
+  CLUTTER_TEST_UNIT ("/property-transition/custom-progress", property_transition_custom_progress)
+)
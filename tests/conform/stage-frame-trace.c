@@ -0,0 +1,137 @@
+#define CLUTTER_ENABLE_EXPERIMENTAL_API
+#include <clutter/clutter.h>
+
+#include <glib/gstdio.h>
+
+#define N_FRAMES        5
+
+static char *trace_path = NULL;
+
+static void
+on_after_paint (ClutterActor *stage,
+                gboolean     *was_painted)
+{
+  *was_painted = TRUE;
+}
+
+static void
+wait_for_frame (ClutterActor *stage)
+{
+  gboolean was_painted = FALSE;
+  gulong paint_id;
+
+  paint_id = g_signal_connect (stage, "after-paint",
+                               G_CALLBACK (on_after_paint),
+                               &was_painted);
+
+  clutter_actor_queue_redraw (stage);
+
+  while (!was_painted)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (stage, paint_id);
+}
+
+static guint
+count_records (char      **lines,
+               const char *name)
+{
+  char *needle = g_strdup_printf ("{\"name\":\"%s\",", name);
+  guint i, n_records = 0;
+
+  for (i = 0; lines[i] != NULL; i++)
+    {
+      if (g_str_has_prefix (lines[i], needle))
+        n_records += 1;
+    }
+
+  g_free (needle);
+
+  return n_records;
+}
+
+static void
+stage_frame_trace (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterFrameTiming timings[N_FRAMES];
+  GError *error = NULL;
+  char *contents;
+  char **lines;
+  guint i, n_lines;
+
+  /* the trace enables the frame timings of every stage */
+  g_assert (clutter_stage_get_frame_timings_enabled (CLUTTER_STAGE (stage)));
+
+  clutter_actor_show (stage);
+
+  for (i = 0; i < N_FRAMES; i++)
+    wait_for_frame (stage);
+
+  g_assert_cmpuint (clutter_stage_get_frame_timings (CLUTTER_STAGE (stage),
+                                                     timings,
+                                                     N_FRAMES),
+                    ==,
+                    N_FRAMES);
+
+  for (i = 0; i < N_FRAMES; i++)
+    {
+      g_assert_cmpint (timings[i].paint, >=, 0);
+      g_assert_cmpint (timings[i].total, >=, timings[i].paint);
+    }
+
+  /* disposing of the only stage closes the trace */
+  clutter_actor_destroy (stage);
+
+  g_file_get_contents (trace_path, &contents, NULL, &error);
+  g_assert_no_error (error);
+
+  if (g_test_verbose ())
+    g_print ("%s", contents);
+
+  lines = g_strsplit (contents, "\n", -1);
+  n_lines = g_strv_length (lines);
+
+  /* an array of events, each on its own line, and a trailing newline */
+  g_assert_cmpuint (n_lines, >, 2);
+  g_assert_cmpstr (lines[0], ==, "[");
+  g_assert_cmpstr (lines[n_lines - 1], ==, "");
+
+  for (i = 1; i < n_lines - 1; i++)
+    {
+      g_assert (g_str_has_prefix (lines[i], "{\"name\":"));
+      g_assert (g_str_has_suffix (lines[i], "},"));
+    }
+
+  /* the stage is named once, and each frame has its own record */
+  g_assert_cmpuint (count_records (lines, "thread_name"), ==, 1);
+  g_assert_cmpuint (count_records (lines, "frame"), >=, N_FRAMES);
+  g_assert_cmpuint (count_records (lines, "paint"), >=, N_FRAMES);
+
+  g_strfreev (lines);
+  g_free (contents);
+}
+
+int
+main (int argc, char *argv[])
+{
+  int fd, res;
+
+  /* the trace file is read when initializing Clutter */
+  fd = g_file_open_tmp ("clutter-frame-trace-XXXXXX.json", &trace_path, NULL);
+  g_assert_cmpint (fd, >=, 0);
+  g_close (fd, NULL);
+
+  g_setenv ("CLUTTER_FRAME_TRACE_FILE", trace_path, TRUE);
+
+  clutter_test_init (&argc, &argv);
+
+  clutter_test_add ("/stage/frame-trace", stage_frame_trace);
+
+  res = clutter_test_run ();
+
+  g_unlink (trace_path);
+  g_free (trace_path);
+
+  return res;
+}
@@ -0,0 +1,160 @@
+#define CLUTTER_DISABLE_DEPRECATION_WARNINGS
+#include <clutter/clutter.h>
+
+#define ACTOR_SIZE      50
+
+/* the damage history has to contain only the redraws queued by the
+ * test when the back buffer is reused
+ */
+#define N_FRAMES        5
+
+enum
+{
+  LEFT,
+  MIDDLE,
+  RIGHT,
+
+  N_ACTORS
+};
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *actors[N_ACTORS];
+  guint n_paints[N_ACTORS];
+
+  gboolean was_painted;
+  gboolean full_redraw;
+  gboolean middle_in_clip;
+} RegionData;
+
+static void
+on_actor_paint (ClutterActor *actor,
+                RegionData   *data)
+{
+  int i;
+
+  for (i = 0; i < N_ACTORS; i++)
+    {
+      if (data->actors[i] == actor)
+        data->n_paints[i] += 1;
+    }
+}
+
+/* the stage is painted once for each rectangle of the redraw region */
+static void
+on_stage_paint (ClutterActor *stage,
+                RegionData   *data)
+{
+  cairo_rectangle_int_t clip;
+  gfloat width, height;
+  int x, y;
+
+  clutter_stage_get_redraw_clip_bounds (CLUTTER_STAGE (stage), &clip);
+  clutter_actor_get_size (stage, &width, &height);
+
+  if (g_test_verbose ())
+    g_print ("redraw clip: %d, %d, %d x %d\n",
+             clip.x, clip.y,
+             clip.width, clip.height);
+
+  if (clip.x <= 0 && clip.y <= 0 &&
+      clip.x + clip.width >= width &&
+      clip.y + clip.height >= height)
+    data->full_redraw = TRUE;
+
+  x = 2 * ACTOR_SIZE + ACTOR_SIZE / 2;
+  y = ACTOR_SIZE / 2;
+
+  if (x >= clip.x && x < clip.x + clip.width &&
+      y >= clip.y && y < clip.y + clip.height)
+    data->middle_in_clip = TRUE;
+}
+
+static void
+on_after_paint (ClutterActor *stage,
+                RegionData   *data)
+{
+  data->was_painted = TRUE;
+}
+
+static void
+paint_frame (RegionData *data)
+{
+  int i;
+
+  for (i = 0; i < N_ACTORS; i++)
+    data->n_paints[i] = 0;
+
+  data->was_painted = FALSE;
+  data->full_redraw = FALSE;
+  data->middle_in_clip = FALSE;
+
+  /* only the actors on the sides are redrawn */
+  clutter_actor_queue_redraw (data->actors[LEFT]);
+  clutter_actor_queue_redraw (data->actors[RIGHT]);
+
+  while (!data->was_painted)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+stage_redraw_region_disjoint (void)
+{
+  RegionData data = { NULL, };
+  int i;
+
+  data.stage = clutter_test_get_stage ();
+
+  /* the actor in the middle is inside the bounding box of the redraws
+   * queued on the two others, but not inside either of them
+   */
+  for (i = 0; i < N_ACTORS; i++)
+    {
+      data.actors[i] = clutter_actor_new ();
+      clutter_actor_set_position (data.actors[i], i * ACTOR_SIZE * 2, 0);
+      clutter_actor_set_size (data.actors[i], ACTOR_SIZE, ACTOR_SIZE);
+      clutter_actor_set_background_color (data.actors[i], CLUTTER_COLOR_Red);
+      clutter_actor_add_child (data.stage, data.actors[i]);
+
+      g_signal_connect (data.actors[i], "paint",
+                        G_CALLBACK (on_actor_paint),
+                        &data);
+    }
+
+  g_signal_connect_after (data.stage, "paint",
+                          G_CALLBACK (on_stage_paint),
+                          &data);
+  g_signal_connect (data.stage, "after-paint",
+                    G_CALLBACK (on_after_paint),
+                    &data);
+
+  clutter_actor_show (data.stage);
+
+  for (i = 0; i < N_FRAMES; i++)
+    paint_frame (&data);
+
+  if (data.full_redraw)
+    {
+      if (g_test_verbose ())
+        g_print ("Clipped redraws are not available\n");
+    }
+  else
+    {
+      g_assert_cmpuint (data.n_paints[LEFT], >, 0);
+      g_assert_cmpuint (data.n_paints[RIGHT], >, 0);
+
+      /* the area between the two redraws is not repainted */
+      g_assert (!data.middle_in_clip);
+      g_assert_cmpuint (data.n_paints[MIDDLE], ==, 0);
+    }
+
+  g_signal_handlers_disconnect_by_func (data.stage, on_stage_paint, &data);
+  g_signal_handlers_disconnect_by_func (data.stage, on_after_paint, &data);
+
+  for (i = 0; i < N_ACTORS; i++)
+    clutter_actor_destroy (data.actors[i]);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/stage/redraw-region/disjoint", stage_redraw_region_disjoint)
+)
@@ -325,6 +325,96 @@ text_password_char (void)
   clutter_actor_destroy (CLUTTER_ACTOR (text));
 }
 
+static void
+text_shared_layout (void)
+{
+  ClutterText *a = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 10", "Cancel"));
+  ClutterText *b = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 10", "Cancel"));
+  PangoAttrList *attrs;
+
+  g_object_ref_sink (a);
+  g_object_ref_sink (b);
+
+  /* the same contents with the same settings are shaped once */
+  g_assert (clutter_text_get_layout (a) == clutter_text_get_layout (b));
+
+  clutter_text_set_text (b, "OK");
+  g_assert (clutter_text_get_layout (a) != clutter_text_get_layout (b));
+
+  clutter_text_set_text (b, "Cancel");
+  g_assert (clutter_text_get_layout (a) == clutter_text_get_layout (b));
+
+  /* equal attributes are matched by value */
+  attrs = pango_attr_list_new ();
+  pango_attr_list_insert (attrs, pango_attr_weight_new (PANGO_WEIGHT_BOLD));
+  clutter_text_set_attributes (a, attrs);
+  pango_attr_list_unref (attrs);
+  g_assert (clutter_text_get_layout (a) != clutter_text_get_layout (b));
+
+  attrs = pango_attr_list_new ();
+  pango_attr_list_insert (attrs, pango_attr_weight_new (PANGO_WEIGHT_BOLD));
+  clutter_text_set_attributes (b, attrs);
+  pango_attr_list_unref (attrs);
+  g_assert (clutter_text_get_layout (a) == clutter_text_get_layout (b));
+
+  clutter_text_set_font_name (b, "Sans 12");
+  g_assert (clutter_text_get_layout (a) != clutter_text_get_layout (b));
+  clutter_text_set_font_name (b, "Sans 10");
+
+  /* editable text is never shared */
+  clutter_text_set_editable (b, TRUE);
+  g_assert (clutter_text_get_layout (a) != clutter_text_get_layout (b));
+
+  clutter_actor_destroy (CLUTTER_ACTOR (a));
+  clutter_actor_destroy (CLUTTER_ACTOR (b));
+  g_object_unref (a);
+  g_object_unref (b);
+}
+
+static void
+text_async_layout (void)
+{
+  ClutterText *a = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 10", NULL));
+  ClutterText *b = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 10", NULL));
+  gfloat width_a, width_b;
+  PangoLayout *layout;
+
+  g_object_ref_sink (a);
+  g_object_ref_sink (b);
+
+  clutter_text_set_async_layout (a, TRUE);
+  g_assert (clutter_text_get_async_layout (a));
+
+  clutter_text_set_text (a, "Shaped in a worker thread");
+  clutter_text_set_text (b, "Shaped in a worker thread");
+
+  /* nothing is displayed until the layout has been shaped */
+  layout = clutter_text_get_layout (a);
+  g_assert_cmpstr (pango_layout_get_text (layout), ==, "");
+
+  clutter_text_wait_for_layout (a);
+
+  layout = clutter_text_get_layout (a);
+  g_assert_cmpstr (pango_layout_get_text (layout), ==, "Shaped in a worker thread");
+
+  clutter_actor_get_preferred_width (CLUTTER_ACTOR (a), -1, NULL, &width_a);
+  clutter_actor_get_preferred_width (CLUTTER_ACTOR (b), -1, NULL, &width_b);
+  g_assert_cmpfloat (width_a, ==, width_b);
+
+  /* the previous contents are displayed while the new ones are shaped */
+  clutter_text_set_text (a, "Shaped again");
+  layout = clutter_text_get_layout (a);
+  g_assert_cmpstr (pango_layout_get_text (layout), ==, "Shaped in a worker thread");
+
+  clutter_text_wait_for_layout (a);
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (a)), ==, "Shaped again");
+
+  clutter_actor_destroy (CLUTTER_ACTOR (a));
+  clutter_actor_destroy (CLUTTER_ACTOR (b));
+  g_object_unref (a);
+  g_object_unref (b);
+}
+
 static ClutterEvent *
 init_event (void)
 {
@@ -544,6 +634,8 @@ CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/text/get-chars", text_get_chars)
   CLUTTER_TEST_UNIT ("/text/delete-text", text_delete_text)
   CLUTTER_TEST_UNIT ("/text/password-char", text_password_char)
+  CLUTTER_TEST_UNIT ("/text/shared-layout", text_shared_layout)
+  CLUTTER_TEST_UNIT ("/text/async-layout", text_async_layout)
   CLUTTER_TEST_UNIT ("/text/cursor", text_cursor)
   CLUTTER_TEST_UNIT ("/text/event", text_event)
   CLUTTER_TEST_UNIT ("/text/idempotent-use-markup", text_idempotent_use_markup)
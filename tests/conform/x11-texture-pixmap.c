@@ -0,0 +1,248 @@
+#define CLUTTER_DISABLE_DEPRECATION_WARNINGS
+#include <clutter/clutter.h>
+
+#include <X11/Xlib.h>
+#include <X11/extensions/Xdamage.h>
+
+#include <clutter/x11/clutter-x11.h>
+#include <clutter/x11/clutter-x11-texture-pixmap.h>
+
+#define PIXMAP_SIZE     100
+#define ACTOR_OFFSET    10
+#define ACTOR_SIZE      150     /* scales the pixmap by 1.5 */
+
+/* the number of frames to wait for the damage of a real drawing */
+#define MAX_FRAMES      100
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *texture;
+
+  int damage_event_base;
+  XDamageNotifyEvent damage_event;
+  gboolean got_damage_event;
+
+  guint n_paints;
+
+  /* the emissions of ::queue-damage-redraw, in pixmap coordinates */
+  GArray *damaged_areas;
+  guint paint_at_damage;
+
+  cairo_rectangle_int_t redraw_clip;
+} DamageData;
+
+static ClutterX11FilterReturn
+damage_event_filter (XEvent       *xev,
+                     ClutterEvent *cev,
+                     gpointer      user_data)
+{
+  DamageData *data = user_data;
+
+  if (xev->type == data->damage_event_base + XDamageNotify)
+    {
+      data->damage_event = *(XDamageNotifyEvent *) xev;
+      data->got_damage_event = TRUE;
+    }
+
+  return CLUTTER_X11_FILTER_CONTINUE;
+}
+
+static void
+on_queue_damage_redraw (ClutterX11TexturePixmap *texture,
+                        int                      x,
+                        int                      y,
+                        int                      width,
+                        int                      height,
+                        DamageData              *data)
+{
+  cairo_rectangle_int_t area = { x, y, width, height };
+
+  if (g_test_verbose ())
+    g_print ("damage: %d, %d, %d x %d (paint %u)\n",
+             x, y, width, height, data->n_paints);
+
+  g_array_append_val (data->damaged_areas, area);
+  data->paint_at_damage = data->n_paints;
+}
+
+static void
+on_stage_paint (ClutterActor *stage,
+                DamageData   *data)
+{
+  clutter_stage_get_redraw_clip_bounds (CLUTTER_STAGE (stage),
+                                        &data->redraw_clip);
+  data->n_paints += 1;
+}
+
+static void
+wait_for_paint (DamageData *data)
+{
+  guint n_paints = data->n_paints;
+
+  clutter_actor_queue_redraw (data->texture);
+
+  while (data->n_paints == n_paints)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+/* delivers a damage event for the texture, as if the X server sent it */
+static void
+send_damage_event (DamageData *data,
+                   int         x,
+                   int         y,
+                   int         width,
+                   int         height)
+{
+  XDamageNotifyEvent event = data->damage_event;
+
+  event.area.x = x;
+  event.area.y = y;
+  event.area.width = width;
+  event.area.height = height;
+
+  clutter_x11_handle_event ((XEvent *) &event);
+}
+
+static gboolean
+has_damaged_area (DamageData *data,
+                  int         x,
+                  int         y,
+                  int         width,
+                  int         height)
+{
+  guint i;
+
+  for (i = 0; i < data->damaged_areas->len; i++)
+    {
+      const cairo_rectangle_int_t *area =
+        &g_array_index (data->damaged_areas, cairo_rectangle_int_t, i);
+
+      if (area->x == x && area->y == y &&
+          area->width == width && area->height == height)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+texture_pixmap_coalesce_damage (void)
+{
+  DamageData data = { NULL, };
+  Display *xdpy;
+  Pixmap pixmap;
+  GC gc;
+  int error_base, i;
+  guint n_paints;
+
+  if (!clutter_check_windowing_backend (CLUTTER_WINDOWING_X11))
+    return;
+
+  xdpy = clutter_x11_get_default_display ();
+
+  if (!XDamageQueryExtension (xdpy, &data.damage_event_base, &error_base))
+    {
+      if (g_test_verbose ())
+        g_print ("The X server does not support the Damage extension\n");
+
+      return;
+    }
+
+  pixmap = XCreatePixmap (xdpy,
+                          DefaultRootWindow (xdpy),
+                          PIXMAP_SIZE, PIXMAP_SIZE,
+                          DefaultDepth (xdpy, DefaultScreen (xdpy)));
+  gc = XCreateGC (xdpy, pixmap, 0, NULL);
+
+  data.stage = clutter_test_get_stage ();
+  data.damaged_areas = g_array_new (FALSE, FALSE, sizeof (cairo_rectangle_int_t));
+
+  data.texture = clutter_x11_texture_pixmap_new_with_pixmap (pixmap);
+  clutter_x11_texture_pixmap_set_automatic (CLUTTER_X11_TEXTURE_PIXMAP (data.texture),
+                                            TRUE);
+  clutter_actor_set_position (data.texture, ACTOR_OFFSET, ACTOR_OFFSET);
+  clutter_actor_set_size (data.texture, ACTOR_SIZE, ACTOR_SIZE);
+  clutter_actor_add_child (data.stage, data.texture);
+
+  g_signal_connect (data.texture, "queue-damage-redraw",
+                    G_CALLBACK (on_queue_damage_redraw),
+                    &data);
+  g_signal_connect_after (data.stage, "paint",
+                          G_CALLBACK (on_stage_paint),
+                          &data);
+  clutter_x11_add_filter (damage_event_filter, &data);
+
+  clutter_actor_show (data.stage);
+  wait_for_paint (&data);
+
+  /* draw on the pixmap, to get a real damage event to replay */
+  XFillRectangle (xdpy, pixmap, gc, 0, 0, PIXMAP_SIZE, PIXMAP_SIZE);
+  XSync (xdpy, False);
+
+  for (i = 0; i < MAX_FRAMES && !data.got_damage_event; i++)
+    wait_for_paint (&data);
+
+  g_assert (data.got_damage_event);
+
+  /* flush the damage of the drawing */
+  wait_for_paint (&data);
+  wait_for_paint (&data);
+  g_array_set_size (data.damaged_areas, 0);
+
+  /* damage the texture three times within the same frame; the first
+   * two areas are adjacent, and form a single rectangle
+   */
+  send_damage_event (&data, 0, 0, 10, 10);
+  send_damage_event (&data, 10, 0, 10, 10);
+  send_damage_event (&data, 40, 40, 10, 10);
+
+  /* the signal is deferred to the next frame */
+  g_assert_cmpuint (data.damaged_areas->len, ==, 0);
+
+  n_paints = data.n_paints;
+  wait_for_paint (&data);
+
+  /* and emitted once for each rectangle of the region, before painting */
+  g_assert_cmpuint (data.damaged_areas->len, ==, 2);
+  g_assert (has_damaged_area (&data, 0, 0, 20, 10));
+  g_assert (has_damaged_area (&data, 40, 40, 10, 10));
+  g_assert_cmpuint (data.paint_at_damage, ==, n_paints);
+
+  /* the clip is rounded outwards: pixel 1 of the pixmap covers
+   * [1.5, 3.0] on the actor, so the redraw must cover [1, 3]
+   */
+  wait_for_paint (&data);
+  g_array_set_size (data.damaged_areas, 0);
+
+  send_damage_event (&data, 1, 1, 1, 1);
+
+  /* paint the frame without queueing a redraw on the whole actor */
+  n_paints = data.n_paints;
+  while (data.n_paints == n_paints)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmpuint (data.damaged_areas->len, ==, 1);
+
+  if (g_test_verbose ())
+    g_print ("redraw clip: %d, %d, %d x %d\n",
+             data.redraw_clip.x, data.redraw_clip.y,
+             data.redraw_clip.width, data.redraw_clip.height);
+
+  g_assert_cmpint (data.redraw_clip.x, <=, ACTOR_OFFSET + 1);
+  g_assert_cmpint (data.redraw_clip.y, <=, ACTOR_OFFSET + 1);
+  g_assert_cmpint (data.redraw_clip.x + data.redraw_clip.width, >=, ACTOR_OFFSET + 3);
+  g_assert_cmpint (data.redraw_clip.y + data.redraw_clip.height, >=, ACTOR_OFFSET + 3);
+
+  clutter_x11_remove_filter (damage_event_filter, &data);
+  g_signal_handlers_disconnect_by_func (data.stage, on_stage_paint, &data);
+
+  clutter_actor_destroy (data.texture);
+  g_array_free (data.damaged_areas, TRUE);
+
+  XFreeGC (xdpy, gc);
+  XFreePixmap (xdpy, pixmap);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/x11/texture-pixmap/coalesce-damage", texture_pixmap_coalesce_damage)
+)
@@ -0,0 +1,216 @@
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#include "clutter-easing.h"
+
+#define N_VALUES 4096
+#define N_ITERATIONS 200
+
+static gint n_values = N_VALUES;
+static gint n_iterations = N_ITERATIONS;
+
+static GOptionEntry entries[] = {
+  {
+    "num-values", 'v',
+    0,
+    G_OPTION_ARG_INT, &n_values,
+    "Number of progress values", "VALUES"
+  },
+  {
+    "num-iterations", 'i',
+    0,
+    G_OPTION_ARG_INT, &n_iterations,
+    "Number of iterations", "ITERATIONS"
+  },
+  { NULL }
+};
+
+/* the parameters of the parametrized modes */
+#define N_STEPS         4
+#define BEZIER_X_1      0.3
+#define BEZIER_Y_1      -0.4
+#define BEZIER_X_2      0.7
+#define BEZIER_Y_2      1.4
+
+/* the same parameters used by ClutterTimeline */
+static gdouble
+ease_direct (ClutterAnimationMode mode,
+             gdouble              t,
+             gdouble              d)
+{
+  switch (mode)
+    {
+    case CLUTTER_STEPS:
+      return clutter_ease_steps_end (t, d, N_STEPS);
+
+    case CLUTTER_STEP_START:
+      return clutter_ease_steps_start (t, d, 1);
+
+    case CLUTTER_STEP_END:
+      return clutter_ease_steps_end (t, d, 1);
+
+    case CLUTTER_CUBIC_BEZIER:
+      return clutter_ease_cubic_bezier (t, d,
+                                        BEZIER_X_1, BEZIER_Y_1,
+                                        BEZIER_X_2, BEZIER_Y_2);
+
+    case CLUTTER_EASE:
+      return clutter_ease_cubic_bezier (t, d, 0.25, 0.1, 0.25, 1.0);
+
+    case CLUTTER_EASE_IN:
+      return clutter_ease_cubic_bezier (t, d, 0.42, 0.0, 1.0, 1.0);
+
+    case CLUTTER_EASE_OUT:
+      return clutter_ease_cubic_bezier (t, d, 0.0, 0.0, 0.58, 1.0);
+
+    case CLUTTER_EASE_IN_OUT:
+      return clutter_ease_cubic_bezier (t, d, 0.42, 0.0, 0.58, 1.0);
+
+    default:
+      return clutter_easing_for_mode (mode, t, d);
+    }
+}
+
+static ClutterEasingTable *
+table_new (ClutterAnimationMode mode,
+           gboolean             sampled)
+{
+  switch (mode)
+    {
+    case CLUTTER_STEPS:
+      return clutter_easing_table_new_steps (N_STEPS, CLUTTER_STEP_MODE_END);
+
+    case CLUTTER_CUBIC_BEZIER:
+      return clutter_easing_table_new_cubic_bezier (BEZIER_X_1, BEZIER_Y_1,
+                                                    BEZIER_X_2, BEZIER_Y_2,
+                                                    sampled);
+
+    default:
+      return NULL;
+    }
+}
+
+static gdouble
+time_table (const ClutterEasingTable *table,
+            const gdouble            *elapsed,
+            const gdouble            *duration,
+            gdouble                  *res,
+            GTimer                   *timer)
+{
+  gint j;
+
+  g_timer_start (timer);
+  for (j = 0; j < n_iterations; j++)
+    clutter_easing_table_evaluate_array (table, elapsed, duration, res, n_values);
+
+  return g_timer_elapsed (timer, NULL);
+}
+
+static gdouble
+get_max_error (ClutterAnimationMode  mode,
+               const gdouble        *elapsed,
+               const gdouble        *duration,
+               const gdouble        *res)
+{
+  gdouble max_error = 0.0;
+  gint i;
+
+  for (i = 0; i < n_values; i++)
+    max_error = MAX (max_error, ABS (res[i] - ease_direct (mode, elapsed[i], duration[i])));
+
+  return max_error;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  gdouble *elapsed, *duration, *res;
+  GTimer *timer;
+  gint mode, i, j;
+
+  context = g_option_context_new ("- easing functions performance test");
+  g_option_context_add_main_entries (context, entries, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return EXIT_FAILURE;
+    }
+
+  g_option_context_free (context);
+
+  elapsed = g_new (gdouble, n_values);
+  duration = g_new (gdouble, n_values);
+  res = g_new (gdouble, n_values);
+
+  for (i = 0; i < n_values; i++)
+    {
+      elapsed[i] = i;
+      duration[i] = n_values - 1;
+    }
+
+  timer = g_timer_new ();
+
+  printf ("Easing performance test with %d values and %d iterations\n",
+          n_values,
+          n_iterations);
+  printf ("%-18s %10s %10s %10s %8s %10s %10s\n",
+          "mode", "direct ns", "exact ns", "table ns", "speedup",
+          "exact err", "table err");
+
+  for (mode = CLUTTER_LINEAR; mode < CLUTTER_ANIMATION_LAST; mode++)
+    {
+      ClutterEasingTable *exact_owned, *sampled_owned;
+      const ClutterEasingTable *exact, *sampled;
+      gdouble direct_time, exact_time, sampled_time;
+      gdouble exact_error, sampled_error;
+      gdouble n_evals = (gdouble) n_values * n_iterations;
+
+      exact_owned = table_new (mode, FALSE);
+      sampled_owned = table_new (mode, TRUE);
+
+      if (exact_owned != NULL)
+        {
+          exact = exact_owned;
+          sampled = sampled_owned;
+        }
+      else
+        {
+          exact = clutter_easing_table_get_for_mode (mode, FALSE);
+          sampled = clutter_easing_table_get_for_mode (mode, TRUE);
+        }
+
+      g_timer_start (timer);
+      for (j = 0; j < n_iterations; j++)
+        for (i = 0; i < n_values; i++)
+          res[i] = ease_direct (mode, elapsed[i], duration[i]);
+      direct_time = g_timer_elapsed (timer, NULL);
+
+      /* the exact tables must give the same results of the timeline */
+      exact_time = time_table (exact, elapsed, duration, res, timer);
+      exact_error = get_max_error (mode, elapsed, duration, res);
+
+      sampled_time = time_table (sampled, elapsed, duration, res, timer);
+      sampled_error = get_max_error (mode, elapsed, duration, res);
+
+      printf ("%-18s %10.2f %10.2f %10.2f %7.1fx %10.2g %10.2g\n",
+              clutter_get_easing_name_for_mode (mode),
+              direct_time * 1e9 / n_evals,
+              exact_time * 1e9 / n_evals,
+              sampled_time * 1e9 / n_evals,
+              direct_time / MAX (sampled_time, 1e-9),
+              exact_error,
+              sampled_error);
+
+      clutter_easing_table_free (exact_owned);
+      clutter_easing_table_free (sampled_owned);
+    }
+
+  g_timer_destroy (timer);
+  g_free (elapsed);
+  g_free (duration);
+  g_free (res);
+
+  return EXIT_SUCCESS;
+}
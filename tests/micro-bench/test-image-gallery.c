@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include <clutter/clutter.h>
+
+#define N_IMAGES        200
+#define THUMB_SIZE      64
+
+static gint n_images = N_IMAGES;
+static gchar *filename = NULL;
+
+static GOptionEntry entries[] = {
+  {
+    "num-images", 'n',
+    0,
+    G_OPTION_ARG_INT, &n_images,
+    "Number of images", "IMAGES"
+  },
+  {
+    "file", 'f',
+    0,
+    G_OPTION_ARG_FILENAME, &filename,
+    "Image file to load", "FILE"
+  },
+  { NULL }
+};
+
+static gint n_loaded = 0;
+static gint64 load_start = 0;
+static gint64 last_frame = 0;
+static gint64 max_frame = 0;
+
+static void
+on_after_paint (ClutterActor *stage)
+{
+  gint64 now = g_get_monotonic_time ();
+
+  if (last_frame != 0 && n_loaded < n_images)
+    max_frame = MAX (max_frame, now - last_frame);
+
+  last_frame = now;
+}
+
+static void
+on_image_loaded (GObject      *image,
+                 GAsyncResult *result,
+                 gpointer      user_data)
+{
+  GError *error = NULL;
+
+  if (!clutter_image_load_finish (CLUTTER_IMAGE (image), result, &error))
+    {
+      g_printerr ("Unable to load '%s': %s\n", filename, error->message);
+      g_error_free (error);
+    }
+
+  if (++n_loaded == n_images)
+    {
+      printf ("Loaded %d images in %.2f ms, longest frame: %.2f ms\n",
+              n_images,
+              (g_get_monotonic_time () - load_start) / 1000.0,
+              max_frame / 1000.0);
+
+      clutter_main_quit ();
+    }
+}
+
+static gboolean
+queue_redraw (gpointer stage)
+{
+  clutter_actor_queue_redraw (CLUTTER_ACTOR (stage));
+
+  return G_SOURCE_CONTINUE;
+}
+
+int
+main (int argc, char **argv)
+{
+  ClutterActor *stage, *grid;
+  ClutterLayoutManager *layout;
+  GError *error = NULL;
+  GFile *file;
+  gint i;
+
+  g_setenv ("CLUTTER_VBLANK", "none", FALSE);
+  g_setenv ("CLUTTER_DEFAULT_FPS", "1000", FALSE);
+
+  if (clutter_init_with_args (&argc, &argv,
+                              NULL,
+                              entries,
+                              NULL,
+                              &error) != CLUTTER_INIT_SUCCESS)
+    return 1;
+
+  if (filename == NULL)
+    filename = g_strdup (TESTS_IMAGE_FILE);
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_size (stage, 800, 600);
+  clutter_stage_set_title (CLUTTER_STAGE (stage), "Image Gallery");
+  g_signal_connect (stage, "destroy", G_CALLBACK (clutter_main_quit), NULL);
+  g_signal_connect (stage, "after-paint", G_CALLBACK (on_after_paint), NULL);
+
+  layout = clutter_flow_layout_new (CLUTTER_FLOW_HORIZONTAL);
+  grid = clutter_actor_new ();
+  clutter_actor_set_layout_manager (grid, layout);
+  clutter_actor_add_constraint (grid, clutter_bind_constraint_new (stage, CLUTTER_BIND_WIDTH, 0));
+  clutter_actor_add_child (stage, grid);
+
+  printf ("Image loading performance test with %d images of %d x %d pixels\n",
+          n_images,
+          THUMB_SIZE, THUMB_SIZE);
+
+  file = g_file_new_for_commandline_arg (filename);
+  load_start = g_get_monotonic_time ();
+
+  for (i = 0; i < n_images; i++)
+    {
+      ClutterContent *image = clutter_image_new ();
+      ClutterActor *thumb = clutter_actor_new ();
+
+      clutter_actor_set_size (thumb, THUMB_SIZE, THUMB_SIZE);
+      clutter_actor_set_content_gravity (thumb, CLUTTER_CONTENT_GRAVITY_RESIZE_ASPECT);
+      clutter_actor_set_content (thumb, image);
+      clutter_actor_add_child (grid, thumb);
+
+      clutter_image_load_async (CLUTTER_IMAGE (image), file,
+                                THUMB_SIZE, THUMB_SIZE,
+                                NULL,
+                                on_image_loaded,
+                                NULL);
+
+      g_object_unref (image);
+    }
+
+  g_object_unref (file);
+
+  clutter_actor_show (stage);
+
+  clutter_threads_add_idle (queue_redraw, stage);
+
+  clutter_main ();
+
+  clutter_actor_destroy (stage);
+  g_free (filename);
+
+  return EXIT_SUCCESS;
+}
@@ -101,6 +101,37 @@ create_label (void)
   return label;
 }
 
+/* the labels displaying the same string share their layout, so
+ * every label but the first is a hit in the shared layout cache
+ */
+static void
+print_layout_sharing (ClutterActor *stage)
+{
+  GHashTable *layouts;
+  ClutterActorIter iter;
+  ClutterActor *child;
+  int n_labels = 0;
+  int n_layouts;
+
+  layouts = g_hash_table_new (NULL, NULL);
+
+  clutter_actor_iter_init (&iter, stage);
+  while (clutter_actor_iter_next (&iter, &child))
+    {
+      g_hash_table_add (layouts, clutter_text_get_layout (CLUTTER_TEXT (child)));
+      n_labels += 1;
+    }
+
+  n_layouts = g_hash_table_size (layouts);
+
+  printf ("labels=%d, layouts=%d, layout cache hit rate=%.1f%%\n",
+          n_labels,
+          n_layouts,
+          n_labels > 0 ? 100.0 * (n_labels - n_layouts) / n_labels : 0.0);
+
+  g_hash_table_unref (layouts);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -179,6 +210,8 @@ main (int argc, char *argv[])
 
   clutter_actor_show_all (stage);
 
+  print_layout_sharing (stage);
+
   clutter_threads_add_idle (queue_redraw, stage);
 
   clutter_main ();